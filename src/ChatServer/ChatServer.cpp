@@ -188,6 +188,13 @@ void ChatServer::Process()
     }
 }
 
+//======================================================================================================================
+
+void ChatServer::Idle(uint32 timeout)
+{
+    mDatabaseManager->waitForCompletedJobs(timeout);
+}
+
 
 //======================================================================================================================
 
@@ -284,7 +291,7 @@ int main(int argc, char* argv[])
                 break;
         }
 
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        gChatServer->Idle(1);
     }
 
     // Shutdown things
@@ -69,6 +69,9 @@ public:
 
     void    Process();
 
+    // Sleeps for up to timeout ms, a completed database job wakes us up early.
+    void    Idle(uint32 timeout);
+
 private:
 
     void    _updateDBServerList(uint32 status);
@@ -105,6 +105,43 @@ void ClientManager::SendMessageToClient(Message* message)
     }
 }
 
+//======================================================================================================================
+//
+// Fans a multicast envelope from a zone out to the clients listed in it.
+// Layout: opcode, uint16 account count, account ids, payload. Every client gets a message sharing the payload.
+//
+void ClientManager::SendMulticastToClients(Message* message)
+{
+    message->ResetIndex();
+    message->getUint32();  // opClusterMulticastMessage
+
+    uint16 accountCount = message->getUint16();
+    uint16 payloadOffset = static_cast<uint16>(6 + accountCount * 4);
+
+    if(message->getSize() <= payloadOffset)
+    {
+        gLogger->log(LogManager::NOTICE,"ClientManager::SendMulticastToClients: malformed multicast, %u accounts in %u bytes",accountCount,message->getSize());
+        gMessageFactory->DestroyMessage(message);
+        return;
+    }
+
+    boost::recursive_mutex::scoped_lock lk(mServiceMutex);
+
+    for(uint16 i = 0; i < accountCount; i++)
+    {
+        Message* clientMessage = gMessageFactory->CreateSharedMessage(message, payloadOffset);
+
+        clientMessage->setAccountId(message->getUint32());
+        clientMessage->setPriority(message->getPriority());
+        clientMessage->setFastpath(message->getFastpath());
+
+        SendMessageToClient(clientMessage);
+    }
+
+    // the payload stays around until the last client message has been sent
+    gMessageFactory->DestroyMessage(message);
+}
+
 //======================================================================================================================
 //
 // handleserverdown
@@ -61,6 +61,7 @@ public:
     void                        Process(void);
 
     void                        SendMessageToClient(Message* message);
+    void                        SendMulticastToClients(Message* message);
 
     // Inherited NetworkCallback
     virtual NetworkClient*	    handleSessionConnect(Session* session, Service* service);
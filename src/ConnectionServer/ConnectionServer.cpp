@@ -189,6 +189,13 @@ void ConnectionServer::Process(void)
 
 //======================================================================================================================
 
+void ConnectionServer::Idle(uint32 timeout)
+{
+    mDatabaseManager->waitForCompletedJobs(timeout);
+}
+
+//======================================================================================================================
+
 void ConnectionServer::_updateDBServerList(uint32 status)
 {
     // Execute our query
@@ -255,7 +262,7 @@ int main(int argc, char* argv[])
         }
 
 
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        gConnectionServer->Idle(1);
     }
 
     // Shutdown things
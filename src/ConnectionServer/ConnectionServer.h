@@ -56,6 +56,9 @@ public:
     void	Process(void);
     void    ToggleLock();
 
+    // Sleeps for up to timeout ms, a completed database job wakes us up early.
+    void	Idle(uint32 timeout);
+
 private:
 
     void	_updateDBServerList(uint32 status);
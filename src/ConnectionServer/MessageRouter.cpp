@@ -123,7 +123,11 @@ void MessageRouter::RouteMessage(Message* message, ConnectionClient* client)
         // If this is meant for a client, send it to the ClientManager
         if(message->getDestinationId() == 0)
         {
-            mClientManager->SendMessageToClient(message);
+            // one payload for many clients, fan it out here
+            if(opcode == opClusterMulticastMessage)
+                mClientManager->SendMulticastToClients(message);
+            else
+                mClientManager->SendMessageToClient(message);
         }
         else // Send it to the ServerManager
         {
@@ -27,6 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "Database.h"
 
+#include "DatabaseManager.h"
 #include "DataBinding.h"
 #include "DataBindingFactory.h"
 #include "DatabaseCallback.h"
@@ -35,12 +36,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseJob.h"
 #include "DatabaseType.h"
 #include "DatabaseWorkerThread.h"
+#include "PreparedStatement.h"
 #include "Transaction.h"
+#include "WriteBehindBuffer.h"
 
 #include "Common/LogManager.h"
 
 #include "Common/ConfigManager.h"
 
+#include "Utils/clock.h"
+
 #include <cstdarg>
 #include <cstdlib>
 #include <cstdio>
@@ -50,6 +55,8 @@ Database::Database(DBType type, char* host, uint16 port, char* user, char* pass,
     mDatabaseType(type),
     mDataBindingFactory(0),
     mDatabaseImplementation(0),
+    mManager(0),
+    mWriteBehind(0),
     mJobPool(sizeof(DatabaseJob)),
     mTransactionPool(sizeof(Transaction))
 {
@@ -80,6 +87,14 @@ Database::Database(DBType type, char* host, uint16 port, char* user, char* pass,
 
         pushIdleWorker(newWorker);
     }
+
+    // fire and forget updates of the same rows are merged within this window (ms)
+    uint32 writeBehindWindow = gConfig->read<uint32>("DBWriteBehindWindow",0);
+    if(writeBehindWindow)
+    {
+        Anh_Utils::Clock::Init();
+        mWriteBehind = new WriteBehindBuffer(writeBehindWindow);
+    }
 }
 
 
@@ -88,6 +103,17 @@ Database::~Database(void)
 {
     DatabaseWorkerThread* worker = 0;
 
+    // nothing that was deferred may get lost
+    if(mWriteBehind)
+    {
+        _flushWriteBehind(true);
+
+        gLogger->log(LogManager::INFORMATION,"Database write behind: %"PRIu64" updates queued, %"PRIu64" merged, %"PRIu64" statements written",
+                     mWriteBehind->getQueuedCount(),mWriteBehind->getCoalescedCount(),mWriteBehind->getStatementCount());
+
+        delete(mWriteBehind);
+    }
+
     while(mWorkerIdleQueue.size())
     {
         worker = mWorkerIdleQueue.pop();
@@ -105,20 +131,26 @@ Database::~Database(void)
 
 void Database::Process(void)
 {
-    DatabaseWorkerThread* worker = 0;
     DatabaseJob* job = 0;
 
-    // Check to see if we have an idle worker, and a job to give it.
-    if(mWorkerIdleQueue.size() && mJobPendingQueue.size())
+    // Queue the deferred updates once their window is up.
+    if(mWriteBehind)
     {
-        // Pop the worker and job off thier queues.
-        worker	= mWorkerIdleQueue.pop();
-        job		= mJobPendingQueue.pop();
+        bool due;
+        {
+            boost::mutex::scoped_lock lock(mWriteBehindMutex);
+            due = mWriteBehind->isDue(Anh_Utils::Clock::getSingleton()->getLocalTime());
+        }
 
-        // Hand The job to the worker.
-        worker->ExecuteJob(job);
+        if(due)
+        {
+            _flushWriteBehind(false);
+        }
     }
 
+    // Jobs get handed out as they are queued and as workers get free, this only catches up on what is left.
+    _dispatchJobs();
+
     // Now process any completed jobs.
     uint32 completedCount = mJobCompleteQueue.size();
 
@@ -136,9 +168,41 @@ void Database::Process(void)
         // Free the result and the job
         this->DestroyResult(job->getDatabaseResult());
 
+        delete(job->getParameters());
+
         mJobPool.ordered_free(job);
     }
 }
+//======================================================================================================================
+
+void Database::_dispatchJobs()
+{
+    boost::mutex::scoped_lock lock(mDispatchMutex);
+
+    while(mWorkerIdleQueue.size() && mJobPendingQueue.size())
+    {
+        // Pop the worker and job off thier queues.
+        DatabaseWorkerThread* worker	= mWorkerIdleQueue.pop();
+        DatabaseJob* job				= mJobPendingQueue.pop();
+
+        // Hand The job to the worker, this wakes it up.
+        worker->ExecuteJob(job);
+    }
+}
+
+//======================================================================================================================
+
+void Database::pushDatabaseJobComplete(DatabaseJob* job)
+{
+    mJobCompleteQueue.push(job);
+
+    // wake up the server thread
+    if(mManager)
+    {
+        mManager->notifyJobComplete();
+    }
+}
+
 //======================================================================================================================
 int Database::GetCount(const int8* tablename)
 {
@@ -221,6 +285,7 @@ void Database::ExecuteSqlAsync(DatabaseCallback* callback, void* ref, const int8
 
     // Add the job to our processList;
     mJobPendingQueue.push(job);
+    _dispatchJobs();
 
     va_end(args);
 }
@@ -250,9 +315,167 @@ void Database::ExecuteSqlAsyncNoArguments(DatabaseCallback* callback, void* ref,
 
     // Add the job to our processList;
     mJobPendingQueue.push(job);
+    _dispatchJobs();
 }
 //======================================================================================================================
 
+void Database::ExecuteUpdateDeferred(uint64 ownerId, const int8* table, const int8* column, const int8* condition, const int8* value, ...)
+{
+    va_list args;
+    va_start(args, value);
+    int8    localValue[8192];
+    vsnprintf(localValue, sizeof(localValue), value, args);
+    va_end(args);
+
+    _deferUpdate(ownerId,table,column,condition,localValue);
+}
+
+//======================================================================================================================
+
+void Database::_deferUpdate(uint64 ownerId, const int8* table, const int8* column, const int8* condition, const int8* localValue)
+{
+    if(!mWriteBehind)
+    {
+        ExecuteSqlAsync(0,0,"UPDATE %s SET %s=%s WHERE %s",table,column,localValue,condition);
+        return;
+    }
+
+    boost::mutex::scoped_lock lock(mWriteBehindMutex);
+    mWriteBehind->add(table,column,condition,localValue,ownerId,Anh_Utils::Clock::getSingleton()->getLocalTime());
+}
+
+//======================================================================================================================
+
+void Database::FlushDeferredUpdates(uint64 ownerId)
+{
+    if(!mWriteBehind)
+    {
+        return;
+    }
+
+    std::vector<std::string> statements;
+
+    {
+        boost::mutex::scoped_lock lock(mWriteBehindMutex);
+        mWriteBehind->flushOwner(ownerId, statements, DATABASEJOB_SQL_SIZE - 1);
+    }
+
+    // The async workers give no order against the jobs queued next, so write directly.
+    _writeDeferredStatements(statements, true);
+}
+
+//======================================================================================================================
+//
+// Writes the pending deferred updates, through the workers or, on shutdown and explicit flushes, directly.
+//
+
+void Database::_flushWriteBehind(bool synchronous)
+{
+    std::vector<std::string> statements;
+
+    {
+        boost::mutex::scoped_lock lock(mWriteBehindMutex);
+        mWriteBehind->flush(statements, DATABASEJOB_SQL_SIZE - 1);
+    }
+
+    _writeDeferredStatements(statements, synchronous);
+}
+
+//======================================================================================================================
+
+void Database::_writeDeferredStatements(const std::vector<std::string>& statements, bool synchronous)
+{
+    std::vector<std::string>::const_iterator it = statements.begin();
+
+    while(it != statements.end())
+    {
+        if((*it).length() >= DATABASEJOB_SQL_SIZE)
+        {
+            gLogger->log(LogManager::ERR,"Database write behind: dropped a statement of %u characters",static_cast<uint32>((*it).length()));
+        }
+        else if(synchronous)
+        {
+            DestroyResult(mDatabaseImplementation->ExecuteSql(const_cast<int8*>((*it).c_str())));
+        }
+        else
+        {
+            ExecuteSqlAsyncNoArguments(0,0,(*it).c_str());
+        }
+
+        ++it;
+    }
+}
+
+//======================================================================================================================
+
+uint32 Database::PrepareStatement(const int8* sql)
+{
+    boost::mutex::scoped_lock lock(mStatementMutex);
+
+    if(strlen(sql) >= DATABASEJOB_SQL_SIZE)
+    {
+        gLogger->log(LogManager::CRITICAL,"Database::PrepareStatement: statement too long (%s)",sql);
+        return 0;
+    }
+
+    mStatements.push_back(sql);
+
+    return static_cast<uint32>(mStatements.size());
+}
+
+//======================================================================================================================
+
+DatabaseResult* Database::ExecuteStatement(uint32 statementId, const StatementParameters& parameters, DataBinding* binding)
+{
+    std::string sql;
+    {
+        boost::mutex::scoped_lock lock(mStatementMutex);
+
+        if(!statementId || statementId > mStatements.size())
+        {
+            gLogger->log(LogManager::CRITICAL,"Database::ExecuteStatement: no statement %u",statementId);
+            return NULL;
+        }
+
+        sql = mStatements[statementId - 1];
+    }
+
+    return mDatabaseImplementation->ExecuteStatement(statementId,sql.c_str(),&parameters,binding);
+}
+
+//======================================================================================================================
+
+void Database::ExecuteStatementAsync(DatabaseCallback* callback, void* ref, uint32 statementId, const StatementParameters& parameters, DataBinding* binding)
+{
+    DatabaseJob* job;
+    {
+        boost::mutex::scoped_lock lock(mStatementMutex);
+
+        if(!statementId || statementId > mStatements.size())
+        {
+            gLogger->log(LogManager::CRITICAL,"Database::ExecuteStatementAsync: no statement %u",statementId);
+            return;
+        }
+
+        // Setup our job, the worker prepares the statement from its sql when its connection has not yet.
+        job = new(mJobPool.ordered_malloc()) DatabaseJob();
+        job->setSql(const_cast<int8*>(mStatements[statementId - 1].c_str()));
+    }
+
+    job->setCallback(callback);
+    job->setClientReference(ref);
+    job->setMultiJob(false);
+
+    // the job outlives the callers parameters, they are freed with the job
+    job->setStatement(statementId,new StatementParameters(parameters),binding);
+
+    // Add the job to our processList
+    mJobPendingQueue.push(job);
+    _dispatchJobs();
+}
+
+//======================================================================================================================
+
 DatabaseResult* Database::ExecuteProcedure(const int8* sql, ...)
 {
     DatabaseResult* newResult = 0;
@@ -295,8 +518,59 @@ void Database::ExecuteProcedureAsync(DatabaseCallback* callback, void* ref, cons
 
     // Add the job to our processList
     mJobPendingQueue.push(job);
+    _dispatchJobs();
+
+    va_end(args);
+}
+
+//======================================================================================================================
+
+void Database::ExecuteSqlBatchAsync(DatabaseCallback* callback, void* ref, const int8* sql, ...)
+{
+    // format our sql string
+    va_list args;
+    va_start(args, sql);
+    int8    localSql[DATABASEJOB_SQL_SIZE];
+    vsnprintf(localSql, sizeof(localSql), sql, args);
+    va_end(args);
+
+    gLogger->log(LogManager::SQL,"sql :: %s",localSql); // SQL Debug Log
+
+    // Setup our job, it is executed like a procedure so all results stay on the connection
+    DatabaseJob* job = new(mJobPool.ordered_malloc()) DatabaseJob();
+    job->setCallback(callback);
+    job->setClientReference(ref);
+    job->setSql(localSql);
+    job->setMultiJob(true);
+
+    // Add the job to our processList
+    mJobPendingQueue.push(job);
+    _dispatchJobs();
+}
 
+//======================================================================================================================
+
+void Database::ExecuteSqlStreamAsync(DatabaseCallback* callback, void* ref, const int8* sql, ...)
+{
+    // format our sql string
+    va_list args;
+    va_start(args, sql);
+    int8    localSql[DATABASEJOB_SQL_SIZE];
+    vsnprintf(localSql, sizeof(localSql), sql, args);
     va_end(args);
+
+    gLogger->log(LogManager::SQL,"sql :: %s",localSql); // SQL Debug Log
+
+    // Setup our job
+    DatabaseJob* job = new(mJobPool.ordered_malloc()) DatabaseJob();
+    job->setCallback(callback);
+    job->setClientReference(ref);
+    job->setSql(localSql);
+    job->setStreamJob(true);
+
+    // Add the job to our processList
+    mJobPendingQueue.push(job);
+    _dispatchJobs();
 }
 
 //======================================================================================================================
@@ -32,8 +32,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/typedefs.h"
 #include "Utils/concurrent_queue.h"
 #include <queue>
+#include <string>
+#include <vector>
 #include "DataBindingFactory.h"
 #include <boost/pool/pool.hpp>
+#include <boost/thread/mutex.hpp>
 #include "DatabaseManager/declspec.h"
 
 
@@ -46,6 +49,9 @@ class DatabaseCallback;
 class DatabaseResult;
 class DatabaseJob;
 class Transaction;
+class WriteBehindBuffer;
+class DatabaseManager;
+class StatementParameters;
 
 typedef Anh_Utils::concurrent_queue<DatabaseJob*>				DatabaseJobQueue;
 typedef Anh_Utils::concurrent_queue<DatabaseWorkerThread*>		DatabaseWorkerThreadQueue;
@@ -65,9 +71,35 @@ public:
     void                                    ExecuteSqlAsync(DatabaseCallback* callback, void* ref, const int8* sql, ...);
     void									  ExecuteSqlAsyncNoArguments(DatabaseCallback* callback, void* ref, const int8* sql);
 
+    // Fire and forget "UPDATE table SET column=<value> WHERE condition", value is formatted from the arguments.
+    // Updates of the same row and column within the write behind window are merged, see WriteBehindBuffer.
+    // ownerId is the character the row belongs to, see FlushDeferredUpdates.
+    void									  ExecuteUpdateDeferred(uint64 ownerId, const int8* table, const int8* column, const int8* condition, const int8* value, ...);
+
+    // Writes the deferred updates of one character right away on the calling thread, whatever is queued or read
+    // afterwards sees them. For the saves that hand a character to another zone or to the next load, costs nothing
+    // when the character has no updates pending.
+    void									  FlushDeferredUpdates(uint64 ownerId);
+
+    // Registers a statement with ? placeholders, returns its id. Every connection prepares it on first use and
+    // keeps it, parameters are sent and rows are fetched with the binary protocol.
+    uint32								  PrepareStatement(const int8* sql);
+
+    // Columns the binding reads are fetched as its types, saves a conversion on GetNextRow. It has to outlive the job.
+    DatabaseResult*                         ExecuteStatement(uint32 statementId, const StatementParameters& parameters, DataBinding* binding = NULL);
+    void									  ExecuteStatementAsync(DatabaseCallback* callback, void* ref, uint32 statementId, const StatementParameters& parameters, DataBinding* binding = NULL);
+
     DatabaseResult*                         ExecuteProcedure(const int8* sql, ...);
     void                                    ExecuteProcedureAsync(DatabaseCallback* callback, void* ref, const int8* sql, ...);
 
+    // Several statements separated by ; in one round trip, the callback walks their results with
+    // DatabaseResult::NextResultSet. The worker is busy until the result gets destroyed.
+    void                                    ExecuteSqlBatchAsync(DatabaseCallback* callback, void* ref, const int8* sql, ...);
+
+    // For big selects, the rows are read from the server as the callback calls GetNextRow until it returns false,
+    // instead of being stored in memory first. getRowCount is 0, the worker is busy until the result gets destroyed.
+    void                                    ExecuteSqlStreamAsync(DatabaseCallback* callback, void* ref, const int8* sql, ...);
+
     uint32								  Escape_String(int8* target,const int8* source,uint32 length);
 
     void									  DestroyResult(DatabaseResult* result);
@@ -80,6 +112,11 @@ public:
 
     void									  pushDatabaseJobComplete(DatabaseJob* job);
 
+    // The manager gets woken up when a job completed.
+    void									  setManager(DatabaseManager* manager) {
+        mManager = manager;
+    }
+
     Transaction*							  startTransaction(DatabaseCallback* callback, void* ref);
     void									  destroyTransaction(Transaction* t);
 
@@ -105,15 +142,24 @@ private:
 #ifdef _WIN32
 #pragma warning (disable : 4251)
 #endif
+    std::vector<std::string>                mStatements;        // sql of the prepared statements, id - 1
+    boost::mutex                            mStatementMutex;
+
     DatabaseJobQueue                        mJobPendingQueue;
     DatabaseJobQueue                        mJobCompleteQueue;
     DatabaseWorkerThreadQueue               mWorkerIdleQueue;
 
     DatabaseImplementation*                 mDatabaseImplementation;  // Use this implementation for any syncronous calls.
+    DatabaseManager*                        mManager;
+
+    boost::mutex                            mDispatchMutex;
 
     uint32                                  mMinThreads;
     uint32                                  mMaxThreads;
 
+    WriteBehindBuffer*                      mWriteBehind;       // NULL when the window is 0, deferred updates are executed right away then
+    boost::mutex                            mWriteBehindMutex;
+
     boost::pool<boost::default_user_allocator_malloc_free>							  mJobPool;
     boost::pool<boost::default_user_allocator_malloc_free>							  mTransactionPool;
     // Re-enable the warning.
@@ -122,6 +168,13 @@ private:
 #endif
 protected:
     DatabaseResult*                         ExecuteSql(const int8* sql, ...);
+
+    // Hands pending jobs to idle workers, for as long as there are both.
+    void                                    _dispatchJobs();
+
+    void                                    _deferUpdate(uint64 ownerId, const int8* table, const int8* column, const int8* condition, const int8* localValue);
+    void                                    _flushWriteBehind(bool synchronous);
+    void                                    _writeDeferredStatements(const std::vector<std::string>& statements, bool synchronous);
 };
 
 //======================================================================================================================
@@ -140,15 +193,12 @@ inline DatabaseWorkerThread* Database::popIdleWorker(void)
 inline void Database::pushIdleWorker(DatabaseWorkerThread* worker)
 {
     mWorkerIdleQueue.push(worker);
-}
 
-//======================================================================================================================
-
-inline void Database::pushDatabaseJobComplete(DatabaseJob* job)
-{
-    mJobCompleteQueue.push(job);
+    // a worker got free, it takes the next job right away
+    _dispatchJobs();
 }
 
+
 //======================================================================================================================
 
 #endif // ANH_DATABASEMANAGER_DATABASE_H
@@ -38,6 +38,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 class DataBinding;
 class DatabaseWorkerThread;
+class StatementParameters;
 
 typedef boost::singleton_pool<DatabaseResult,sizeof(DatabaseResult),boost::default_user_allocator_malloc_free> ResultPool;
 
@@ -48,12 +49,18 @@ public:
     DatabaseImplementation(char* host, uint16 port, char* user, char* pass, char* schema) {};
     virtual							~DatabaseImplementation(void) {};
 
-    virtual DatabaseResult*			ExecuteSql(int8* sql,bool procedure = false) = 0;
+    // A streamed result leaves the rows on the server, they are read one by one on GetNextRow.
+    virtual DatabaseResult*			ExecuteSql(int8* sql,bool procedure = false,bool streamed = false) = 0;
+
+    // Executes the prepared statement sql, it is prepared on the first call for an id and cached per connection.
+    // Rows are fetched right away with the binary protocol, columns the binding reads as its types.
+    virtual DatabaseResult*			ExecuteStatement(uint32 statementId, const int8* sql, const StatementParameters* parameters, DataBinding* binding) = 0;
 
     virtual DatabaseWorkerThread*	DestroyResult(DatabaseResult* result) = 0;
 
-    virtual void						GetNextRow(DatabaseResult* result, DataBinding* binding, void* object) = 0;
+    virtual bool						GetNextRow(DatabaseResult* result, DataBinding* binding, void* object) = 0;
     virtual void						ResetRowIndex(DatabaseResult* result, uint64 index = 0) = 0;
+    virtual bool						NextResultSet(DatabaseResult* result) = 0;
 
     virtual uint32					Escape_String(int8* target,const int8* source,uint32 length) = 0;
 
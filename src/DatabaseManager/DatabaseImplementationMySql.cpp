@@ -29,16 +29,20 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 #include <boost/lexical_cast.hpp>
 
 #include <mysql.h>
+#include <errmsg.h>
+#include <mysqld_error.h>
 
 #include "Utils/bstring.h"
 #include "Common/LogManager.h"
 
 #include "DatabaseManager/DatabaseResult.h"
 #include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/PreparedStatement.h"
 #include "DatabaseManager/declspec.h"
 
 //======================================================================================================================
@@ -64,13 +68,22 @@ DatabaseImplementationMySql::DatabaseImplementationMySql(char* host, uint16 port
 //======================================================================================================================
 DatabaseImplementationMySql::~DatabaseImplementationMySql(void)
 {
+    // Statements belong to the connection, close them first.
+    StatementMap::iterator it = mStatements.begin();
+    while(it != mStatements.end())
+    {
+        mysql_stmt_close((*it).second);
+        ++it;
+    }
+    mStatements.clear();
+
     // Close the connection and destroy our connection object.
     mysql_close(mConnection);
     mysql_thread_end();
 }
 
 //======================================================================================================================
-DatabaseResult* DatabaseImplementationMySql::ExecuteSql(int8* sql,bool procedure)
+DatabaseResult* DatabaseImplementationMySql::ExecuteSql(int8* sql,bool procedure,bool streamed)
 {
     DatabaseResult* newResult = new(ResultPool::ordered_malloc()) DatabaseResult(procedure);
 
@@ -83,16 +96,24 @@ DatabaseResult* DatabaseImplementationMySql::ExecuteSql(int8* sql,bool procedure
     if(mysql_errno(mConnection) != 0)
     {
         gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_error(mConnection));
-
-
+        newResult->setError(true);
     }
 
-    mResultSet = mysql_store_result(mConnection);
+    // streamed rows stay on the server until they are fetched, the row count is unknown until then
+    if(streamed)
+    {
+        mResultSet = mysql_use_result(mConnection);
+        newResult->setStreamed(mResultSet != NULL);
+    }
+    else
+    {
+        mResultSet = mysql_store_result(mConnection);
+    }
 
     newResult->setConnectionReference((void*)mConnection);
     newResult->setResultSetReference((void*)mResultSet);
 
-    if (mResultSet)
+    if (mResultSet && !streamed)
     {
         newResult->setRowCount(mResultSet->row_count);
     }
@@ -100,6 +121,370 @@ DatabaseResult* DatabaseImplementationMySql::ExecuteSql(int8* sql,bool procedure
     return newResult;
 }
 
+//======================================================================================================================
+
+DatabaseResult* DatabaseImplementationMySql::ExecuteStatement(uint32 statementId, const int8* sql, const StatementParameters* parameters, DataBinding* binding)
+{
+    DatabaseResult* newResult = new(ResultPool::ordered_malloc()) DatabaseResult(false);
+
+    newResult->setDatabaseImplementation(this);
+    newResult->setConnectionReference((void*)mConnection);
+
+    newResult->setError(true);
+
+    // A statement is gone when the connection was lost, after the reconnect it gets prepared once more.
+    for(uint32 attempt = 0; attempt < 2; attempt++)
+    {
+        MYSQL_STMT* statement = _prepareStatement(statementId,sql);
+
+        if(!statement)
+        {
+            break;
+        }
+
+        uint32 error = _executeStatement(statement,parameters,binding,newResult);
+
+        if(!error)
+        {
+            newResult->setError(false);
+            break;
+        }
+
+        gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_stmt_error(statement));
+
+        _closeStatement(statementId);
+
+        if(error != CR_SERVER_GONE_ERROR && error != CR_SERVER_LOST && error != ER_UNKNOWN_STMT_HANDLER)
+        {
+            break;
+        }
+    }
+
+    return newResult;
+}
+
+//======================================================================================================================
+
+MYSQL_STMT* DatabaseImplementationMySql::_prepareStatement(uint32 statementId, const int8* sql)
+{
+    StatementMap::iterator it = mStatements.find(statementId);
+
+    if(it != mStatements.end())
+    {
+        return (*it).second;
+    }
+
+    MYSQL_STMT* statement = mysql_stmt_init(mConnection);
+
+    if(!statement)
+    {
+        gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_error(mConnection));
+        return NULL;
+    }
+
+    if(mysql_stmt_prepare(statement, sql, (unsigned long)strlen(sql)) != 0)
+    {
+        gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s (%s)", mysql_stmt_error(statement), sql);
+        mysql_stmt_close(statement);
+        return NULL;
+    }
+
+    mStatements.insert(std::make_pair(statementId,statement));
+
+    return statement;
+}
+
+//======================================================================================================================
+
+void DatabaseImplementationMySql::_closeStatement(uint32 statementId)
+{
+    StatementMap::iterator it = mStatements.find(statementId);
+
+    if(it != mStatements.end())
+    {
+        mysql_stmt_close((*it).second);
+        mStatements.erase(it);
+    }
+}
+
+//======================================================================================================================
+//
+// binds the parameters and executes, returns the mysql error number, 0 on success
+//
+
+uint32 DatabaseImplementationMySql::_executeStatement(MYSQL_STMT* statement, const StatementParameters* parameters, DataBinding* binding, DatabaseResult* result)
+{
+    uint32 parameterCount = parameters ? parameters->getCount() : 0;
+
+    if(mysql_stmt_param_count(statement) != parameterCount)
+    {
+        gLogger->log(LogManager::CRITICAL,"DatabaseImplementationMySql::ExecuteStatement: statement takes %u parameters, got %u",
+                     (uint32)mysql_stmt_param_count(statement),parameterCount);
+        return CR_INVALID_PARAMETER_NO;
+    }
+
+    if(parameterCount)
+    {
+        std::vector<MYSQL_BIND> parameterBinds(parameterCount);
+        memset(&parameterBinds[0],0,sizeof(MYSQL_BIND) * parameterCount);
+
+        for(uint32 i = 0; i < parameterCount; i++)
+        {
+            const StatementParameters::Parameter&	parameter	= parameters->getParameter(i);
+            MYSQL_BIND&								bind		= parameterBinds[i];
+
+            // numbers are read from the start of mValue
+            bind.buffer = const_cast<uint64*>(&parameter.mValue);
+
+            switch(parameter.mType)
+            {
+            case DFT_uint8:
+                bind.buffer_type	= MYSQL_TYPE_TINY;
+                bind.is_unsigned	= 1;
+                break;
+
+            case DFT_uint16:
+                bind.buffer_type	= MYSQL_TYPE_SHORT;
+                bind.is_unsigned	= 1;
+                break;
+
+            case DFT_int32:
+                bind.buffer_type	= MYSQL_TYPE_LONG;
+                break;
+
+            case DFT_uint32:
+                bind.buffer_type	= MYSQL_TYPE_LONG;
+                bind.is_unsigned	= 1;
+                break;
+
+            case DFT_int64:
+                bind.buffer_type	= MYSQL_TYPE_LONGLONG;
+                break;
+
+            case DFT_uint64:
+                bind.buffer_type	= MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned	= 1;
+                break;
+
+            case DFT_float:
+                bind.buffer_type	= MYSQL_TYPE_FLOAT;
+                break;
+
+            case DFT_double:
+                bind.buffer_type	= MYSQL_TYPE_DOUBLE;
+                break;
+
+            case DFT_string:
+            case DFT_raw:
+                bind.buffer_type	= (parameter.mType == DFT_raw) ? MYSQL_TYPE_BLOB : MYSQL_TYPE_STRING;
+                bind.buffer			= const_cast<char*>(parameter.mString.data());
+                bind.buffer_length	= (unsigned long)parameter.mString.length();
+                break;
+
+            default:
+                bind.buffer_type	= MYSQL_TYPE_NULL;
+                break;
+            }
+        }
+
+        if(mysql_stmt_bind_param(statement,&parameterBinds[0]) != 0)
+        {
+            return mysql_stmt_errno(statement);
+        }
+    }
+
+    if(mysql_stmt_execute(statement) != 0)
+    {
+        return mysql_stmt_errno(statement);
+    }
+
+    _fetchStatementResult(statement,binding,result);
+
+    return 0;
+}
+
+//======================================================================================================================
+//
+// Fetches all rows with the binary protocol. Columns the binding covers are fetched as the type it asks for, the
+// others as their own type. The rows end up in a StatementResult, so the statement is free for the next execution.
+//
+
+void DatabaseImplementationMySql::_fetchStatementResult(MYSQL_STMT* statement, DataBinding* binding, DatabaseResult* result)
+{
+    MYSQL_RES* metaData = mysql_stmt_result_metadata(statement);
+
+    // no result set, ie an update
+    if(!metaData)
+    {
+        return;
+    }
+
+    uint32 columnCount = mysql_num_fields(metaData);
+
+    if(!columnCount)
+    {
+        mysql_free_result(metaData);
+        mysql_stmt_free_result(statement);
+        return;
+    }
+
+    StatementResult*			rows = new StatementResult(columnCount);
+    MYSQL_FIELD*				columns = mysql_fetch_fields(metaData);
+
+    std::vector<MYSQL_BIND>		columnBinds(columnCount);
+    std::vector<uint64>			cells(columnCount,0);
+    std::vector<my_bool>		isNull(columnCount,0);
+    std::vector<unsigned long>	lengths(columnCount,0);
+    std::vector<int8>			strings(columnCount * STATEMENT_STRING_BUFFER);
+
+    memset(&columnBinds[0],0,sizeof(MYSQL_BIND) * columnCount);
+
+    for(uint32 column = 0; column < columnCount; column++)
+    {
+        DataFieldType type = DFT_none;
+
+        // the first field of the binding that reads the column decides its type
+        if(binding)
+        {
+            for(uint32 i = 0; i < binding->getFieldCount(); i++)
+            {
+                if(binding->mDataFields[i].mColumn == column)
+                {
+                    type = binding->mDataFields[i].mDataType;
+                    break;
+                }
+            }
+        }
+
+        if(type == DFT_none)
+        {
+            switch(columns[column].type)
+            {
+            case MYSQL_TYPE_TINY:
+            case MYSQL_TYPE_SHORT:
+            case MYSQL_TYPE_INT24:
+            case MYSQL_TYPE_LONG:
+            case MYSQL_TYPE_LONGLONG:
+            case MYSQL_TYPE_YEAR:
+                type = (columns[column].flags & UNSIGNED_FLAG) ? DFT_uint64 : DFT_int64;
+                break;
+
+            case MYSQL_TYPE_FLOAT:
+            case MYSQL_TYPE_DOUBLE:
+                type = DFT_double;
+                break;
+
+            case MYSQL_TYPE_NULL:
+                break;
+
+            default:
+                type = DFT_string;
+                break;
+            }
+        }
+
+        MYSQL_BIND& bind = columnBinds[column];
+
+        bind.buffer		= &cells[column];
+        bind.is_null	= &isNull[column];
+        bind.length		= &lengths[column];
+
+        switch(type)
+        {
+        case DFT_int8:		bind.buffer_type = MYSQL_TYPE_TINY;										break;
+        case DFT_uint8:		bind.buffer_type = MYSQL_TYPE_TINY;		bind.is_unsigned = 1;			break;
+        case DFT_int16:		bind.buffer_type = MYSQL_TYPE_SHORT;									break;
+        case DFT_uint16:	bind.buffer_type = MYSQL_TYPE_SHORT;	bind.is_unsigned = 1;			break;
+        case DFT_int32:		bind.buffer_type = MYSQL_TYPE_LONG;										break;
+        case DFT_uint32:	bind.buffer_type = MYSQL_TYPE_LONG;		bind.is_unsigned = 1;			break;
+        case DFT_int64:		bind.buffer_type = MYSQL_TYPE_LONGLONG;									break;
+        case DFT_uint64:	bind.buffer_type = MYSQL_TYPE_LONGLONG;	bind.is_unsigned = 1;			break;
+        case DFT_float:		bind.buffer_type = MYSQL_TYPE_FLOAT;									break;
+        case DFT_double:	bind.buffer_type = MYSQL_TYPE_DOUBLE;									break;
+
+        case DFT_none:
+        case DFT_datetime:
+        {
+            type				= DFT_none;
+            bind.buffer			= NULL;
+            bind.buffer_type	= MYSQL_TYPE_NULL;
+        }
+        break;
+
+        default:
+        {
+            bind.buffer_type	= (type == DFT_raw) ? MYSQL_TYPE_BLOB : MYSQL_TYPE_STRING;
+            type				= DFT_string;
+            bind.buffer			= &strings[column * STATEMENT_STRING_BUFFER];
+            bind.buffer_length	= STATEMENT_STRING_BUFFER;
+        }
+        break;
+        }
+
+        rows->setColumnType(column,type);
+    }
+
+    mysql_free_result(metaData);
+
+    if(mysql_stmt_bind_result(statement,&columnBinds[0]) != 0 || mysql_stmt_store_result(statement) != 0)
+    {
+        gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_stmt_error(statement));
+        mysql_stmt_free_result(statement);
+        delete(rows);
+        return;
+    }
+
+    int status;
+
+    while((status = mysql_stmt_fetch(statement)) == 0 || status == MYSQL_DATA_TRUNCATED)
+    {
+        for(uint32 column = 0; column < columnCount; column++)
+        {
+            if(rows->getColumnType(column) != DFT_string)
+            {
+                if(isNull[column])
+                {
+                    cells[column] = 0;
+                }
+                continue;
+            }
+
+            unsigned long length = isNull[column] ? 0 : lengths[column];
+
+            if(length > STATEMENT_STRING_BUFFER)
+            {
+                // did not fit the buffer, get the whole value
+                std::vector<int8>	value(length);
+                MYSQL_BIND			bind;
+
+                memset(&bind,0,sizeof(MYSQL_BIND));
+                bind.buffer_type	= columnBinds[column].buffer_type;
+                bind.buffer			= &value[0];
+                bind.buffer_length	= length;
+
+                mysql_stmt_fetch_column(statement,&bind,column,0);
+
+                cells[column] = rows->addString(&value[0],length);
+            }
+            else
+            {
+                cells[column] = rows->addString(&strings[column * STATEMENT_STRING_BUFFER],length);
+            }
+        }
+
+        rows->addRow(&cells[0]);
+    }
+
+    if(status == 1)
+    {
+        gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_stmt_error(statement));
+    }
+
+    mysql_stmt_free_result(statement);
+
+    result->setStatementResult(rows);
+    result->setRowCount(rows->getRowCount());
+}
 
 //======================================================================================================================
 
@@ -107,9 +492,13 @@ DatabaseWorkerThread* DatabaseImplementationMySql::DestroyResult(DatabaseResult*
 {
     DatabaseWorkerThread* worker = NULL;
 
+    // rows of a prepared statement
+    delete(result->getStatementResult());
+
     if((MYSQL_RES*)result->getResultSetReference() == mResultSet)
         mResultSet = NULL;
 
+    // rows of a streamed result that were not read are fetched and dropped here
     mysql_free_result((MYSQL_RES*)result->getResultSetReference());
 
     if(result->isMultiResult())
@@ -118,7 +507,10 @@ DatabaseWorkerThread* DatabaseImplementationMySql::DestroyResult(DatabaseResult*
         {
             mysql_free_result(mysql_store_result((MYSQL*)result->getConnectionReference()));
         }
+    }
 
+    if(result->isMultiResult() || result->isStreamed())
+    {
         worker = result->getWorkerReference();
     }
 
@@ -129,16 +521,28 @@ DatabaseWorkerThread* DatabaseImplementationMySql::DestroyResult(DatabaseResult*
 
 
 //======================================================================================================================
-void DatabaseImplementationMySql::GetNextRow(DatabaseResult* result, DataBinding* binding, void* object)
+bool DatabaseImplementationMySql::GetNextRow(DatabaseResult* result, DataBinding* binding, void* object)
 {
     unsigned int  i; //, numRows = 0;
-    MYSQL_ROW     row;
+    MYSQL_ROW     row = NULL;
     MYSQL_RES*    mySqlResult = (MYSQL_RES*)result->getResultSetReference();
 
+    if(result->getStatementResult())
+    {
+        return(result->getStatementResult()->GetNextRow(binding,object));
+    }
+
     // If any rows were returned
     if (mySqlResult)
     {
         row = mysql_fetch_row(mySqlResult);
+
+        // a streamed result only finds out about a broken connection here
+        if(!row && result->isStreamed() && mysql_errno((MYSQL*)result->getConnectionReference()) != 0)
+        {
+            gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_error((MYSQL*)result->getConnectionReference()));
+        }
+
         if (row)
         {
             for (i = 0; i < binding->getFieldCount(); i++)
@@ -233,6 +637,8 @@ void DatabaseImplementationMySql::GetNextRow(DatabaseResult* result, DataBinding
             }
         } //if (row)
     }
+
+    return(row != NULL);
 }
 
 
@@ -243,6 +649,16 @@ void DatabaseImplementationMySql::ResetRowIndex(DatabaseResult* result, uint64 i
         gLogger->log(LogManager::CRITICAL,"Bad Ptr 'DatabaseResult* result' at DatabaseImplementationMySql::ResetRowIndex.");
         return;
     }
+    if(result->getStatementResult())
+    {
+        result->getStatementResult()->setRowIndex(index);
+        return;
+    }
+    if(result->isStreamed())
+    {
+        gLogger->log(LogManager::CRITICAL,"DatabaseImplementationMySql::ResetRowIndex: a streamed result can not seek.");
+        return;
+    }
     MYSQL_RES* temp = (MYSQL_RES*)result->getResultSetReference();
     if(!temp)
     {
@@ -253,6 +669,53 @@ void DatabaseImplementationMySql::ResetRowIndex(DatabaseResult* result, uint64 i
 }
 
 
+//======================================================================================================================
+//
+// the result set we are done with is freed, the connection stays with the result until it gets destroyed
+//
+
+bool DatabaseImplementationMySql::NextResultSet(DatabaseResult* result)
+{
+    MYSQL* connection = (MYSQL*)result->getConnectionReference();
+
+    if((MYSQL_RES*)result->getResultSetReference() == mResultSet)
+        mResultSet = NULL;
+
+    mysql_free_result((MYSQL_RES*)result->getResultSetReference());
+
+    result->setResultSetReference(NULL);
+    result->setRowCount(0);
+
+    if(!result->isMultiResult() || result->getStatementResult())
+    {
+        return false;
+    }
+
+    int status = mysql_next_result(connection);
+
+    if(status != 0)
+    {
+        // -1 is the end of the results, anything above an error in the statement
+        if(status > 0)
+        {
+            gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_error(connection));
+        }
+
+        return false;
+    }
+
+    MYSQL_RES* resultSet = mysql_store_result(connection);
+
+    result->setResultSetReference((void*)resultSet);
+
+    if(resultSet)
+    {
+        result->setRowCount(resultSet->row_count);
+    }
+
+    return true;
+}
+
 //======================================================================================================================
 uint64 DatabaseImplementationMySql::GetInsertId(void)
 {
@@ -28,6 +28,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ANH_DATABASEMANAGER_DATABASEIMPLEMENTATIONMYSQL_H
 #define ANH_DATABASEMANAGER_DATABASEIMPLEMENTATIONMYSQL_H
 
+#include <map>
+
 #include "DatabaseImplementation.h"
 #include "Utils/typedefs.h"
 #include "DatabaseManager/declspec.h"
@@ -38,6 +40,7 @@ class DatabaseResult;
 typedef struct st_mysql MYSQL;
 typedef struct st_mysql_res MYSQL_RES;
 typedef struct st_mysql_rows MYSQL_ROWS;
+typedef struct st_mysql_stmt MYSQL_STMT;
 
 
 //======================================================================================================================
@@ -48,18 +51,38 @@ public:
     DatabaseImplementationMySql(char* host, uint16 port, char* user, char* pass, char* schema);
     virtual							~DatabaseImplementationMySql(void);
 
-    virtual DatabaseResult*			ExecuteSql(int8* sql,bool procedure = false);
+    virtual DatabaseResult*			ExecuteSql(int8* sql,bool procedure = false,bool streamed = false);
+    virtual DatabaseResult*			ExecuteStatement(uint32 statementId, const int8* sql, const StatementParameters* parameters, DataBinding* binding);
     virtual DatabaseWorkerThread*		DestroyResult(DatabaseResult* result);
 
-    virtual void						GetNextRow(DatabaseResult* result, DataBinding* binding, void* object);
+    virtual bool						GetNextRow(DatabaseResult* result, DataBinding* binding, void* object);
     virtual void						ResetRowIndex(DatabaseResult* result, uint64 index = 0);
+    virtual bool						NextResultSet(DatabaseResult* result);
     virtual uint64					GetInsertId(void);
 
     virtual uint32					Escape_String(int8* target,const int8* source,uint32 length);
 
 private:
+
+    typedef std::map<uint32,MYSQL_STMT*>	StatementMap;
+
+    MYSQL_STMT*                 _prepareStatement(uint32 statementId, const int8* sql);
+    void                        _closeStatement(uint32 statementId);
+    uint32                      _executeStatement(MYSQL_STMT* statement, const StatementParameters* parameters, DataBinding* binding, DatabaseResult* result);
+    void                        _fetchStatementResult(MYSQL_STMT* statement, DataBinding* binding, DatabaseResult* result);
+
     MYSQL*                      mConnection;
     MYSQL_RES*                  mResultSet;
+
+    // Win32 complains about stl during linkage, disable the warning.
+#ifdef _WIN32
+#pragma warning (disable : 4251)
+#endif
+    StatementMap                mStatements;    // prepared on this connection, by statement id
+    // Re-enable the warning.
+#ifdef _WIN32
+#pragma warning (default : 4251)
+#endif
 };
 
 
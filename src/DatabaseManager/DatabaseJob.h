@@ -31,17 +31,23 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <stdlib.h>
 #include <cstring>
 
+#include "Utils/typedefs.h"
+
+// statements longer than that do not fit a job
+#define DATABASEJOB_SQL_SIZE	8192
+
 //======================================================================================================================
 class DatabaseCallback;
 class DatabaseResult;
 class DataBinding;
+class StatementParameters;
 
 
 //======================================================================================================================
 class DatabaseJob
 {
 public:
-    DatabaseJob() : mDatabaseCallback(NULL),mDatabaseResult(NULL),mClientReference(NULL),mMultiJob(false) {}
+    DatabaseJob() : mDatabaseCallback(NULL),mDatabaseResult(NULL),mClientReference(NULL),mMultiJob(false),mStreamJob(false),mStatementId(0),mParameters(NULL),mBinding(NULL) {}
     DatabaseCallback*           getCallback(void)                               {
         return mDatabaseCallback;
     }
@@ -73,13 +79,39 @@ public:
     bool						  isMultiJob() {
         return mMultiJob;
     }
+    void						  setStreamJob(bool job) {
+        mStreamJob = job;
+    }
+    bool						  isStreamJob() {
+        return mStreamJob;
+    }
+
+    // A job with a statement id executes the prepared statement in mSql, 0 means plain sql.
+    void						  setStatement(uint32 id, StatementParameters* parameters, DataBinding* binding) {
+        mStatementId	= id;
+        mParameters		= parameters;
+        mBinding		= binding;
+    }
+    uint32						  getStatementId() {
+        return mStatementId;
+    }
+    StatementParameters*		  getParameters() {
+        return mParameters;
+    }
+    DataBinding*				  getBinding() {
+        return mBinding;
+    }
 
 private:
     DatabaseCallback*           mDatabaseCallback;
     DatabaseResult*             mDatabaseResult;
     void*                       mClientReference;
-    int8                        mSql[8192];
+    int8                        mSql[DATABASEJOB_SQL_SIZE];
     bool						  mMultiJob;
+    bool						  mStreamJob;
+    uint32						  mStatementId;
+    StatementParameters*		  mParameters;
+    DataBinding*				  mBinding;
 };
 
 
@@ -31,6 +31,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 //======================================================================================================================
 DatabaseManager::DatabaseManager(void)
+    : mCompletedJobs(0)
 {
 
 }
@@ -66,6 +67,7 @@ Database* DatabaseManager::Connect(DBType type, int8* host, uint16 port, int8* u
 
     // Create our new Database object and initiailzie it.
     newDatabase = new Database(type, host, port, user, pass, schema);
+    newDatabase->setManager(this);
 
     // Add the new DB to our process list.
     mDatabaseList.push_back(newDatabase);
@@ -73,5 +75,32 @@ Database* DatabaseManager::Connect(DBType type, int8* host, uint16 port, int8* u
     return newDatabase;
 }
 
+//======================================================================================================================
+
+void DatabaseManager::waitForCompletedJobs(uint32 timeout)
+{
+    boost::mutex::scoped_lock lock(mCompleteMutex);
+
+    if(!mCompletedJobs)
+    {
+        mCompleteCondition.timed_wait(lock, boost::posix_time::milliseconds(timeout));
+    }
+
+    // the next Process picks them up
+    mCompletedJobs = 0;
+}
+
+//======================================================================================================================
+
+void DatabaseManager::notifyJobComplete()
+{
+    {
+        boost::mutex::scoped_lock lock(mCompleteMutex);
+        mCompletedJobs++;
+    }
+
+    mCompleteCondition.notify_one();
+}
+
 
 
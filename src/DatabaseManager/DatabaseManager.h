@@ -32,6 +32,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <list>
 #include "Utils/typedefs.h"
 #include "DatabaseManager/declspec.h"
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 
 
 //======================================================================================================================
@@ -52,12 +54,22 @@ public:
 
     Database*                       Connect(DBType type, int8* host, uint16 port, int8* user, int8* pass, int8* dbname);
 
+    // Blocks the server thread for up to timeout ms, returns as soon as one of our databases completed a job.
+    void                            waitForCompletedJobs(uint32 timeout);
+
+    // Called by the database worker threads.
+    void                            notifyJobComplete();
+
 private:
     // Win32 complains about stl during linkage, disable the warning.
 #ifdef _WIN32
 #pragma warning (disable : 4251)
 #endif
     DatabaseList                    mDatabaseList;
+
+    boost::mutex                    mCompleteMutex;
+    boost::condition_variable       mCompleteCondition;
+    uint32                          mCompletedJobs;
     // Re-enable the warning.
 #ifdef _WIN32
 #pragma warning (default : 4251)
@@ -36,10 +36,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 
 //======================================================================================================================
-void DatabaseResult::GetNextRow(DataBinding* dataBinding, void* object)
+bool DatabaseResult::GetNextRow(DataBinding* dataBinding, void* object)
 {
     // Just shunt this method to the actual implementation method.  This might have thread problems right now.
-    mDatabaseImplementation->GetNextRow(this, dataBinding, object);
+    return(mDatabaseImplementation->GetNextRow(this, dataBinding, object));
 }
 
 
@@ -50,5 +50,12 @@ void DatabaseResult::ResetRowIndex(int index)
 }
 
 
+//======================================================================================================================
+bool DatabaseResult::NextResultSet()
+{
+    return(mDatabaseImplementation->NextResultSet(this));
+}
+
+
 
 
@@ -36,6 +36,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 class DatabaseImplementation;
 class DataBinding;
 class DatabaseWorkerThread;
+class StatementResult;
 
 
 //======================================================================================================================
@@ -43,12 +44,16 @@ class DBMANAGER_API DatabaseResult
 {
 public:
     DatabaseResult(bool multiResult = false)
-        :mWorkerReference(0), mConnectionReference(0),mResultSetReference(0),mRowCount(0),mDatabaseImplementation(0),mMultiResult(multiResult) {};
+        :mWorkerReference(0), mConnectionReference(0),mResultSetReference(0),mRowCount(0),mDatabaseImplementation(0),mMultiResult(multiResult),mStreamed(false),mError(false),mStatementResult(0) {};
     ~DatabaseResult(void) {};
 
-    virtual void               GetNextRow(DataBinding* dataBinding, void* object);
+    // false when there was no row left, the object is untouched then
+    virtual bool               GetNextRow(DataBinding* dataBinding, void* object);
     void                        ResetRowIndex(int index = 0);
 
+    // Moves on to the next result set of a multi statement or procedure result, false when there is none.
+    bool                        NextResultSet();
+
     void*						  getConnectionReference(void) {
         return mConnectionReference;
     }
@@ -69,6 +74,14 @@ public:
     void						  setMultiResult(bool b) {
         mMultiResult = b;
     }
+    // A streamed result reads its rows from the connection on GetNextRow, its row count stays 0.
+    // Like a multi result it keeps the worker until it gets destroyed.
+    bool						  isStreamed() {
+        return mStreamed;
+    }
+    void						  setStreamed(bool b) {
+        mStreamed = b;
+    }
 
     DatabaseImplementation*     getDatabaseImplementation(void)                 {
         return mDatabaseImplementation;
@@ -90,6 +103,22 @@ public:
         mRowCount = count;
     }
 
+    // set when the query or statement failed on the server, callbacks that need to know whether a write made it check this
+    bool						  hasError() {
+        return mError;
+    }
+    void						  setError(bool b) {
+        mError = b;
+    }
+
+    // set when the result came from a prepared statement, its rows are already fetched
+    StatementResult*            getStatementResult(void)                        {
+        return mStatementResult;
+    }
+    void                        setStatementResult(StatementResult* result)     {
+        mStatementResult = result;
+    }
+
 private:
     DatabaseWorkerThread*			mWorkerReference;
     void*							mConnectionReference;
@@ -97,6 +126,9 @@ private:
     uint64						mRowCount;
     DatabaseImplementation*		mDatabaseImplementation;
     bool							mMultiResult;
+    bool							mStreamed;
+    bool							mError;
+    StatementResult*				mStatementResult;
 };
 
 
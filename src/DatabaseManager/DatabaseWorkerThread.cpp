@@ -68,7 +68,7 @@ DatabaseWorkerThread::DatabaseWorkerThread(DBType type, Database* database, char
 
 DatabaseWorkerThread::~DatabaseWorkerThread(void)
 {
-    mExit = true;
+    requestExit();
 
     mThread.interrupt();
     mThread.join();
@@ -110,34 +110,63 @@ void DatabaseWorkerThread::run()
     _startup();
 
     // Main loop
-    while(!mExit)
+    for(;;)
     {
-        // Is there a job waiting?
-        if(mCurrentJob)
+        DatabaseJob* job = 0;
+
+        // Sleep until we get a job.
         {
             boost::mutex::scoped_lock lk(mWorkerThreadMutex);
-            // Execute our query
-            DatabaseResult* result = mDatabaseImplementation->ExecuteSql(mCurrentJob->getSql(),mCurrentJob->isMultiJob());
-
-            // Attach the result to our job and send it back.
-            mCurrentJob->setDatabaseResult(result);
 
-            // put it on the complete list
-            mDatabase->pushDatabaseJobComplete(mCurrentJob);
+            while(!mCurrentJob && !mExit)
+            {
+                mJobCondition.wait(lk);
+            }
 
-            // Put ourselves back on the idle list.
-            if(!result->isMultiResult())
+            if(mExit)
             {
-                mDatabase->pushIdleWorker(this);
+                break;
             }
-            else
-                result->setWorkerReference(this);
 
+            job = mCurrentJob;
+        }
+
+        // Execute our query
+        DatabaseResult* result;
+
+        if(job->getStatementId())
+        {
+            result = mDatabaseImplementation->ExecuteStatement(job->getStatementId(),job->getSql(),job->getParameters(),job->getBinding());
+        }
+        else
+        {
+            result = mDatabaseImplementation->ExecuteSql(job->getSql(),job->isMultiJob(),job->isStreamJob());
+        }
+
+        // Attach the result to our job and send it back.
+        job->setDatabaseResult(result);
+
+        // A multi or streamed result keeps our connection busy until the result is destroyed, that may happen
+        // as soon as the job is on the complete list.
+        bool multiResult = result->isMultiResult() || result->isStreamed();
+        if(multiResult)
+        {
+            result->setWorkerReference(this);
+        }
+
+        {
+            boost::mutex::scoped_lock lk(mWorkerThreadMutex);
             mCurrentJob = 0;
         }
 
-        // and always sleep a little.
-        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        // put it on the complete list
+        mDatabase->pushDatabaseJobComplete(job);
+
+        // Put ourselves back on the idle list, this may hand us the next job right away.
+        if(!multiResult)
+        {
+            mDatabase->pushIdleWorker(this);
+        }
     }
 
     // internal shutdown method
@@ -31,6 +31,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseType.h"
 #include "Utils/typedefs.h"
 #include "DatabaseManager/declspec.h"
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/thread.hpp>
 
 //======================================================================================================================
@@ -51,9 +52,7 @@ public:
 
     void                        ExecuteJob(DatabaseJob* job);
 
-    void						  requestExit() {
-        mExit = true;
-    }
+    void						  requestExit();
 
 protected:
     int8                        mHostname[256];
@@ -78,6 +77,7 @@ private:
 #pragma warning (disable : 4251)
 #endif
     boost::mutex              mWorkerThreadMutex;
+    boost::condition_variable	mJobCondition;      // signaled when we got a job or should exit
     boost::thread			    mThread;
     // Re-enable the warning.
 #ifdef _WIN32
@@ -93,8 +93,24 @@ private:
 
 inline void DatabaseWorkerThread::ExecuteJob(DatabaseJob* job)
 {
-    boost::mutex::scoped_lock lk(mWorkerThreadMutex);
-    mCurrentJob = job;
+    {
+        boost::mutex::scoped_lock lk(mWorkerThreadMutex);
+        mCurrentJob = job;
+    }
+
+    mJobCondition.notify_one();
+}
+
+//======================================================================================================================
+
+inline void DatabaseWorkerThread::requestExit()
+{
+    {
+        boost::mutex::scoped_lock lk(mWorkerThreadMutex);
+        mExit = true;
+    }
+
+    mJobCondition.notify_one();
 }
 
 //======================================================================================================================
@@ -0,0 +1,367 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "PreparedStatement.h"
+
+#include "Utils/bstring.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//======================================================================================================================
+
+StatementParameters::StatementParameters()
+{
+}
+
+//======================================================================================================================
+
+StatementParameters::~StatementParameters()
+{
+}
+
+//======================================================================================================================
+
+void StatementParameters::_addValue(DataFieldType type, const void* value, uint32 size)
+{
+    Parameter parameter;
+
+    parameter.mType		= type;
+    parameter.mValue	= 0;
+    memcpy(&parameter.mValue, value, size);
+
+    mParameters.push_back(parameter);
+}
+
+//======================================================================================================================
+
+void StatementParameters::addUint8(uint8 value)
+{
+    _addValue(DFT_uint8, &value, sizeof(value));
+}
+
+void StatementParameters::addUint16(uint16 value)
+{
+    _addValue(DFT_uint16, &value, sizeof(value));
+}
+
+void StatementParameters::addUint32(uint32 value)
+{
+    _addValue(DFT_uint32, &value, sizeof(value));
+}
+
+void StatementParameters::addUint64(uint64 value)
+{
+    _addValue(DFT_uint64, &value, sizeof(value));
+}
+
+void StatementParameters::addInt32(int32 value)
+{
+    _addValue(DFT_int32, &value, sizeof(value));
+}
+
+void StatementParameters::addInt64(int64 value)
+{
+    _addValue(DFT_int64, &value, sizeof(value));
+}
+
+void StatementParameters::addFloat(float value)
+{
+    _addValue(DFT_float, &value, sizeof(value));
+}
+
+void StatementParameters::addDouble(double value)
+{
+    _addValue(DFT_double, &value, sizeof(value));
+}
+
+//======================================================================================================================
+
+void StatementParameters::addString(const std::string& value)
+{
+    Parameter parameter;
+
+    parameter.mType		= DFT_string;
+    parameter.mValue	= 0;
+    parameter.mString	= value;
+
+    mParameters.push_back(parameter);
+}
+
+//======================================================================================================================
+
+void StatementParameters::addRaw(const int8* data, uint32 length)
+{
+    Parameter parameter;
+
+    parameter.mType		= DFT_raw;
+    parameter.mValue	= 0;
+    parameter.mString.assign(data, length);
+
+    mParameters.push_back(parameter);
+}
+
+//======================================================================================================================
+
+StatementResult::StatementResult(uint32 columnCount)
+    : mColumnTypes(columnCount,DFT_none)
+    , mColumnCount(columnCount)
+    , mRowIndex(0)
+{
+}
+
+//======================================================================================================================
+
+StatementResult::~StatementResult()
+{
+}
+
+//======================================================================================================================
+
+void StatementResult::addRow(const uint64* cells)
+{
+    mCells.insert(mCells.end(), cells, cells + mColumnCount);
+}
+
+//======================================================================================================================
+
+uint32 StatementResult::addString(const int8* data, uint32 length)
+{
+    mStrings.push_back(std::string(data, length));
+
+    return static_cast<uint32>(mStrings.size() - 1);
+}
+
+//======================================================================================================================
+
+uint32 StatementResult::getValueSize(DataFieldType type)
+{
+    switch(type)
+    {
+    case DFT_int8:
+    case DFT_uint8:
+        return 1;
+
+    case DFT_int16:
+    case DFT_uint16:
+        return 2;
+
+    case DFT_int32:
+    case DFT_uint32:
+    case DFT_float:
+        return 4;
+
+    case DFT_int64:
+    case DFT_uint64:
+    case DFT_double:
+        return 8;
+
+    default:
+        return 0;
+    }
+}
+
+//======================================================================================================================
+
+bool StatementResult::GetNextRow(DataBinding* binding, void* object)
+{
+    if(mRowIndex >= getRowCount())
+    {
+        return(false);
+    }
+
+    const uint64* cells = &mCells[static_cast<size_t>(mRowIndex * mColumnCount)];
+    mRowIndex++;
+
+    for(uint32 i = 0; i < binding->getFieldCount(); i++)
+    {
+        DataField&	field	= binding->mDataFields[i];
+        int8*		target	= reinterpret_cast<int8*>(object) + field.mDataOffset;
+
+        if(field.mColumn >= mColumnCount || mColumnTypes[field.mColumn] == DFT_none)
+        {
+            continue;
+        }
+
+        DataFieldType	columnType	= mColumnTypes[field.mColumn];
+        uint64			cell		= cells[field.mColumn];
+
+        switch(field.mDataType)
+        {
+        case DFT_string:
+        case DFT_bstring:
+        case DFT_raw:
+        {
+            std::string value;
+
+            if(columnType == DFT_string)
+            {
+                value = mStrings[static_cast<size_t>(cell)];
+            }
+            else
+            {
+                int64	integer;
+                double	real;
+                int8	buffer[64];
+
+                _readNumber(cell,columnType,columnType,integer,real);
+
+                if(columnType == DFT_float || columnType == DFT_double)
+                {
+                    sprintf(buffer,"%g",real);
+                }
+                else if(columnType == DFT_uint64)
+                {
+                    sprintf(buffer,"%"PRIu64"",static_cast<uint64>(integer));
+                }
+                else
+                {
+                    sprintf(buffer,"%"PRId64"",integer);
+                }
+
+                value = buffer;
+            }
+
+            if(field.mDataType == DFT_bstring)
+            {
+                *reinterpret_cast<BString*>(target) = value.c_str();
+            }
+            else if(field.mDataType == DFT_raw)
+            {
+                memcpy(target, value.data(), value.length());
+            }
+            else
+            {
+                // leave room for the terminator
+                size_t length = value.length();
+                if(field.mDataSize && length >= field.mDataSize)
+                {
+                    length = field.mDataSize - 1;
+                }
+
+                memcpy(target, value.data(), length);
+                target[length] = 0;
+            }
+        }
+        break;
+
+        default:
+        {
+            uint32 size = getValueSize(field.mDataType);
+
+            if(!size)
+            {
+                break;
+            }
+
+            // fetched as the type the binding asks for
+            if(columnType == field.mDataType)
+            {
+                memcpy(target, &cell, size);
+                break;
+            }
+
+            int64	integer;
+            double	real;
+
+            _readNumber(cell,columnType,field.mDataType,integer,real);
+            _writeNumber(target,field.mDataType,integer,real);
+        }
+        break;
+        }
+    }
+
+    return(true);
+}
+
+//======================================================================================================================
+
+void StatementResult::_readNumber(uint64 cell, DataFieldType type, DataFieldType targetType, int64& integer, double& real)
+{
+    switch(type)
+    {
+    case DFT_int8:		{ int8   v; memcpy(&v,&cell,sizeof(v)); integer = v; real = v; } break;
+    case DFT_uint8:		{ uint8  v; memcpy(&v,&cell,sizeof(v)); integer = v; real = v; } break;
+    case DFT_int16:		{ int16  v; memcpy(&v,&cell,sizeof(v)); integer = v; real = v; } break;
+    case DFT_uint16:	{ uint16 v; memcpy(&v,&cell,sizeof(v)); integer = v; real = v; } break;
+    case DFT_int32:		{ int32  v; memcpy(&v,&cell,sizeof(v)); integer = v; real = v; } break;
+    case DFT_uint32:	{ uint32 v; memcpy(&v,&cell,sizeof(v)); integer = v; real = v; } break;
+    case DFT_int64:		{ int64  v; memcpy(&v,&cell,sizeof(v)); integer = v; real = static_cast<double>(v); } break;
+    case DFT_uint64:	{ uint64 v; memcpy(&v,&cell,sizeof(v)); integer = static_cast<int64>(v); real = static_cast<double>(v); } break;
+    case DFT_float:		{ float  v; memcpy(&v,&cell,sizeof(v)); integer = static_cast<int64>(v); real = v; } break;
+    case DFT_double:	{ double v; memcpy(&v,&cell,sizeof(v)); integer = static_cast<int64>(v); real = v; } break;
+
+    case DFT_string:
+    {
+        const int8* value = mStrings[static_cast<size_t>(cell)].c_str();
+
+        if(targetType == DFT_uint64)
+        {
+            integer = static_cast<int64>(strtoull(value,NULL,10));
+        }
+        else
+        {
+            integer = strtoll(value,NULL,10);
+        }
+
+        real = strtod(value,NULL);
+    }
+    break;
+
+    default:
+    {
+        integer	= 0;
+        real	= 0.0;
+    }
+    break;
+    }
+}
+
+//======================================================================================================================
+
+void StatementResult::_writeNumber(int8* target, DataFieldType type, int64 integer, double real)
+{
+    switch(type)
+    {
+    case DFT_int8:		{ int8   v = static_cast<int8>(integer);	memcpy(target,&v,sizeof(v)); } break;
+    case DFT_uint8:		{ uint8  v = static_cast<uint8>(integer);	memcpy(target,&v,sizeof(v)); } break;
+    case DFT_int16:		{ int16  v = static_cast<int16>(integer);	memcpy(target,&v,sizeof(v)); } break;
+    case DFT_uint16:	{ uint16 v = static_cast<uint16>(integer);	memcpy(target,&v,sizeof(v)); } break;
+    case DFT_int32:		{ int32  v = static_cast<int32>(integer);	memcpy(target,&v,sizeof(v)); } break;
+    case DFT_uint32:	{ uint32 v = static_cast<uint32>(integer);	memcpy(target,&v,sizeof(v)); } break;
+    case DFT_int64:		{ int64  v = integer;						memcpy(target,&v,sizeof(v)); } break;
+    case DFT_uint64:	{ uint64 v = static_cast<uint64>(integer);	memcpy(target,&v,sizeof(v)); } break;
+    case DFT_float:		{ float  v = static_cast<float>(real);		memcpy(target,&v,sizeof(v)); } break;
+    case DFT_double:	{ double v = real;							memcpy(target,&v,sizeof(v)); } break;
+
+    default:
+        break;
+    }
+}
+
+//======================================================================================================================
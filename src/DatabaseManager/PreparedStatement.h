@@ -0,0 +1,160 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_DATABASEMANAGER_PREPAREDSTATEMENT_H
+#define ANH_DATABASEMANAGER_PREPAREDSTATEMENT_H
+
+#include <string>
+#include <vector>
+
+#include "Utils/typedefs.h"
+#include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/declspec.h"
+
+// string columns are fetched into a buffer of that size first, longer values get fetched again
+#define STATEMENT_STRING_BUFFER	256
+
+//======================================================================================================================
+//
+// Typed parameters of a prepared statement, in the order of its ? placeholders.
+// They are sent with the binary protocol, so strings need no escaping.
+//
+
+class DBMANAGER_API StatementParameters
+{
+public:
+
+    class Parameter
+    {
+    public:
+
+        DataFieldType	mType;
+        uint64			mValue;		// numeric values, stored at the start
+        std::string		mString;
+    };
+
+    StatementParameters();
+    ~StatementParameters();
+
+    void				addUint8(uint8 value);
+    void				addUint16(uint16 value);
+    void				addUint32(uint32 value);
+    void				addUint64(uint64 value);
+    void				addInt32(int32 value);
+    void				addInt64(int64 value);
+    void				addFloat(float value);
+    void				addDouble(double value);
+    void				addString(const std::string& value);
+    void				addRaw(const int8* data, uint32 length);
+
+    uint32				getCount() const {
+        return static_cast<uint32>(mParameters.size());
+    }
+    const Parameter&	getParameter(uint32 index) const {
+        return mParameters[index];
+    }
+
+private:
+
+    void				_addValue(DataFieldType type, const void* value, uint32 size);
+
+    // Win32 complains about stl during linkage, disable the warning.
+#ifdef _WIN32
+#pragma warning (disable : 4251)
+#endif
+    std::vector<Parameter>	mParameters;
+    // Re-enable the warning.
+#ifdef _WIN32
+#pragma warning (default : 4251)
+#endif
+};
+
+//======================================================================================================================
+//
+// The rows of a prepared statement, fetched with the binary protocol by the worker that executed it.
+// Every column keeps the type it was fetched as, numbers in their binary form, strings are kept aside and the
+// cell holds their index. GetNextRow copies a row to the binding offsets and converts where the types differ,
+// so a result can be read with several bindings, like a text protocol result.
+//
+
+class DBMANAGER_API StatementResult
+{
+public:
+
+    explicit StatementResult(uint32 columnCount);
+    ~StatementResult();
+
+    // DFT_string for any kind of string, DFT_none for columns that were not fetched
+    void				setColumnType(uint32 column, DataFieldType type) {
+        mColumnTypes[column] = type;
+    }
+    DataFieldType		getColumnType(uint32 column) const {
+        return mColumnTypes[column];
+    }
+    uint32				getColumnCount() const {
+        return mColumnCount;
+    }
+
+    void				addRow(const uint64* cells);
+    uint32				addString(const int8* data, uint32 length);
+
+    uint64				getRowCount() const {
+        return mColumnCount ? (mCells.size() / mColumnCount) : 0;
+    }
+    void				setRowIndex(uint64 index) {
+        mRowIndex = index;
+    }
+
+    bool				GetNextRow(DataBinding* binding, void* object);
+
+    // Size of the binary value of a numeric field type, 0 for everything else.
+    static uint32		getValueSize(DataFieldType type);
+
+private:
+
+    void				_readNumber(uint64 cell, DataFieldType type, DataFieldType targetType, int64& integer, double& real);
+    void				_writeNumber(int8* target, DataFieldType type, int64 integer, double real);
+
+    // Win32 complains about stl during linkage, disable the warning.
+#ifdef _WIN32
+#pragma warning (disable : 4251)
+#endif
+    std::vector<DataFieldType>	mColumnTypes;
+    std::vector<uint64>			mCells;
+    std::vector<std::string>	mStrings;
+    // Re-enable the warning.
+#ifdef _WIN32
+#pragma warning (default : 4251)
+#endif
+
+    uint32				mColumnCount;
+    uint64				mRowIndex;
+};
+
+//======================================================================================================================
+
+#endif
@@ -0,0 +1,210 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "WriteBehindBuffer.h"
+
+//======================================================================================================================
+
+WriteBehindBuffer::WriteBehindBuffer(uint64 window)
+    : mWindow(window)
+    , mOldestTime(0)
+    , mPendingCount(0)
+    , mQueuedCount(0)
+    , mCoalescedCount(0)
+    , mStatementCount(0)
+{
+}
+
+//======================================================================================================================
+
+WriteBehindBuffer::~WriteBehindBuffer()
+{
+}
+
+//======================================================================================================================
+
+void WriteBehindBuffer::add(const std::string& table, const std::string& column, const std::string& condition, const std::string& value, uint64 owner, uint64 currentTime)
+{
+    RowMap& rows = mColumns[std::make_pair(table, column)];
+
+    mQueuedCount++;
+
+    Row row;
+    row.mValue = value;
+    row.mOwner = owner;
+
+    std::pair<RowMap::iterator, bool> inserted = rows.insert(std::make_pair(condition, row));
+    if(!inserted.second)
+    {
+        // the row is pending already, the newer value wins
+        (*inserted.first).second = row;
+        mCoalescedCount++;
+        return;
+    }
+
+    if(!mPendingCount)
+    {
+        mOldestTime = currentTime;
+    }
+
+    mPendingCount++;
+}
+
+//======================================================================================================================
+
+bool WriteBehindBuffer::isDue(uint64 currentTime) const
+{
+    return(mPendingCount && (currentTime - mOldestTime >= mWindow));
+}
+
+//======================================================================================================================
+
+void WriteBehindBuffer::flush(std::vector<std::string>& statements, uint32 maxLength)
+{
+    ColumnMap::iterator it = mColumns.begin();
+
+    while(it != mColumns.end())
+    {
+        _buildStatements((*it).first.first, (*it).first.second, (*it).second, statements, maxLength);
+        ++it;
+    }
+
+    mColumns.clear();
+    mPendingCount = 0;
+}
+
+//======================================================================================================================
+
+void WriteBehindBuffer::flushOwner(uint64 owner, std::vector<std::string>& statements, uint32 maxLength)
+{
+    ColumnMap::iterator it = mColumns.begin();
+
+    while(it != mColumns.end())
+    {
+        RowMap& rows = (*it).second;
+        RowMap	owned;
+
+        RowMap::iterator rowIt = rows.begin();
+
+        while(rowIt != rows.end())
+        {
+            if((*rowIt).second.mOwner == owner)
+            {
+                owned.insert(*rowIt);
+                rows.erase(rowIt++);
+                mPendingCount--;
+            }
+            else
+            {
+                ++rowIt;
+            }
+        }
+
+        if(!owned.empty())
+        {
+            _buildStatements((*it).first.first, (*it).first.second, owned, statements, maxLength);
+        }
+
+        if(rows.empty())
+        {
+            mColumns.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+//======================================================================================================================
+//
+// One row becomes a plain update, more rows become
+// UPDATE table SET column=CASE WHEN c1 THEN v1 WHEN c2 THEN v2 END WHERE (c1) OR (c2)
+//
+
+void WriteBehindBuffer::_buildStatements(const std::string& table, const std::string& column, const RowMap& rows, std::vector<std::string>& statements, uint32 maxLength)
+{
+    RowMap::const_iterator it = rows.begin();
+
+    while(it != rows.end())
+    {
+        std::string head = "UPDATE " + table + " SET " + column + "=";
+
+        // see how many rows fit, a row costs its condition twice and its value
+        RowMap::const_iterator last = it;
+        size_t length = head.length() + 20;
+        uint32 count = 0;
+
+        while(last != rows.end())
+        {
+            size_t rowLength = 2 * (*last).first.length() + (*last).second.mValue.length() + 20;
+
+            if(count && (length + rowLength > maxLength))
+            {
+                break;
+            }
+
+            length += rowLength;
+            count++;
+            ++last;
+        }
+
+        std::string statement = head;
+
+        if(count == 1)
+        {
+            statement += (*it).second.mValue + " WHERE " + (*it).first;
+        }
+        else
+        {
+            std::string where;
+
+            statement += "CASE";
+
+            for(RowMap::const_iterator row = it; row != last; ++row)
+            {
+                statement += " WHEN " + (*row).first + " THEN " + (*row).second.mValue;
+
+                if(!where.empty())
+                {
+                    where += " OR ";
+                }
+
+                where += "(" + (*row).first + ")";
+            }
+
+            statement += " END WHERE " + where;
+        }
+
+        statements.push_back(statement);
+        mStatementCount++;
+
+        it = last;
+    }
+}
+
+//======================================================================================================================
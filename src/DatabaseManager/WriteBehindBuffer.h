@@ -0,0 +1,121 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_DATABASEMANAGER_WRITEBEHINDBUFFER_H
+#define ANH_DATABASEMANAGER_WRITEBEHINDBUFFER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Utils/typedefs.h"
+#include "DatabaseManager/declspec.h"
+
+//======================================================================================================================
+//
+// Collects fire and forget updates of single columns, keyed by table, column and the row condition.
+// An update of a row and column that is still pending replaces the pending value, once the oldest
+// pending update waited for the window everything is written as one multi row statement per column.
+//
+// Only use it for columns that are not written through other statements as well, the merged update
+// is written when the buffer is flushed, not in the order the updates came in. Every row names the
+// character it belongs to, so a character leaving the zone can have just its own rows written.
+//
+
+class DBMANAGER_API WriteBehindBuffer
+{
+public:
+
+    explicit WriteBehindBuffer(uint64 window);
+    ~WriteBehindBuffer();
+
+    // Queues "UPDATE table SET column=value WHERE condition", value has to be a ready sql literal.
+    void		add(const std::string& table, const std::string& column, const std::string& condition, const std::string& value, uint64 owner, uint64 currentTime);
+
+    // True once the oldest pending update waited for the window.
+    bool		isDue(uint64 currentTime) const;
+
+    // Moves everything pending into statements of at most maxLength characters.
+    // A single row longer than that still gets its own statement.
+    void		flush(std::vector<std::string>& statements, uint32 maxLength);
+
+    // As flush, for the rows of one owner only, the others stay pending.
+    void		flushOwner(uint64 owner, std::vector<std::string>& statements, uint32 maxLength);
+
+    uint32		getPendingCount() const {
+        return mPendingCount;
+    }
+    uint64		getWindow() const {
+        return mWindow;
+    }
+
+    // Updates queued, updates replaced by a later one, and statements written since startup.
+    uint64		getQueuedCount() const {
+        return mQueuedCount;
+    }
+    uint64		getCoalescedCount() const {
+        return mCoalescedCount;
+    }
+    uint64		getStatementCount() const {
+        return mStatementCount;
+    }
+
+private:
+
+    // Win32 complains about stl during linkage, disable the warning.
+#ifdef _WIN32
+#pragma warning (disable : 4251)
+#endif
+    struct Row
+    {
+        std::string	mValue;
+        uint64		mOwner;
+    };
+
+    typedef std::map<std::string, Row>										RowMap;
+    typedef std::map<std::pair<std::string, std::string>, RowMap>			ColumnMap;
+
+    void		_buildStatements(const std::string& table, const std::string& column, const RowMap& rows, std::vector<std::string>& statements, uint32 maxLength);
+
+    ColumnMap	mColumns;
+    // Re-enable the warning.
+#ifdef _WIN32
+#pragma warning (default : 4251)
+#endif
+
+    uint64		mWindow;
+    uint64		mOldestTime;
+    uint32		mPendingCount;
+
+    uint64		mQueuedCount;
+    uint64		mCoalescedCount;
+    uint64		mStatementCount;
+};
+
+//======================================================================================================================
+
+#endif
@@ -139,6 +139,13 @@ void LoginServer::Process(void)
     gMessageFactory->Process();
 }
 
+//======================================================================================================================
+
+void LoginServer::Idle(uint32 timeout)
+{
+    mDatabaseManager->waitForCompletedJobs(timeout);
+}
+
 
 //======================================================================================================================
 void handleExit(void)
@@ -188,7 +195,7 @@ int main(int argc, char* argv[])
             if(std::cin.get() == 'q')
                 break;
 
-        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        gLoginServer->Idle(10);
     }
 
     // Shutdown things
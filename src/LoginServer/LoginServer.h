@@ -47,6 +47,9 @@ public:
 
     void	Process(void);
 
+    // Sleeps for up to timeout ms, a completed database job wakes us up early.
+    void	Idle(uint32 timeout);
+
 private:
     NetworkManager*									mNetworkManager;
     Service*                        mService;
@@ -67,6 +67,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+
 //======================================================================================================================
 
 bool		MessageLib::mInsFlag    = false;
@@ -169,6 +171,78 @@ bool MessageLib::_checkDistance(const glm::vec3& mPosition1, Object* object, uin
     return false;
 }
 
+//======================================================================================================================
+//
+// Sends one message to a list of players. More than one recipient gets a single multicast envelope per
+// MULTICAST_MAX_ACCOUNTS players which the connectionserver fans out, so the zone serializes and sends it once.
+// All players share the connectionserver session, so any of their clients carries the envelope.
+//
+void MessageLib::_sendToPlayers(Message* message, const PlayerRecipientList& recipients, uint16 priority, bool unreliable) const
+{
+    if(recipients.empty())
+    {
+        mMessageFactory->DestroyMessage(message);
+        return;
+    }
+
+    DispatchClient* client = recipients.front()->getClient();
+
+    if(recipients.size() == 1)
+    {
+        if(unreliable)
+            client->SendChannelAUnreliable(message,recipients.front()->getAccountId(),CR_Client,static_cast<uint8>(priority));
+        else
+            client->SendChannelA(message,recipients.front()->getAccountId(),CR_Client,static_cast<uint8>(priority));
+
+        return;
+    }
+
+    PlayerRecipientList::const_iterator playerIt = recipients.begin();
+
+    // the envelope has to fit into a message, huge payloads go out as shared messages per player instead
+    int32 maxAccounts = std::min<int32>(MULTICAST_MAX_ACCOUNTS, (0xffff - 6 - static_cast<int32>(message->getSize())) / 4);
+
+    if(maxAccounts < 2)
+    {
+        while(playerIt != recipients.end())
+        {
+            if(unreliable)
+                ((*playerIt)->getClient())->SendChannelAUnreliable(mMessageFactory->CreateSharedMessage(message),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
+            else
+                ((*playerIt)->getClient())->SendChannelA(mMessageFactory->CreateSharedMessage(message),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
+
+            ++playerIt;
+        }
+
+        mMessageFactory->DestroyMessage(message);
+        return;
+    }
+
+    while(playerIt != recipients.end())
+    {
+        uint16 accountCount = static_cast<uint16>(std::min<int32>(static_cast<int32>(recipients.end() - playerIt), maxAccounts));
+
+        mMessageFactory->StartMessage();
+        mMessageFactory->addUint32(opClusterMulticastMessage);
+        mMessageFactory->addUint16(accountCount);
+
+        for(uint16 i = 0; i < accountCount; i++, ++playerIt)
+        {
+            mMessageFactory->addUint32((*playerIt)->getAccountId());
+        }
+
+        mMessageFactory->addData(message->getData(),message->getSize());
+
+        // the connectionserver picks up the envelope, the account ids are inside
+        if(unreliable)
+            client->SendChannelAUnreliable(mMessageFactory->EndMessage(),0,CR_Client,static_cast<uint8>(priority));
+        else
+            client->SendChannelA(mMessageFactory->EndMessage(),0,CR_Client,static_cast<uint8>(priority));
+    }
+
+    mMessageFactory->DestroyMessage(message);
+}
+
 //======================================================================================================================
 //
 // broadcasts a message to all players in range of the given object
@@ -178,6 +252,9 @@ void MessageLib::_sendToInRangeUnreliable(Message* message, Object* const object
     PlayerObjectSet*			inRangePlayers	= object->getKnownPlayers();
     PlayerObjectSet::iterator	playerIt		= inRangePlayers->begin();
 
+    PlayerRecipientList recipients;
+    recipients.reserve(inRangePlayers->size() + 1);
+
     bool failed = false;
     //save us some cycles if traffic is low
 
@@ -187,11 +264,7 @@ void MessageLib::_sendToInRangeUnreliable(Message* message, Object* const object
         {
             if(_checkPlayer((*playerIt)))
             {
-                // clone our message
-                mMessageFactory->StartMessage();
-                mMessageFactory->addData(message->getData(),message->getSize());
-
-                ((*playerIt)->getClient())->SendChannelAUnreliable(mMessageFactory->EndMessage(),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
+                recipients.push_back(*playerIt);
             }
             else
             {
@@ -215,11 +288,7 @@ void MessageLib::_sendToInRangeUnreliable(Message* message, Object* const object
                 bool yn = _checkDistance((*playerIt)->mPosition,object,mMessageFactory->HeapWarningLevel());
                 if(yn)
                 {
-                    // clone our message
-                    mMessageFactory->StartMessage();
-                    mMessageFactory->addData(message->getData(),message->getSize());
-
-                    ((*playerIt)->getClient())->SendChannelAUnreliable(mMessageFactory->EndMessage(),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
+                    recipients.push_back(*playerIt);
                 }
                 else
                 {
@@ -237,12 +306,11 @@ void MessageLib::_sendToInRangeUnreliable(Message* message, Object* const object
 
         if(_checkPlayer(srcPlayer))
         {
-            (srcPlayer->getClient())->SendChannelAUnreliable(message,srcPlayer->getAccountId(),CR_Client,static_cast<uint8>(priority));
-            return;
+            recipients.push_back(srcPlayer);
         }
     }
 
-    mMessageFactory->DestroyMessage(message);
+    _sendToPlayers(message,recipients,priority,true);
 }
 
 //======================================================================================================================
@@ -252,15 +320,14 @@ void MessageLib::_sendToInRange(Message* message, Object* const object,uint16 pr
     PlayerObjectSet*			inRangePlayers	= object->getKnownPlayers();
     PlayerObjectSet::iterator	playerIt		= inRangePlayers->begin();
 
+    PlayerRecipientList recipients;
+    recipients.reserve(inRangePlayers->size() + 1);
+
     while(playerIt != inRangePlayers->end())
     {
         if(_checkPlayer((*playerIt)))
         {
-            // clone our message
-            mMessageFactory->StartMessage();
-            mMessageFactory->addData(message->getData(),message->getSize());
-
-            ((*playerIt)->getClient())->SendChannelA(mMessageFactory->EndMessage(),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
+            recipients.push_back(*playerIt);
         }
 
         ++playerIt;
@@ -272,12 +339,11 @@ void MessageLib::_sendToInRange(Message* message, Object* const object,uint16 pr
 
         if(_checkPlayer(srcPlayer))
         {
-            (srcPlayer->getClient())->SendChannelA(message,srcPlayer->getAccountId(),CR_Client, static_cast<uint8>(priority));
-            return;
+            recipients.push_back(srcPlayer);
         }
     }
 
-    mMessageFactory->DestroyMessage(message);
+    _sendToPlayers(message,recipients,priority,false);
 }
 
 //======================================================================================================================
@@ -295,21 +361,20 @@ void MessageLib::_sendToInstancedPlayers(Message* message,uint16 priority, const
     PlayerList const			inRangeMembers	= playerObject->getInRangeGroupMembers(true);
     PlayerList::const_iterator	playerIt		= inRangeMembers.begin();
 
+    PlayerRecipientList recipients;
+    recipients.reserve(inRangeMembers.size());
+
     while (playerIt != inRangeMembers.end())
     {
         if (_checkPlayer(*playerIt))
         {
-            // Clone the message.
-            mMessageFactory->StartMessage();
-            mMessageFactory->addData(message->getData(),message->getSize());
-
-            ((*playerIt)->getClient())->SendChannelA(mMessageFactory->EndMessage(),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
+            recipients.push_back(*playerIt);
         }
 
         ++playerIt;
     }
 
-    mMessageFactory->DestroyMessage(message);
+    _sendToPlayers(message,recipients,priority,false);
 }
 
 //======================================================================================================================
@@ -327,21 +392,20 @@ void MessageLib::_sendToInstancedPlayersUnreliable(Message* message,uint16 prior
     PlayerList const			inRangeMembers	= playerObject->getInRangeGroupMembers(true);
     PlayerList::const_iterator	playerIt		= inRangeMembers.begin();
 
+    PlayerRecipientList recipients;
+    recipients.reserve(inRangeMembers.size());
+
     while (playerIt != inRangeMembers.end())
     {
         if (_checkPlayer(*playerIt))
         {
-            // Clone the message.
-            mMessageFactory->StartMessage();
-            mMessageFactory->addData(message->getData(),message->getSize());
-
-            ((*playerIt)->getClient())->SendChannelAUnreliable(mMessageFactory->EndMessage(),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
+            recipients.push_back(*playerIt);
         }
 
         ++playerIt;
     }
 
-    mMessageFactory->DestroyMessage(message);
+    _sendToPlayers(message,recipients,priority,true);
 }
 
 //======================================================================================================================
@@ -353,29 +417,22 @@ void MessageLib::_sendToAll(Message* message,uint16 priority,bool unreliable) co
     const PlayerAccMap* const		players		= gWorldManager->getPlayerAccMap();
     PlayerAccMap::const_iterator	playerIt	= players->begin();
 
+    PlayerRecipientList recipients;
+    recipients.reserve(players->size());
+
     while(playerIt != players->end())
     {
         const PlayerObject* const player = (*playerIt).second;
 
         if(_checkPlayer(player))
         {
-            mMessageFactory->StartMessage();
-            mMessageFactory->addData(message->getData(),message->getSize());
-
-            if(unreliable)
-            {
-                (player->getClient())->SendChannelAUnreliable(mMessageFactory->EndMessage(),player->getAccountId(),CR_Client,static_cast<uint8>(priority));
-            }
-            else
-            {
-                (player->getClient())->SendChannelA(mMessageFactory->EndMessage(),player->getAccountId(),CR_Client,static_cast<uint8>(priority));
-            }
+            recipients.push_back(player);
         }
 
         ++playerIt;
     }
 
-    mMessageFactory->DestroyMessage(message);
+    _sendToPlayers(message,recipients,priority,unreliable);
 }
 
 
@@ -37,6 +37,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ZoneServer/MoodTypes.h"
 
 #include "Common/OutOfBand.h"
+#include "Utils/FlatSet.h"
 
 #include <vector>
 #include <list>
@@ -78,8 +79,12 @@ class ActiveConversation;
 
 typedef struct tagResourceLocation ResourceLocation;
 
-typedef std::set<PlayerObject*>			PlayerObjectSetML;
+typedef utils::FlatSet<PlayerObject*>	PlayerObjectSetML;
 typedef std::list<PlayerObject*>		PlayerList;
+typedef std::vector<const PlayerObject*>	PlayerRecipientList;
+
+// account ids carried by one multicast envelope to the connectionserver
+#define MULTICAST_MAX_ACCOUNTS	256
 
 enum ObjectUpdate
 {
@@ -580,6 +585,7 @@ private:
     void				_sendToInstancedPlayersUnreliable(Message* message, uint16 priority, const PlayerObject* const player) const ;
     void				_sendToInstancedPlayers(Message* message, uint16 priority, const PlayerObject* const player) const ;
     void				_sendToAll(Message* message,uint16 priority,bool unreliable = false) const;
+    void				_sendToPlayers(Message* message, const PlayerRecipientList& recipients, uint16 priority, bool unreliable) const;
 
     /**
      * Sends a spatial message to in-range players.
@@ -28,45 +28,156 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "CompCryptor.h"
 #include <zlib.h>
 
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANH_CRYPT_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 needs the gcc target attribute and cpu check, msvc 2010 has no AVX2 intrinsics.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ANH_CRYPT_AVX2
+#include <immintrin.h>
+#endif
 
 //======================================================================================================================
-CompCryptor::CompCryptor(void)
+//
+// Decrypt kernels. Every 32bit word is XORed with the previous ciphertext word, so unlike Encrypt all words can be
+// handled in parallel. The kernels walk the buffer from the back, that way the previous ciphertext word is still
+// untouched when a block gets decrypted in place.
+//
+
+namespace
+{
+typedef void (*DecryptKernel)(uint32* words, uint32 wordCount, uint32 seed);
+
+// decrypts words[0, wordCount) , the vector kernels hand us their leftover head words
+void decryptWordsScalar(uint32* words, uint32 wordCount, uint32 seed)
+{
+    if(!wordCount)
+        return;
+
+    for(uint32 i = wordCount - 1; i > 0; i--)
+    {
+        words[i] ^= words[i - 1];
+    }
+
+    words[0] ^= seed;
+}
+
+#ifdef ANH_CRYPT_SSE2
+void decryptWordsSSE2(uint32* words, uint32 wordCount, uint32 seed)
+{
+    uint32 i = wordCount;
+
+    while(i >= 5)
+    {
+        i -= 4;
+
+        __m128i current  = _mm_loadu_si128((const __m128i*)(words + i));
+        __m128i previous = _mm_loadu_si128((const __m128i*)(words + i - 1));
+
+        _mm_storeu_si128((__m128i*)(words + i), _mm_xor_si128(current, previous));
+    }
+
+    decryptWordsScalar(words, i, seed);
+}
+#endif
+
+#ifdef ANH_CRYPT_AVX2
+__attribute__((target("avx2")))
+void decryptWordsAVX2(uint32* words, uint32 wordCount, uint32 seed)
+{
+    uint32 i = wordCount;
+
+    while(i >= 9)
+    {
+        i -= 8;
+
+        __m256i current  = _mm256_loadu_si256((const __m256i*)(words + i));
+        __m256i previous = _mm256_loadu_si256((const __m256i*)(words + i - 1));
+
+        _mm256_storeu_si256((__m256i*)(words + i), _mm256_xor_si256(current, previous));
+    }
+
+    decryptWordsScalar(words, i, seed);
+}
+#endif
+
+DecryptKernel selectDecryptKernel()
 {
-    mStreamData = new z_stream;
+#ifdef ANH_CRYPT_AVX2
+    if(__builtin_cpu_supports("avx2"))
+        return &decryptWordsAVX2;
+#endif
+
+#ifdef ANH_CRYPT_SSE2
+    return &decryptWordsSSE2;
+#else
+    return &decryptWordsScalar;
+#endif
 }
 
+// picked once at startup from what the cpu supports
+const DecryptKernel gDecryptKernel = selectDecryptKernel();
+}
+
+
+//======================================================================================================================
+CompCryptor::CompCryptor(int compressionLevel, int compressionStrategy)
+{
+    mDeflateStream = new z_stream;
+    mDeflateStream->zalloc = Z_NULL;
+    mDeflateStream->zfree = Z_NULL;
+    mDeflateStream->opaque = Z_NULL;
+    mDeflateStream->avail_in = 0;
+    mDeflateStream->next_in = Z_NULL;
+
+    if(deflateInit2(mDeflateStream, compressionLevel, Z_DEFLATED, MAX_WBITS, 8, compressionStrategy) != Z_OK)
+    {
+        // Bad level/strategy from the config, fall back to the zlib defaults.
+        deflateInit(mDeflateStream, Z_DEFAULT_COMPRESSION);
+    }
+
+    mInflateStream = new z_stream;
+    mInflateStream->zalloc = Z_NULL;
+    mInflateStream->zfree = Z_NULL;
+    mInflateStream->opaque = Z_NULL;
+    mInflateStream->avail_in = 0;
+    mInflateStream->next_in = Z_NULL;
+
+    inflateInit(mInflateStream);
+}
 
 //======================================================================================================================
+
 CompCryptor::~CompCryptor(void)
 {
-    delete mStreamData;
+    deflateEnd(mDeflateStream);
+    inflateEnd(mInflateStream);
+
+    delete mDeflateStream;
+    delete mInflateStream;
 }
 
 //======================================================================================================================
+
 int CompCryptor::Compress(int8* inData, uint32 inLen, int8* outData, uint32 outLen)
 {
-    // Init our stream
-    mStreamData->zalloc = Z_NULL;
-    mStreamData->zfree = Z_NULL;
-    mStreamData->opaque = Z_NULL;
-    mStreamData->avail_in = 0;
-    mStreamData->next_in = Z_NULL;
-    deflateInit(mStreamData, Z_DEFAULT_COMPRESSION);
+    // Reuse our stream, this only resets the counters and keeps the allocated state.
+    deflateReset(mDeflateStream);
 
     // Setup our struct
-    mStreamData->next_in = (Bytef*)inData;
-    mStreamData->avail_in = inLen;
-    mStreamData->next_out = (Bytef*)outData;
-    mStreamData->avail_out = outLen;
+    mDeflateStream->next_in = (Bytef*)inData;
+    mDeflateStream->avail_in = inLen;
+    mDeflateStream->next_out = (Bytef*)outData;
+    mDeflateStream->avail_out = outLen;
 
     // compress our data and get it's final size.
-    deflate(mStreamData, Z_FINISH);
-    uint32 outBytes = mStreamData->total_out;
-    if (outBytes)
-    {
-        // We only call this on a successful decompression.
-        deflateEnd(mStreamData);
-    }
+    deflate(mDeflateStream, Z_FINISH);
+
+    uint32 outBytes = mDeflateStream->total_out;
 
     // May as well not compress it if it's going to be bigger.
     if (outBytes > inLen)
@@ -77,42 +188,31 @@ int CompCryptor::Compress(int8* inData, uint32 inLen, int8* outData, uint32 outL
     return outBytes;
 }
 
-
 //======================================================================================================================
+
 int CompCryptor::Decompress(int8* inData, uint32 inLen, int8* outData, uint32 outLen)
 {
     // If it's not compressed, don't decompress it.
     if (inData[0] != 'x')
         return 0;
 
-    // Init our stream
-    mStreamData->zalloc = Z_NULL;
-    mStreamData->zfree = Z_NULL;
-    mStreamData->opaque = Z_NULL;
-    mStreamData->avail_in = 0;
-    mStreamData->next_in = Z_NULL;
-    inflateInit(mStreamData);
+    // Reuse our stream, this only resets the counters and keeps the allocated state.
+    inflateReset(mInflateStream);
 
     // Setup our struct
-    mStreamData->next_in = (Bytef*)inData;
-    mStreamData->avail_in = inLen;
-    mStreamData->next_out = (Bytef*)outData;
-    mStreamData->avail_out = outLen;
+    mInflateStream->next_in = (Bytef*)inData;
+    mInflateStream->avail_in = inLen;
+    mInflateStream->next_out = (Bytef*)outData;
+    mInflateStream->avail_out = outLen;
 
     // compress our data and get it's final size.
-    inflate(mStreamData, Z_FINISH);
-    uint32 outBytes = mStreamData->total_out;
-    if (outBytes)
-    {
-        // We only call this on a successful decompression.
-        inflateEnd(mStreamData);
-    }
+    inflate(mInflateStream, Z_FINISH);
 
-    return outBytes;
+    return mInflateStream->total_out;
 }
 
-
 //======================================================================================================================
+
 int CompCryptor::Encrypt(int8* data, uint32 len, uint32 seed)
 {
     //seed = seed ^ 0x62491908;
@@ -145,28 +245,93 @@ int CompCryptor::Decrypt(int8* data, uint32 len, uint32 seed)
 
     int retVal = 0;
 
-    uint32 tempSeed = 0;
     uint32 blockCount = (len / 4);
     uint32 byteCount = (len % 4);
 
-    for(uint32 count = 0; count < blockCount; count++)
-    {
-        tempSeed = ((uint32*)data)[count];
-        ((uint32*)data)[count] ^= seed;
-        seed = tempSeed;
-    }
+    // The trailing bytes are XORed with the last ciphertext word, grab it before the words get decrypted.
+    uint32 lastSeed = seed;
+
+    if(blockCount)
+        memcpy(&lastSeed, data + (blockCount - 1) * 4, sizeof(uint32));
 
     for(uint32 count = blockCount * 4; count < blockCount * 4 + byteCount; count++)
     {
-        data[count] ^= seed;
+        data[count] ^= lastSeed;
     }
 
+    gDecryptKernel((uint32*)data, blockCount, seed);
+
     return retVal;
 }
 
 
+//======================================================================================================================
+//
+// Slicing-by-8, folds 8 bytes per step through the 8 derived tables.
+// The words are assembled byte by byte so this gives the same result on any endianess.
+//
+
+inline uint32 CompCryptor::_crcSlice8(uint32 crc, const uint8* bytes)
+{
+    uint32 low  = crc ^ ((uint32)bytes[0] | ((uint32)bytes[1] << 8) | ((uint32)bytes[2] << 16) | ((uint32)bytes[3] << 24));
+    uint32 high = (uint32)bytes[4] | ((uint32)bytes[5] << 8) | ((uint32)bytes[6] << 16) | ((uint32)bytes[7] << 24);
+
+    return mCrcSliceTable[7][low & 0xFF] ^
+           mCrcSliceTable[6][(low >> 8) & 0xFF] ^
+           mCrcSliceTable[5][(low >> 16) & 0xFF] ^
+           mCrcSliceTable[4][low >> 24] ^
+           mCrcSliceTable[3][high & 0xFF] ^
+           mCrcSliceTable[2][(high >> 8) & 0xFF] ^
+           mCrcSliceTable[1][(high >> 16) & 0xFF] ^
+           mCrcSliceTable[0][high >> 24];
+}
+
 //======================================================================================================================
 uint32 CompCryptor::GenerateCRC(int8* data, uint32 len, uint32 seed)
+{
+    uint32 newCRC = _crcInit(seed), index = 0;
+
+    const uint8* bytes = (const uint8*)data;
+
+    while(len >= 8)
+    {
+        newCRC = _crcSlice8(newCRC, bytes);
+
+        bytes += 8;
+        len -= 8;
+    }
+
+    // The remaining bytes go through the regular table.
+    for(uint32 i = 0; i < len; i++ )
+    {
+        index = (bytes[i]) ^ newCRC;
+        newCRC = (newCRC >> 8) & 0x00FFFFFF;
+        newCRC ^= mCrcTable[index & 0xFF];
+    }
+
+    return ~newCRC;
+}
+
+//======================================================================================================================
+
+uint32 CompCryptor::DecryptAndGenerateCRC(int8* data, uint32 len, uint32 headerLen, uint32 seed)
+{
+    // The crc covers the packet as received, so it goes first. Client packets are far smaller than the L1 cache,
+    // the decrypt then runs the vector kernel over what the crc just loaded, instead of interleaving word by word.
+    uint32 crc = GenerateCRC(data, len, seed);
+
+    // The header is checksummed but not encrypted.
+    if(headerLen < len)
+    {
+        Decrypt(data + headerLen, len - headerLen, seed);
+    }
+
+    return crc;
+}
+
+//======================================================================================================================
+
+uint32 CompCryptor::_crcInit(uint32 seed)
 {
     uint32 newCRC = 0, index = 0;
 
@@ -182,18 +347,32 @@ uint32 CompCryptor::GenerateCRC(int8* data, uint32 len, uint32 seed)
     newCRC = (newCRC >> 8) &0x00FFFFFF;
     newCRC ^= mCrcTable[index & 0xFF];
 
-    for(uint32 i = 0; i < len; i++ )
+    return newCRC;
+}
+
+//======================================================================================================================
+
+bool CompCryptor::_initCrcSliceTables(void)
+{
+    for(uint32 i = 0; i < 256; i++)
     {
-        index = (data[i]) ^ newCRC;
-        newCRC = (newCRC >> 8) & 0x00FFFFFF;
-        newCRC ^= mCrcTable[index & 0xFF];
+        mCrcSliceTable[0][i] = mCrcTable[i];
     }
 
-    return ~newCRC;
-}
+    for(uint32 i = 0; i < 256; i++)
+    {
+        for(uint32 slice = 1; slice < 8; slice++)
+        {
+            uint32 previous = mCrcSliceTable[slice - 1][i];
+            mCrcSliceTable[slice][i] = (previous >> 8) ^ mCrcTable[previous & 0xFF];
+        }
+    }
 
+    return true;
+}
 
 //======================================================================================================================
+
 const uint32 CompCryptor::mCrcTable[256] =
 {
     0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
@@ -241,3 +420,8 @@ const uint32 CompCryptor::mCrcTable[256] =
     0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
 };
 
+//======================================================================================================================
+
+// Filled once at startup, before any socket thread can checksum a packet.
+uint32 CompCryptor::mCrcSliceTable[8][256];
+bool   CompCryptor::mCrcSliceTableInit = CompCryptor::_initCrcSliceTables();
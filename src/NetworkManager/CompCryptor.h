@@ -40,7 +40,8 @@ typedef struct z_stream_s z_stream;
 class NET_API CompCryptor
 {
 public:
-    CompCryptor(void);
+    // level and strategy are handed to deflateInit2, the defaults match Z_DEFAULT_COMPRESSION / Z_DEFAULT_STRATEGY
+    CompCryptor(int compressionLevel = -1, int compressionStrategy = 0);
     ~CompCryptor(void);
 
     int                               Compress(int8* inData, uint32 inLen, int8* outData, uint32 outLen);
@@ -51,9 +52,22 @@ public:
 
     uint32                            GenerateCRC(int8* data, uint32 len, uint32 seed);
 
+    // Checks and decrypts an incoming packet: returns the crc of data[0, len) as received and decrypts data[headerLen, len).
+    uint32                            DecryptAndGenerateCRC(int8* data, uint32 len, uint32 headerLen, uint32 seed);
+
 private:
-    z_stream*                         mStreamData;
+    static uint32                     _crcInit(uint32 seed);
+    static uint32                     _crcSlice8(uint32 crc, const uint8* bytes);
+
+    // Both streams live as long as the cryptor and are only reset between packets.
+    z_stream*                         mDeflateStream;
+    z_stream*                         mInflateStream;
     static const uint32               mCrcTable[256];
+
+    // Slicing-by-8 tables derived from mCrcTable, mCrcSliceTable[0] is mCrcTable itself.
+    static bool                       _initCrcSliceTables(void);
+    static uint32                     mCrcSliceTable[8][256];
+    static bool                       mCrcSliceTableInit;
 };
 
 
@@ -51,5 +51,13 @@ void DispatchClient::SendChannelAUnreliable(Message* message, uint32 accountId,
     NetworkClient::SendChannelAUnreliable(message, priority);
 }
 
+void DispatchClient::PostChannelA(Message* message, uint32 accountId, uint8 serverId, uint8 priority)
+{
+    message->setRouted(true);
+    message->setAccountId(accountId);
+    message->setDestinationId(serverId);
+    NetworkClient::PostChannelA(message, priority, false);
+}
+
 //======================================================================================================================
 
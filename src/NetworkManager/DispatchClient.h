@@ -41,6 +41,8 @@ public:
 
     virtual void	SendChannelA(Message* message, uint32 accountId, uint8 serverId, uint8 priority);
     virtual void	SendChannelAUnreliable(Message* message, uint32 accountId, uint8 serverId, uint8 priority);
+    // SendChannelA for worker threads, safe to call from any thread
+    virtual void	PostChannelA(Message* message, uint32 accountId, uint8 serverId, uint8 priority);
     void			setAccountId(uint32 id) {
         mAccountId = id;
     };
@@ -33,6 +33,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "NetworkManager/declspec.h"
 
+#include <boost/detail/atomic_count.hpp>
+
 enum MessagePath
 {
     MP_None = 0,
@@ -65,6 +67,8 @@ public:
         , mFastpath(false)
         , mPendingDelete(false)
         , mData(0)
+        , mSharedBody(0)
+        , mShareCount(0)
         , mLogged(false)
         , mLogTime(0)
         , mSession(NULL)
@@ -109,8 +113,16 @@ public:
     bool                        getFastpath(void)                 {
         return mFastpath;
     }
+    // A body stays on the heap until every message sharing it has been packetized.
     bool                        getPendingDelete(void)            {
-        return mPendingDelete;
+        return mPendingDelete && !mShareCount;
+    }
+    Message*                    getSharedBody(void)               {
+        return mSharedBody;
+    }
+    // The bytes this message takes up on its factory heap, a shared message only has its header there.
+    uint32                      getHeapSize(void)                 {
+        return sizeof(Message) + (mSharedBody ? 0 : mSize);
     }
 
     void                        setData(int8* data)               {
@@ -144,8 +156,20 @@ public:
         mFastpath = fastpath;
     }
     void                        setPendingDelete(bool pending)    {
+        // We are done with the shared data, the body may go once all its references are done.
+        if(pending && !mPendingDelete && mSharedBody)
+            --mSharedBody->mShareCount;
+
         mPendingDelete = pending;
     }
+    // Reference the data of body, starting at offset, instead of carrying a copy of it.
+    // The body must not be changed afterwards.
+    void                        setSharedBody(Message* body, uint16 offset = 0) {
+        mSharedBody = body;
+        ++body->mShareCount;
+
+        Init(body->getData() + offset, body->getSize() - offset);
+    }
 
     void                        getInt8(int8& data)               {
         data = *(int8*)&mData[mIndex];
@@ -302,6 +326,9 @@ private:
 
     int8*                       mData;
 
+    Message*                    mSharedBody;
+    boost::detail::atomic_count mShareCount;	// messages still referencing our data, decremented by the write threads
+
 };
 
 class CompareMsg
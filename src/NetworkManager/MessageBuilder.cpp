@@ -0,0 +1,282 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "MessageBuilder.h"
+
+#include "Utils/clock.h"
+#include "NetworkManager/Message.h"
+#include "NetworkManager/MessageFactory.h"
+
+#include <cassert>
+#include <cstring>
+
+//======================================================================================================================
+
+MessageBuilder::MessageBuilder(void) :
+    mCursor(0),
+    mBuilding(false)
+{
+    mBuffer.reserve(1024);
+}
+
+//======================================================================================================================
+
+MessageBuilder::~MessageBuilder(void)
+{
+    // the blocks go with our heap, nothing may reference our messages anymore
+    std::vector<Message*>::iterator it = mMessages.begin();
+
+    while(it != mMessages.end())
+    {
+        (*it)->~Message();
+        ++it;
+    }
+}
+
+//======================================================================================================================
+
+void MessageBuilder::StartMessage(void)
+{
+    assert(!mBuilding && "Can't handle more than one message at once.");
+
+    _processGarbageCollection();
+
+    mBuffer.clear();
+    mBuilding = true;
+}
+
+//======================================================================================================================
+
+Message* MessageBuilder::EndMessage(void)
+{
+    assert(mBuilding && "Must call StartMessage before EndMessage.");
+
+    uint32 size = static_cast<uint32>(mBuffer.size());
+    int8* block = mHeap.allocate(sizeof(Message) + size);
+
+    Message* message = new(block) Message();
+
+    if(size)
+        memcpy(block + sizeof(Message), &mBuffer[0], size);
+
+    message->setData(block + sizeof(Message));
+    message->setSize(static_cast<uint16>(size));
+    message->setCreateTime(Anh_Utils::Clock::getSingleton()->getStoredTime());
+
+    mMessages.push_back(message);
+    mBuilding = false;
+
+    return message;
+}
+
+//======================================================================================================================
+
+void MessageBuilder::_append(const void* data, uint32 len)
+{
+    // Make sure we've called StartMessage()
+    assert(mBuilding && "Must call StartMessage before adding data");
+    assert(mBuffer.size() + len <= 0xffff && "Message exceeds the maximum message size.");
+
+    size_t offset = mBuffer.size();
+    mBuffer.resize(offset + len);
+    memcpy(&mBuffer[offset], data, len);
+}
+
+//======================================================================================================================
+//
+// Our messages are flagged pending delete by the session write threads, give their blocks back to the heap.
+// A window of the live messages per call keeps StartMessage cheap.
+//
+void MessageBuilder::_processGarbageCollection(void)
+{
+    uint64 now = Anh_Utils::Clock::getSingleton()->getStoredTime();
+    uint32 count = 0;
+
+    while((count < 50) && !mMessages.empty())
+    {
+        if(mCursor >= mMessages.size())
+            mCursor = 0;
+
+        Message* message = mMessages[mCursor];
+
+        if(message->getPendingDelete())
+        {
+            uint32 heapSize = message->getHeapSize();
+            message->~Message();
+            mHeap.release(reinterpret_cast<int8*>(message), heapSize);
+
+            mMessages[mCursor] = mMessages.back();
+            mMessages.pop_back();
+        }
+        else
+        {
+            // a message that never made it to a session would pin its block forever
+            if(now - message->getCreateTime() > MESSAGE_MAX_LIFE_TIME)
+                MessageFactory::HandleStuckMessage(message);
+
+            mCursor++;
+        }
+
+        count++;
+    }
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addInt8(int8 data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addUint8(uint8 data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addInt16(int16 data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addUint16(uint16 data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addInt32(int32 data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addUint32(uint32 data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addInt64(int64 data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addUint64(uint64 data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addFloat(float data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addDouble(double data)
+{
+    _append(&data, sizeof(data));
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addString(const std::string& string)
+{
+    BString str(string.c_str());
+    addString(str);
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addString(const std::wstring& string)
+{
+    BString str(string.c_str());
+    addString(str);
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addString(const char* cstring)
+{
+    BString str;
+    str = cstring;
+    addString(str);
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addString(const BString& data)
+{
+    // Same layout as the MessageFactory, 16 bit length for ansi, 32 bit length for unicode strings.
+    switch(data.getType())
+    {
+    case BSTRType_UTF8:
+    case BSTRType_ANSI:
+    {
+        addUint16(data.getLength());
+        _append(data.getAnsi(), data.getLength());
+    }
+    break;
+
+    case BSTRType_Unicode16:
+    {
+        addUint32(data.getLength());
+        _append(data.getUnicode16(), data.getLength() * 2);
+    }
+    break;
+    }
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addData(const int8* data, uint16 len)
+{
+    _append(data, len);
+}
+
+//======================================================================================================================
+
+void MessageBuilder::addData(const uint8_t* data, uint16 len)
+{
+    _append(data, len);
+}
+
+//======================================================================================================================
+
@@ -0,0 +1,119 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_NETWORKMANAGER_MESSAGEBUILDER_H
+#define ANH_NETWORKMANAGER_MESSAGEBUILDER_H
+
+#include "Utils/typedefs.h"
+#include "Utils/bstring.h"
+
+#include "NetworkManager/declspec.h"
+#include "NetworkManager/MessageSlabHeap.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+//======================================================================================================================
+
+class Message;
+
+//======================================================================================================================
+//
+// Builds messages without the MessageFactory.
+//
+// A builder owns its build buffer and the blocks of the messages it hands out, so every worker thread can build
+// baselines and deltas with its own builder while the main thread keeps using gMessageFactory. The worker hands
+// its messages to Session::PostChannelA, the sessions flag them pending delete once they are packetized and the
+// builder takes their blocks back on one of its next StartMessage calls. Messages nobody picks up are dealt with
+// like stuck messages of the MessageFactory.
+//
+// A builder is not thread safe itself, use one per thread. It has to outlive the messages it built.
+//
+
+class NET_API MessageBuilder
+{
+public:
+
+    MessageBuilder(void);
+    ~MessageBuilder(void);
+
+    void                    StartMessage(void);
+    Message*                EndMessage(void);
+
+    // Data packing methods, they match the ones of the MessageFactory.
+    void                    addInt8(int8 data);
+    void                    addUint8(uint8 data);
+    void                    addInt16(int16 data);
+    void                    addUint16(uint16 data);
+    void                    addInt32(int32 data);
+    void                    addUint32(uint32 data);
+    void                    addInt64(int64 data);
+    void                    addUint64(uint64 data);
+    void                    addFloat(float data);
+    void                    addDouble(double data);
+    void                    addString(const BString& data);
+    void					addString(const std::string& string);
+    void					addString(const std::wstring& string);
+    void					addString(const char* cstring);
+    void                    addData(const int8* data, uint16 len);
+    void                    addData(const uint8_t* data, uint16 len);
+
+    // messages built and not reclaimed yet
+    uint32                  getMessageCount(void) const {
+        return static_cast<uint32>(mMessages.size());
+    }
+    const MessageSlabHeap&  getHeap(void) const {
+        return mHeap;
+    }
+
+private:
+
+    void                    _append(const void* data, uint32 len);
+    void                    _processGarbageCollection(void);
+
+    // Win32 complains about stl during linkage, disable the warning.
+#ifdef _WIN32
+#pragma warning (disable : 4251)
+#endif
+    std::vector<int8>       mBuffer;
+    std::vector<Message*>   mMessages;
+    // Re-enable the warning.
+#ifdef _WIN32
+#pragma warning (default : 4251)
+#endif
+
+    MessageSlabHeap         mHeap;
+    uint32                  mCursor;
+    bool                    mBuilding;
+};
+
+//======================================================================================================================
+
+#endif //ANH_NETWORKMANAGER_MESSAGEBUILDER_H
+
@@ -57,15 +57,30 @@ MessageFactory::MessageFactory(uint32 heapSize,uint32 serviceId)
     , mServiceId(0)
     , mHeapWarnLevel(80.0)
     , mMaxHeapUsedPercent(0)
+    , mSlabHeap(NULL)
+    , mBuildBuffer(NULL)
+    , mHeapMaxSize(heapSize)
+    , mSlabCursor(0)
 {
     // the singleton is only for use with the zone - the services use their own instantiations as we need 1 factory per thread
     // as the factory is not thread safe
 
-    // Allocate our message heap.
-    mMessageHeap = new int8[mHeapTotalSize];
-    memset(mMessageHeap, 0xed, mHeapTotalSize);
-    mHeapStart = mMessageHeap;
-    mHeapEnd = mMessageHeap;
+    // With slabs a message held by a slow session only pins its own block, the ring heap can not reclaim
+    // anything allocated after it
+    if(gConfig->read<bool>("MessageHeapSlabs",false))
+    {
+        mSlabHeap = new MessageSlabHeap();
+        mBuildBuffer = new int8[sizeof(Message) + 0xffff];
+        mHeapMaxSize = mHeapTotalSize * MESSAGE_SLAB_MAX_GROWTH;
+    }
+    else
+    {
+        // Allocate our message heap.
+        mMessageHeap = new int8[mHeapTotalSize];
+        memset(mMessageHeap, 0xed, mHeapTotalSize);
+        mHeapStart = mMessageHeap;
+        mHeapEnd = mMessageHeap;
+    }
 
     mLastHeapLevel = 0;
     mLastHeapLevelTime = gClock->getSingleton()->getStoredTime();
@@ -81,6 +96,8 @@ MessageFactory::~MessageFactory()
     // Here is the place for deletes of member data! Not in the Shutdown().
     // But now start to pray that no one still uses these messages. Who knows in this mess?
     delete[] mMessageHeap;
+    delete[] mBuildBuffer;
+    delete mSlabHeap;
 
     // mSingleton = 0;
     // Actually, we can't null mSingleton since network manager calls this code directly,
@@ -111,11 +128,20 @@ void MessageFactory::StartMessage(void)
     // Do some garbage collection if we can.
     _processGarbageCollection();
 
+    assert(mCurrentMessage==0 && "Can't handle more than one message at once.");
+
+    if(mSlabHeap)
+    {
+        // build in our scratch buffer, the size class is known once the message is done
+        mCurrentMessageStart = mBuildBuffer;
+        mCurrentMessage = new(mCurrentMessageStart) Message();
+        mCurrentMessageEnd = mCurrentMessageStart + sizeof(Message);
+        return;
+    }
+
     // Initialize the message start and end.
     mCurrentMessageStart = mHeapStart;
 
-    assert(mCurrentMessage==0 && "Can't handle more than one message at once.");
-
     mCurrentMessageEnd = mCurrentMessageStart;
 
     // Adjust start bounds if necessary.
@@ -158,23 +184,44 @@ Message* MessageFactory::EndMessage(void)
     // Do some garbage collection if we can.
     //_processGarbageCollection();
 
-    // Just cast the message start
-    Message* message = mCurrentMessage;
+    Message* message;
+
+    if(mSlabHeap)
+    {
+        message = _moveToSlab();
+    }
+    else
+    {
+        // Just cast the message start
+        message = mCurrentMessage;
+
+        message->setData(mCurrentMessageStart + sizeof(Message));
+        message->setSize((uint16)(mCurrentMessageEnd - mCurrentMessageStart) - sizeof(Message));
+
+        //adjust heapstart to past our new message
+        mHeapStart += message->getSize() + sizeof(Message);
+    }
 
-    message->setData(mCurrentMessageStart + sizeof(Message));
-    message->setSize((uint16)(mCurrentMessageEnd - mCurrentMessageStart) - sizeof(Message));
     message->setCreateTime(gClock->getSingleton()->getStoredTime());
     mCurrentMessageStart = mCurrentMessageEnd;
 
     // Zero out our mCurrentMessage so we know we're not working on one.
     mCurrentMessage = 0;
 
-    //adjust heapstart to past our new message
-    mHeapStart += message->getSize() + sizeof(Message);
-
     //Update our stats.
     mMessagesCreated++;
     mCurrentUsed = ((float)_getHeapSize() / (float)mHeapTotalSize)* 100.0f;
+
+    // the slab heap grows before it lets the heap warning level climb
+    if(mSlabHeap && mCurrentUsed > 75.0f && mHeapTotalSize < mHeapMaxSize)
+    {
+        mHeapTotalSize = std::min<uint32>(mHeapTotalSize * 2, mHeapMaxSize);
+        mCurrentUsed = ((float)_getHeapSize() / (float)mHeapTotalSize)* 100.0f;
+
+        gLogger->log(LogManager::WARNING, "MessageFactory Service %u slab heap grown to %u bytes", mServiceId, mHeapTotalSize);
+        _logSlabStats();
+    }
+
     mMaxHeapUsedPercent = std::max<float>(mMaxHeapUsedPercent,  mCurrentUsed);
 
 
@@ -200,6 +247,21 @@ void MessageFactory::DestroyMessage(Message* message)
 
 //======================================================================================================================
 
+Message* MessageFactory::CreateSharedMessage(Message* body, uint16 offset)
+{
+    assert(offset <= body->getSize() && "Shared message offset past the end of the body");
+
+    // Only the header goes on the heap, the data stays with the body.
+    StartMessage();
+
+    Message* message = EndMessage();
+    message->setSharedBody(body, offset);
+
+    return message;
+}
+
+//======================================================================================================================
+
 void MessageFactory::addInt8(int8 data)
 {
     // Make sure we've called StartMessage()
@@ -464,6 +526,12 @@ void MessageFactory::addData(const uint8_t* data, uint16 len)
 
 void MessageFactory::_processGarbageCollection(void)
 {
+    if(mSlabHeap)
+    {
+        _processSlabGarbageCollection();
+        return;
+    }
+
     uint32 mlt = 3;
     if(_getHeapSize() > 70.0)
         mlt = 2;
@@ -487,10 +555,10 @@ void MessageFactory::_processGarbageCollection(void)
             if (message->getPendingDelete())
             {
 
-                //uint32 size = message->getSize();
+                uint32 heapSize = message->getHeapSize();
                 message->~Message();
-                //memset(mHeapEnd, 0xed, size + sizeof(Message));
-                mHeapEnd += message->getSize() + sizeof(Message);
+                //memset(mHeapEnd, 0xed, heapSize);
+                mHeapEnd += heapSize;
 
                 mMessagesDestroyed++;
 
@@ -603,6 +671,13 @@ void MessageFactory::_processGarbageCollection(void)
 
 void MessageFactory::_adjustHeapStartBounds(uint32 size)
 {
+    if(mSlabHeap)
+    {
+        // the build buffer holds the largest message there can be
+        assert((mCurrentMessageEnd + size) <= (mBuildBuffer + sizeof(Message) + 0xffff) && "Message exceeds the maximum message size.");
+        return;
+    }
+
     // Are we going to overflow our heap?
     uint32 heapSize = _getHeapSize();
 
@@ -684,11 +759,114 @@ void MessageFactory::_adjustMessageStart(uint32 size)
 }
 
 //======================================================================================================================
+//
+// Moves the message we just built out of the build buffer into a block of its size class.
+//
+Message* MessageFactory::_moveToSlab(void)
+{
+    uint32 size = (uint32)(mCurrentMessageEnd - mCurrentMessageStart) - sizeof(Message);
 
+    int8* block = mSlabHeap->allocate(sizeof(Message) + size);
 
+    mCurrentMessage->~Message();
 
+    Message* message = new(block) Message();
+    memcpy(block + sizeof(Message), mCurrentMessageStart + sizeof(Message), size);
 
+    message->setData(block + sizeof(Message));
+    message->setSize((uint16)size);
 
+    mSlabMessages.push_back(message);
 
+    return message;
+}
 
+//======================================================================================================================
+//
+// Every message goes back to its size class on its own, so we look at a window of the live messages per call and
+// a stuck one does not hold up any of the others.
+//
+void MessageFactory::_processSlabGarbageCollection(void)
+{
+    uint64 now = Anh_Utils::Clock::getSingleton()->getStoredTime();
+    uint32 count = 0;
+
+    while((count < 50) && !mSlabMessages.empty())
+    {
+        if(mSlabCursor >= mSlabMessages.size())
+            mSlabCursor = 0;
+
+        Message* message = mSlabMessages[mSlabCursor];
+
+        if(message->getPendingDelete())
+        {
+            uint32 heapSize = message->getHeapSize();
+            message->~Message();
+            mSlabHeap->release(reinterpret_cast<int8*>(message), heapSize);
+
+            mMessagesDestroyed++;
+
+            // the order of the live messages does not matter, fill the gap with the last one
+            mSlabMessages[mSlabCursor] = mSlabMessages.back();
+            mSlabMessages.pop_back();
+        }
+        else
+        {
+            if(now - message->getCreateTime() > MESSAGE_MAX_LIFE_TIME)
+                HandleStuckMessage(message);
+
+            mSlabCursor++;
+        }
+
+        count++;
+    }
+}
+
+//======================================================================================================================
+//
+// A stuck message only pins its own block, but its session still has to go if it does not pick it up.
+//
+void MessageFactory::HandleStuckMessage(Message* message)
+{
+    uint64 now = Anh_Utils::Clock::getSingleton()->getStoredTime();
+    Session* session = (Session*)message->mSession;
 
+    if(!message->mLogged)
+    {
+        gLogger->log(LogManager::WARNING, "Garbage Collection found a new stuck message!");
+        gLogger->logCont(LogManager::INFORMATION, "age : %u ", uint32((now - message->getCreateTime())/1000));
+
+        message->mLogged = true;
+        message->mLogTime = now;
+    }
+
+    if(!session)
+    {
+        gLogger->log(LogManager::INFORMATION, "Garbage Collection found sessionless packet");
+        message->setPendingDelete(true);
+    }
+    else if((now - message->getCreateTime() > MESSAGE_MAX_LIFE_TIME*3) && session->getStatus() < SSTAT_Disconnecting)
+    {
+        // make sure that the status is not set again from Destroy to Disconnecting
+        // otherwise we wont ever get rid of that session
+        session->setCommand(SCOM_Disconnect);
+        gLogger->log(LogManager::EMERGENCY, "Garbage Collection Message Heap Time out. Destroying Session");
+    }
+}
+
+//======================================================================================================================
+
+void MessageFactory::_logSlabStats(void)
+{
+    gLogger->log(LogManager::INFORMATION, "MessageFactory Service %u STATS: slab heap - live: %u, reserved: %u, messages: %u", mServiceId, mSlabHeap->getLiveBytes(), mSlabHeap->getReservedBytes(), mSlabMessages.size());
+
+    for(uint32 sizeClass = 0; sizeClass < MessageSlabHeap::SizeClassCount; sizeClass++)
+    {
+        if(mSlabHeap->getLiveBlocks(sizeClass))
+        {
+            gLogger->logCont(LogManager::INFORMATION, "%u byte blocks: %u live, %u bytes", MessageSlabHeap::getBlockSize(sizeClass), mSlabHeap->getLiveBlocks(sizeClass), mSlabHeap->getLiveBytes(sizeClass));
+        }
+    }
+}
+
+//======================================================================================================================
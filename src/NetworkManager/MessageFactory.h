@@ -30,10 +30,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <cstdint>
 #include <string>
+#include <vector>
 #include "Utils/typedefs.h"
 #include "Utils/bstring.h"
 #include "Common/ConfigManager.h"
 #include "NetworkManager/declspec.h"
+#include "NetworkManager/MessageSlabHeap.h"
 
 //======================================================================================================================
 
@@ -44,6 +46,9 @@ class Message;
 // NEVER DELETE MESSAGES THAT ARE STILL REFERENCED SOMEWHERE
 #define MESSAGE_MAX_LIFE_TIME	60000
 
+// how far the slab heap may grow past the configured heap size before we report heap pressure
+#define MESSAGE_SLAB_MAX_GROWTH	4
+
 //======================================================================================================================
 
 class NET_API MessageFactory
@@ -63,9 +68,18 @@ public:
 
     void                    DestroyMessage(Message* message);
 
+    // Creates a message that references the data of body instead of copying it, for broadcasting one message
+    // to many sessions. body stays alive until the last of them has been packetized. A non zero offset skips
+    // a leading part of the body, ie the envelope of a multicast message.
+    Message*                CreateSharedMessage(Message* body, uint16 offset = 0);
+
     static MessageFactory*	getSingleton(void);
     static void             destroySingleton(void);
 
+    // Deals with a message that outlived MESSAGE_MAX_LIFE_TIME on a slab heap, a sessionless one is flagged for
+    // deletion and a session that does not pick its message up gets disconnected. Used by the MessageBuilders too.
+    static void             HandleStuckMessage(Message* message);
+
     // Data packing methods.
     void                    addInt8(int8 data);
     void                    addUint8(uint8 data);
@@ -89,9 +103,17 @@ public:
     float					getHeapsize() {
         return mCurrentUsed;
     }
+
+    // NULL unless the factory runs on size class slabs (MessageHeapSlabs=1) instead of the ring heap
+    const MessageSlabHeap*	getSlabHeap() const {
+        return mSlabHeap;
+    }
 private:
 
     void                    _processGarbageCollection(void);
+    void                    _processSlabGarbageCollection(void);
+    Message*                _moveToSlab(void);
+    void                    _logSlabStats(void);
     void                    _adjustHeapStartBounds(uint32 size);
     //make sure our messageclass size is put inside heap bounds
     void					_adjustMessageStart(uint32 size);
@@ -121,6 +143,23 @@ private:
     uint64					mLastHeapLevelTime;
     float					mCurrentUsed;
 
+    // Slab mode, messages are built in mBuildBuffer and moved to a block of their size class when done.
+    // mHeapTotalSize is the soft limit the heap usage is measured against, it grows up to mHeapMaxSize.
+    MessageSlabHeap*		mSlabHeap;
+    int8*					mBuildBuffer;
+    uint32					mHeapMaxSize;
+    uint32					mSlabCursor;
+
+    // Win32 complains about stl during linkage, disable the warning.
+#ifdef _WIN32
+#pragma warning (disable : 4251)
+#endif
+    std::vector<Message*>	mSlabMessages;
+    // Re-enable the warning.
+#ifdef _WIN32
+#pragma warning (default : 4251)
+#endif
+
     static MessageFactory*	mSingleton;
     // Anh_Utils::Clock*		mClock;
 };
@@ -152,6 +191,11 @@ inline void MessageFactory::destroySingleton(void)
 
 inline uint32 MessageFactory::_getHeapSize(void)
 {
+    if (mSlabHeap)
+    {
+        return mSlabHeap->getLiveBytes();
+    }
+
     if (mHeapStart >= mHeapEnd)
     {
         return (uint32)(mHeapStart - mHeapEnd);
@@ -59,7 +59,8 @@ enum MessageOpcodes
     opDeleteCharacterMessage				= 0xe87ad031,
     opDeleteCharacterReplyMessage			= 0x8268989b,
     opLauncherSessionOpen                   = 0x486f6f6e,
-    opLauncherSessionCreated                = 0x2e4e6574
+    opLauncherSessionCreated                = 0x2e4e6574,
+    opClusterMulticastMessage				= 0xc81c1713	// zone -> connectionserver, one payload for a list of accounts
 };
 
 
@@ -0,0 +1,128 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "MessageSlabHeap.h"
+
+#include <algorithm>
+#include <cassert>
+
+//======================================================================================================================
+
+MessageSlabHeap::MessageSlabHeap(void) :
+    mLiveBytesTotal(0),
+    mReservedBytes(0)
+{
+    for(uint32 i = 0; i < SizeClassCount; i++)
+    {
+        mFreeLists[i] = 0;
+        mLiveBlocks[i] = 0;
+    }
+}
+
+//======================================================================================================================
+
+MessageSlabHeap::~MessageSlabHeap(void)
+{
+    std::vector<int8*>::iterator it = mSlabs.begin();
+
+    while(it != mSlabs.end())
+    {
+        delete[] (*it);
+        ++it;
+    }
+}
+
+//======================================================================================================================
+
+uint32 MessageSlabHeap::getSizeClass(uint32 size)
+{
+    uint32 sizeClass = 0;
+
+    while(getBlockSize(sizeClass) < size)
+        sizeClass++;
+
+    assert(sizeClass < SizeClassCount && "Block size exceeds the largest size class");
+
+    return sizeClass;
+}
+
+//======================================================================================================================
+
+int8* MessageSlabHeap::allocate(uint32 size)
+{
+    uint32 sizeClass = getSizeClass(size);
+
+    if(!mFreeLists[sizeClass])
+        _refill(sizeClass);
+
+    FreeBlock* block = mFreeLists[sizeClass];
+    mFreeLists[sizeClass] = block->next;
+
+    mLiveBlocks[sizeClass]++;
+    mLiveBytesTotal += getBlockSize(sizeClass);
+
+    return reinterpret_cast<int8*>(block);
+}
+
+//======================================================================================================================
+
+void MessageSlabHeap::release(int8* block, uint32 size)
+{
+    uint32 sizeClass = getSizeClass(size);
+
+    assert(mLiveBlocks[sizeClass] && "Releasing a block of an empty size class");
+
+    FreeBlock* freeBlock = reinterpret_cast<FreeBlock*>(block);
+    freeBlock->next = mFreeLists[sizeClass];
+    mFreeLists[sizeClass] = freeBlock;
+
+    mLiveBlocks[sizeClass]--;
+    mLiveBytesTotal -= getBlockSize(sizeClass);
+}
+
+//======================================================================================================================
+
+void MessageSlabHeap::_refill(uint32 sizeClass)
+{
+    uint32 blockSize = getBlockSize(sizeClass);
+    uint32 slabSize = std::max<uint32>(SlabSize, blockSize);
+
+    int8* slab = new int8[slabSize];
+    mSlabs.push_back(slab);
+    mReservedBytes += slabSize;
+
+    // chain the blocks up front to back, so they get handed out in address order
+    for(uint32 offset = slabSize; offset >= blockSize; offset -= blockSize)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + offset - blockSize);
+        block->next = mFreeLists[sizeClass];
+        mFreeLists[sizeClass] = block;
+    }
+}
+
+//======================================================================================================================
+
@@ -0,0 +1,116 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_NETWORKMANAGER_MESSAGESLABHEAP_H
+#define ANH_NETWORKMANAGER_MESSAGESLABHEAP_H
+
+#include "Utils/typedefs.h"
+
+#include "NetworkManager/declspec.h"
+
+#include <vector>
+
+
+//======================================================================================================================
+//
+// Size class allocator for the MessageFactory.
+//
+// Blocks come in power of two sizes from 64 bytes up to 128k, which covers a Message header plus the largest
+// payload a message can carry. Every class keeps its own free list fed by slabs that are carved into blocks, so
+// a block goes back for reuse the moment it is released, no matter how old the blocks around it are.
+// Slabs are kept until the heap is destroyed, the heap only ever grows to the peak it had to serve.
+//
+
+class NET_API MessageSlabHeap
+{
+public:
+
+    enum
+    {
+        MinBlockShift	= 6,
+        SizeClassCount	= 12,
+        SlabSize		= 256 * 1024
+    };
+
+    MessageSlabHeap(void);
+    ~MessageSlabHeap(void);
+
+    // Returns a block of at least size bytes.
+    int8*				allocate(uint32 size);
+
+    // Hands a block back, size has to be the one it was allocated with.
+    void				release(int8* block, uint32 size);
+
+    static uint32		getSizeClass(uint32 size);
+    static uint32		getBlockSize(uint32 sizeClass) {
+        return 1 << (sizeClass + MinBlockShift);
+    }
+
+    // bytes of the blocks handed out and not released
+    uint32				getLiveBytes(void) const {
+        return mLiveBytesTotal;
+    }
+    uint32				getLiveBytes(uint32 sizeClass) const {
+        return mLiveBlocks[sizeClass] * getBlockSize(sizeClass);
+    }
+    uint32				getLiveBlocks(uint32 sizeClass) const {
+        return mLiveBlocks[sizeClass];
+    }
+    // bytes taken from the system for slabs
+    uint32				getReservedBytes(void) const {
+        return mReservedBytes;
+    }
+
+private:
+
+    struct FreeBlock
+    {
+        FreeBlock*	next;
+    };
+
+    void				_refill(uint32 sizeClass);
+
+    // Win32 complains about stl during linkage, disable the warning.
+#ifdef _WIN32
+#pragma warning (disable : 4251)
+#endif
+    std::vector<int8*>	mSlabs;
+    // Re-enable the warning.
+#ifdef _WIN32
+#pragma warning (default : 4251)
+#endif
+
+    FreeBlock*			mFreeLists[SizeClassCount];
+    uint32				mLiveBlocks[SizeClassCount];
+    uint32				mLiveBytesTotal;
+    uint32				mReservedBytes;
+};
+
+//======================================================================================================================
+
+#endif //ANH_NETWORKMANAGER_MESSAGESLABHEAP_H
+
@@ -48,6 +48,30 @@ NetConfig::NetConfig()
 
     mServerPacketWindow			= gConfig->read<int>("ServerPacketWindowSize",800);
     mClientPacketWindow			= gConfig->read<int>("ClientPacketWindowSize",80);
+
+    mSocketReadBatchSize		= gConfig->read<int>("SocketReadBatchSize",1);
+    if(mSocketReadBatchSize < 1)
+        mSocketReadBatchSize = 1;
+    if(mSocketReadBatchSize > 64)
+        mSocketReadBatchSize = 64;
+
+    mSocketWriteBatchSize		= gConfig->read<int>("SocketWriteBatchSize",1);
+    if(mSocketWriteBatchSize < 1)
+        mSocketWriteBatchSize = 1;
+    if(mSocketWriteBatchSize > 64)
+        mSocketWriteBatchSize = 64;
+
+    mSocketShardCount			= gConfig->read<int>("SocketShardCount",1);
+    if(mSocketShardCount < 1)
+        mSocketShardCount = 1;
+    if(mSocketShardCount > 16)
+        mSocketShardCount = 16;
+
+    //compression
+    mCompressionLevelServerServer		= gConfig->read<int>("CompressionLevelServerServer",-1);
+    mCompressionLevelServerClient		= gConfig->read<int>("CompressionLevelServerClient",-1);
+    mCompressionStrategyServerServer	= gConfig->read<int>("CompressionStrategyServerServer",0);
+    mCompressionStrategyServerClient	= gConfig->read<int>("CompressionStrategyServerClient",0);
     //mMaxBazaarListing = gConfig->read<int>("BazaarMaxListing",35);
 
 }
@@ -68,6 +68,27 @@ public:
     uint32	getClientPacketWindow() {
         return mClientPacketWindow;
     }
+    uint32	getSocketReadBatchSize() {
+        return mSocketReadBatchSize;
+    }
+    uint32	getSocketWriteBatchSize() {
+        return mSocketWriteBatchSize;
+    }
+    uint32	getSocketShardCount() {
+        return mSocketShardCount;
+    }
+    int32	getServerServerCompressionLevel() {
+        return mCompressionLevelServerServer;
+    }
+    int32	getServerClientCompressionLevel() {
+        return mCompressionLevelServerClient;
+    }
+    int32	getServerServerCompressionStrategy() {
+        return mCompressionStrategyServerServer;
+    }
+    int32	getServerClientCompressionStrategy() {
+        return mCompressionStrategyServerClient;
+    }
 
 private:
 
@@ -89,6 +110,21 @@ private:
 
     uint32					mServerPacketWindow;
     uint32					mClientPacketWindow;
+
+    //amount of datagrams the socket read thread drains per receive call (1 = one recvfrom per datagram)
+    uint32					mSocketReadBatchSize;
+
+    //amount of datagrams the socket write thread gathers per send call (1 = one sendto per datagram)
+    uint32					mSocketWriteBatchSize;
+
+    //amount of SO_REUSEPORT sockets (each with its own read/write thread) the client service listens on, linux only
+    uint32					mSocketShardCount;
+
+    //zlib level (-1 default, 0-9) and strategy (0 default, 1 filtered, 2 huffman only, 3 rle) of the outgoing packets
+    int32					mCompressionLevelServerServer;
+    int32					mCompressionLevelServerClient;
+    int32					mCompressionStrategyServerServer;
+    int32					mCompressionStrategyServerClient;
 };
 
 #endif
@@ -51,6 +51,14 @@ void NetworkClient::SendChannelAUnreliable(Message* message, uint8 priority)
     return mSession->SendChannelAUnreliable(message);
 }
 
+void NetworkClient::PostChannelA(Message* message, uint8 priority, bool fastpath)
+{
+    message->setPriority(priority);
+    message->setFastpath(fastpath);
+
+    return mSession->PostChannelA(message);
+}
+
 
 //======================================================================================================================
 void NetworkClient::Disconnect(uint8 reason)
@@ -70,6 +70,8 @@ public:
 
     virtual void	SendChannelA(Message* message, uint8 priority, bool fastpath);
     virtual void	SendChannelAUnreliable(Message* message, uint8 priority);
+    // SendChannelA for worker threads, safe to call from any thread
+    virtual void	PostChannelA(Message* message, uint8 priority, bool fastpath);
     virtual void	Disconnect(uint8 reason);
 
     Session*		getSession(void) {
@@ -0,0 +1,158 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "ReliableWindow.h"
+
+#include <cassert>
+
+#define WINDOW_INITIAL_CAPACITY	64
+
+//======================================================================================================================
+
+ReliableWindow::ReliableWindow(uint16 firstSequence) :
+    mSlots(WINDOW_INITIAL_CAPACITY, (Packet*)0),
+    mMask(WINDOW_INITIAL_CAPACITY - 1),
+    mCount(0),
+    mFrontSequence(firstSequence),
+    mSendSequence(firstSequence)
+{
+}
+
+//======================================================================================================================
+
+ReliableWindow::~ReliableWindow(void)
+{
+}
+
+//======================================================================================================================
+
+bool ReliableWindow::push(Packet* packet)
+{
+    if(mCount >= RELIABLE_WINDOW_MAX_COUNT)
+        return false;
+
+    if(mCount == mSlots.size())
+        _grow();
+
+    mSlots[getBackSequence() & mMask] = packet;
+    mCount++;
+
+    return true;
+}
+
+//======================================================================================================================
+
+Packet* ReliableWindow::popUnsent(void)
+{
+    if(!getUnsentCount())
+        return 0;
+
+    return mSlots[mSendSequence++ & mMask];
+}
+
+//======================================================================================================================
+
+uint32 ReliableWindow::getAckCount(uint16 sequence) const
+{
+    // Acks are cumulative, everything up to and including sequence got through. A duplicate ack for something we
+    // released already wraps around to a huge distance and so ends up out of bounds as well.
+    uint32 distance = (uint16)(sequence - mFrontSequence);
+
+    if(distance >= getSentCount())
+        return 0;
+
+    return distance + 1;
+}
+
+//======================================================================================================================
+
+uint32 ReliableWindow::getSentCountBefore(uint16 sequence) const
+{
+    uint32 distance	= (uint16)(sequence - mFrontSequence);
+    uint32 sent		= getSentCount();
+
+    // More than half the sequence space ahead means the sequence is behind our window, a stale report.
+    if(distance >= 0x8000)
+        return 0;
+
+    return (distance < sent) ? distance : sent;
+}
+
+//======================================================================================================================
+
+Packet* ReliableWindow::popFront(void)
+{
+    if(!mCount)
+        return 0;
+
+    uint32	index	= mFrontSequence & mMask;
+    Packet* packet	= mSlots[index];
+
+    mSlots[index] = 0;
+
+    // Anything popped that was never sent is dropped from the unsent part.
+    if(mSendSequence == mFrontSequence)
+        mSendSequence++;
+
+    mFrontSequence++;
+    mCount--;
+
+    return packet;
+}
+
+//======================================================================================================================
+
+Packet* ReliableWindow::getSent(uint32 offset) const
+{
+    if(offset >= getSentCount())
+        return 0;
+
+    return mSlots[(uint16)(mFrontSequence + offset) & mMask];
+}
+
+//======================================================================================================================
+
+void ReliableWindow::_grow(void)
+{
+    assert(mSlots.size() < RELIABLE_WINDOW_MAX_COUNT && "Reliable window exceeds its maximum");
+
+    std::vector<Packet*>	slots(mSlots.size() * 2, (Packet*)0);
+    uint32					mask = slots.size() - 1;
+
+    // Packets keep their sequence, only the index they map to changes with the mask.
+    for(uint32 i = 0; i < mCount; i++)
+    {
+        uint16 sequence = (uint16)(mFrontSequence + i);
+        slots[sequence & mask] = mSlots[sequence & mMask];
+    }
+
+    mSlots.swap(slots);
+    mMask = mask;
+}
+
+//======================================================================================================================
+
@@ -0,0 +1,138 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_NETWORKMANAGER_RELIABLEWINDOW_H
+#define ANH_NETWORKMANAGER_RELIABLEWINDOW_H
+
+#include "Utils/typedefs.h"
+
+#include "NetworkManager/declspec.h"
+
+#include <vector>
+
+
+//======================================================================================================================
+
+class Packet;
+
+//======================================================================================================================
+
+// The window never holds more than half the sequence space, past that a stale sequence could no longer be told apart
+// from one in the window.
+#define RELIABLE_WINDOW_MAX_COUNT	0x8000
+
+// Sessions stop building reliable packets at this count and leave the messages queued until acks make room. What is
+// left up to the maximum takes the fragments of the message being built when the limit is hit.
+#define RELIABLE_WINDOW_BUILD_LIMIT	0x7000
+
+//======================================================================================================================
+//
+// The reliable send window of a session.
+//
+// Packets are kept in a ring indexed by their 16 bit sequence, so looking up a sequence for an ack or a resend is a
+// mask and a load, and the sequence rollover from 0xffff to 0 is plain modular arithmetic.
+// The window is split in two parts, all counted from the oldest packet we still hold:
+//
+//   [front, send)  sent, waiting to be acknowledged
+//   [send, back)   built, not yet put on the wire
+//
+// The ring starts small and doubles when the window fills up, up to RELIABLE_WINDOW_MAX_COUNT slots.
+//
+
+class NET_API ReliableWindow
+{
+public:
+
+    ReliableWindow(uint16 firstSequence = 0);
+    ~ReliableWindow(void);
+
+    // Appends a freshly built packet, it gets the sequence getBackSequence() returned before the call.
+    // Returns false and leaves the packet to the caller when the window holds RELIABLE_WINDOW_MAX_COUNT packets.
+    bool				push(Packet* packet);
+
+    // Hands out the oldest packet not sent yet and moves it to the sent part, NULL if there is none.
+    Packet*				popUnsent(void);
+
+    // Returns how many sent packets an ack for sequence releases, 0 for duplicates and acks past what we sent.
+    uint32				getAckCount(uint16 sequence) const;
+
+    // Returns how many sent packets lie before sequence, the ones to resend for an out of order packet.
+    // Sequences behind the window count as stale and return 0.
+    uint32				getSentCountBefore(uint16 sequence) const;
+
+    // Removes and returns the oldest packet, NULL if the window is empty.
+    Packet*				popFront(void);
+
+    // Returns the sent packet offset places after the oldest one.
+    Packet*				getSent(uint32 offset) const;
+
+    uint32				getCount(void) const {
+        return mCount;
+    }
+    bool				isFull(void) const {
+        return mCount >= RELIABLE_WINDOW_BUILD_LIMIT;
+    }
+    uint32				getSentCount(void) const {
+        return (uint16)(mSendSequence - mFrontSequence);
+    }
+    uint32				getUnsentCount(void) const {
+        return mCount - getSentCount();
+    }
+    uint16				getFrontSequence(void) const {
+        return mFrontSequence;
+    }
+    uint16				getSendSequence(void) const {
+        return mSendSequence;
+    }
+    uint16				getBackSequence(void) const {
+        return (uint16)(mFrontSequence + mCount);
+    }
+
+private:
+
+    void				_grow(void);
+
+    // Win32 complains about stl during linkage, disable the warning.
+#ifdef _WIN32
+#pragma warning (disable : 4251)
+#endif
+    std::vector<Packet*>	mSlots;
+    // Re-enable the warning.
+#ifdef _WIN32
+#pragma warning (default : 4251)
+#endif
+
+    uint32					mMask;
+    uint32					mCount;
+    uint16					mFrontSequence;
+    uint16					mSendSequence;
+};
+
+//======================================================================================================================
+
+#endif //ANH_NETWORKMANAGER_RELIABLEWINDOW_H
+
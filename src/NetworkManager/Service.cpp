@@ -40,6 +40,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NetworkManager/Message.h"
 
 #include "Common/ConfigManager.h"
+#include "NetworkManager/NetConfig.h"
 #include "Utils/typedefs.h"
 
 #include <boost/thread/thread.hpp>
@@ -51,6 +52,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #else
 #include <sys/socket.h>
 #include <arpa/inet.h>
+#include <errno.h>
 
 #define INVALID_SOCKET	-1
 #define SOCKET_ERROR	-1
@@ -70,9 +72,6 @@ bool Service::mSocketsSubsystemInitComplete = false;
 
 Service::Service(NetworkManager* networkManager, bool serverservice, uint32 id, int8* localAddress, uint16 localPort,uint32 mfHeapSize) :
     mNetworkManager(networkManager),
-    mSocketReadThread(0),
-    mSocketWriteThread(0),
-    mLocalSocket(0),
     avgTime(0),
     avgPacketsbuild (0),
     mLocalAddress(0),
@@ -100,8 +99,93 @@ Service::Service(NetworkManager* networkManager, bool serverservice, uint32 id,
     }
 #endif //WIN32
 
+    // Only the client facing service gets sharded. Every shard binds its own socket to our port with SO_REUSEPORT,
+    // the kernel hashes the clients 4-tuple so a client always ends up on the same shard and thus the same session map.
+    uint32 shardCount = 1;
+
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX) && defined(SO_REUSEPORT)
+    if(!mServerService)
+        shardCount = gNetConfig->getSocketShardCount();
+#endif
+
+    for(uint32 i = 0; i < shardCount; i++)
+    {
+        SOCKET shardSocket = _openSocket(shardCount > 1);
+
+        // Create our read/write socket classes
+        SocketWriteThread* writeThread = new SocketWriteThread(shardSocket,this,mServerService);
+        SocketReadThread* readThread = new SocketReadThread(shardSocket, writeThread,this,mfHeapSize, mServerService);
+
+        mLocalSockets.push_back(shardSocket);
+        mSocketWriteThreads.push_back(writeThread);
+        mSocketReadThreads.push_back(readThread);
+    }
+
+    if(shardCount > 1)
+        gLogger->log(LogManager::INFORMATION, "Service %u listening with %u SO_REUSEPORT shards", mId, shardCount);
+
+    // Query the stack for the actual address and port we got and store it in the service.
+    //getsockname(mLocalSocket, (sockaddr*)&server, &serverLen);
+    //mLocalAddress = server.sin_addr.s_addr;
+    //mLocalPort = server.sin_port;
+    /*
+        // Reset the connect call to universe.
+        toAddr.sa_family = AF_INET;
+        *((uint32*)&toAddr.sa_data[2]) = 0;
+        *((uint16*)&(toAddr.sa_data[0])) = 0;
+        sent = connect(mLocalSocket, &toAddr, toLen);
+    */
+}
+
+//======================================================================================================================
+
+Service::~Service(void)
+{
+    Session* session = 0;
+
+    while(mSessionProcessQueue.size())
+    {
+        session = mSessionProcessQueue.pop();
+
+        if(session)
+        {
+            session->getSocketReadThread()->RemoveAndDestroySession(session);
+        }
+    }
+
+    for(uint32 i = 0; i < mLocalSockets.size(); i++)
+    {
+        delete mSocketWriteThreads[i];
+        delete mSocketReadThreads[i];
+
+        closesocket(mLocalSockets[i]);
+    }
+
+    mSocketWriteThreads.clear();
+    mSocketReadThreads.clear();
+    mLocalSockets.clear();
+
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+    WSACleanup();
+#endif
+}
+
+//======================================================================================================================
+
+SOCKET Service::_openSocket(bool reusePort)
+{
     // Create our socket descriptors
-    SOCKET mLocalSocket = socket(PF_INET, SOCK_DGRAM, 0);
+    SOCKET localSocket = socket(PF_INET, SOCK_DGRAM, 0);
+
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX) && defined(SO_REUSEPORT)
+    // Has to be set on every shard before it binds, otherwise the second bind fails with EADDRINUSE.
+    if(reusePort)
+    {
+        int reuse = 1;
+        if(setsockopt(localSocket, SOL_SOCKET, SO_REUSEPORT, (char*)&reuse, sizeof(reuse)) == SOCKET_ERROR)
+            gLogger->log(LogManager::CRITICAL, "Service %u: setting SO_REUSEPORT failed, errno %u", mId, errno);
+    }
+#endif
 
     // Bind to our listen port.
     sockaddr_in   server;
@@ -110,7 +194,7 @@ Service::Service(NetworkManager* networkManager, bool serverservice, uint32 id,
     server.sin_addr.s_addr = INADDR_ANY;
 
     // Attempt to bind to our socket
-    bind(mLocalSocket, (sockaddr*)&server, sizeof(server));
+    bind(localSocket, (sockaddr*)&server, sizeof(server));
 
     // We need to call connect on the socket to an address before we can know which address we have.
     // The address specified in the connect call determines which interface our socket is associated with
@@ -141,55 +225,13 @@ Service::Service(NetworkManager* networkManager, bool serverservice, uint32 id,
 
     value = configvalue *1024;
 
-    setsockopt(mLocalSocket,SOL_SOCKET,SO_RCVBUF,(char*)&value,valuelength);
+    setsockopt(localSocket,SOL_SOCKET,SO_RCVBUF,(char*)&value,valuelength);
 
     int temp = 1;
     //9 is IP_DONTFRAG (PK told me to put that here so we know wtf 9 means :P
-    setsockopt(mLocalSocket, IPPROTO_IP, 9, (char*)&temp, sizeof(temp));
-
-
-    // Create our read/write socket classes
-    mSocketWriteThread = new SocketWriteThread(mLocalSocket,this,mServerService);
-    mSocketReadThread = new SocketReadThread(mLocalSocket, mSocketWriteThread,this,mfHeapSize, mServerService);
-
-    // Query the stack for the actual address and port we got and store it in the service.
-    //getsockname(mLocalSocket, (sockaddr*)&server, &serverLen);
-    //mLocalAddress = server.sin_addr.s_addr;
-    //mLocalPort = server.sin_port;
-    /*
-        // Reset the connect call to universe.
-        toAddr.sa_family = AF_INET;
-        *((uint32*)&toAddr.sa_data[2]) = 0;
-        *((uint16*)&(toAddr.sa_data[0])) = 0;
-        sent = connect(mLocalSocket, &toAddr, toLen);
-    */
-}
-
-//======================================================================================================================
-
-Service::~Service(void)
-{
-    Session* session = 0;
-
-    while(mSessionProcessQueue.size())
-    {
-        session = mSessionProcessQueue.pop();
-
-        if(session)
-        {
-            mSocketReadThread->RemoveAndDestroySession(session);
-        }
-    }
+    setsockopt(localSocket, IPPROTO_IP, 9, (char*)&temp, sizeof(temp));
 
-    delete mSocketWriteThread;
-    delete mSocketReadThread;
-
-    closesocket(mLocalSocket);
-    mLocalSocket = INVALID_SOCKET;
-
-#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
-    WSACleanup();
-#endif
+    return localSocket;
 }
 
 //======================================================================================================================
@@ -259,7 +301,7 @@ void Service::Process()
         }
         else if(session->getStatus() == SSTAT_Destroy)
         {
-            mSocketReadThread->RemoveAndDestroySession(session);
+            session->getSocketReadThread()->RemoveAndDestroySession(session);
 
 
             continue;
@@ -312,14 +354,16 @@ void Service::Connect(NetworkClient* client, int8* address, uint16 port)
     // a queue/async connect method.  FIXME:  Make queue based, async using NetworkCallback for status changes.
 
     // We want this to be a blocking call for now, so loop waiting for change in session status from Connecting.
-    mSocketReadThread->NewOutgoingConnection(address, port);
+    // Outgoing connections always go through the first shard.
+    SocketReadThread* socketReadThread = mSocketReadThreads[0];
+    socketReadThread->NewOutgoingConnection(address, port);
 
     // don't want a hard loop pegging the cpu.
     while(1)
     {
-        if(mSocketReadThread->getNewConnectionInfo()->mSession)
+        if(socketReadThread->getNewConnectionInfo()->mSession)
         {
-            if(mSocketReadThread->getNewConnectionInfo()->mSession->getStatus() == SSTAT_Connected)
+            if(socketReadThread->getNewConnectionInfo()->mSession->getStatus() == SSTAT_Connected)
             {
                 break;
             }
@@ -328,8 +372,8 @@ void Service::Connect(NetworkClient* client, int8* address, uint16 port)
         boost::this_thread::sleep(boost::posix_time::milliseconds(10));
     }
 
-    client->setSession(mSocketReadThread->getNewConnectionInfo()->mSession);
-    mSocketReadThread->getNewConnectionInfo()->mSession->setClient(client);
+    client->setSession(socketReadThread->getNewConnectionInfo()->mSession);
+    socketReadThread->getNewConnectionInfo()->mSession->setClient(client);
 }
 
 //======================================================================================================================
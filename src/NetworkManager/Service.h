@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NetworkManager/declspec.h"
 
 #include <list>
+#include <vector>
 
 
 //======================================================================================================================
@@ -48,6 +49,9 @@ class NetworkCallback;
 
 typedef Anh_Utils::concurrent_queue<Session*>	SessionQueue;
 typedef std::list<NetworkCallback*>				NetworkCallbackList;
+typedef std::vector<SocketReadThread*>			SocketReadThreadList;
+typedef std::vector<SocketWriteThread*>			SocketWriteThreadList;
+typedef std::vector<SOCKET>						SocketList;
 
 //======================================================================================================================
 
@@ -85,9 +89,14 @@ public:
     bool	isQueued() {
         return mQueued;
     }
+    uint32	getShardCount() {
+        return (uint32)mLocalSockets.size();
+    }
 
 private:
 
+    SOCKET	_openSocket(bool reusePort);
+
     NetworkCallback*		mCallBack;
     //NetworkCallbackList		mNetworkCallbackList;
 
@@ -96,6 +105,11 @@ private:
 #pragma warning (disable : 4251)
 #endif
     SessionQueue			mSessionProcessQueue;
+
+    // One socket and read/write thread pair per shard, shard 0 also handles our outgoing connections.
+    SocketList				mLocalSockets;
+    SocketReadThreadList	mSocketReadThreads;
+    SocketWriteThreadList	mSocketWriteThreads;
     // Re-enable the warning.
 #ifdef _WIN32
 #pragma warning (default : 4251)
@@ -103,9 +117,6 @@ private:
 
     int8					mLocalAddressName[256];
     NetworkManager*			mNetworkManager;
-    SocketReadThread*		mSocketReadThread;
-    SocketWriteThread*		mSocketWriteThread;
-    SOCKET					mLocalSocket;
     uint64					avgTime;
     uint64					lasttime;
     uint32					avgPacketsbuild;
@@ -53,7 +53,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <algorithm>
 #include <stdio.h>
 
-
 //======================================================================================================================
 
 Session::Session(void) :
@@ -92,8 +91,6 @@ Session::Session(void) :
     mServerPacketsReceived(0),
     mOutSequenceNext(0),
     mInSequenceNext(0),
-    mOutSequenceRollover(false),
-    mNextPacketSequenceSent(0),
     mLastRemotePacketAckReceived(0),
     mWindowSizeCurrent(8000),
     mWindowResendSize(8000),
@@ -136,8 +133,6 @@ Session::~Session(void)
     gLogger->log(LogManager::DEBUG, "Session::~Session ",this->getId());
     Message* message = 0;
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
     while(!mOutgoingMessageQueue.empty())
     {
         message = mOutgoingMessageQueue.front();
@@ -168,6 +163,30 @@ Session::~Session(void)
         message->mSession = NULL;
     }
 
+    while(mWorkerMessageQueue.pop(message))
+    {
+        message->setPendingDelete(true);
+        message->mSession = NULL;
+    }
+
+    while(!mWorkerReliableQueue.empty())
+    {
+        message = mWorkerReliableQueue.front();
+        mWorkerReliableQueue.pop();
+
+        message->setPendingDelete(true);
+        message->mSession = NULL;
+    }
+
+    while(!mWorkerUnreliableQueue.empty())
+    {
+        message = mWorkerUnreliableQueue.front();
+        mWorkerUnreliableQueue.pop();
+
+        message->setPendingDelete(true);
+        message->mSession = NULL;
+    }
+
     while(!mMultiMessageQueue.empty())
     {
         message = mMultiMessageQueue.front();
@@ -210,57 +229,28 @@ Session::~Session(void)
         mOutOfOrderPackets.erase(ooopsIt++);
     }
 
-    PacketWindowList::iterator it = mNewWindowPacketList.begin();
-
-    while(it != mNewWindowPacketList.end())
-    {
-        savedPackets++;
-        Packet* packet = (*it);
-        mPacketFactory->DestroyPacket(packet);
-        mNewWindowPacketList.erase(it++);
-    }
-
-    it = mNewRolloverWindowPacketList.begin();
-
-    while(it != mNewRolloverWindowPacketList.end())
-    {
-        savedPackets++;
-        Packet* packet = (*it);
-        mPacketFactory->DestroyPacket(packet);
-        mNewRolloverWindowPacketList.erase(it++);
-    }
-
-    it = mWindowPacketList.begin();
-
-    while(it != mWindowPacketList.end())
+    while(Packet* packet = mReliableWindow.popFront())
     {
         savedPackets++;
-        Packet* packet = (*it);
         mPacketFactory->DestroyPacket(packet);
-        mWindowPacketList.erase(it++);
     }
 
-    it = mRolloverWindowPacketList.begin();
-
-    while(it != mRolloverWindowPacketList.end())
+    Packet* packet;
+    while(!mWindowControlQueue.empty())
     {
-        savedPackets++;
-        Packet* packet = (*it);
+        packet = mWindowControlQueue.front();
+        mWindowControlQueue.pop();
         mPacketFactory->DestroyPacket(packet);
-        mRolloverWindowPacketList.erase(it++);
     }
 
-    it = mNewWindowPacketList.begin();
-
-    while(it != mNewWindowPacketList.end())
+    while(!mReadThreadPacketQueue.empty())
     {
         savedPackets++;
-        Packet* packet = (*it);
+        packet = mReadThreadPacketQueue.front();
+        mReadThreadPacketQueue.pop();
         mPacketFactory->DestroyPacket(packet);
-        mNewWindowPacketList.erase(it++);
     }
 
-    Packet* packet;
     while(!mOutgoingReliablePacketQueue.empty())
     {
         savedPackets++;
@@ -303,8 +293,14 @@ void Session::ProcessWriteThread(void)
 
     uint64 wholeTime = packetBuildTime = packetBuildTimeStart = now;
 
+    // apply the acks and resend requests the read thread received before we look at the window
+    _processReadThreadPackets();
+
+    _processWorkerMessages();
+
     //only process when we are busy - we dont need to iterate through possible resends all the time
-    if((!mUnreliableMessageQueue.size())&&(!mOutgoingMessageQueue.size()) && (!mNewWindowPacketList.size()))
+    if((!mUnreliableMessageQueue.size())&&(!mOutgoingMessageQueue.size()) && (!mReliableWindow.getUnsentCount())
+            && mWorkerReliableQueue.empty() && mWorkerUnreliableQueue.empty())
     {
         if(!mSendDelayedAck)
         {
@@ -351,13 +347,16 @@ void Session::ProcessWriteThread(void)
     uint32 pUnreliableBuild = 0;
 
     //build reliable packets dont use timeGetTime ... -its expensive
-    while((pBuild < 100) && mOutgoingMessageQueue.size())
+    //a client that stops acking fills the window, the messages then wait in the queue until acks make room again
+    while((pBuild < 100) && mOutgoingMessageQueue.size() && !mReliableWindow.isFull())
     {
-        pBuild += _buildPackets();
+        pBuild += _buildPackets(mOutgoingMessageQueue);
     }
 
-    uint32 resendPackets = 0;
-
+    while((pBuild < 100) && mWorkerReliableQueue.size() && !mReliableWindow.isFull())
+    {
+        pBuild += _buildPackets(mWorkerReliableQueue);
+    }
 
     //build unreliable packets
     while((pUnreliableBuild < 100) && mUnreliableMessageQueue.size())
@@ -366,92 +365,31 @@ void Session::ProcessWriteThread(void)
         //this way they get lost when we have lag but thats not exactly a hughe problem
         //and we dont get problems with our window list filled with unreliables
         //which never get acked
-        pUnreliableBuild += _buildPacketsUnreliable();
+        pUnreliableBuild += _buildPacketsUnreliable(mUnreliableMessageQueue);
     }
 
-    // Now check to see if we can send any more reliable packets out the wire yet.  NOT optimized
-    PacketWindowList::iterator	iter;
-    PacketWindowList::iterator	iterRoll;
-
-    Packet*						windowPacket	= NULL;
-    uint32						packetsSent		= 0;
-
-    //Rollover happens when our sequence reaches 65535
-    //the old (< sequence = 0)packets go in the rolloverqueue and wait for being send and/or acknowledged and then deleted
-    if(mOutSequenceRollover)
+    while((pUnreliableBuild < 100) && mWorkerUnreliableQueue.size())
     {
-        boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
-        iterRoll = mRolloverWindowPacketList.begin();
-
-        //the list contains all packets those already send / resend and those not already send are in the back
-        //this means we always iterate through the oldest packets first until we get to the new packets
-        //up to the point that our packetwindowsize of packets is send
-
-        //it will make sense to use a separate list for already send packets as we do not want to iterate constantly through
-        //old but not yet acknowledged packets - this doesnt seem to be a problem though
-
-
-        iterRoll = mNewRolloverWindowPacketList.begin();
-
-        while(iterRoll != mNewRolloverWindowPacketList.end())
-        {
-
-            windowPacket = *iterRoll;
-            windowPacket->setReadIndex(2);
-            uint16 sequence = ntohs(windowPacket->getUint16());
-
-
-            // If we've sent our mWindowSizeCurrent of packets, break out and wait for some acks.
-            // make sure we send at least a minimum as we dont want any stalling
-            if (packetsSent >= mWindowSizeCurrent)
-                break;
-
-            _addOutgoingReliablePacket(windowPacket);
-            iterRoll = mNewRolloverWindowPacketList.erase(iterRoll);
-            mRolloverWindowPacketList.push_back(windowPacket);
-            packetsSent++;
-
-            mNextPacketSequenceSent++;
-        }
+        pUnreliableBuild += _buildPacketsUnreliable(mWorkerUnreliableQueue);
     }
 
-    resendPackets = 0;
-
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
-    //WindowPacketList is our current window of send and not yet acknowledged packets
-    //A Rollover might still be in existance
-
-    iter = mNewWindowPacketList.begin();
+    // Now check to see if we can send any more reliable packets out the wire yet.
+    Packet*						windowPacket	= NULL;
+    uint32						packetsSent		= 0;
 
-    //mNewWindoPacketList has the not yet send Packets
-    while(iter != mNewWindowPacketList.end())
+    //the window hands out the built but not yet send packets in sequence order, they stay in the window
+    //until they are acknowledged. A sequence rollover needs no special handling there
+    while(packetsSent < mWindowSizeCurrent)
     {
+        windowPacket = mReliableWindow.popUnsent();
 
-        windowPacket = *iter;
-        //windowPacket->setReadIndex(2);
-        //uint16 sequence = ntohs(windowPacket->getUint16());
-
-        // If we've sent our mWindowSizeCurrent of packets, break out and wait for some acks.
-        // make sure we send at least a minimum as we dont wont any stalling
-        if (packetsSent >= mWindowSizeCurrent)
+        if(!windowPacket)
             break;
 
         _addOutgoingReliablePacket(windowPacket);
-
-        //mWindoPacketList has the already send but not yet acknowledged Packets
-        mWindowPacketList.push_back(windowPacket);
         packetsSent++;
-
-        ++mNextPacketSequenceSent;
-
-        mNewWindowPacketList.erase(iter++);
-
     }
 
-    lk.unlock();
-
     // Handle any specific commands
     switch (mCommand)
     {
@@ -522,8 +460,6 @@ void Session::SendChannelA(Message* message)
         return;
     }
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
     //the connectionserver puts a lot of fastpaths here  - so just put them were they belong
     //this alone takes roughly 5% cpu off of the connectionserver
 
@@ -534,6 +470,8 @@ void Session::SendChannelA(Message* message)
         message->setFastpath(false);	  //send it as reliable if its to big
         mOutgoingMessageQueue.push(message);
     }
+
+    mSocketWriteThread->Wakeup();
 }
 
 void Session::SendChannelAUnreliable(Message* message)
@@ -547,7 +485,6 @@ void Session::SendChannelAUnreliable(Message* message)
         return;
     }
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
     if(message->getSize() > mMaxUnreliableSize)	//I send the attribute messages as unreliables	 but they can be to big!!
     {
         message->setFastpath(false);	  //send it as reliable if its to big
@@ -555,6 +492,27 @@ void Session::SendChannelAUnreliable(Message* message)
     }
     else
         mUnreliableMessageQueue.push(message);
+
+    mSocketWriteThread->Wakeup();
+}
+
+//======================================================================================================================
+// the outgoing message queues take a single producer, posted messages go through a queue of their own which
+// the write thread sorts into reliables and unreliables like SendChannelA does
+
+void Session::PostChannelA(Message* message)
+{
+    message->mSession = this;
+
+    if(mStatus != SSTAT_Connected)
+    {
+        message->setPendingDelete(true);
+        return;
+    }
+
+    mWorkerMessageQueue.push(message);
+
+    mSocketWriteThread->Wakeup();
 }
 
 
@@ -650,17 +608,13 @@ void Session::HandleSessionPacket(Packet* packet)
         return;
     }
 
+    // The window belongs to the write thread, it resends what the remote side misses
     case SESSIONOP_DataOrder1:
+    case SESSIONOP_DataOrder2:
     case SESSIONOP_DataOrder3:
     case SESSIONOP_DataOrder4:
     {
-        _processDataOrderPacket(packet);
-        return;
-    }
-
-    case SESSIONOP_DataOrder2:
-    {
-        _processDataOrderChannelB(packet);
+        _postWindowControlPacket(packet);
         return;
     }
 
@@ -688,7 +642,7 @@ void Session::HandleSessionPacket(Packet* packet)
     case SESSIONOP_DataAck3:
     case SESSIONOP_DataAck4:
     {
-        _processDataChannelAck(packet);
+        _postWindowControlPacket(packet);
         return;
     }
 
@@ -787,7 +741,7 @@ void Session::HandleSessionPacket(Packet* packet)
             orderPacket->setIsCompressed(false);
             orderPacket->setIsEncrypted(true);
 
-            _addOutgoingUnreliablePacket(orderPacket);
+            _postOutgoingUnreliablePacket(orderPacket);
 
 
         }
@@ -804,7 +758,7 @@ void Session::HandleSessionPacket(Packet* packet)
             orderPacket->setIsCompressed(false);
             orderPacket->setIsEncrypted(true);
 
-            _addOutgoingUnreliablePacket(orderPacket);
+            _postOutgoingUnreliablePacket(orderPacket);
 
         }
         break;
@@ -820,7 +774,7 @@ void Session::HandleSessionPacket(Packet* packet)
             orderPacket->setIsCompressed(false);
             orderPacket->setIsEncrypted(true);
 
-            _addOutgoingUnreliablePacket(orderPacket);
+            _postOutgoingUnreliablePacket(orderPacket);
 
             //mPacketFactory->DestroyPacket(packet);
             return;
@@ -946,13 +900,9 @@ Packet* Session::getOutgoingReliablePacket(void)
     mServerPacketsSent++;
 
     // Get a new Outgoing packet
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
     packet =  mOutgoingReliablePacketQueue.front();
     mOutgoingReliablePacketQueue.pop();
 
-    lk.unlock();
-
     mLastPacketSent = Anh_Utils::Clock::getSingleton()->getStoredTime();
 
     return packet;
@@ -970,13 +920,9 @@ Packet* Session::getOutgoingUnreliablePacket(void)
     mServerPacketsSent++;
 
     // Get a new Outgoing packet
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
     packet =  mOutgoingUnreliablePacketQueue.front();
     mOutgoingUnreliablePacketQueue.pop();
 
-    lk.unlock();
-
     mLastPacketSent = Anh_Utils::Clock::getSingleton()->getStoredTime();
 
     return packet;
@@ -989,11 +935,9 @@ Message* Session::getIncomingQueueMessage()
     Message* message = 0;
 
 
-    if (!mIncomingMessageQueue.size())
+    if (mIncomingMessageQueue.empty())
         return message;
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
     message = mIncomingMessageQueue.front();
     mIncomingMessageQueue.pop();
 
@@ -1033,7 +977,7 @@ void Session::_processSessionRequestPacket(Packet* packet)
     mStatus = SSTAT_Connecting;
 
     // Push the packet on our outgoing queue
-    _addOutgoingUnreliablePacket(newPacket);
+    _postOutgoingUnreliablePacket(newPacket);
     mService->AddSessionToProcessQueue(this);
 
     // Destroy our incoming packet, it's not needed any longer.
@@ -1306,169 +1250,35 @@ void Session::_processDataChannelB(Packet* packet)
 //======================================================================================================================
 void Session::_processDataChannelAck(Packet* packet)
 {
-    uint32 oldsize = mWindowSizeCurrent;
-
-    Packet* windowPacket = 0;
-    uint16 windowPacketSequence = 0;
-    PacketWindowList::iterator iter;
-    PacketWindowList::iterator itN;
-
     // Get the sequence off our incoming packet
     packet->setReadIndex(2);  //skip the header
     uint16 sequence = ntohs(packet->getUint16());
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-    uint32 pDel = 0;
-
-    // If our windowQueue is empty, this is a dupe ack for the last packet that was on it.  Just return.
-    if(mOutSequenceRollover)
-    {
-        if((!mRolloverWindowPacketList.size()) && (!mNewRolloverWindowPacketList.size()))
-        {
-            mOutSequenceRollover = false;
-        }
-        // this is an ack for the new queue	 so the old queue can go completely
-        else if((sequence < (0xFFFF - (mRolloverWindowPacketList.size()+mNewRolloverWindowPacketList.size()))))
-        {
-
-            gLogger->log(LogManager::DEBUG,"Data Channel Ack Rollover complete. Windowsize %u ack seq new queue %u",mWindowSizeCurrent,sequence);
-            mLastRemotePacketAckReceived = Anh_Utils::Clock::getSingleton()->getLocalTime();
-
-            mOutSequenceRollover = false;
-            iter = mRolloverWindowPacketList.begin();
-
-            //now that communication is reestablished we can resize our window again
-            if(mWindowSizeCurrent < mWindowResendSize)
-            {
-                mWindowSizeCurrent += uint32(mWindowResendSize/10);
-                if(mWindowSizeCurrent >mWindowResendSize)
-                    mWindowSizeCurrent = mWindowResendSize;
-            }
-            //destroy them now they are acknowleged
-            //they dont have to be resend
-            while(iter != mRolloverWindowPacketList.end())
-            {
-                pDel ++;
-                mPacketFactory->DestroyPacket(*iter);
-                mRolloverWindowPacketList.erase(iter);
-                iter = mRolloverWindowPacketList.begin();
-
-
-            }
-        }
-        else//else if(sequence < 0xFFFF - mRolloverWindowPacketList.size()) thats an ack purely for the old list
-        {
-            //only parts of the old queue can go
-            iter = mRolloverWindowPacketList.begin();
-            windowPacket = *iter;
-            windowPacket->setReadIndex(2);
-            windowPacketSequence = ntohs(windowPacket->getUint16());
-
-            if(sequence < windowPacketSequence)
-            {
-            }
-            else
-            {
-
-                // This is a proper ack, so handle it.
-                if(mWindowSizeCurrent < mWindowResendSize)
-                {
-                    // I dont go with a set window of packets in our queues here as I think
-                    // that the servers (especially the zones) need to keep on sending
-                    // especially when loads of players log on to one zone in this situation we get easily a few thousand to tenthsnd messages
-                    // in a short time
-                    mWindowSizeCurrent += uint32(mWindowResendSize/10);
-                    if(mWindowSizeCurrent >mWindowResendSize)
-                        mWindowSizeCurrent = mWindowResendSize;
-                }
-                while(sequence >= windowPacketSequence)
-                {
-                    pDel ++;
-                    mPacketFactory->DestroyPacket(*iter);
-                    mRolloverWindowPacketList.erase(iter);
-
-                    // If the list is empty, break out
-                    if(mRolloverWindowPacketList.size() == 0)
-                    {
-                        gLogger->log(LogManager::DEBUG,"Data Channel Ack: Rollover complete Windowsize %u ack seq %u", mWindowSizeCurrent,sequence);
-                        windowPacket = 0;
-                        windowPacketSequence = 0;
-
-                        if(mNewRolloverWindowPacketList.size() == 0)
-                            mOutSequenceRollover = false;
-
-                        break;
-                    }
-
-                    iter = mRolloverWindowPacketList.begin();
-                    windowPacket = *iter;
-                    windowPacket->setReadIndex(2);
-                    windowPacketSequence = ntohs(windowPacket->getUint16());
-                }//while(sequence >= windowPacketSequence)
-
-                mLastRemotePacketAckReceived = Anh_Utils::Clock::getSingleton()->getStoredTime();
-
-                // Our current window increases here, as we know come communication is back.
-
-            }//if(sequence < windowPacketSequence)
+    // Acks are cumulative, duplicates and acks for packets we never sent come back as 0
+    uint32 ackCount = mReliableWindow.getAckCount(sequence);
 
-            mPacketFactory->DestroyPacket(packet);
-            gLogger->log(LogManager::DEBUG, "Data Channel Ack::Rollover Ack Windowsize %u ack seq new queue %u",mWindowSizeCurrent,sequence);
-
-            return;
-        }//else if(sequence < 0xFFFF - mRolloverWindowPacketList.size())
-    }	   //if the rollover was gone completely we continue with the regular list
-
-    if (mWindowPacketList.size() == 0)
-    {
-        //gLogger->log(LogManager::DEBUG,"Dupe ACK received - Nothing in resend window - seq: %u, Session:0x%x%.4x", sequence, mService->getId(), getId());
-        mPacketFactory->DestroyPacket(packet);
-        return;
-    }
-
-    iter = mWindowPacketList.begin();
-    windowPacket = *iter;
-    windowPacket->setReadIndex(2); //skip the header
-    windowPacketSequence = ntohs(windowPacket->getUint16());
-
-    if (sequence < windowPacketSequence)
-    {
-        // Dpulicate ack, drop it.
-        //gLogger->log(LogManager::DEBUG, "Dupe ACK received - No such packet in window - ackSeq: %u, expect: %u, Session:0x%x%.4x", sequence, windowPacketSequence, mService->getId(), getId());
-    }
-    else if (sequence > windowPacketSequence + mWindowPacketList.size())
-    {
-        // This ack is way out of bounds, log a message and drop it.
-        //gLogger->log(LogManager::DEBUG, "DataChannelAck:  Ack out of bounds - ackSeq: %u, expect: %u, Session:0x%x%.4x", sequence, windowPacketSequence, mService->getId(), getId());
-    }
-    else
+    if(ackCount)
     {
         // This is a proper ack, so handle it.
         if(mWindowSizeCurrent < mWindowResendSize)
         {
+            // I dont go with a set window of packets in our queues here as I think
+            // that the servers (especially the zones) need to keep on sending
+            // especially when loads of players log on to one zone in this situation we get easily a few thousand to tenthsnd messages
+            // in a short time
             mWindowSizeCurrent += uint32(mWindowResendSize/10);
             if(mWindowSizeCurrent >mWindowResendSize)
                 mWindowSizeCurrent = mWindowResendSize;
         }
 
-        while (sequence >= windowPacketSequence)
+        //destroy them now they are acknowleged
+        //they dont have to be resend
+        for(uint32 i = 0; i < ackCount; i++)
         {
-            pDel ++;
-            mPacketFactory->DestroyPacket(*iter);
-            mWindowPacketList.erase(iter);
-
-            // If the window is empty, break out
-            if (mWindowPacketList.size() == 0)
-                break;
-
-            iter = mWindowPacketList.begin();
-            windowPacket = *iter;
-            windowPacket->setReadIndex(2); //skip the header
-            windowPacketSequence = ntohs(windowPacket->getUint16());
+            mPacketFactory->DestroyPacket(mReliableWindow.popFront());
         }
 
         mLastRemotePacketAckReceived = Anh_Utils::Clock::getSingleton()->getStoredTime();
-
     }
 
     // Destroy our incoming packet, it's not needed any longer.
@@ -1480,103 +1290,44 @@ void Session::_processDataChannelAck(Packet* packet)
 void Session::_processDataOrderPacket(Packet* packet)
 {
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex); // mRolloverWindowPacketList and WindowPacketList get accessed by the socketwritethread and by the socketreadthread both through the session
-
     packet->setReadIndex(2);
     uint16 sequence = ntohs(packet->getUint16());
 
-    PacketWindowList::iterator	iter			= mWindowPacketList.begin();
-    PacketWindowList::iterator	iterRoll = mRolloverWindowPacketList.begin();
-
-    // If the window packet list is empty just bail out now.
-    if (iter == mWindowPacketList.end()) {
+    // If we have nothing on the wire just bail out now.
+    if (!mReliableWindow.getSentCount())
+    {
+        mPacketFactory->DestroyPacket(packet);
         return;
     }
 
-    Packet*						windowPacket	= *iter;
-
-
-    windowPacket->setReadIndex(2);
-    uint16 windowSequence = ntohs(windowPacket->getUint16());
-
+    uint16 windowSequence = mReliableWindow.getFrontSequence();
 
     gLogger->log(LogManager::WARNING, "Out-Of-order packet session 0x%x%.4x seq: %u, windowsequ : %u", mService->getId(), mId, sequence, windowSequence);
 
-    //Do some bounds checking
-    if (sequence < windowSequence)
-    {
-        gLogger->log(LogManager::WARNING,"Out-Of-Order packet sequence too small, may be a duplicate or we handled our acks wrong.  seq: %u, expect >: %u", sequence, windowSequence);
-
-    }
-
-    if (sequence > windowSequence + mWindowPacketList.size())
-    {
-        gLogger->log(LogManager::WARNING, "Rollover Out-Of-Order packet  seq: %u, expect >: %u", sequence, windowSequence);
-
-        return;
-    }
+    //the remote received sequence, so everything we sent before it got lost
+    uint32 resendCount = mReliableWindow.getSentCountBefore(sequence);
 
-    //The location of the packetsequence out of order has NOBEARING on the question on which list we will find the last properly received Packet!!!
-    if(mRolloverWindowPacketList.size()&& (sequence > (65535-mRolloverWindowPacketList.size())))
+    if(!resendCount)
     {
-        //jupp its on the rolloverlist
-
-        uint16 count = 0;
-        for (iterRoll = mRolloverWindowPacketList.begin(); iterRoll != mRolloverWindowPacketList.end(); iterRoll++)
-        {
-            // Grab our window packet
-            windowPacket = (*iterRoll);
-            windowPacket->setReadIndex(2);
-            uint16 windowRollSequence = ntohs(windowPacket->getUint16());
-
-            // If it's smaller than the order packet send it, otherwise break;
-            if (windowRollSequence < sequence )
-            {
-
-                if(Anh_Utils::Clock::getSingleton()->getLocalTime() - windowPacket->getTimeOOHSent() < 200)
-                    break;
-
-                _addOutgoingReliablePacket(windowPacket);
-
-                windowPacket->setTimeOOHSent(Anh_Utils::Clock::getSingleton()->getLocalTime());
-
-                if (mWindowSizeCurrent > (mWindowResendSize/10))
-                    mWindowSizeCurrent--;
-
-            }
-        }
+        gLogger->log(LogManager::WARNING,"Out-Of-Order packet sequence out of our window, may be a duplicate or we handled our acks wrong.  seq: %u, expect >: %u", sequence, windowSequence);
     }
 
-    uint16 count = 0;
     uint64 localTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
-    for (iter = mWindowPacketList.begin(); iter != mWindowPacketList.end(); iter++)
-    {
-        // Grab our window packet
-        windowPacket = (*iter);
-        windowPacket->setReadIndex(2);
-        uint16 windowSequence = ntohs(windowPacket->getUint16());
 
-        // If it's smaller than the order packet send it, otherwise break;
-        // do we want to throttle the amount of packets being send to 10 or 50 or 100 ???
-        // if we receive a sequence on the rolloverlist (65530 for example) we will
-        // always send ALL packets on the regular list -
+    for(uint32 i = 0; i < resendCount; i++)
+    {
+        Packet* windowPacket = mReliableWindow.getSent(i);
 
         //make sure we do not spam the connection needlessly with packets
-        if(localTime - windowPacket->getTimeOOHSent() > 10)
-        {
-            _addOutgoingReliablePacket(windowPacket);
+        if(localTime - windowPacket->getTimeOOHSent() <= 10)
+            break;
 
-            windowPacket->setTimeOOHSent(localTime);
+        _addOutgoingReliablePacket(windowPacket);
 
-            if (mWindowSizeCurrent > (mWindowResendSize/10))
-                mWindowSizeCurrent--;
+        windowPacket->setTimeOOHSent(localTime);
 
-        }
-        else
-        {
-            mPacketFactory->DestroyPacket(packet);
-            return;
-        }
+        if (mWindowSizeCurrent > (mWindowResendSize/10))
+            mWindowSizeCurrent--;
     }
 
     // Destroy our incoming packet, it's not needed any longer.
@@ -1593,30 +1344,18 @@ void Session::_processDataOrderPacket(Packet* packet)
 void Session::_resendData()
 {
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex); // mRolloverWindowPacketList and WindowPacketList get accessed by the socketwritethread and by the socketreadthread both through the session
-
-    PacketWindowList::iterator	iter			= mWindowPacketList.begin();
-    PacketWindowList::iterator	iterRoll = mRolloverWindowPacketList.begin();
-
-    Packet*		windowPacket;
-
-    // If the window packet list is empty just bail out now.
-    if (mWindowPacketList.size() == 0)
-    {
-        return;
-    }
+    uint32 sentCount = mReliableWindow.getSentCount();
 
     uint64 localTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
     uint64 waitTime = 0;
     uint64 oooTime = 0;
-    uint32 packetsSend = 0;
 
-    for (iterRoll = mRolloverWindowPacketList.begin(); iterRoll != mRolloverWindowPacketList.end(); iterRoll++)
+    //oldest packets first, stop at the first one that is still fresh
+    for(uint32 i = 0; i < sentCount; i++)
     {
         // Grab our window packet
-        windowPacket = (*iterRoll);
+        Packet* windowPacket = mReliableWindow.getSent(i);
 
-        // If it's smaller than the order packet send it, otherwise break;
         if(windowPacket->getTimeSent() == 0)
             return;
 
@@ -1627,152 +1366,58 @@ void Session::_resendData()
         {
             windowPacket->setTimeOOHSent(localTime);
             _addOutgoingReliablePacket(windowPacket);
-            packetsSend++;
-        }
-        else
-        {
-            //gLogger->log(LogManager::WARNING, "_resendData WaitTime : %I64u; Packets send %u", waitTime, packetsSend);
-            return;
-        }
-    }
-
-    localTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
-    for (iter = mWindowPacketList.begin(); iter != mWindowPacketList.end(); iter++)
-    {
-
-        // Grab our window packet
-        windowPacket = (*iter);
-
-        if(windowPacket->getTimeSent() == 0)
-            return;
-
-        waitTime = localTime - windowPacket->getTimeSent();
-        oooTime = localTime - windowPacket->getTimeOOHSent();
-        if((waitTime> 700)&&(oooTime > 700))
-            //if(waitTime> 700)
-        {
-            windowPacket->setTimeOOHSent(localTime);
-            _addOutgoingReliablePacket(windowPacket);
-            packetsSend++;
         }
         else
         {
-            //gLogger->log(LogManager::WARNING, "_resendData WaitTime : %I64u; Packets send %u", waitTime, packetsSend);
             return;
         }
     }
-
-    //gLogger->log(LogManager::WARNING, "_resendData WaitTime : %I64u; Packets send %u", waitTime, packetsSend);
 }
 
 
 //======================================================================================================================
 void Session::_processDataOrderChannelB(Packet* packet)
 {
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);//
-
     packet->setReadIndex(2);
     uint16 sequence = ntohs(packet->getUint16());
     uint16 bottomSequence = ntohs(packet->getUint16());
 
-    if(!mWindowPacketList.size())
+    if(!mReliableWindow.getSentCount())
     {
         mPacketFactory->DestroyPacket(packet);
         return;
     }
 
-    PacketWindowList::iterator iter = mWindowPacketList.begin();
-    PacketWindowList::iterator iterRoll = mRolloverWindowPacketList.begin();
-
-    Packet* windowPacket = *iter;
-    windowPacket->setReadIndex(2);
-    uint16 windowSequence = ntohs(windowPacket->getUint16());
-
+    uint16 windowSequence = mReliableWindow.getFrontSequence();
 
     gLogger->log(LogManager::WARNING, "Out-Of-order packet session 0x%x%.4x seq: %u, windowsequ : %u", mService->getId(), mId, sequence, windowSequence);
 
-    //Do some bounds checking
-    if (sequence < windowSequence)
-    {
-        gLogger->log(LogManager::WARNING,"Out-Of-Order packet sequence too small, may be a duplicate or we handled our acks wrong.  seq: %u, expect >: %u", sequence, windowSequence);
-    }
-
-    if (sequence > windowSequence + mWindowPacketList.size())
-    {
-        gLogger->log(LogManager::WARNING, "Rollover Out-Of-Order packet  seq: %u, expect >: %u", sequence, windowSequence);
-    }
-
-    //The location of the packetsequence out of order has NOBEARING on the question on which list we will find the last properly received Packet!!!
+    //resend what we sent in [bottomSequence, sequence)
+    uint32 resendCount	= mReliableWindow.getSentCountBefore(sequence);
+    uint32 first		= mReliableWindow.getSentCountBefore(bottomSequence);
 
-
-    if(mRolloverWindowPacketList.size()&& (sequence > (65535-mRolloverWindowPacketList.size())))
+    if(!resendCount)
     {
-        //jupp its on the rolloverlist
-        //mRolloverWindowPacketList and WindowPacketList get accessed by the socketwritethread and by the socketreadthread both through the session
-
-        uint16 count = 0;
-        for (iterRoll = mRolloverWindowPacketList.begin(); iterRoll != mWindowPacketList.end(); iterRoll++)
-        {
-            // Grab our window packet
-            windowPacket = (*iterRoll);
-            windowPacket->setReadIndex(2);
-            uint16 windowRollSequence = ntohs(windowPacket->getUint16());
-
-            // If it's smaller than the order packet send it, otherwise break;
-            if ((windowRollSequence < sequence) && (windowRollSequence >= bottomSequence))
-            {
-                //count++;
-                //if(count > 50)
-                //	break;
-
-                if(Anh_Utils::Clock::getSingleton()->getLocalTime() - windowPacket->getTimeOOHSent() < 200)
-                    break;
-
-                _addOutgoingReliablePacket(windowPacket);
-
-                windowPacket->setTimeOOHSent(Anh_Utils::Clock::getSingleton()->getLocalTime());
-
-                if (mWindowSizeCurrent > (mWindowResendSize/10))
-                    mWindowSizeCurrent--;
-
-            }
-        }
-
+        gLogger->log(LogManager::WARNING,"Out-Of-Order packet sequence out of our window, may be a duplicate or we handled our acks wrong.  seq: %u, expect >: %u", sequence, windowSequence);
     }
 
-    uint16 count = 0;
     uint64 localTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
-    for (iter = mWindowPacketList.begin(); iter != mWindowPacketList.end(); iter++)
+
+    for(uint32 i = first; i < resendCount; i++)
     {
-        // boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-        // Grab our window packet
-        windowPacket = (*iter);
-        windowPacket->setReadIndex(2);
-        uint16 windowSequence = ntohs(windowPacket->getUint16());
-
-        // If it's smaller than the order packet send it, otherwise break;
-        // do we want to throttle the amount of packets being send to 10 or 50 or 100 ???
-        // if we receive a sequence on the rolloverlist (65530 for example) we will
-        // always send ALL packets on the regular list - I dont anticipate a big deal here though!!!
-        if((windowPacket->getTimeOOHSent() == 0) || (localTime - windowPacket->getTimeOOHSent() > 200))
-        {
+        Packet* windowPacket = mReliableWindow.getSent(i);
 
-            _addOutgoingReliablePacket(windowPacket);
+        if((windowPacket->getTimeOOHSent() != 0) && (localTime - windowPacket->getTimeOOHSent() <= 200))
+            break;
 
-            windowPacket->setTimeOOHSent(Anh_Utils::Clock::getSingleton()->getLocalTime());
+        _addOutgoingReliablePacket(windowPacket);
 
-            if (mWindowSizeCurrent > (mWindowResendSize/10))
-                mWindowSizeCurrent--;
+        windowPacket->setTimeOOHSent(localTime);
 
-        }
-        else
-        {
-            mPacketFactory->DestroyPacket(packet);
-            return;
-        }
+        if (mWindowSizeCurrent > (mWindowResendSize/10))
+            mWindowSizeCurrent--;
     }
 
-
     // Destroy our incoming packet, it's not needed any longer.
     mPacketFactory->DestroyPacket(packet);
 }
@@ -2061,7 +1706,7 @@ void Session::_processPingPacket(Packet* packet)
         newPacket->setIsEncrypted(true);
 
         // Push the packet on our outgoing queue
-        _addOutgoingUnreliablePacket(newPacket);
+        _postOutgoingUnreliablePacket(newPacket);
         mLastPingPacketSent = Anh_Utils::Clock::getSingleton()->getStoredTime();
     }
     // Backend servers are larger to incorporate more features, 9 bytes(packet size).
@@ -2080,7 +1725,7 @@ void Session::_processPingPacket(Packet* packet)
             newPacket->setIsEncrypted(true);
 
             // Push the packet on our outgoing queue
-            _addOutgoingUnreliablePacket(newPacket);
+            _postOutgoingUnreliablePacket(newPacket);
             mLastPingPacketSent = Anh_Utils::Clock::getSingleton()->getStoredTime();
         }
     }
@@ -2130,7 +1775,7 @@ void Session::_processNetStatRequestPacket(Packet* packet)
     newPacket->setIsEncrypted(true);
 
     // Push the packet on our outgoing queue
-    _addOutgoingUnreliablePacket(newPacket);
+    _postOutgoingUnreliablePacket(newPacket);
 
     // Destroy our incoming packet, it's not needed any longer.
     mPacketFactory->DestroyPacket(packet);
@@ -2241,12 +1886,8 @@ void Session::_addIncomingMessage(Message* message, uint8 priority)
     // simple bounds checking
     //assert(priority < 0x10);
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
     mIncomingMessageQueue.push(message);
 
-    lk.unlock();
-
     // Let the service know we need to be processed.
     mService->AddSessionToProcessQueue(this);
 }
@@ -2292,14 +1933,9 @@ void Session::_buildOutgoingReliableRoutedPackets(Message* message)
         newPacket->setIsEncrypted(true);
 
         // Push the packet on our outgoing queue
-        boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
-        mNewWindowPacketList.push_back(newPacket);
+        _pushReliableWindowPacket(newPacket);
 
-        if(!++mOutSequenceNext)
-            _handleOutSequenceRollover();
-
-        lk.unlock();
+        ++mOutSequenceNext;
 
         // Now build any remaining packets.
         while (messageSize > messageIndex)
@@ -2322,12 +1958,9 @@ void Session::_buildOutgoingReliableRoutedPackets(Message* message)
             newPacket->setIsEncrypted(true);
 
             // Push the packet on our outgoing queue
-            boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
-            mNewWindowPacketList.push_back(newPacket);
+            _pushReliableWindowPacket(newPacket);
 
-            if(!++mOutSequenceNext)
-                _handleOutSequenceRollover();
+            ++mOutSequenceNext;
         }
     }
     else
@@ -2350,12 +1983,9 @@ void Session::_buildOutgoingReliableRoutedPackets(Message* message)
         newPacket->setIsEncrypted(true);
 
         // Push the packet on our outgoing queue
-        boost::recursive_mutex::scoped_lock lk(mSessionMutex);
+        _pushReliableWindowPacket(newPacket);
 
-        mNewWindowPacketList.push_back(newPacket);
-
-        if(!++mOutSequenceNext)
-            _handleOutSequenceRollover();
+        ++mOutSequenceNext;
     }
     message->setPendingDelete(true);
 }
@@ -2397,12 +2027,9 @@ void Session::_buildOutgoingReliablePackets(Message* message)
         newPacket->setIsEncrypted(true);
 
         // Push the packet on our outgoing queue
-        boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
-        mNewWindowPacketList.push_back(newPacket);
+        _pushReliableWindowPacket(newPacket);
 
-        if(!++mOutSequenceNext)
-            _handleOutSequenceRollover();
+        ++mOutSequenceNext;
 
         // Now build any remaining packets.
         while (messageSize > messageIndex)
@@ -2424,12 +2051,9 @@ void Session::_buildOutgoingReliablePackets(Message* message)
             newPacket->setIsEncrypted(true);
 
             // Push the packet on our outgoing queue
-            boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
-            mNewWindowPacketList.push_back(newPacket);
+            _pushReliableWindowPacket(newPacket);
 
-            if(!++mOutSequenceNext)
-                _handleOutSequenceRollover();
+            ++mOutSequenceNext;
         }
     }
     else
@@ -2452,12 +2076,9 @@ void Session::_buildOutgoingReliablePackets(Message* message)
         newPacket->setIsEncrypted(true);
 
         // Push the packet on our outgoing queue
-        boost::recursive_mutex::scoped_lock lk(mSessionMutex);
+        _pushReliableWindowPacket(newPacket);
 
-        mNewWindowPacketList.push_back(newPacket);
-
-        if(!++mOutSequenceNext)
-            _handleOutSequenceRollover();
+        ++mOutSequenceNext;
     }
     message->setPendingDelete(true);
 }
@@ -2499,27 +2120,117 @@ void Session::_buildOutgoingUnreliablePackets(Message* message)
 //======================================================================================================================
 void Session::_addOutgoingReliablePacket(Packet* packet)
 {
-    // Push the packet on our outgoing queue
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
     // Set our last packet sent time index
     packet->setTimeQueued(Anh_Utils::Clock::getSingleton()->getLocalTime());
     mOutgoingReliablePacketQueue.push(packet);
 }
 
+//======================================================================================================================
+// puts a freshly built packet in the window, only the write thread builds packets
+// the build loop stops at the build limit, so only a message with more fragments than the headroom ends up here
+// with a full window - the sequences are lost then and the session is dropped
+
+void Session::_pushReliableWindowPacket(Packet* packet)
+{
+    if(!mReliableWindow.push(packet))
+    {
+        gLogger->log(LogManager::WARNING,"Session %u reliable window full, disconnecting", this->getId());
+
+        mPacketFactory->DestroyPacket(packet);
+        mCommand = SCOM_Disconnect;
+    }
+}
+
 
 //======================================================================================================================
 void Session::_addOutgoingUnreliablePacket(Packet* packet)
 {
-    // Push the packet on our outgoing queue
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
     // Set our last packet sent time index
     packet->setTimeQueued(Anh_Utils::Clock::getSingleton()->getLocalTime());
     mOutgoingUnreliablePacketQueue.push(packet);
 }
 
 
+//======================================================================================================================
+// the read thread never touches the window, acks and out of order packets are applied by the write thread
+
+void Session::_postWindowControlPacket(Packet* packet)
+{
+    mWindowControlQueue.push(packet);
+    mSocketWriteThread->Wakeup();
+}
+
+
+//======================================================================================================================
+// replies the read thread builds go through the write thread, which owns the outgoing packet queues
+
+void Session::_postOutgoingUnreliablePacket(Packet* packet)
+{
+    packet->setTimeQueued(Anh_Utils::Clock::getSingleton()->getLocalTime());
+
+    mReadThreadPacketQueue.push(packet);
+    mSocketWriteThread->Wakeup();
+}
+
+
+//======================================================================================================================
+// write thread, picks up what the read thread handed over since the last round
+
+void Session::_processReadThreadPackets(void)
+{
+    while(!mWindowControlQueue.empty())
+    {
+        Packet* packet = mWindowControlQueue.front();
+        mWindowControlQueue.pop();
+
+        packet->setReadIndex(0);
+
+        switch(packet->getUint16())
+        {
+        case SESSIONOP_DataOrder1:
+        case SESSIONOP_DataOrder3:
+        case SESSIONOP_DataOrder4:
+            _processDataOrderPacket(packet);
+            break;
+
+        case SESSIONOP_DataOrder2:
+            _processDataOrderChannelB(packet);
+            break;
+
+        default:
+            _processDataChannelAck(packet);
+            break;
+        }
+    }
+
+    while(!mReadThreadPacketQueue.empty())
+    {
+        mOutgoingUnreliablePacketQueue.push(mReadThreadPacketQueue.front());
+        mReadThreadPacketQueue.pop();
+    }
+}
+
+
+//======================================================================================================================
+// write thread, picks up the messages worker threads posted since the last round
+
+void Session::_processWorkerMessages(void)
+{
+    Message* message;
+
+    while(mWorkerMessageQueue.pop(message))
+    {
+        if(message->getFastpath() && (message->getSize() < mMaxUnreliableSize))
+            mWorkerUnreliableQueue.push(message);
+        else
+        {
+            message->setFastpath(false);	  //send it as reliable if its to big
+            mWorkerReliableQueue.push(message);
+        }
+    }
+}
+
+
 //======================================================================================================================
 int8* Session::getAddressString(void)
 {
@@ -2535,7 +2246,7 @@ uint16 Session::getPortHost(void)
 
 //======================================================================================================================
 
-uint32 Session::_buildPackets()
+uint32 Session::_buildPackets(MessageHandoffQueue& queue)
 {
 
     // 2 things
@@ -2545,19 +2256,17 @@ uint32 Session::_buildPackets()
     // 2nd are there any ways a session can have to generate routed and not routed packets ????? - No its either or
 
     uint32 packetsbuild = 0;
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
     //get our message
 
-    Message* message = mOutgoingMessageQueue.front();
-    mOutgoingMessageQueue.pop();
+    Message* message = queue.front();
+    queue.pop();
 
     //=================================
     // messages need to be of a certain size to make multimessages viable
     // so sort out the big ones or those which are alone in the queue and make a single packet if necessary
 
-    if(!mOutgoingMessageQueue.size()
-            || message->getSize() + mOutgoingMessageQueue.front()->getSize() > mMaxPacketSize - 21)
+    if(!queue.size()
+            || message->getSize() + queue.front()->getSize() > mMaxPacketSize - 21)
 
     {
         packetsbuild++;
@@ -2578,9 +2287,9 @@ uint32 Session::_buildPackets()
             //cave we *might* have 2bytes for Size !!!!!!  (if size 255 or bigger)
             uint16 baseSize = 19 + message->getSize(); // 2 header, 2 sequence, 2 0019, 1(3) size,7 prio/routing, 3 comp/crc
             packetsbuild++;
-            while(baseSize < mMaxPacketSize && mOutgoingMessageQueue.size())
+            while(baseSize < mMaxPacketSize && queue.size())
             {
-                message = mOutgoingMessageQueue.front();
+                message = queue.front();
 
                 baseSize += (message->getSize() + 10); // size + prio + routing	 //thats supposed to be 8
                 //cave size *might* be > 255  so using 3 (1 plus 2) for size as a standard!!
@@ -2588,7 +2297,7 @@ uint32 Session::_buildPackets()
                 if(baseSize >= mMaxPacketSize )
                     break;
 
-                mOutgoingMessageQueue.pop();
+                queue.pop();
                 mRoutedMultiMessageQueue.push(message);
             }
             _buildRoutedMultiDataPacket();
@@ -2599,16 +2308,16 @@ uint32 Session::_buildPackets()
 
             uint16 baseSize = 14 + message->getSize(); // 2 header, 2 sequence, 2 0019, 1 size(3) ,2 prio/routing, 3 comp/crc
             packetsbuild++;
-            while(baseSize < mMaxPacketSize && mOutgoingMessageQueue.size())
+            while(baseSize < mMaxPacketSize && queue.size())
             {
-                message = mOutgoingMessageQueue.front();
+                message = queue.front();
 
                 baseSize += (message->getSize() + 5); // size + prio + routing   cave size *might be > 255 so using 3 (1+2) for size as a standard!!
 
                 if(baseSize >= mMaxPacketSize)
                     break;
 
-                mOutgoingMessageQueue.pop();
+                queue.pop();
                 mMultiMessageQueue.push(message);
 
             }
@@ -2623,20 +2332,18 @@ uint32 Session::_buildPackets()
 
 //======================================================================================================================
 
-uint32 Session::_buildPacketsUnreliable()
+uint32 Session::_buildPacketsUnreliable(MessageHandoffQueue& queue)
 {
 
     uint32 packetsbuild = 0;
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-
-    Message* message = mUnreliableMessageQueue.front();
-    mUnreliableMessageQueue.pop();
+    Message* message = queue.front();
+    queue.pop();
 
     // no larger ones than ff yet, we want at least 2 messages to fit in, dont use routed mesages, so the frontline server does packing only
-    if(!mUnreliableMessageQueue.size()
-            || message->getRouted() || mUnreliableMessageQueue.front()->getRouted()//dont pack unreliable in server server - the idea is it just costs unnecessary cpu time
-            || message->getSize() > 252 || mUnreliableMessageQueue.front()->getSize() > 252 //sizebyte so 255 is max including header
-            || message->getSize() + mUnreliableMessageQueue.front()->getSize() > mMaxUnreliableSize - 16)
+    if(!queue.size()
+            || message->getRouted() || queue.front()->getRouted()//dont pack unreliable in server server - the idea is it just costs unnecessary cpu time
+            || message->getSize() > 252 || queue.front()->getSize() > 252 //sizebyte so 255 is max including header
+            || message->getSize() + queue.front()->getSize() > mMaxUnreliableSize - 16)
     {
         packetsbuild++;
         _buildOutgoingUnreliablePackets(message);
@@ -2649,16 +2356,16 @@ uint32 Session::_buildPacketsUnreliable()
 
         uint16 baseSize = 12 + message->getSize(); // 2 header, 2 sequence, 2 0019, 1 size,2 prio/routing, 3 comp/crc
         packetsbuild++;
-        while(baseSize < mMaxUnreliableSize && mUnreliableMessageQueue.size())
+        while(baseSize < mMaxUnreliableSize && queue.size())
         {
-            message = mUnreliableMessageQueue.front();
+            message = queue.front();
 
             baseSize += message->getSize() + 3; // size + prio + routing
 
             if(baseSize >= mMaxPacketSize || message->getRouted() || message->getSize() > 252)
                 break;
 
-            mUnreliableMessageQueue.pop();
+            queue.pop();
             mMultiUnreliableQueue.push(message);
         }
 
@@ -2701,12 +2408,10 @@ void Session::_buildMultiDataPacket()
     newPacket->setIsCompressed(true);
     newPacket->setIsEncrypted(true);
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-    mNewWindowPacketList.push_back(newPacket);
+    _pushReliableWindowPacket(newPacket);
 
     //sequence of packets uint16 +1 for every packet rollover from 0xffff to 0
-    if(!++mOutSequenceNext)
-        _handleOutSequenceRollover();
+    ++mOutSequenceNext;
 }
 
 //======================================================================
@@ -2757,12 +2462,10 @@ void Session::_buildRoutedMultiDataPacket()
     newPacket->setIsCompressed(false); //server server !!! save the cycles!!!
     newPacket->setIsEncrypted(true);
 
-    boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-    mNewWindowPacketList.push_back(newPacket);
+    _pushReliableWindowPacket(newPacket);
 
     //sequence of packets uint16 +1 for every packet rollover from 0xffff to 0
-    if(!++mOutSequenceNext)
-        _handleOutSequenceRollover();
+    ++mOutSequenceNext;
 }
 
 //======================================================================
@@ -2802,19 +2505,4 @@ void Session::_buildUnreliableMultiDataPacket()
 
 //======================================================================================================================
 
-void Session::_handleOutSequenceRollover()
-{
-    //rollover of the packet sequence from 0xffff to 0
-    gLogger->log(LogManager::DEBUG, "Session Sequence Rollover queuesize %u nextseqsent: %u Service %u", mWindowPacketList.size(),mNextPacketSequenceSent,mService->getId());
-    mOutSequenceRollover = true;
-
-    mRolloverWindowPacketList = mWindowPacketList;
-    mNewRolloverWindowPacketList = mNewWindowPacketList;
-
-    mWindowPacketList.clear();
-    mNewWindowPacketList.clear();
-}
-
-//======================================================================================================================
-
 
@@ -35,11 +35,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <boost/thread/thread.hpp>
 
 #include "Utils/clock.h"
+#include "Utils/ConcurrentQueue.h"
+#include "Utils/SpscQueue.h"
 #include "Utils/typedefs.h"
 
 #include "NetworkManager/Message.h"
 
 #include "NetworkManager/NetConfig.h"
+#include "NetworkManager/ReliableWindow.h"
 #include "NetworkManager/declspec.h"
 
 //======================================================================================================================
@@ -59,6 +62,12 @@ typedef std::list<Packet*,std::allocator<Packet*> >		PacketWindowList;
 typedef std::queue<Packet*>								PacketQueue;
 //typedef std::priority_queue<Message*,std::vector<Message*>,CompareMsg>  MessageQueue;
 typedef std::queue<Message*>							MessageQueue;
+// Messages handed from exactly one thread to exactly one other thread (main <-> socket threads)
+typedef utils::SpscQueue<Message*, 64>					MessageHandoffQueue;
+// Packets the read thread hands to the write thread
+typedef utils::SpscQueue<Packet*, 64>					PacketHandoffQueue;
+// Messages any number of worker threads hand to the write thread
+typedef utils::ConcurrentQueue<Message*>				MessagePostQueue;
 
 //======================================================================================================================
 
@@ -99,6 +108,11 @@ public:
     void                        SendChannelA(Message* message);
 
     void						  SendChannelAUnreliable(Message* message);
+
+    // SendChannelA for threads other than the one feeding the session, ie workers building with a MessageBuilder.
+    // Safe to call from any number of threads, the messages of one thread keep their order.
+    void                        PostChannelA(Message* message);
+
     void                        DestroyIncomingMessage(Message* message);
     void                        DestroyPacket(Packet* packet);
 
@@ -110,6 +124,9 @@ public:
     Service*                    getService(void)                                {
         return mService;
     }
+    SocketReadThread*           getSocketReadThread(void)                       {
+        return mSocketReadThread;
+    }
     uint32                      getId(void)                                     {
         return mId;
     }
@@ -129,6 +146,11 @@ public:
         return mOutgoingUnreliablePacketQueue.size();
     }
     Packet*                     getOutgoingUnreliablePacket(void);
+    bool                        getOutgoingWorkPending(void)                    {
+        return mSendDelayedAck || !mOutgoingMessageQueue.empty() || !mUnreliableMessageQueue.empty() || !mOutgoingReliablePacketQueue.empty()
+               || !mWindowControlQueue.empty() || !mReadThreadPacketQueue.empty()
+               || !mWorkerReliableQueue.empty() || !mWorkerUnreliableQueue.empty();
+    }
     uint32                      getIncomingQueueMessageCount()    {
         return mIncomingMessageQueue.size();
     }
@@ -240,8 +262,9 @@ private:
     void                        _addOutgoingMessage(Message* message, uint8 priority, bool fastpath);
     void                        _addIncomingMessage(Message* message, uint8 priority);
 
-    uint32					  _buildPackets();
-    uint32					  _buildPacketsUnreliable();
+    uint32					  _buildPackets(MessageHandoffQueue& queue);
+    uint32					  _buildPacketsUnreliable(MessageHandoffQueue& queue);
+    void                        _processWorkerMessages(void);
 
 
     void						  _buildMultiDataPacket();//fastpath
@@ -252,11 +275,14 @@ private:
     void						  _buildOutgoingReliableRoutedPackets(Message* message);
     void                        _buildOutgoingUnreliablePackets(Message* message);
     void                        _addOutgoingReliablePacket(Packet* packet);
+    void                        _pushReliableWindowPacket(Packet* packet);
     void                        _addOutgoingUnreliablePacket(Packet* packet);
+    void                        _postWindowControlPacket(Packet* packet);
+    void                        _postOutgoingUnreliablePacket(Packet* packet);
+    void                        _processReadThreadPackets(void);
     void                        _resendOutgoingPackets(void);
     void                        _sendPingPacket(void);
 
-    void						  _handleOutSequenceRollover();
 
 
     //we want to use bigger packets in the zone connection server communication!
@@ -317,8 +343,6 @@ private:
     uint16                      mOutSequenceNext;
     uint16                      mInSequenceNext;
 
-    bool						  mOutSequenceRollover;
-    uint16                      mNextPacketSequenceSent;
     uint64                      mLastRemotePacketAckReceived;
     uint32                      mWindowSizeCurrent;		//amount of packets we want to send in one round
     uint32                      mWindowResendSize;	    //
@@ -337,29 +361,34 @@ private:
 #ifdef _WIN32
 #pragma warning (disable : 4251)
 #endif
-    // Message queues.
-    MessageQueue                mOutgoingMessageQueue;		//here we store the messages given to us by the messagelib
-    MessageQueue                mUnreliableMessageQueue;
-
-    MessageQueue                mIncomingMessageQueue;
+    // Message queues. The hand-off queues are lock free, only the main thread pushes the outgoing ones and only
+    // the write thread pops them, only the read thread pushes the incoming one and only the main thread pops it.
+    MessageHandoffQueue         mOutgoingMessageQueue;		//here we store the messages given to us by the messagelib
+    MessageHandoffQueue         mUnreliableMessageQueue;
+
+    MessageHandoffQueue         mIncomingMessageQueue;
+
+    // Messages posted by worker threads. The write thread sorts them into its own reliable and unreliable queues,
+    // those are built after the ones of the main thread.
+    MessagePostQueue            mWorkerMessageQueue;
+    MessageHandoffQueue         mWorkerReliableQueue;			//write thread only
+    MessageHandoffQueue         mWorkerUnreliableQueue;		//write thread only
     MessageQueue				  mMultiMessageQueue;
     MessageQueue				  mRoutedMultiMessageQueue;
     MessageQueue				  mMultiUnreliableQueue;
 
-    // Packet queues.
+    // Packet queues. The window and the outgoing packet queues belong to the write thread, the read thread hands
+    // over the acks and out of order requests it receives and the replies it builds through the hand-off queues.
+    PacketHandoffQueue          mWindowControlQueue;				//acks and out of order packets, applied to the window by the write thread
+    PacketHandoffQueue          mReadThreadPacketQueue;			//unreliables built by the read thread (order requests, pings, session responses)
     PacketQueue                 mOutgoingReliablePacketQueue;		//these are packets put on by the sessionwrite thread to send
     PacketQueue                 mOutgoingUnreliablePacketQueue;   //build unreliables they will get send directly by the socket write thread  without storing for possible r esends
-    PacketWindowList            mWindowPacketList;				//our build packets - ready to get send
-    PacketWindowList			  mRolloverWindowPacketList;		//send packets after a rollover they await sending and / or acknowledgement by the client
-    PacketWindowList			  mNewRolloverWindowPacketList;
-    PacketWindowList            mNewWindowPacketList;
-    PacketWindowList			  mOutOfOrderPackets;
+    ReliableWindow              mReliableWindow;				//our build packets - waiting to get send and / or acknowledged
+    PacketWindowList			  mOutOfOrderPackets;				//read thread only
 
     PacketQueue                 mIncomingFragmentedPacketQueue;
     PacketQueue                 mIncomingRoutedFragmentedPacketQueue;
     PacketWindowList            mIncomingPacketList;
-
-    boost::recursive_mutex	  mSessionMutex;
     // Re-enable the warning.
 #ifdef _WIN32
 #pragma warning (default : 4251)
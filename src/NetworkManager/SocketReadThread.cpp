@@ -55,6 +55,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #else
 #include <sys/socket.h>
 #include <arpa/inet.h>
+#include <errno.h>
 
 #define INVALID_SOCKET	-1
 #define SOCKET_ERROR	-1
@@ -66,6 +67,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 SocketReadThread::SocketReadThread(SOCKET socket, SocketWriteThread* writeThread, Service* service,uint32 mfHeapSize, bool serverservice) :
     mReceivePacket(0),
     mDecompressPacket(0),
+    mReceivePackets(0),
+    mReceiveHeaders(0),
+    mReceiveVectors(0),
+    mReceiveAddresses(0),
+    mReadBatchSize(1),
+    mReceiveCallCount(0),
+    mReceivePacketCount(0),
+    mLastStatsTime(0),
     mSessionFactory(0),
     mPacketFactory(0),
     mCompCryptor(0),
@@ -102,6 +111,36 @@ SocketReadThread::SocketReadThread(SOCKET socket, SocketWriteThread* writeThread
     mReceivePacket = mPacketFactory->CreatePacket();
     mDecompressPacket = mPacketFactory->CreatePacket();
 
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX)
+    // Batched receive relies on recvmmsg, so it is only available on linux.
+    mReadBatchSize = gNetConfig->getSocketReadBatchSize();
+
+    if(mReadBatchSize > 1)
+    {
+        mReceivePackets		= new Packet*[mReadBatchSize];
+        mReceiveHeaders		= new struct mmsghdr[mReadBatchSize];
+        mReceiveVectors		= new struct iovec[mReadBatchSize];
+        mReceiveAddresses	= new struct sockaddr_in[mReadBatchSize];
+
+        memset(mReceiveHeaders, 0, sizeof(struct mmsghdr) * mReadBatchSize);
+
+        for(uint32 i = 0; i < mReadBatchSize; i++)
+        {
+            mReceivePackets[i] = mPacketFactory->CreatePacket();
+
+            mReceiveVectors[i].iov_base = mReceivePackets[i]->getData();
+            mReceiveVectors[i].iov_len  = mMessageMaxSize;
+
+            mReceiveHeaders[i].msg_hdr.msg_name		= &mReceiveAddresses[i];
+            mReceiveHeaders[i].msg_hdr.msg_namelen	= sizeof(struct sockaddr_in);
+            mReceiveHeaders[i].msg_hdr.msg_iov		= &mReceiveVectors[i];
+            mReceiveHeaders[i].msg_hdr.msg_iovlen	= 1;
+        }
+    }
+#endif
+
+    mLastStatsTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
     // start our thread
     boost::thread t(std::tr1::bind(&SocketReadThread::run, this));
     mThread = boost::move(t);
@@ -120,6 +159,11 @@ SocketReadThread::~SocketReadThread()
     mThread.interrupt();
     mThread.join();
 
+    delete [] mReceivePackets;
+    delete [] mReceiveHeaders;
+    delete [] mReceiveVectors;
+    delete [] mReceiveAddresses;
+
     delete mPacketFactory;
     delete mSessionFactory;
 
@@ -133,10 +177,8 @@ SocketReadThread::~SocketReadThread()
 void SocketReadThread::run(void)
 {
     struct sockaddr_in  from;
-    uint32              address, fromLen = sizeof(from), count;
+    uint32              fromLen = sizeof(from), count;
     int16               recvLen;
-    uint16              port, decompressLen;
-    Session*            session;
     fd_set              socketSet;
     struct              timeval tv;
 
@@ -151,6 +193,7 @@ void SocketReadThread::run(void)
         if(mNewConnection.mPort != 0)
         {
             Session* newSession = mSessionFactory->CreateSession();
+            newSession->setSocketReadThread(this);
             newSession->setCommand(SCOM_Connect);
             newSession->setAddress(inet_addr(mNewConnection.mAddress));
             newSession->setPort(htons(mNewConnection.mPort));
@@ -168,9 +211,16 @@ void SocketReadThread::run(void)
             mSocketWriteThread->NewSession(newSession);
         }
 
+        // Drain up to mReadBatchSize datagrams with a single call if batching is enabled.
+        if(mReadBatchSize > 1)
+        {
+            _receiveBatch();
+            _logReceiveStats();
+            continue;
+        }
+
         // Reset our internal members so we can use the packet again.
         mReceivePacket->Reset();
-        mDecompressPacket->Reset();
 
         // Build a new fd_set structure
         FD_SET(mSocket, &socketSet);
@@ -186,6 +236,8 @@ void SocketReadThread::run(void)
             // Read any incoming packets.
             recvLen = recvfrom(mSocket, mReceivePacket->getData(),(int) mMessageMaxSize, 0, (sockaddr*)&from, reinterpret_cast<socklen_t*>(&fromLen));
 
+            mReceiveCallCount++;
+
             if(recvLen <= 0)
             {
                 int	errorNr = 0;
@@ -212,232 +264,335 @@ void SocketReadThread::run(void)
                 continue;
             }
 
-            if(recvLen > mMessageMaxSize)
+            mReceivePacketCount++;
+
+            // The session took ownership of the packet, grab a fresh one for the next read.
+            if(_processIncomingPacket(mReceivePacket, recvLen, &from))
             {
-                gLogger->log(LogManager::NOTICE, "Socket Read Thread Received Size > mMessageMaxSize: %u", recvLen);
+                mReceivePacket = mPacketFactory->CreatePacket();
             }
 
-            // Get our remote Address and port
-            address		= from.sin_addr.s_addr;
-            port		= from.sin_port;
+            // Acks and resend requests are queued on the session, let the write thread pick them up.
+            mSocketWriteThread->Wakeup();
+        }
 
-            uint64 hash = address | (((uint64)port) << 32);
+        _logReceiveStats();
 
-            // Grab our packet type
-            mReceivePacket->Reset();           // Reset our internal members so we can use the packet again.
-            mReceivePacket->setSize(recvLen); // crc is subtracted by the decryption
+        boost::this_thread::sleep(boost::posix_time::microseconds(10));
+    }
 
-            uint8  packetTypeLow	= mReceivePacket->peekUint8();
-            uint16 packetType		= mReceivePacket->getUint16();
+    // Shutdown internally
+    _shutdown();
+}
 
-            boost::mutex::scoped_lock lk(mSocketReadMutex);
+//======================================================================================================================
 
-            AddressSessionMap::iterator i = mAddressSessionMap.find(hash);
+bool SocketReadThread::_processIncomingPacket(Packet* packet, uint32 recvLen, struct sockaddr_in* from)
+{
+    uint32              address;
+    uint16              port, decompressLen;
+    Session*            session;
 
-            if(i != mAddressSessionMap.end())
-            {
-                session = (*i).second;
-            }
-            else
-            {
-                // We should only be creating a new session if it's a session request packet
-                if(packetType == SESSIONOP_SessionRequest)
-                {
-                    session = mSessionFactory->CreateSession();
-                    session->setSocketReadThread(this);
-                    session->setPacketFactory(mPacketFactory);
-                    session->setAddress(address);  // Store the address and port in network order so we don't have to
-                    session->setPort(port);  // convert them all the time.  Only convert for humans.
-                    session->setResendWindowSize(mSessionResendWindowSize);
-
-                    // Insert the session into our address map and process list
-                    mAddressSessionMap.insert(std::make_pair(hash, session));
-                    mSocketWriteThread->NewSession(session);
-                    session->mHash = hash;
-
-                    gLogger->log(LogManager::DEBUG, "Added Service %i: New Session(%s, %u), AddressMap: %i",mSessionFactory->getService()->getId(), inet_ntoa(from.sin_addr), ntohs(session->getPort()), mAddressSessionMap.size());
-                }
-                else
-                {
-                    gLogger->log(LogManager::WARNING, "Socket Read Thread Session not found. Type:0x%.4x", packetType);
+    mDecompressPacket->Reset();
 
-                    lk.unlock();
+    if(recvLen > mMessageMaxSize)
+    {
+        gLogger->log(LogManager::NOTICE, "Socket Read Thread Received Size > mMessageMaxSize: %u", recvLen);
+    }
 
-                    continue;
-                }
-            }
+    // Get our remote Address and port
+    address		= from->sin_addr.s_addr;
+    port		= from->sin_port;
+
+    uint64 hash = address | (((uint64)port) << 32);
+
+    // Grab our packet type
+    packet->Reset();           // Reset our internal members so we can use the packet again.
+    packet->setSize(recvLen); // crc is subtracted by the decryption
+
+    uint8  packetTypeLow	= packet->peekUint8();
+    uint16 packetType		= packet->getUint16();
+
+    boost::mutex::scoped_lock lk(mSocketReadMutex);
+
+    AddressSessionMap::iterator i = mAddressSessionMap.find(hash);
+
+    if(i != mAddressSessionMap.end())
+    {
+        session = (*i).second;
+    }
+    else
+    {
+        // We should only be creating a new session if it's a session request packet
+        if(packetType == SESSIONOP_SessionRequest)
+        {
+            session = mSessionFactory->CreateSession();
+            session->setSocketReadThread(this);
+            session->setPacketFactory(mPacketFactory);
+            session->setAddress(address);  // Store the address and port in network order so we don't have to
+            session->setPort(port);  // convert them all the time.  Only convert for humans.
+            session->setResendWindowSize(mSessionResendWindowSize);
+
+            // Insert the session into our address map and process list
+            mAddressSessionMap.insert(std::make_pair(hash, session));
+            mSocketWriteThread->NewSession(session);
+            session->mHash = hash;
+
+            gLogger->log(LogManager::DEBUG, "Added Service %i: New Session(%s, %u), AddressMap: %i",mSessionFactory->getService()->getId(), inet_ntoa(from->sin_addr), ntohs(session->getPort()), mAddressSessionMap.size());
+        }
+        else
+        {
+            gLogger->log(LogManager::WARNING, "Socket Read Thread Session not found. Type:0x%.4x", packetType);
 
             lk.unlock();
 
-            // I don't like any of the code below, but it's going to take me a bit to work out a good way to handle decompression
-            // and decryption.  It's dependent on session layer protocol information, which should not be looked at here.  Should
-            // be placed in Session, though I'm not sure how or where yet.
-            // Set the size of the packet
+            return false;
+        }
+    }
+
+    lk.unlock();
+
+    // I don't like any of the code below, but it's going to take me a bit to work out a good way to handle decompression
+    // and decryption.  It's dependent on session layer protocol information, which should not be looked at here.  Should
+    // be placed in Session, though I'm not sure how or where yet.
+    // Set the size of the packet
 
-            // Validate our date header.  If it's not a valid header, drop it.
-            if(packetType > 0x00ff && (packetType & 0x00ff) == 0 && session != NULL)
+    // Validate our date header.  If it's not a valid header, drop it.
+    if(packetType > 0x00ff && (packetType & 0x00ff) == 0 && session != NULL)
+    {
+        switch(packetType)
+        {
+        case SESSIONOP_Disconnect:
+        case SESSIONOP_DataAck1:
+        case SESSIONOP_DataAck2:
+        case SESSIONOP_DataAck3:
+        case SESSIONOP_DataAck4:
+        case SESSIONOP_DataOrder1:
+        case SESSIONOP_DataOrder2:
+        case SESSIONOP_DataOrder3:
+        case SESSIONOP_DataOrder4:
+        case SESSIONOP_Ping:
+        {
+            // Check the CRC and decrypt the packet in a single pass, a mismatching packet gets dropped anyway.
+            uint32 packetCrc = mCompCryptor->DecryptAndGenerateCRC(packet->getData(), recvLen - 2, 2, session->getEncryptKey());  // - 2 crc
+
+            uint8 crcLow  = (uint8)*(packet->getData() + recvLen - 1);
+            uint8 crcHigh = (uint8)*(packet->getData() + recvLen - 2);
+
+            if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
             {
-                switch(packetType)
-                {
-                case SESSIONOP_Disconnect:
-                case SESSIONOP_DataAck1:
-                case SESSIONOP_DataAck2:
-                case SESSIONOP_DataAck3:
-                case SESSIONOP_DataAck4:
-                case SESSIONOP_DataOrder1:
-                case SESSIONOP_DataOrder2:
-                case SESSIONOP_DataOrder3:
-                case SESSIONOP_DataOrder4:
-                case SESSIONOP_Ping:
-                {
-                    // Before we do anything else, check the CRC.
-                    uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());  // - 2 crc
-
-                    uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
-                    uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
-
-                    if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
-                    {
-                        // CRC mismatch.  Dropping packet.
-                        //gLogger->hexDump(mReceivePacket->getData(),mReceivePacket->getSize());
-                        gLogger->log(LogManager::DEBUG, "DIS/ACK/ORDER/PING dropped.");
-                        continue;
-                    }
-
-                    // Decrypt the packet
-                    mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());
-
-                    // Send the packet to the session.
-                    session->HandleSessionPacket(mReceivePacket);
-                    mReceivePacket = mPacketFactory->CreatePacket();
-                }
-                break;
+                // CRC mismatch.  Dropping packet.
+                //gLogger->hexDump(packet->getData(),packet->getSize());
+                gLogger->log(LogManager::DEBUG, "DIS/ACK/ORDER/PING dropped.");
+                return false;
+            }
 
-                case SESSIONOP_MultiPacket:
-                case SESSIONOP_NetStatRequest:
-                case SESSIONOP_NetStatResponse:
-                case SESSIONOP_DataChannel1:
-                case SESSIONOP_DataChannel2:
-                case SESSIONOP_DataChannel3:
-                case SESSIONOP_DataChannel4:
-                case SESSIONOP_DataFrag1:
-                case SESSIONOP_DataFrag2:
-                case SESSIONOP_DataFrag3:
-                case SESSIONOP_DataFrag4:
-                {
-                    // Before we do anything else, check the CRC.
-                    uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
-
-                    uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
-                    uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
-
-                    if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
-                    {
-                        // CRC mismatch.  Dropping packet.
-
-                        gLogger->log(LogManager::NOTICE, "Socket Read Thread: Reliable Packet dropped. %X CRC mismatch.", packetType);
-                        mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
-                        continue;
-                    }
-
-                    // Decrypt the packet
-                    mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
-
-                    // Decompress the packet
-                    decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 2, recvLen - 5, mDecompressPacket->getData() + 2, mDecompressPacket->getMaxPayload() - 5);
-
-                    if(decompressLen > 0)
-                    {
-                        mDecompressPacket->setIsCompressed(true);
-                        mDecompressPacket->setSize(decompressLen + 2); // add the packet header size
-                        *((uint16*)(mDecompressPacket->getData())) = *((uint16*)mReceivePacket->getData());
-                        session->HandleSessionPacket(mDecompressPacket);
-                        mDecompressPacket = mPacketFactory->CreatePacket();
-
-                        break;
-                    }
-                    else
-                    {
-                        // we have to remove comp/crc
-                        mReceivePacket->setSize(mReceivePacket->getSize() - 3);
-                    }
-                }
+            // Send the packet to the session.
+            session->HandleSessionPacket(packet);
+            return true;
+        }
+        break;
+
+        case SESSIONOP_MultiPacket:
+        case SESSIONOP_NetStatRequest:
+        case SESSIONOP_NetStatResponse:
+        case SESSIONOP_DataChannel1:
+        case SESSIONOP_DataChannel2:
+        case SESSIONOP_DataChannel3:
+        case SESSIONOP_DataChannel4:
+        case SESSIONOP_DataFrag1:
+        case SESSIONOP_DataFrag2:
+        case SESSIONOP_DataFrag3:
+        case SESSIONOP_DataFrag4:
+        {
+            // Check the CRC and decrypt the packet in a single pass.
+            uint32 packetCrc = mCompCryptor->DecryptAndGenerateCRC(packet->getData(), recvLen - 2, 2, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
 
-                case SESSIONOP_SessionRequest:
-                case SESSIONOP_SessionResponse:
-                case SESSIONOP_FatalError:
-                case SESSIONOP_FatalErrorResponse:
-                    //case SESSIONOP_Reset:
-                {
-                    // Send the packet to the session.
+            uint8 crcLow  = (uint8)*(packet->getData() + recvLen - 1);
+            uint8 crcHigh = (uint8)*(packet->getData() + recvLen - 2);
 
-                    session->HandleSessionPacket(mReceivePacket);
-                    mReceivePacket = mPacketFactory->CreatePacket();
-                }
-                break;
+            if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
+            {
+                // CRC mismatch.  Dropping packet.
 
-                default:
-                {
-                    gLogger->log(LogManager::NOTICE, "SocketReadThread: Dont know what todo with this packet! --tmr <3");
-                }
-                break;
+                gLogger->log(LogManager::NOTICE, "Socket Read Thread: Reliable Packet dropped. %X CRC mismatch.", packetType);
+                return false;
+            }
+
+            // Decompress the packet
+            decompressLen = mCompCryptor->Decompress(packet->getData() + 2, recvLen - 5, mDecompressPacket->getData() + 2, mDecompressPacket->getMaxPayload() - 5);
 
-                } //end switch(sessionOp)
+            if(decompressLen > 0)
+            {
+                mDecompressPacket->setIsCompressed(true);
+                mDecompressPacket->setSize(decompressLen + 2); // add the packet header size
+                *((uint16*)(mDecompressPacket->getData())) = *((uint16*)packet->getData());
+                session->HandleSessionPacket(mDecompressPacket);
+                mDecompressPacket = mPacketFactory->CreatePacket();
+
+                break;
             }
-            // Validate that our data is actually fastpath
-            else if(packetTypeLow < 0x0d && session != NULL) // highest fastpath I've seen is 0x0b -tmr
+            else
             {
-                // Before we do anything else, check the CRC.
-                uint32	packetCrc	= mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
-                uint8	crcLow		= (uint8)*(mReceivePacket->getData() + recvLen - 1);
-                uint8	crcHigh		= (uint8)*(mReceivePacket->getData() + recvLen - 2);
+                // we have to remove comp/crc
+                packet->setSize(packet->getSize() - 3);
+            }
+        }
 
-                if(crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
-                {
-                    // CRC mismatch.  Dropping packet.
-                    gLogger->log(LogManager::NOTICE, "Packet dropped.  CRC mismatch.");
-                    continue;
-                }
+        case SESSIONOP_SessionRequest:
+        case SESSIONOP_SessionResponse:
+        case SESSIONOP_FatalError:
+        case SESSIONOP_FatalErrorResponse:
+            //case SESSIONOP_Reset:
+        {
+            // Send the packet to the session.
 
-                // It's a 'fastpath' packet.  Send it directly up the data channel
-                mCompCryptor->Decrypt(mReceivePacket->getData() + 1, recvLen - 3, session->getEncryptKey());  // don't hardcode the header buffer or CRc len.
+            session->HandleSessionPacket(packet);
+            return true;
+        }
+        break;
 
-                // Decompress the packet
-                decompressLen	= 0;
-                uint8 compFlag	= (uint8)*(mReceivePacket->getData() + recvLen - 3);
+        default:
+        {
+            gLogger->log(LogManager::NOTICE, "SocketReadThread: Dont know what todo with this packet! --tmr <3");
+        }
+        break;
 
-                if(compFlag == 1)
-                {
-                    decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 1, recvLen - 4, mDecompressPacket->getData() + 1, mDecompressPacket->getMaxPayload() - 4);
-                }
+        } //end switch(sessionOp)
+    }
+    // Validate that our data is actually fastpath
+    else if(packetTypeLow < 0x0d && session != NULL) // highest fastpath I've seen is 0x0b -tmr
+    {
+        // It's a 'fastpath' packet.  Check the CRC and decrypt it in a single pass, then send it directly up the data channel
+        uint32	packetCrc	= mCompCryptor->DecryptAndGenerateCRC(packet->getData(), recvLen - 2, 1, session->getEncryptKey());  // don't hardcode the header buffer or CRc len.
+        uint8	crcLow		= (uint8)*(packet->getData() + recvLen - 1);
+        uint8	crcHigh		= (uint8)*(packet->getData() + recvLen - 2);
 
-                if(decompressLen > 0)
-                {
-                    mDecompressPacket->setIsCompressed(true);
-                    mDecompressPacket->setSize(decompressLen + 1); // add the packet header size
+        if(crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
+        {
+            // CRC mismatch.  Dropping packet.
+            gLogger->log(LogManager::NOTICE, "Packet dropped.  CRC mismatch.");
+            return false;
+        }
 
-                    *((uint8*)(mDecompressPacket->getData())) = *((uint8*)mReceivePacket->getData());
+        // Decompress the packet
+        decompressLen	= 0;
+        uint8 compFlag	= (uint8)*(packet->getData() + recvLen - 3);
 
-                    // send the packet up the stack
-                    session->HandleFastpathPacket(mDecompressPacket);
-                    mDecompressPacket = mPacketFactory->CreatePacket();
-                }
-                else
-                {
-                    // send the packet up the stack, remove comp/crc
-                    mReceivePacket->setSize(mReceivePacket->getSize() - 3);
+        if(compFlag == 1)
+        {
+            decompressLen = mCompCryptor->Decompress(packet->getData() + 1, recvLen - 4, mDecompressPacket->getData() + 1, mDecompressPacket->getMaxPayload() - 4);
+        }
 
-                    session->HandleFastpathPacket(mReceivePacket);
-                    mReceivePacket = mPacketFactory->CreatePacket();
-                }
-            }
+        if(decompressLen > 0)
+        {
+            mDecompressPacket->setIsCompressed(true);
+            mDecompressPacket->setSize(decompressLen + 1); // add the packet header size
+
+            *((uint8*)(mDecompressPacket->getData())) = *((uint8*)packet->getData());
+
+            // send the packet up the stack
+            session->HandleFastpathPacket(mDecompressPacket);
+            mDecompressPacket = mPacketFactory->CreatePacket();
         }
+        else
+        {
+            // send the packet up the stack, remove comp/crc
+            packet->setSize(packet->getSize() - 3);
+
+            session->HandleFastpathPacket(packet);
+            return true;
+        }
+    }
 
+    return false;
+}
+
+//======================================================================================================================
+
+void SocketReadThread::_receiveBatch(void)
+{
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX)
+    fd_set              socketSet;
+    struct timeval      tv;
+
+    FD_ZERO(&socketSet);
+    FD_SET(mSocket, &socketSet);
+
+    tv.tv_sec   = 0;
+    tv.tv_usec  = 250;
+
+    if(select(mSocket + 1, &socketSet, 0, 0, &tv) <= 0 || !FD_ISSET(mSocket, &socketSet))
+    {
+        return;
+    }
+
+    // The kernel overwrites the address length and datagram length of every slot, reset them before each call.
+    for(uint32 i = 0; i < mReadBatchSize; i++)
+    {
+        mReceivePackets[i]->Reset();
+        mReceiveHeaders[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        mReceiveHeaders[i].msg_len = 0;
+    }
+
+    int received = recvmmsg(mSocket, mReceiveHeaders, mReadBatchSize, MSG_DONTWAIT, 0);
+
+    mReceiveCallCount++;
+
+    if(received <= 0)
+    {
+        if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            gLogger->log(LogManager::WARNING, "Error(recvmmsg): %i", errno);
+        }
+
+        return;
+    }
+
+    mReceivePacketCount += received;
+
+    // Run crc/decrypt/decompress and hand off the whole batch before we touch the socket again.
+    for(int i = 0; i < received; i++)
+    {
+        uint32 recvLen = mReceiveHeaders[i].msg_len;
+
+        if(!recvLen)
+            continue;
+
+        if(_processIncomingPacket(mReceivePackets[i], recvLen, &mReceiveAddresses[i]))
+        {
+            mReceivePackets[i] = mPacketFactory->CreatePacket();
+            mReceiveVectors[i].iov_base = mReceivePackets[i]->getData();
+        }
+    }
+
+    // Acks and resend requests are queued on the sessions, let the write thread pick them up.
+    mSocketWriteThread->Wakeup();
+
+    // Only back off when the socket did not fill the whole batch, otherwise there is more waiting for us.
+    if((uint32)received < mReadBatchSize)
+    {
         boost::this_thread::sleep(boost::posix_time::microseconds(10));
     }
+#endif
+}
 
-    // Shutdown internally
-    _shutdown();
+//======================================================================================================================
+
+void SocketReadThread::_logReceiveStats(void)
+{
+    uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+    if(now - mLastStatsTime < 60000)
+        return;
+
+    mLastStatsTime = now;
+
+    if(!mReceiveCallCount)
+        return;
+
+    gLogger->log(LogManager::INFORMATION, "Service %u read thread: %.2f packets per receive call (packets: %" PRIu64 ", calls: %" PRIu64 ", batch: %u)",
+                 mSessionFactory->getService()->getId(), (float)mReceivePacketCount / (float)mReceiveCallCount, mReceivePacketCount, mReceiveCallCount, mReadBatchSize);
 }
 
 //======================================================================================================================
@@ -49,6 +49,10 @@ class Session;
 class Service;
 class Packet;
 
+struct mmsghdr;
+struct iovec;
+struct sockaddr_in;
+
 //======================================================================================================================
 
 typedef std::list<Session*>			SessionList;
@@ -90,14 +94,37 @@ public:
         mExit = true;
     }
 
+    uint64                        getReceiveCallCount(void)   {
+        return mReceiveCallCount;
+    }
+    uint64                        getReceivePacketCount(void) {
+        return mReceivePacketCount;
+    }
+
 protected:
 
     void                          _startup(void);
     void                          _shutdown(void);
 
+    bool                          _processIncomingPacket(Packet* packet, uint32 recvLen, struct sockaddr_in* from);
+    void                          _receiveBatch(void);
+    void                          _logReceiveStats(void);
+
     Packet*                       mReceivePacket;
     Packet*                       mDecompressPacket;
 
+    // Batched receive, only used when SocketReadBatchSize > 1
+    Packet**                      mReceivePackets;
+    struct mmsghdr*               mReceiveHeaders;
+    struct iovec*                 mReceiveVectors;
+    struct sockaddr_in*           mReceiveAddresses;
+    uint32                        mReadBatchSize;
+
+    // Statistics
+    uint64                        mReceiveCallCount;
+    uint64                        mReceivePacketCount;
+    uint64                        mLastStatsTime;
+
     uint16						mMessageMaxSize;
     SocketWriteThread*            mSocketWriteThread;
     SessionFactory*               mSessionFactory;
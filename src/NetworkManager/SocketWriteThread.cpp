@@ -69,7 +69,17 @@ SocketWriteThread::SocketWriteThread(SOCKET socket, Service* service, bool serve
     mService(0),
     mCompCryptor(0),
     mSocket(0),
-    mIsRunning(false)
+    mIsRunning(false),
+    mSendBatchBuffer(0),
+    mSendHeaders(0),
+    mSendVectors(0),
+    mSendAddresses(0),
+    mSendBatchSize(1),
+    mSendBatchCount(0),
+    mSendCallCount(0),
+    mSendPacketCount(0),
+    mLastStatsTime(0),
+    mWakeupPending(false)
 {
     mSocket = socket;
     mService = service;
@@ -91,8 +101,39 @@ SocketWriteThread::SocketWriteThread(SOCKET socket, Service* service, bool serve
     // We do have a global clock object, don't use seperate clock and times for every process.
     // mClock = new Anh_Utils::Clock();
 
-    // Create our CompCryptor object.
-    mCompCryptor = new CompCryptor();
+    // Create our CompCryptor object, every service can run its own compression settings.
+    if(mServerService)
+        mCompCryptor = new CompCryptor(gNetConfig->getServerServerCompressionLevel(), gNetConfig->getServerServerCompressionStrategy());
+    else
+        mCompCryptor = new CompCryptor(gNetConfig->getServerClientCompressionLevel(), gNetConfig->getServerClientCompressionStrategy());
+
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX)
+    // Batched send relies on sendmmsg, so it is only available on linux.
+    mSendBatchSize = gNetConfig->getSocketWriteBatchSize();
+
+    if(mSendBatchSize > 1)
+    {
+        mSendBatchBuffer	= new int8[mSendBatchSize * SEND_BUFFER_SIZE];
+        mSendHeaders		= new struct mmsghdr[mSendBatchSize];
+        mSendVectors		= new struct iovec[mSendBatchSize];
+        mSendAddresses		= new struct sockaddr[mSendBatchSize];
+
+        memset(mSendHeaders, 0, sizeof(struct mmsghdr) * mSendBatchSize);
+
+        for(uint32 i = 0; i < mSendBatchSize; i++)
+        {
+            mSendVectors[i].iov_base = mSendBatchBuffer + (i * SEND_BUFFER_SIZE);
+            mSendVectors[i].iov_len  = 0;
+
+            mSendHeaders[i].msg_hdr.msg_name	= &mSendAddresses[i];
+            mSendHeaders[i].msg_hdr.msg_namelen	= sizeof(struct sockaddr);
+            mSendHeaders[i].msg_hdr.msg_iov		= &mSendVectors[i];
+            mSendHeaders[i].msg_hdr.msg_iovlen	= 1;
+        }
+    }
+#endif
+
+    mLastStatsTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
 
     // start our thread
     boost::thread t(std::tr1::bind(&SocketWriteThread::run, this));
@@ -119,11 +160,18 @@ SocketWriteThread::~SocketWriteThread()
     // shutdown our thread
     mExit = true;
 
+    Wakeup();
+
     mThread.interrupt();
     mThread.join();
 
     delete mCompCryptor;
 
+    delete [] mSendBatchBuffer;
+    delete [] mSendHeaders;
+    delete [] mSendVectors;
+    delete [] mSendAddresses;
+
     // delete(mClock);
 }
 
@@ -144,12 +192,14 @@ void SocketWriteThread::run()
     // Main loop
     while(!mExit)
     {
+        bool workPending = false;
 
         uint32 sessionCount = mSessionQueue.size();
 
         for(uint32 i = 0; i < sessionCount; i++)
         {
             uint32 packetCount = 0;
+
             session = mSessionQueue.pop();
 
             if(!session)
@@ -171,23 +221,24 @@ void SocketWriteThread::run()
                 _sendPacket(packet, session);
             }
 
-
             packetCount = 0;
 
             // Send any outgoing unreliable packets
             //uint32 ucount = 0;
             while (session->getOutgoingUnreliablePacketCount())
             {
-
                 packet = session->getOutgoingUnreliablePacket();
                 _sendPacket(packet, session);
                 session->DestroyPacket(packet);
             }
 
-
             // If the session is still in a connected state, Put us back in the queue.
             if (session->getStatus() != SSTAT_Disconnected)
             {
+                // We hit our packet limit or there are messages left to packetize, come straight back.
+                if(session->getOutgoingWorkPending())
+                    workPending = true;
+
                 mSessionQueue.push(session);
             }
             else
@@ -199,8 +250,13 @@ void SocketWriteThread::run()
             }
         }
 
+        // Put everything we gathered this round on the wire.
+        _flushSendBatch();
 
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        _logSendStats();
+
+        if(!workPending)
+            _waitForWork();
     }
 
     // Shutdown internally
@@ -226,10 +282,9 @@ void SocketWriteThread::_shutdown(void)
 
 //======================================================================================================================
 
-void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
+uint32 SocketWriteThread::_buildPacket(Packet* packet, Session* session, int8* buffer, struct sockaddr* toAddr)
 {
-    struct sockaddr     toAddr;
-    uint32              sent, toLen = sizeof(toAddr), outLen;
+    uint32              outLen;
 
 
     // Going to simulate network packet loss here.
@@ -248,12 +303,12 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
     packet->setTimeSent(Anh_Utils::Clock::getSingleton()->getStoredTime());
 
     // Setup our to address
-    toAddr.sa_family = AF_INET;
-    *((unsigned int*)&toAddr.sa_data[2]) = session->getAddress();     // Ports and addresses are stored in network order.
-    *((unsigned short*)&(toAddr.sa_data[0])) = session->getPort();    // Only need to convert for humans.
+    toAddr->sa_family = AF_INET;
+    *((unsigned int*)&toAddr->sa_data[2]) = session->getAddress();     // Ports and addresses are stored in network order.
+    *((unsigned short*)&(toAddr->sa_data[0])) = session->getPort();    // Only need to convert for humans.
 
     // Copy our 2 byte header.
-    *((uint16*)mSendBuffer) = *((uint16*)packet->getData());
+    *((uint16*)buffer) = *((uint16*)packet->getData());
 
     // Compress the packet if needed.
     if(packet->getIsCompressed())
@@ -261,11 +316,11 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
         if(packetTypeLow == 0)
         {
             // Compress our packet, but not the header
-            outLen = mCompCryptor->Compress(packet->getData() + 2, packet->getSize() - 2, mSendBuffer + 2, sizeof(mSendBuffer));
+            outLen = mCompCryptor->Compress(packet->getData() + 2, packet->getSize() - 2, buffer + 2, SEND_BUFFER_SIZE);
         }
         else
         {
-            outLen = mCompCryptor->Compress(packet->getData() + 1, packet->getSize() - 1, mSendBuffer + 1, sizeof(mSendBuffer));
+            outLen = mCompCryptor->Compress(packet->getData() + 1, packet->getSize() - 1, buffer + 1, SEND_BUFFER_SIZE);
         }
 
         // If we compressed it, place a 1 at the end of the buffer.
@@ -273,36 +328,36 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
         {
             if(packetTypeLow == 0)
             {
-                mSendBuffer[outLen + 2] = 1;
+                buffer[outLen + 2] = 1;
                 outLen += 3;  //thats 2 (uncompressed) headerbytes plus the encryption flag
             }
             else
             {
-                mSendBuffer[outLen + 1] = 1;
+                buffer[outLen + 1] = 1;
                 outLen += 2;
             }
         }
         // else a 0 - so no compression
         else
         {
-            memcpy(mSendBuffer, packet->getData(), packet->getSize());
+            memcpy(buffer, packet->getData(), packet->getSize());
             outLen = packet->getSize();
 
-            mSendBuffer[outLen] = 0;
+            buffer[outLen] = 0;
             outLen += 1;
         }
     }
     else if(packetType == SESSIONOP_SessionResponse || packetType == SESSIONOP_CriticalError)
     {
-        memcpy(mSendBuffer, packet->getData(), packet->getSize());
+        memcpy(buffer, packet->getData(), packet->getSize());
         outLen = packet->getSize();
     }
     else
     {
-        memcpy(mSendBuffer, packet->getData(), packet->getSize());
+        memcpy(buffer, packet->getData(), packet->getSize());
         outLen = packet->getSize();
 
-        mSendBuffer[outLen] = 0;
+        buffer[outLen] = 0;
         outLen += 1;
     }
 
@@ -311,23 +366,54 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
     {
         if(packetTypeLow == 0)
         {
-            mCompCryptor->Encrypt(mSendBuffer + 2, outLen - 2, session->getEncryptKey()); // -2 header is not encrypted
+            mCompCryptor->Encrypt(buffer + 2, outLen - 2, session->getEncryptKey()); // -2 header is not encrypted
         }
         else if(packetTypeLow < 0x0d)
         {
-            mCompCryptor->Encrypt(mSendBuffer + 1, outLen - 1, session->getEncryptKey()); // - 1 header is not encrypted
+            mCompCryptor->Encrypt(buffer + 1, outLen - 1, session->getEncryptKey()); // - 1 header is not encrypted
         }
 
-        packet->setCRC(mCompCryptor->GenerateCRC(mSendBuffer, outLen, session->getEncryptKey()));
+        packet->setCRC(mCompCryptor->GenerateCRC(buffer, outLen, session->getEncryptKey()));
 
 
-        mSendBuffer[outLen] = (uint8)(packet->getCRC() >> 8);
-        mSendBuffer[outLen + 1] = (uint8)packet->getCRC();
+        buffer[outLen] = (uint8)(packet->getCRC() >> 8);
+        buffer[outLen + 1] = (uint8)packet->getCRC();
         outLen += 2;
     }
 
+    return outLen;
+}
+
+//======================================================================================================================
+
+void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
+{
+    struct sockaddr     toAddr;
+    uint32              outLen;
+    int32               sent, toLen = sizeof(toAddr);
+
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX)
+    if(mSendBatchSize > 1)
+    {
+        // The packet gets copied into its batch slot, so it can be destroyed or resent before we flush.
+        outLen = _buildPacket(packet, session, mSendBatchBuffer + (mSendBatchCount * SEND_BUFFER_SIZE), &mSendAddresses[mSendBatchCount]);
+
+        mSendVectors[mSendBatchCount].iov_len = outLen;
+
+        if(++mSendBatchCount == mSendBatchSize)
+            _flushSendBatch();
+
+        return;
+    }
+#endif
+
+    outLen = _buildPacket(packet, session, mSendBuffer, &toAddr);
+
     sent = sendto(mSocket, mSendBuffer, outLen, 0, &toAddr, toLen);
 
+    mSendCallCount++;
+    mSendPacketCount++;
+
     if (sent < 0)
     {
         gLogger->log(LogManager::ALERT, "Unkown Error from socket sendto: %u", errno);
@@ -336,10 +422,93 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
 
 //======================================================================================================================
 
+void SocketWriteThread::_flushSendBatch(void)
+{
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX)
+    uint32 offset = 0;
+
+    while(offset < mSendBatchCount)
+    {
+        int sent = sendmmsg(mSocket, mSendHeaders + offset, mSendBatchCount - offset, 0);
+
+        mSendCallCount++;
+
+        if(sent <= 0)
+        {
+            if(errno == EINTR)
+                continue;
+
+            gLogger->log(LogManager::ALERT, "Unkown Error from socket sendmmsg: %u", errno);
+
+            // Skip the datagram the kernel refused, the reliable layer will resend it if needed.
+            sent = 1;
+        }
+        else
+        {
+            mSendPacketCount += sent;
+        }
+
+        offset += sent;
+    }
+
+    mSendBatchCount = 0;
+#endif
+}
+
+//======================================================================================================================
+
+void SocketWriteThread::_waitForWork(void)
+{
+    boost::mutex::scoped_lock lk(mWakeupMutex);
+
+    // We still wake up periodically so sessions get to process their resends and timeouts.
+    if(!mWakeupPending.load(boost::memory_order_acquire) && !mExit)
+    {
+        mWakeupCondition.timed_wait(lk, boost::posix_time::milliseconds(SEND_IDLE_WAIT));
+    }
+
+    mWakeupPending.store(false, boost::memory_order_release);
+}
+
+//======================================================================================================================
+
+void SocketWriteThread::Wakeup(void)
+{
+    // A wakeup already pending covers this one, the common case while the thread is busy costs a single exchange.
+    if(mWakeupPending.exchange(true, boost::memory_order_acq_rel))
+        return;
+
+    // Taking the mutex makes sure the thread is either still about to check the flag or already waiting.
+    boost::mutex::scoped_lock lk(mWakeupMutex);
+    mWakeupCondition.notify_one();
+}
+
+//======================================================================================================================
+
+void SocketWriteThread::_logSendStats(void)
+{
+    uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+    if(now - mLastStatsTime < 60000)
+        return;
+
+    mLastStatsTime = now;
+
+    if(!mSendCallCount)
+        return;
+
+    gLogger->log(LogManager::INFORMATION, "Service %u write thread: %.2f packets per send call (packets: %" PRIu64 ", calls: %" PRIu64 ", batch: %u)",
+                 mService->getId(), (float)mSendPacketCount / (float)mSendCallCount, mSendPacketCount, mSendCallCount, mSendBatchSize);
+}
+
+//======================================================================================================================
+
 void SocketWriteThread::NewSession(Session* session)
 {
     //using concurrent queue that has a recursive mutex
     mSessionQueue.push(session);
+
+    Wakeup();
 }
 
 //======================================================================================================================
@@ -33,10 +33,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/concurrent_queue.h"
 #include "NetworkManager/declspec.h"
 
+#include <boost/atomic.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 
 #define SEND_BUFFER_SIZE 8192
 
+// milliseconds the write thread sleeps when no session has anything queued
+#define SEND_IDLE_WAIT 10
+
 //======================================================================================================================
 
 class Service;
@@ -44,6 +50,10 @@ class Packet;
 class Session;
 class CompCryptor;
 
+struct mmsghdr;
+struct iovec;
+struct sockaddr;
+
 typedef Anh_Utils::concurrent_queue<Session*>    SessionQueue;
 
 //======================================================================================================================
@@ -59,6 +69,9 @@ public:
 
     void			NewSession(Session* session);
 
+    // Called whenever a session queued outgoing work, ends the idle wait of the write thread.
+    void			Wakeup(void);
+
     bool			getIsRunning(void) {
         return mIsRunning;
     }
@@ -72,6 +85,10 @@ private:
     void			_shutdown(void);
 
     void			_sendPacket(Packet* packet, Session* session);
+    uint32			_buildPacket(Packet* packet, Session* session, int8* buffer, struct sockaddr* toAddr);
+    void			_flushSendBatch(void);
+    void			_waitForWork(void);
+    void			_logSendStats(void);
 
     //void				*mtheHandle;
 
@@ -92,6 +109,19 @@ private:
     uint32				unCount;
     uint32				reCount;
     bool				mServerService;
+
+    // Batched send, only used when SocketWriteBatchSize > 1
+    int8*				mSendBatchBuffer;
+    struct mmsghdr*		mSendHeaders;
+    struct iovec*		mSendVectors;
+    struct sockaddr*	mSendAddresses;
+    uint32				mSendBatchSize;
+    uint32				mSendBatchCount;
+
+    // Statistics
+    uint64				mSendCallCount;
+    uint64				mSendPacketCount;
+    uint64				mLastStatsTime;
     // Anh_Utils::Clock*	mClock;
 
     // Win32 complains about stl during linkage, disable the warning.
@@ -102,12 +132,15 @@ private:
 
     boost::thread   			mThread;
     boost::recursive_mutex      mSocketWriteMutex;
+    boost::mutex				mWakeupMutex;
+    boost::condition_variable	mWakeupCondition;
     // Re-enable the warning.
 #ifdef _WIN32
 #pragma warning (default : 4251)
 #endif
 
     bool						mExit;
+    boost::atomic<bool>			mWakeupPending;	// set by the producers, only the false -> true transition takes the mutex
 };
 
 //======================================================================================================================
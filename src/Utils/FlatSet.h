@@ -0,0 +1,338 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef SRC_UTILS_FLATSET_H_
+#define SRC_UTILS_FLATSET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "Utils/typedefs.h"
+
+namespace utils {
+
+/**
+ * FlatSet is a set kept as a sorted vector, meant for the small sets every object carries around
+ * such as its known objects and known players.
+ *
+ * Lookups are a binary search over contiguous memory and iterating is a walk over an array,
+ * instead of chasing red-black tree nodes all over the heap. The interface mirrors std::set so it
+ * can stand in for one.
+ *
+ * Erasing only marks the slot as erased, nothing moves. Iterators stay valid when any element is
+ * erased, the erased element included, so the std::set idiom erase(it++) works and a broadcast
+ * over the set survives a receiver being removed from it underneath. Erased slots are reused when
+ * the same value comes back and are squeezed out by an insert once they make up half of the
+ * storage.
+ *
+ * Inserting may move elements. Every move bumps the set's epoch, an iterator that sees a newer
+ * epoch looks the element it stands on up again. As with std::set an iteration that inserts or
+ * erases visits each element that stays in the set exactly once, elements inserted underneath it
+ * may or may not come up.
+ */
+template <typename T, typename Compare = std::less<T> >
+class FlatSet {
+public:
+    typedef T key_type;
+    typedef T value_type;
+    typedef Compare key_compare;
+    typedef std::size_t size_type;
+
+    /// Elements are constant, iterator and const_iterator are the same as for std::set.
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        const_iterator() : set_(nullptr), index_(kEnd_), epoch_(0), value_(), ahead_(false) {}
+
+        reference operator*() const {
+            sync_();
+            return set_->values_[index_];
+        }
+        pointer operator->() const {
+            sync_();
+            return &set_->values_[index_];
+        }
+
+        const_iterator& operator++() {
+            sync_();
+
+            // the element we stood on was squeezed out, we already stand on the one after it
+            if (ahead_) {
+                ahead_ = false;
+            } else if (index_ != kEnd_) {
+                moveTo_(set_->nextLive_(index_ + 1));
+            }
+
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        /// Any two iterators past the last slot are equal, a cached end() survives the set changing.
+        bool operator==(const const_iterator& other) const {
+            sync_();
+            other.sync_();
+            return index_ == other.index_;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class FlatSet;
+
+        const_iterator(const FlatSet* set, size_type index) : set_(set), index_(kEnd_), epoch_(0), value_(), ahead_(false) {
+            moveTo_(index);
+        }
+
+        bool atEnd_() const {
+            sync_();
+            return index_ == kEnd_;
+        }
+
+        void moveTo_(size_type index) const {
+            epoch_ = set_->epoch_;
+
+            if (index < set_->values_.size()) {
+                index_ = index;
+                value_ = set_->values_[index];
+            } else {
+                index_ = kEnd_;
+            }
+        }
+
+        /// Finds the element again after the slots moved, or the next live one if it was squeezed out.
+        void sync_() const {
+            if (index_ == kEnd_ || epoch_ == set_->epoch_) {
+                return;
+            }
+
+            size_type index = set_->lowerBound_(value_);
+
+            if (index < set_->values_.size() && !set_->compare_(value_, set_->values_[index])) {
+                moveTo_(index);
+                return;
+            }
+
+            moveTo_(set_->nextLive_(index));
+            ahead_ = true;
+        }
+
+        const FlatSet* set_;
+        mutable size_type index_;
+        mutable size_type epoch_;
+        mutable T value_;
+        mutable bool ahead_;
+    };
+
+    typedef const_iterator iterator;
+
+    FlatSet() : size_(0), erased_(0), epoch_(0) {}
+
+    const_iterator begin() const {
+        return const_iterator(this, nextLive_(0));
+    }
+    const_iterator end() const {
+        return const_iterator(this, values_.size());
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+    size_type size() const {
+        return size_;
+    }
+
+    void clear() {
+        values_.clear();
+        live_.clear();
+        size_ = 0;
+        erased_ = 0;
+        ++epoch_;
+    }
+
+    /// Reserves room for count elements, sets that are known to grow can skip the reallocations.
+    void reserve(size_type count) {
+        values_.reserve(count);
+        live_.reserve(count);
+    }
+
+    const_iterator find(const T& value) const {
+        size_type index = lowerBound_(value);
+
+        if (index < values_.size() && live_[index] && !compare_(value, values_[index])) {
+            return const_iterator(this, index);
+        }
+
+        return end();
+    }
+
+    size_type count(const T& value) const {
+        return (find(value) != end()) ? 1 : 0;
+    }
+
+    /**
+     * Inserts a value if it is not in the set yet.
+     *
+     * \param value The value to insert.
+     * \return The iterator to the value and true if it was inserted, as std::set::insert.
+     */
+    std::pair<const_iterator, bool> insert(const T& value) {
+        size_type index = lowerBound_(value);
+
+        if (index < values_.size() && !compare_(value, values_[index])) {
+            if (live_[index]) {
+                return std::make_pair(const_iterator(this, index), false);
+            }
+
+            // Erased before, bring it back in place.
+            live_[index] = 1;
+            ++size_;
+            --erased_;
+
+            return std::make_pair(const_iterator(this, index), true);
+        }
+
+        if (erased_ && erased_ * 2 >= values_.size()) {
+            compact_();
+            index = lowerBound_(value);
+        }
+
+        values_.insert(values_.begin() + index, value);
+        live_.insert(live_.begin() + index, 1);
+        ++size_;
+        ++epoch_;
+
+        return std::make_pair(const_iterator(this, index), true);
+    }
+
+    /// Erases the element the iterator points to, the iterator stays valid.
+    void erase(const_iterator it) {
+        // an iterator pushed on to the next element no longer stands on what it was asked to erase
+        if (it.atEnd_() || it.ahead_ || !live_[it.index_]) {
+            return;
+        }
+
+        live_[it.index_] = 0;
+        ++erased_;
+
+        // The last one is gone, no iterator can point to a live element anymore.
+        if (--size_ == 0) {
+            clear();
+        }
+    }
+
+    size_type erase(const T& value) {
+        const_iterator it = find(value);
+
+        if (it == end()) {
+            return 0;
+        }
+
+        erase(it);
+        return 1;
+    }
+
+    void swap(FlatSet& other) {
+        values_.swap(other.values_);
+        live_.swap(other.live_);
+        std::swap(size_, other.size_);
+        std::swap(erased_, other.erased_);
+        ++epoch_;
+        ++other.epoch_;
+    }
+
+private:
+    static const size_type kEnd_ = static_cast<size_type>(-1);
+
+    /// Binary search that picks the half without a branch, a mispredicted jump per step costs more than the compare.
+    size_type lowerBound_(const T& value) const {
+        size_type count = values_.size();
+
+        if (count == 0) {
+            return 0;
+        }
+
+        const T* base = &values_[0];
+
+        while (count > 1) {
+            size_type half = count / 2;
+            base = compare_(base[half], value) ? base + half : base;
+            count -= half;
+        }
+
+        return (base - &values_[0]) + (compare_(*base, value) ? 1 : 0);
+    }
+
+    size_type nextLive_(size_type index) const {
+        while (index < values_.size() && !live_[index]) {
+            ++index;
+        }
+
+        return index;
+    }
+
+    void compact_() {
+        size_type write = 0;
+
+        for (size_type read = 0; read < values_.size(); ++read) {
+            if (live_[read]) {
+                values_[write] = values_[read];
+                live_[write] = 1;
+                ++write;
+            }
+        }
+
+        values_.resize(write);
+        live_.resize(write);
+        erased_ = 0;
+        ++epoch_;
+    }
+
+    std::vector<T> values_;
+    std::vector<uint8> live_;
+    size_type size_;
+    size_type erased_;
+    size_type epoch_;
+    Compare compare_;
+};
+
+}  // namespace utils
+
+#endif  // SRC_UTILS_FLATSET_H_
@@ -0,0 +1,173 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef SRC_UTILS_SPSCQUEUE_H_
+#define SRC_UTILS_SPSCQUEUE_H_
+
+#include "Utils/typedefs.h"
+
+#pragma warning(disable:4800)
+#pragma warning(disable:4244)
+#include <boost/atomic.hpp>
+#pragma warning(default:4244)
+#pragma warning(default:4800)
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+namespace utils {
+
+/**
+ * SpscQueue is an unbounded single-producer, single-consumer queue used to hand items from
+ * exactly one thread to exactly one other thread without taking a lock.
+ *
+ * Items are stored in fixed size blocks that are chained together, so a push only allocates
+ * once every BlockSize items and the queue never has to refuse an item. The producer publishes
+ * an item by bumping the push count with release semantics, the consumer acquires it before
+ * reading the slot. The interface mirrors std::queue so it can stand in for one.
+ *
+ * push() may only be called from the producer thread; front(), pop() and empty() only from the
+ * consumer thread. size() may be called from either side and returns a snapshot.
+ */
+template <typename T, uint32 BlockSize = 256>
+class SpscQueue {
+public:
+    /// Default constructor initializes the queue to a default state.
+    SpscQueue()
+        : head_(new Block())
+        , read_index_(0)
+        , pop_count_(0)
+        , tail_(head_)
+        , write_index_(0)
+        , push_count_(0) {}
+
+    /// Default destructor releases the blocks, items still in the queue are dropped.
+    ~SpscQueue() {
+        while (head_ != nullptr) {
+            Block* tmp = head_;
+            head_ = tmp->next;
+            delete tmp;
+        }
+    }
+
+    /**
+     * Pushes an item onto the back of the queue, producer thread only.
+     *
+     * \param t The item being pushed onto the queue.
+     */
+    void push(const T& t) {
+        if (write_index_ == BlockSize) {
+            // The consumer never looks at next before the push count tells it there is an
+            // item in there, so a plain store is enough here.
+            Block* block = new Block();
+            tail_->next = block;
+            tail_ = block;
+            write_index_ = 0;
+        }
+
+        tail_->items[write_index_++] = t;
+
+        push_count_.store(push_count_.load(::boost::memory_order_relaxed) + 1, ::boost::memory_order_release);
+    }
+
+    /// Returns true if there is nothing to pop, consumer thread only.
+    bool empty() const {
+        return pop_count_.load(::boost::memory_order_relaxed) == push_count_.load(::boost::memory_order_acquire);
+    }
+
+    /// Returns the amount of items currently queued.
+    uint32 size() const {
+        return push_count_.load(::boost::memory_order_acquire) - pop_count_.load(::boost::memory_order_acquire);
+    }
+
+    /**
+     * Returns the item at the front of the queue, consumer thread only.
+     *
+     * The queue must not be empty.
+     */
+    T& front() {
+        if (read_index_ == BlockSize) {
+            _nextBlock();
+        }
+
+        return head_->items[read_index_];
+    }
+
+    /// Removes the item at the front of the queue, consumer thread only. The queue must not be empty.
+    void pop() {
+        if (read_index_ == BlockSize) {
+            _nextBlock();
+        }
+
+        head_->items[read_index_++] = T();
+
+        pop_count_.store(pop_count_.load(::boost::memory_order_relaxed) + 1, ::boost::memory_order_release);
+    }
+
+private:
+    // Not copyable, the producer and consumer each hold pointers into the block chain.
+    SpscQueue(const SpscQueue&);
+    SpscQueue& operator=(const SpscQueue&);
+
+    struct Block {
+        Block() : next(nullptr) {}
+
+        T items[BlockSize];
+        Block* next;
+    };
+
+    // The consumer drained the head block, the producer has already moved on to the next one
+    // (we only get here with an item pending) so it is safe to release it.
+    void _nextBlock() {
+        Block* old_head = head_;
+        head_ = head_->next;
+        read_index_ = 0;
+
+        delete old_head;
+    }
+
+    // @note: The padding keeps the consumer and producer state on separate cache lines so
+    // the two threads do not contend on them.
+    char pad0[CACHE_LINE_SIZE];
+
+    // Consumer state.
+    Block* head_;
+    uint32 read_index_;
+    ::boost::atomic<uint32> pop_count_;
+    char pad1[CACHE_LINE_SIZE];
+
+    // Producer state.
+    Block* tail_;
+    uint32 write_index_;
+    ::boost::atomic<uint32> push_count_;
+    char pad2[CACHE_LINE_SIZE];
+};
+
+}  // namespace utils
+
+#endif  // SRC_UTILS_SPSCQUEUE_H_
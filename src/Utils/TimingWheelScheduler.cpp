@@ -0,0 +1,335 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "TimingWheelScheduler.h"
+
+namespace Anh_Utils
+{
+//======================================================================================================================
+
+TimingWheelScheduler::TimingWheelScheduler(uint64 processTimeLimit, uint64 throttleLimit) : mDue(Nil),mDueTail(Nil),mFree(Nil),mTaskCount(0),mGeneration(0),mCurrentTick(0),mProcessTimeLimit(processTimeLimit),mThrottleLimit(throttleLimit)
+{
+    mLastProcessTime = 0;
+
+    for(uint32 level = 0; level < LevelCount; level++)
+    {
+        for(uint32 slot = 0; slot < LevelSlots; slot++)
+        {
+            mSlots[level][slot] = Nil;
+        }
+    }
+}
+
+//======================================================================================================================
+
+TimingWheelScheduler::~TimingWheelScheduler()
+{
+}
+
+//======================================================================================================================
+
+uint64 TimingWheelScheduler::addTask(FDCallback callback,uint8 priority,uint64 interval,void* async)
+{
+    uint64 currentTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+    if(!mCurrentTick)
+        mCurrentTick = currentTime;
+
+    uint32 index = mFree;
+
+    if(index != Nil)
+    {
+        mFree = mNodes[index].mNext;
+    }
+    else
+    {
+        index = static_cast<uint32>(mNodes.size());
+        mNodes.push_back(TaskNode());
+    }
+
+    // skip 0, an id of 0 means no task to our callers
+    if(!++mGeneration)
+        ++mGeneration;
+
+    TaskNode& node	= mNodes[index];
+    node.mId		= (static_cast<uint64>(mGeneration) << 32) | index;
+    node.mDueTime	= currentTime + interval + 1;
+    node.mInterval	= interval;
+    node.mCallback	= callback;
+    node.mAsync		= async;
+    node.mPriority	= priority;
+    node.mRemoved	= false;
+
+    mTaskCount++;
+    _insert(index);
+
+    return(node.mId);
+}
+
+//======================================================================================================================
+
+void TimingWheelScheduler::removeTask(uint64 id)
+{
+    TaskNode* node = _getNode(id);
+
+    if(!node)
+        return;
+
+    uint32 index = static_cast<uint32>(id);
+
+    // a running task gets released once its callback returns
+    if(node->mList)
+    {
+        _unlink(index);
+        _release(index);
+    }
+    else
+        node->mRemoved = true;
+}
+
+//======================================================================================================================
+
+bool TimingWheelScheduler::checkTask(uint64 id)
+{
+    TaskNode* node = _getNode(id);
+
+    return(node && !node->mRemoved);
+}
+
+//======================================================================================================================
+
+void TimingWheelScheduler::process()
+{
+    uint64	frameStartTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+    //Check for throttle
+    if(frameStartTime < (mLastProcessTime + mThrottleLimit))
+    {
+        return;
+    }
+
+    processUntil(frameStartTime);
+
+    //Set internal Clock so we know when the last call was
+    mLastProcessTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+}
+
+//======================================================================================================================
+
+void TimingWheelScheduler::processUntil(uint64 currentTime)
+{
+    uint64 frameStartTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+    if(!mCurrentTick)
+        mCurrentTick = currentTime;
+
+    while(true)
+    {
+        // whatever is due goes first, leftovers of the last call included
+        while(mDue != Nil)
+        {
+            _runDueTask(currentTime);
+
+            if((Anh_Utils::Clock::getSingleton()->getLocalTime() - frameStartTime) >= mProcessTimeLimit)
+                return;
+        }
+
+        if(mCurrentTick > currentTime)
+            return;
+
+        // nothing to look at, catch up in one go
+        if(!mTaskCount)
+        {
+            mCurrentTick = currentTime + 1;
+            return;
+        }
+
+        uint32 slot = static_cast<uint32>(mCurrentTick & LevelMask);
+
+        if(!slot)
+            _cascade(1);
+
+        // everything in this slot is due now
+        while(mSlots[0][slot] != Nil)
+        {
+            uint32 index = mSlots[0][slot];
+            _unlink(index);
+            _appendDue(index);
+        }
+
+        ++mCurrentTick;
+    }
+}
+
+//======================================================================================================================
+
+bool TimingWheelScheduler::_runDueTask(uint64 currentTime)
+{
+    uint32 index = mDue;
+    _unlink(index);
+
+    // the callback may add tasks and with that move our nodes, so no references across it
+    FDCallback	callback	= mNodes[index].mCallback;
+    void*		async		= mNodes[index].mAsync;
+
+    bool keep = callback(currentTime,async);
+
+    TaskNode& node = mNodes[index];
+
+    if(!keep || node.mRemoved)
+    {
+        _release(index);
+        return(false);
+    }
+
+    node.mDueTime = currentTime + node.mInterval + 1;
+    _insert(index);
+
+    return(true);
+}
+
+//======================================================================================================================
+//
+// Files a task by the distance to its due time, the level is the first one whose span covers it.
+//
+void TimingWheelScheduler::_insert(uint32 index)
+{
+    uint64 dueTime	= std::max<uint64>(mNodes[index].mDueTime, mCurrentTick);
+    uint64 delta	= dueTime - mCurrentTick;
+    uint32 level	= 0;
+
+    while((level < LevelCount - 1) && (delta >> (LevelBits * (level + 1))))
+        level++;
+
+    // past the span of the wheel, park it in the farthest slot, it gets filed again when that one cascades
+    if(delta >> (LevelBits * LevelCount))
+        dueTime = mCurrentTick + (static_cast<uint64>(1) << (LevelBits * LevelCount)) - 1;
+
+    _link(&mSlots[level][(dueTime >> (LevelBits * level)) & LevelMask],index);
+}
+
+//======================================================================================================================
+//
+// Level wrapped around, move the tasks of the next slot of level down to where they belong now.
+//
+void TimingWheelScheduler::_cascade(uint32 level)
+{
+    uint32 slot = static_cast<uint32>((mCurrentTick >> (LevelBits * level)) & LevelMask);
+
+    if(!slot && (level < LevelCount - 1))
+        _cascade(level + 1);
+
+    while(mSlots[level][slot] != Nil)
+    {
+        uint32 index = mSlots[level][slot];
+        _unlink(index);
+        _insert(index);
+    }
+}
+
+//======================================================================================================================
+
+void TimingWheelScheduler::_link(uint32* list, uint32 index)
+{
+    TaskNode& node = mNodes[index];
+
+    node.mPrev = Nil;
+    node.mNext = *list;
+    node.mList = list;
+
+    if(*list != Nil)
+        mNodes[*list].mPrev = index;
+
+    *list = index;
+}
+
+//======================================================================================================================
+
+void TimingWheelScheduler::_appendDue(uint32 index)
+{
+    TaskNode& node = mNodes[index];
+
+    node.mPrev = mDueTail;
+    node.mNext = Nil;
+    node.mList = &mDue;
+
+    if(mDueTail != Nil)
+        mNodes[mDueTail].mNext = index;
+    else
+        mDue = index;
+
+    mDueTail = index;
+}
+
+//======================================================================================================================
+
+void TimingWheelScheduler::_unlink(uint32 index)
+{
+    TaskNode& node = mNodes[index];
+
+    if(node.mPrev != Nil)
+        mNodes[node.mPrev].mNext = node.mNext;
+    else
+        *node.mList = node.mNext;
+
+    if(node.mNext != Nil)
+        mNodes[node.mNext].mPrev = node.mPrev;
+    else if(node.mList == &mDue)
+        mDueTail = node.mPrev;
+
+    node.mList = 0;
+}
+
+//======================================================================================================================
+
+void TimingWheelScheduler::_release(uint32 index)
+{
+    TaskNode& node = mNodes[index];
+
+    node.mId		= 0;
+    node.mList		= 0;
+    node.mRemoved	= false;
+    node.mNext		= mFree;
+
+    mFree = index;
+    mTaskCount--;
+}
+
+//======================================================================================================================
+
+TimingWheelScheduler::TaskNode* TimingWheelScheduler::_getNode(uint64 id)
+{
+    uint32 index = static_cast<uint32>(id);
+
+    if(!id || (index >= mNodes.size()) || (mNodes[index].mId != id))
+        return(0);
+
+    return(&mNodes[index]);
+}
+}
+
+//======================================================================================================================
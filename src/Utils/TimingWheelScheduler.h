@@ -0,0 +1,132 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_UTILS_TIMINGWHEELSCHEDULER_H
+#define ANH_UTILS_TIMINGWHEELSCHEDULER_H
+
+#include <vector>
+
+#include "typedefs.h"
+#include "FastDelegate.h"
+#include "Scheduler.h"
+#include "clock.h"
+
+#include "Utils/declspec.h"
+
+
+namespace Anh_Utils
+{
+//======================================================================================================================
+//
+// Drop in for the Scheduler when there are many tasks of which only a few are due at any time.
+//
+// Tasks sit in a hierarchical timing wheel: four levels of 256 slots with a resolution of 1ms, covering 256ms,
+// 65s, 4.6h and 49 days. A task is filed by its due time, and when a level wraps around the next level's slot is
+// cascaded down, so process() only ever looks at the tasks that are due. Task ids carry the index of their node,
+// adding, removing and checking a task are O(1).
+//
+// Tasks due in the same millisecond run in the order they got due, the priority is kept but not used for ordering.
+// Like the Scheduler a task runs once more than interval milliseconds have passed since it was added or last ran.
+//
+
+class UTILS_API TimingWheelScheduler
+{
+public:
+
+    TimingWheelScheduler(uint64 processTimeLimit = 100, uint64 throttleLimit = 0);
+    ~TimingWheelScheduler();
+
+    uint64	addTask(FDCallback callback,uint8 priority,uint64 interval,void* async);
+    void	removeTask(uint64 id);
+    bool	checkTask(uint64 id);
+    void	process();
+
+    // Runs what is due until currentTime, process() does this for the local time.
+    void	processUntil(uint64 currentTime);
+
+    uint32	getTaskCount() const {
+        return mTaskCount;
+    }
+
+protected:
+
+    enum
+    {
+        LevelBits	= 8,
+        LevelSlots	= 1 << LevelBits,
+        LevelMask	= LevelSlots - 1,
+        LevelCount	= 4,
+        Nil			= 0xffffffff
+    };
+
+    struct TaskNode
+    {
+        uint64		mId;
+        uint64		mDueTime;
+        uint64		mInterval;
+        FDCallback	mCallback;
+        void*		mAsync;
+        uint32		mPrev;
+        uint32		mNext;
+        uint32*		mList;		// head of the slot or due list we are linked into, 0 while free or running
+        uint8		mPriority;
+        bool		mRemoved;	// removed from within its own callback
+    };
+
+    void	_insert(uint32 index);
+    void	_link(uint32* list, uint32 index);
+    void	_appendDue(uint32 index);
+    void	_unlink(uint32 index);
+    void	_release(uint32 index);
+    void	_cascade(uint32 level);
+    bool	_runDueTask(uint64 currentTime);
+    TaskNode* _getNode(uint64 id);
+
+    // Win32 complains about stl during linkage, disable the warning.
+#ifdef _WIN32
+#pragma warning (disable : 4251)
+#endif
+    std::vector<TaskNode>	mNodes;
+    // Re-enable the warning.
+#ifdef _WIN32
+#pragma warning (default : 4251)
+#endif
+
+    uint32				mSlots[LevelCount][LevelSlots];
+    uint32				mDue;			// tasks that are due but did not fit into the process time limit yet
+    uint32				mDueTail;
+    uint32				mFree;
+    uint32				mTaskCount;
+    uint32				mGeneration;	// upper half of the task ids, so ids of released nodes go stale
+    uint64				mCurrentTick;	// the next millisecond to look at, everything before has been filed as due
+    uint64				mProcessTimeLimit, mThrottleLimit, mLastProcessTime;
+};
+}
+
+#endif
+
+//======================================================================================================================
@@ -348,7 +348,7 @@ void ArtisanManager::sampleEvent(PlayerObject* player, CurrentResource* resource
     float					ratio			= (resource->getDistribution((int)player->mPosition.x + 8192,(int)player->mPosition.z + 8192));
     int32					surveyMod		= player->getSkillModValue(SMod_surveying);
     uint32					sampleAmount	= 0;
-    ObjectSet::iterator	it					= player->getKnownObjects()->begin();
+    KnownObjectSet::iterator	it					= player->getKnownObjects()->begin();
     BString					resName			= resource->getName().getAnsi();
     uint32					resType			= resource->getType()->getCategoryId();
     uint16					resPE			= resource->getAttribute(ResAttr_PE);
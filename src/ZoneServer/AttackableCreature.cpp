@@ -32,7 +32,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "MessageLib/MessageLib.h"
 #include "NpcManager.h"
 #include "PlayerObject.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "ResourceContainer.h"
 #include "Weapon.h"
 #include "WorldManager.h"
@@ -2410,7 +2410,7 @@ void AttackableCreature::respawn(void)
     // Put this sucker in the Dormant queue.
     this->clearSpawned();
 
-    gWorldManager->addDormantNpc(this->getId(), mTimeToFirstSpawn);
+    gWorldManager->addDormantNpc(this, mTimeToFirstSpawn);
 }
 
 //=============================================================================
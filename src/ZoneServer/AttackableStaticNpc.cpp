@@ -28,7 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "AttackableStaticNpc.h"
 #include "CellObject.h"
 #include "PlayerObject.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "WorldConfig.h"
 #include "WorldManager.h"
 #include "ZoneTree.h"
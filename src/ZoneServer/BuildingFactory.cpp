@@ -87,25 +87,20 @@ void BuildingFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result
     {
         BuildingObject* building = _createBuilding(result);
 
-        QueryContainerBase* asContainer;
+        if(!building)
+        {
+            gLogger->log(LogManager::DEBUG,"BuildingFactory: no building found");
+            break;
+        }
 
         // if its a cloning facility, query its spawn points
         if(building->getBuildingFamily() == BuildingFamily_Cloning_Facility)
         {
-            asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,BFQuery_CloneData,asyncContainer->mClient);
-            asContainer->mObject = building;
-
-            mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT spawn_clone.parentId,spawn_clone.oX,spawn_clone.oY,spawn_clone.oZ,spawn_clone.oW,"
-                                       "spawn_clone.cell_x,spawn_clone.cell_y,spawn_clone.cell_z,spawn_clone.city "
-                                       "FROM  spawn_clone "
-                                       "INNER JOIN cells ON spawn_clone.parentid = cells.id "
-                                       "INNER JOIN buildings ON cells.parent_id = buildings.id "
-                                       "WHERE buildings.id = %"PRIu64";",building->getId());
-           
+            _requestCloneData(building,BFQuery_CloneData,asyncContainer->mOfCallback,asyncContainer->mClient);
         }
         else
         {
-            asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,BFQuery_Cells,asyncContainer->mClient);
+            QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,BFQuery_Cells,asyncContainer->mClient);
             asContainer->mObject = building;
 
             mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT id FROM cells WHERE parent_id = %"PRIu64";",building->getId());
@@ -115,6 +110,7 @@ void BuildingFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result
     break;
 
     case BFQuery_CloneData:
+    case BFQuery_PlanetCloneData:
     {
         BuildingObject*	building = dynamic_cast<BuildingObject*>(asyncContainer->mObject);
 
@@ -135,6 +131,12 @@ void BuildingFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result
         }
 
         // load cells
+        if(asyncContainer->mQueryType == BFQuery_PlanetCloneData)
+        {
+            _loadPlanetCells(building,asyncContainer->mOfCallback,asyncContainer->mClient);
+            break;
+        }
+
         QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,BFQuery_Cells,asyncContainer->mClient);
         asContainer->mObject = building;
 
@@ -146,27 +148,73 @@ void BuildingFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result
     case BFQuery_Cells:
     {
         BuildingObject*	building = dynamic_cast<BuildingObject*>(asyncContainer->mObject);
-        uint32			cellCount;
+        CellIdList		cells;
         uint64			cellId;
 
         DataBinding*	cellBinding = mDatabase->CreateDataBinding(1);
         cellBinding->addField(DFT_int64,0,8);
 
-        // store us for later lookup
-        mObjectLoadMap.insert(std::make_pair(building->getId(),new(mILCPool.ordered_malloc()) InLoadingContainer(building,asyncContainer->mOfCallback,asyncContainer->mClient)));
+        while(result->GetNextRow(cellBinding,&cellId))
+        {
+            cells.push_back(cellId);
+        }
+
+        mDatabase->DestroyDataBinding(cellBinding);
+
+        _loadCells(building,cells,asyncContainer->mOfCallback,asyncContainer->mClient);
+    }
+    break;
 
-        cellCount = static_cast<uint32>(result->getRowCount());
+    // streamed, cell id and building id of every cell on the planet
+    case BFQuery_PlanetCells:
+    {
+        uint64	cellRow[2];
+        uint32	cellCount = 0;
 
-        building->setLoadCount(cellCount);
+        DataBinding*	cellBinding = mDatabase->CreateDataBinding(2);
+        cellBinding->addField(DFT_uint64,0,8,0);
+        cellBinding->addField(DFT_uint64,8,8,1);
 
-        for(uint32 j = 0; j < cellCount; j++)
+        while(result->GetNextRow(cellBinding,cellRow))
         {
-            result->GetNextRow(cellBinding,&cellId);
-
-            mCellFactory->requestObject(this,cellId,0,0,asyncContainer->mClient);
+            mPlanetCells[cellRow[1]].push_back(cellRow[0]);
+            cellCount++;
         }
 
         mDatabase->DestroyDataBinding(cellBinding);
+
+        gLogger->log(LogManager::DEBUG,"BuildingFactory: Read %u cells of %u buildings",cellCount,static_cast<uint32>(mPlanetCells.size()));
+
+        mDatabase->ExecuteSqlStreamAsync(this,new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,BFQuery_PlanetBuildings,asyncContainer->mClient,asyncContainer->mId),
+                                         "SELECT buildings.id,buildings.oX,buildings.oY,buildings.oZ,buildings.oW,buildings.x,"
+                                         "buildings.y,buildings.z,building_types.model,building_types.width,building_types.height,"
+                                         "building_types.file,building_types.name,building_types.family "
+                                         "FROM buildings INNER JOIN building_types ON (buildings.type_id = building_types.id) "
+                                         "WHERE (buildings.planet_id = %"PRIu64")",asyncContainer->mId);
+    }
+    break;
+
+    // streamed, every row becomes a building right away
+    case BFQuery_PlanetBuildings:
+    {
+        uint32 buildingCount = 0;
+
+        while(BuildingObject* building = _createBuilding(result))
+        {
+            if(building->getBuildingFamily() == BuildingFamily_Cloning_Facility)
+            {
+                _requestCloneData(building,BFQuery_PlanetCloneData,asyncContainer->mOfCallback,asyncContainer->mClient);
+            }
+            else
+            {
+                _loadPlanetCells(building,asyncContainer->mOfCallback,asyncContainer->mClient);
+            }
+
+            buildingCount++;
+        }
+
+        if(buildingCount)
+            gLogger->log(LogManager::NOTICE,"Loaded %u buildings",buildingCount);
     }
     break;
 
@@ -192,13 +240,81 @@ void BuildingFactory::requestObject(ObjectFactoryCallback* ofCallback,uint64 id,
 
 //=============================================================================
 
+void BuildingFactory::requestPlanetBuildings(ObjectFactoryCallback* ofCallback,uint32 planetId,DispatchClient* client)
+{
+    mDatabase->ExecuteSqlStreamAsync(this,new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,BFQuery_PlanetCells,client,planetId),
+                                     "SELECT cells.id,cells.parent_id FROM cells "
+                                     "INNER JOIN buildings ON (cells.parent_id = buildings.id) "
+                                     "WHERE (buildings.planet_id = %u)",planetId);
+}
+
+//=============================================================================
+
+void BuildingFactory::_requestCloneData(BuildingObject* building,uint32 queryType,ObjectFactoryCallback* ofCallback,DispatchClient* client)
+{
+    QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,queryType,client);
+    asContainer->mObject = building;
+
+    mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT spawn_clone.parentId,spawn_clone.oX,spawn_clone.oY,spawn_clone.oZ,spawn_clone.oW,"
+                               "spawn_clone.cell_x,spawn_clone.cell_y,spawn_clone.cell_z,spawn_clone.city "
+                               "FROM  spawn_clone "
+                               "INNER JOIN cells ON spawn_clone.parentid = cells.id "
+                               "INNER JOIN buildings ON cells.parent_id = buildings.id "
+                               "WHERE buildings.id = %"PRIu64";",building->getId());
+}
+
+//=============================================================================
+
+void BuildingFactory::_loadCells(BuildingObject* building,const CellIdList& cells,ObjectFactoryCallback* ofCallback,DispatchClient* client)
+{
+    // nothing to wait for
+    if(cells.empty())
+    {
+        ofCallback->handleObjectReady(building,client);
+        return;
+    }
+
+    // store us for later lookup
+    mObjectLoadMap.insert(std::make_pair(building->getId(),new(mILCPool.ordered_malloc()) InLoadingContainer(building,ofCallback,client)));
+
+    building->setLoadCount(static_cast<uint32>(cells.size()));
+
+    for(CellIdList::const_iterator it = cells.begin(); it != cells.end(); ++it)
+    {
+        mCellFactory->requestCell(this,(*it),building->getId(),client);
+    }
+}
+
+//=============================================================================
+
+void BuildingFactory::_loadPlanetCells(BuildingObject* building,ObjectFactoryCallback* ofCallback,DispatchClient* client)
+{
+    BuildingCellMap::iterator it = mPlanetCells.find(building->getId());
+
+    if(it == mPlanetCells.end())
+    {
+        _loadCells(building,CellIdList(),ofCallback,client);
+        return;
+    }
+
+    CellIdList cells;
+    cells.swap((*it).second);
+    mPlanetCells.erase(it);
+
+    _loadCells(building,cells,ofCallback,client);
+}
+
+//=============================================================================
+
 BuildingObject* BuildingFactory::_createBuilding(DatabaseResult* result)
 {
     BuildingObject*	buildingObject = new BuildingObject();
 
-    uint64 count = result->getRowCount();
-
-    result->GetNextRow(mBuildingBinding,buildingObject);
+    if(!result->GetNextRow(mBuildingBinding,buildingObject))
+    {
+        delete(buildingObject);
+        return(NULL);
+    }
 
     buildingObject->setLoadState(LoadState_Loaded);
     buildingObject->setPlayerStructureFamily(PlayerStructure_TreBuilding);
@@ -28,6 +28,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ANH_ZONESERVER_BUILDING_OBJECT_FACTORY_H
 #define ANH_ZONESERVER_BUILDING_OBJECT_FACTORY_H
 
+#include <map>
+#include <vector>
+
 #include "ObjectFactoryCallback.h"
 #include "FactoryBase.h"
 
@@ -46,11 +49,17 @@ class DispatchClient;
 
 enum BFQuery
 {
-    BFQuery_MainData	= 1,
-    BFQuery_Cells		= 2,
-    BFQuery_CloneData	= 3
+    BFQuery_MainData		= 1,
+    BFQuery_Cells			= 2,
+    BFQuery_CloneData		= 3,
+    BFQuery_PlanetCells		= 4,
+    BFQuery_PlanetBuildings	= 5,
+    BFQuery_PlanetCloneData	= 6
 };
 
+typedef std::vector<uint64>				CellIdList;
+typedef std::map<uint64,CellIdList>		BuildingCellMap;
+
 //=============================================================================
 
 class BuildingFactory : public FactoryBase, public ObjectFactoryCallback
@@ -68,6 +77,10 @@ public:
     void			handleDatabaseJobComplete(void* ref,DatabaseResult* result);
     void			requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client);
 
+    // Loads every building of a planet, the cells of all of them come with one join up front.
+    // Both are streamed, ofCallback gets each building once its cells are ready.
+    void			requestPlanetBuildings(ObjectFactoryCallback* ofCallback,uint32 planetId,DispatchClient* client);
+
     void			releaseAllPoolsMemory();
 
 private:
@@ -78,6 +91,9 @@ private:
     void			_destroyDatabindings();
 
     BuildingObject*	_createBuilding(DatabaseResult* result);
+    void			_requestCloneData(BuildingObject* building,uint32 queryType,ObjectFactoryCallback* ofCallback,DispatchClient* client);
+    void			_loadCells(BuildingObject* building,const CellIdList& cells,ObjectFactoryCallback* ofCallback,DispatchClient* client);
+    void			_loadPlanetCells(BuildingObject* building,ObjectFactoryCallback* ofCallback,DispatchClient* client);
 
     static BuildingFactory*		mSingleton;
     static bool					mInsFlag;
@@ -86,6 +102,9 @@ private:
 
     DataBinding*				mBuildingBinding;
     DataBinding*				mSpawnBinding;
+
+    // cell ids of the buildings of a planet load, an entry goes once its building requested the cells
+    BuildingCellMap				mPlanetCells;
 };
 
 //=============================================================================
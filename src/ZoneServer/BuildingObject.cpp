@@ -134,28 +134,18 @@ uint16 BuildingObject::getCellContentCount()
 }
 
 
-ObjectList BuildingObject::getAllCellChilds()
-{
-    ObjectIDList*	tmpList;
-    ObjectList	resultList;
-    ObjectIDList::iterator childIt;
+//=============================================================================
+//the cells keep their content by type, so we only walk what was asked for
 
+void BuildingObject::getCellContent(uint32 objTypes,ObjectSet* resultSet,uint64 excludeId)
+{
     CellObjectList::iterator cellIt = mCells.begin();
 
     while(cellIt != mCells.end())
     {
-        tmpList = (*cellIt)->getObjects();
-        childIt = tmpList->begin();
-
-        while(childIt != tmpList->end())
-        {
-            Object* childObject = gWorldManager->getObjectById((*childIt));
-            resultList.push_back(childObject);
-            ++childIt;
-        }
+        (*cellIt)->getContent(objTypes,resultSet,excludeId);
         ++cellIt;
     }
-    return(resultList);
 }
 
 //================================================================================
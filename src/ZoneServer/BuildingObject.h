@@ -54,8 +54,6 @@ public:
     BuildingObject();
     ~BuildingObject();
 
-    //ObjectList		getAllCellChilds();
-
     uint32			getLoadCount() {
         return mTotalLoadCount;
     }
@@ -86,7 +84,9 @@ public:
     }
     bool			removeCell(CellObject* cellObject);
     bool			checkForCell(CellObject* cellObject);
-    ObjectList		getAllCellChilds();
+
+    // adds the content of all cells matching objTypes, without the object excludeId
+    void			getCellContent(uint32 objTypes,ObjectSet* resultSet,uint64 excludeId = 0);
 
     uint16			getCellContentCount();
 
@@ -0,0 +1,139 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_ZONESERVER_CELLCONTENTINDEX_H
+#define ANH_ZONESERVER_CELLCONTENTINDEX_H
+
+#include "Utils/typedefs.h"
+#include <vector>
+
+//======================================================================================================================
+//
+// The ids of what is in a cell, bucketed by object type, so the range queries that hit a building only walk the
+// types they asked for. Only ids are kept, the queries look the objects up in the WorldManager as before, so an
+// object that is freed while still listed can't turn up as a dangling pointer.
+//
+// A cell has a few types in it, the buckets are a short vector and keep their order. An id added twice is listed
+// twice and needs to be removed twice, as in the ObjectContainer.
+//
+
+class CellContentIndex
+{
+public:
+
+    typedef std::vector<uint64>	IdList;
+
+    CellContentIndex() : mCount(0) {}
+
+    void	add(uint64 id,uint32 type);
+    bool	remove(uint64 id);
+
+    uint32	size() const {
+        return mCount;
+    }
+
+    // the buckets, a bucket of a type that is gone again stays around empty
+    uint32			getBucketCount() const {
+        return static_cast<uint32>(mBuckets.size());
+    }
+    uint32			getBucketType(uint32 bucket) const {
+        return mBuckets[bucket].mType;
+    }
+    const IdList&	getBucketIds(uint32 bucket) const {
+        return mBuckets[bucket].mIds;
+    }
+
+    // the filter of the spatial queries, the type has no bits outside objTypes
+    bool			bucketMatches(uint32 bucket,uint32 objTypes) const {
+        return((mBuckets[bucket].mType & objTypes) == mBuckets[bucket].mType);
+    }
+
+private:
+
+    struct Bucket
+    {
+        uint32	mType;
+        IdList	mIds;
+    };
+
+    std::vector<Bucket>	mBuckets;
+    uint32				mCount;
+};
+
+//======================================================================================================================
+
+inline void CellContentIndex::add(uint64 id,uint32 type)
+{
+    std::vector<Bucket>::iterator it = mBuckets.begin();
+
+    while(it != mBuckets.end() && (*it).mType != type)
+    {
+        ++it;
+    }
+
+    if(it == mBuckets.end())
+    {
+        Bucket bucket;
+        bucket.mType = type;
+
+        it = mBuckets.insert(mBuckets.end(),bucket);
+    }
+
+    (*it).mIds.push_back(id);
+    mCount++;
+}
+
+//======================================================================================================================
+
+inline bool CellContentIndex::remove(uint64 id)
+{
+    std::vector<Bucket>::iterator it = mBuckets.begin();
+
+    while(it != mBuckets.end())
+    {
+        IdList& ids = (*it).mIds;
+
+        for(size_t i = 0; i < ids.size(); i++)
+        {
+            if(ids[i] == id)
+            {
+                ids[i] = ids.back();
+                ids.pop_back();
+                mCount--;
+                return(true);
+            }
+        }
+
+        ++it;
+    }
+
+    return(false);
+}
+
+//======================================================================================================================
+
+#endif
@@ -86,20 +86,8 @@ void CellFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
     case CellFQuery_MainData:
     {
         CellObject* cell = _createCell(result);
-        uint64		cellId = cell->getId();
-
-        QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,CellFQuery_Objects,asyncContainer->mClient);
-        asContainer->mObject = cell;
-
-        mDatabase->ExecuteSqlAsync(this,asContainer,"(SELECT \'terminals\',id FROM terminals WHERE parent_id = %"PRIu64")"
-                                   " UNION (SELECT \'containers\',id FROM containers WHERE parent_id = %"PRIu64")"
-                                   " UNION (SELECT \'ticket_collectors\',id FROM ticket_collectors WHERE (parent_id=%"PRIu64"))"
-                                   " UNION (SELECT \'persistent_npcs\',id FROM persistent_npcs WHERE parentId=%"PRIu64")"
-                                   " UNION (SELECT \'shuttles\',id FROM shuttles WHERE parentId=%"PRIu64")"
-                                   " UNION (SELECT \'items\',id FROM items WHERE parent_id=%"PRIu64")"
-                                   " UNION (SELECT \'resource_containers\',id FROM resource_containers WHERE parent_id=%"PRIu64")",
-                                   cellId,cellId,cellId,cellId,cellId,cellId,cellId);
-       
+
+        _loadCellObjects(cell,asyncContainer->mOfCallback,asyncContainer->mClient);
     }
     break;
 
@@ -172,6 +160,37 @@ void CellFactory::requestStructureCell(ObjectFactoryCallback* ofCallback,uint64
 
 //=============================================================================
 
+void CellFactory::requestCell(ObjectFactoryCallback* ofCallback,uint64 id,uint64 parentId,DispatchClient* client)
+{
+    CellObject* cell = new CellObject();
+    cell->setCapacity(500);
+    cell->setId(id);
+    cell->setParentId(parentId);
+
+    _loadCellObjects(cell,ofCallback,client);
+}
+
+//=============================================================================
+
+void CellFactory::_loadCellObjects(CellObject* cell,ObjectFactoryCallback* ofCallback,DispatchClient* client)
+{
+    uint64 cellId = cell->getId();
+
+    QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,CellFQuery_Objects,client);
+    asContainer->mObject = cell;
+
+    mDatabase->ExecuteSqlAsync(this,asContainer,"(SELECT \'terminals\',id FROM terminals WHERE parent_id = %"PRIu64")"
+                               " UNION (SELECT \'containers\',id FROM containers WHERE parent_id = %"PRIu64")"
+                               " UNION (SELECT \'ticket_collectors\',id FROM ticket_collectors WHERE (parent_id=%"PRIu64"))"
+                               " UNION (SELECT \'persistent_npcs\',id FROM persistent_npcs WHERE parentId=%"PRIu64")"
+                               " UNION (SELECT \'shuttles\',id FROM shuttles WHERE parentId=%"PRIu64")"
+                               " UNION (SELECT \'items\',id FROM items WHERE parent_id=%"PRIu64")"
+                               " UNION (SELECT \'resource_containers\',id FROM resource_containers WHERE parent_id=%"PRIu64")",
+                               cellId,cellId,cellId,cellId,cellId,cellId,cellId);
+}
+
+//=============================================================================
+
 CellObject* CellFactory::_createCell(DatabaseResult* result)
 {
     CellObject* cellObject = new CellObject();
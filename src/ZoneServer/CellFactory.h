@@ -66,6 +66,9 @@ public:
     void			requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client);
     void			requestStructureCell(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client);
 
+    // for callers that already read the cells row, only the objects in the cell are queried
+    void			requestCell(ObjectFactoryCallback* ofCallback,uint64 id,uint64 parentId,DispatchClient* client);
+
 private:
 
     CellFactory(Database* database);
@@ -74,6 +77,7 @@ private:
     void			_destroyDatabindings();
 
     CellObject*		_createCell(DatabaseResult* result);
+    void			_loadCellObjects(CellObject* cell,ObjectFactoryCallback* ofCallback,DispatchClient* client);
 
     static CellFactory*		mSingleton;
     static bool				mInsFlag;
@@ -30,6 +30,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "PlayerStructureTerminal.h"
 #include "MessageLib/MessageLib.h"
 
+#include <cassert>
+
 
 
 
@@ -100,6 +102,55 @@ void CellObject::prepareDestruction()
         //careful with iterating here!!!
     }
 }
+
+//=============================================================================
+// keep the type index in step with the container, both hooks run after mData changed
+
+void CellObject::_contentAdded(Object* object)
+{
+    mContentIndex.add(object->getId(),object->getType());
+
+    assert(mContentIndex.size() == getObjects()->size() && "cell content index out of step with the container");
+}
+
+//=============================================================================
+// by id only, the object may already be gone
+
+void CellObject::_contentRemoved(uint64 id)
+{
+    mContentIndex.remove(id);
+
+    assert(mContentIndex.size() == getObjects()->size() && "cell content index out of step with the container");
+}
+
+//=============================================================================
+// the objects are looked up by id, like the container content everywhere else
+
+void CellObject::getContent(uint32 objTypes,ObjectSet* resultSet,uint64 excludeId) const
+{
+    for(uint32 bucket = 0; bucket < mContentIndex.getBucketCount(); bucket++)
+    {
+        if(!mContentIndex.bucketMatches(bucket,objTypes))
+        {
+            continue;
+        }
+
+        const CellContentIndex::IdList& ids = mContentIndex.getBucketIds(bucket);
+
+        for(size_t i = 0; i < ids.size(); i++)
+        {
+            if(ids[i] == excludeId)
+            {
+                continue;
+            }
+
+            if(Object* object = gWorldManager->getObjectById(ids[i]))
+            {
+                resultSet->insert(object);
+            }
+        }
+    }
+}
 //=============================================================================
 
 //=============================================================================
@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define ANH_ZONESERVER_CELL_OBJECT_H
 
 #include "StaticObject.h"
+#include "CellContentIndex.h"
 
 //=============================================================================
 
@@ -59,11 +60,19 @@ public:
 
     void		prepareDestruction();
 
+    // adds the content matching objTypes, the same filter the spatial queries use
+    void		getContent(uint32 objTypes,ObjectSet* resultSet,uint64 excludeId = 0) const;
+
+protected:
+
+    void		_contentAdded(Object* object);
+    void		_contentRemoved(uint64 id);
 
 private:
 
     //ObjectList	mChildObjects;
-    uint32		mTotalLoadCount;
+    uint32				mTotalLoadCount;
+    CellContentIndex	mContentIndex;
 
 };
 
@@ -28,7 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "City.h"
 #include "PlayerObject.h"
 #include "QTRegion.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "WorldManager.h"
 #include "ZoneTree.h"
 
@@ -83,8 +83,8 @@ void City::update()
         ++objIt;
     }
 
-    ObjectSet oldKnownObjects = mKnownObjects;
-    ObjectSet::iterator objSetIt = oldKnownObjects.begin();
+    KnownObjectSet oldKnownObjects = mKnownObjects;
+    KnownObjectSet::iterator objSetIt = oldKnownObjects.begin();
 
     while(objSetIt != oldKnownObjects.end())
     {
@@ -154,7 +154,7 @@ void FillerNPC::addTutorialPlayer(uint64 playerId, TutorialTauntConfigData* conf
     if (mTutorialPlayers.empty())
     {
         // We have to register this npc for service.
-        gWorldManager->addDormantNpc(this->getId(), (uint64)tutorialPlayersPeriodUpdateTime);
+        gWorldManager->addDormantNpc(this, (uint64)tutorialPlayersPeriodUpdateTime);
     }
     mTutorialPlayers.insert(std::make_pair(playerId, configData));
 }
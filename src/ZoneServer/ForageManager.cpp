@@ -27,7 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <list>
 #include "QTRegion.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "ZoneTree.h"
 #include "ForageManager.h"
 #include "PlayerObject.h"
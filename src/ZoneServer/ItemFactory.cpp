@@ -52,6 +52,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DatabaseResult.h"
 #include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/PreparedStatement.h"
 #include "WorldConfig.h"
 
 #include "Utils/utils.h"
@@ -82,6 +83,22 @@ ItemFactory*	ItemFactory::Init(Database* database)
 ItemFactory::ItemFactory(Database* database) : FactoryBase(database)
 {
     _setupDatabindings();
+
+    // items get loaded one by one, every time a player logs in
+    mItemStatement		= mDatabase->PrepareStatement("SELECT items.id,items.parent_id,items.item_family,items.item_type,items.privateowner_id,items.oX,items.oY,"
+                          "items.oZ,items.oW,items.x,items.y,items.z,items.planet_id,items.customName,"
+                          "item_types.object_string,item_types.stf_name,item_types.stf_file,item_types.stf_detail_name,"
+                          "item_types.stf_detail_file,items.maxCondition,items.damage,items.dynamicint32,"
+                          "item_types.equipSlots,item_types.equipRestrictions, item_customization.1, item_customization.2, item_types.container "
+                          "FROM items "
+                          "INNER JOIN item_types ON (items.item_type = item_types.id) "
+                          "LEFT JOIN item_customization ON (items.id = item_customization.id) "
+                          "WHERE items.id = ?");
+
+    mAttributeStatement	= mDatabase->PrepareStatement("SELECT attributes.name,item_attributes.value,attributes.internal"
+                          " FROM item_attributes"
+                          " INNER JOIN attributes ON (item_attributes.attribute_id = attributes.id)"
+                          " WHERE item_attributes.item_id = ? ORDER BY item_attributes.order");
 }
 
 //=============================================================================
@@ -116,11 +133,11 @@ void ItemFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
             asContainer->mObject = item;
             asContainer->mDepth = asyncContainer->mDepth;
 
-            mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT attributes.name,item_attributes.value,attributes.internal"
-                                       " FROM item_attributes"
-                                       " INNER JOIN attributes ON (item_attributes.attribute_id = attributes.id)"
-                                       " WHERE item_attributes.item_id = %"PRIu64" ORDER BY item_attributes.order",item->getId());
-               }
+            StatementParameters parameters;
+            parameters.addUint64(item->getId());
+
+            mDatabase->ExecuteStatementAsync(this,asContainer,mAttributeStatement,parameters,mAttributeBinding);
+        }
     }
     break;
 
@@ -219,16 +236,10 @@ void ItemFactory::requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint
     QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,ItemFactoryQuery_MainData,client,id);
     asContainer->mDepth = 0;
 
-    mDatabase->ExecuteSqlAsync(this,asContainer,
-                               "SELECT items.id,items.parent_id,items.item_family,items.item_type,items.privateowner_id,items.oX,items.oY,"
-                               "items.oZ,items.oW,items.x,items.y,items.z,items.planet_id,items.customName,"
-                               "item_types.object_string,item_types.stf_name,item_types.stf_file,item_types.stf_detail_name,"
-                               "item_types.stf_detail_file,items.maxCondition,items.damage,items.dynamicint32,"
-                               "item_types.equipSlots,item_types.equipRestrictions, item_customization.1, item_customization.2, item_types.container "
-                               "FROM items "
-                               "INNER JOIN item_types ON (items.item_type = item_types.id) "
-                               "LEFT JOIN item_customization ON (items.id = item_customization.id)"
-                               "WHERE items.id = %"PRIu64"",id);
+    StatementParameters parameters;
+    parameters.addUint64(id);
+
+    mDatabase->ExecuteStatementAsync(this,asContainer,mItemStatement,parameters,mItemBinding);
    
 }
 
@@ -239,16 +250,10 @@ void ItemFactory::requestContainerContent(ObjectFactoryCallback* ofCallback,uint
     QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,ItemFactoryQuery_MainData,client,id);
     asContainer->mDepth = depth;
 
-    mDatabase->ExecuteSqlAsync(this,asContainer,
-                               "SELECT items.id,items.parent_id,items.item_family,items.item_type,items.privateowner_id,items.oX,items.oY,"
-                               "items.oZ,items.oW,items.x,items.y,items.z,items.planet_id,items.customName,"
-                               "item_types.object_string,item_types.stf_name,item_types.stf_file,item_types.stf_detail_name,"
-                               "item_types.stf_detail_file,items.maxCondition,items.damage,items.dynamicint32,"
-                               "item_types.equipSlots,item_types.equipRestrictions, item_customization.1, item_customization.2, item_types.container "
-                               "FROM items "
-                               "INNER JOIN item_types ON (items.item_type = item_types.id) "
-                               "LEFT JOIN item_customization ON (items.id = item_customization.id)"
-                               "WHERE items.id = %"PRIu64"",id);
+    StatementParameters parameters;
+    parameters.addUint64(id);
+
+    mDatabase->ExecuteStatementAsync(this,asContainer,mItemStatement,parameters,mItemBinding);
   
 }
 
@@ -86,6 +86,9 @@ private:
 
     DataBinding*			mItemIdentifierBinding;
     DataBinding*			mItemBinding;
+
+    uint32					mItemStatement;
+    uint32					mAttributeStatement;
 };
 
 //=============================================================================
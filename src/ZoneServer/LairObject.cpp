@@ -31,7 +31,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NonPersistentNpcFactory.h"
 #include "NpcManager.h"
 #include "PlayerObject.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "WorldManager.h"
 #include "ZoneTree.h"
 #include "MessageLib/MessageLib.h"
@@ -760,7 +760,7 @@ void LairObject::respawn(void)
 
         // When spawning, the lair awaits activation in the dormant queue, so we load the lair instantly and have a wait timer running before the spawn.
         // Since we can force a lair (any object) out of the dormant queue, we have to do the actual spwan countdown with a created object.
-        gWorldManager->addDormantNpc(getId(), 0);
+        gWorldManager->addDormantNpc(this, 0);
     }
     else
     {
@@ -300,7 +300,9 @@ bool Medicine::ConsumeUse(PlayerObject* playerObject)
     if(quantity)
     {
         this->setAttribute("counter_uses_remaining",boost::lexical_cast<std::string>(quantity));
-        gWorldManager->getDatabase()->ExecuteSqlAsync(0, 0, "UPDATE item_attributes SET value='%f' WHERE item_id=%"PRIu64" AND attribute_id=%u",quantity,this->getId(),AttrType_CounterUsesRemaining);
+        int8 condition[64];
+        sprintf(condition,"item_id=%"PRIu64" AND attribute_id=%u",this->getId(),AttrType_CounterUsesRemaining);
+        gWorldManager->getDatabase()->ExecuteUpdateDeferred(playerObject->getId(),"item_attributes","value",condition,"'%f'",quantity);
      
         //now update the uses display
         gMessageLib->sendUpdateUses(this,playerObject);
@@ -29,7 +29,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define ANH_ZONESERVER_MOVING_OBJECT_H
 
 #include "Object.h"
-//#include "QuadTree.h"
 
 class Message;
 class DispatchClient;
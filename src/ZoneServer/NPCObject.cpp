@@ -30,7 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Heightmap.h"
 #include "CellObject.h"
 #include "PlayerObject.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "Weapon.h"
 #include "WorldManager.h"
 #include "ZoneTree.h"
@@ -81,6 +81,14 @@ NPCObject::NPCObject()
 NPCObject::~NPCObject()
 {
     mDamageDealers.clear();
+
+    // the handler queues keep us by pointer
+    if (gWorldManager)
+    {
+        gWorldManager->removeDormantNpc(this->getId());
+        gWorldManager->removeReadyNpc(this->getId());
+        gWorldManager->removeActiveNpc(this->getId());
+    }
 }
 
 //=============================================================================
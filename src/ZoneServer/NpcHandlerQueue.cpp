@@ -0,0 +1,122 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "NpcHandlerQueue.h"
+#include "NPCObject.h"
+
+//=============================================================================
+
+NpcHandlerQueue::NpcHandlerQueue()
+    : mQueued(0)
+    , mHandled(0)
+    , mTotalQueued(0)
+    , mTotalHandled(0)
+{
+}
+
+//=============================================================================
+
+NpcHandlerQueue::~NpcHandlerQueue()
+{
+}
+
+//=============================================================================
+
+void NpcHandlerQueue::add(NPCObject* npc, uint64 dueTime)
+{
+    if (mNpcs.find(npc->getId()) != mNpcs.end())
+    {
+        return;
+    }
+
+    mNpcs.insert(std::make_pair(npc->getId(), mDue.insert(std::make_pair(dueTime, npc))));
+}
+
+//=============================================================================
+
+void NpcHandlerQueue::remove(uint64 npcId)
+{
+    NpcMap::iterator it = mNpcs.find(npcId);
+    if (it != mNpcs.end())
+    {
+        mDue.erase((*it).second);
+        mNpcs.erase(it);
+    }
+}
+
+//=============================================================================
+
+bool NpcHandlerQueue::contains(uint64 npcId) const
+{
+    return (mNpcs.find(npcId) != mNpcs.end());
+}
+
+//=============================================================================
+
+void NpcHandlerQueue::setDueTime(uint64 npcId, uint64 dueTime)
+{
+    NpcMap::iterator it = mNpcs.find(npcId);
+    if (it != mNpcs.end())
+    {
+        NPCObject* npc = (*it).second->second;
+
+        mDue.erase((*it).second);
+        (*it).second = mDue.insert(std::make_pair(dueTime, npc));
+    }
+}
+
+//=============================================================================
+
+NPCObject* NpcHandlerQueue::getDue(uint64 currentTime, uint64& dueTime) const
+{
+    if (mDue.empty() || (mDue.begin()->first > currentTime))
+    {
+        return NULL;
+    }
+
+    dueTime = mDue.begin()->first;
+    return mDue.begin()->second;
+}
+
+//=============================================================================
+
+void NpcHandlerQueue::clear()
+{
+    mDue.clear();
+    mNpcs.clear();
+}
+
+//=============================================================================
+
+void NpcHandlerQueue::setTickStats(uint32 queued, uint32 handled)
+{
+    mQueued = queued;
+    mHandled = handled;
+
+    mTotalQueued += queued;
+    mTotalHandled += handled;
+}
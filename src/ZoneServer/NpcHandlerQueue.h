@@ -0,0 +1,98 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_ZONESERVER_NPC_HANDLER_QUEUE_H
+#define ANH_ZONESERVER_NPC_HANDLER_QUEUE_H
+
+#include "Utils/typedefs.h"
+
+#include <map>
+
+class NPCObject;
+
+//=============================================================================
+//
+// The npcs of one of the WorldManager handler queues (dormant, ready, active), ordered by the time they are due.
+//
+// The handlers only ever look at the front of the queue, so a tick costs the npcs that are due instead of all of
+// them. Npcs are kept by pointer, an npc takes itself out of the queues when it is destroyed.
+//
+
+class NpcHandlerQueue
+{
+public:
+
+    NpcHandlerQueue();
+    ~NpcHandlerQueue();
+
+    // Queues npc to be handled at dueTime. An npc that is queued already keeps its due time.
+    void		add(NPCObject* npc, uint64 dueTime);
+    void		remove(uint64 npcId);
+    bool		contains(uint64 npcId) const;
+
+    // Moves the due time of a queued npc.
+    void		setDueTime(uint64 npcId, uint64 dueTime);
+
+    // Returns the npc due first if it is due at currentTime, NULL otherwise.
+    NPCObject*	getDue(uint64 currentTime, uint64& dueTime) const;
+
+    void		clear();
+    uint32		size() const {
+        return static_cast<uint32>(mNpcs.size());
+    }
+
+    // Npcs queued when the last tick started and npcs handled on it, and both summed up since startup.
+    // The queued count is what a full scan of the queue would have looked at.
+    void		setTickStats(uint32 queued, uint32 handled);
+    uint32		getQueued() const {
+        return mQueued;
+    }
+    uint32		getHandled() const {
+        return mHandled;
+    }
+    uint64		getTotalQueued() const {
+        return mTotalQueued;
+    }
+    uint64		getTotalHandled() const {
+        return mTotalHandled;
+    }
+
+private:
+
+    typedef std::multimap<uint64, NPCObject*>			DueMap;
+    typedef std::map<uint64, DueMap::iterator>			NpcMap;
+
+    DueMap		mDue;
+    NpcMap		mNpcs;
+
+    uint32		mQueued;
+    uint32		mHandled;
+    uint64		mTotalQueued;
+    uint64		mTotalHandled;
+};
+
+#endif
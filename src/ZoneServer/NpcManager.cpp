@@ -155,15 +155,15 @@ uint64 NpcManager::handleNpc(NPCObject* npc, uint64 timeOverdue)
         waitTime = 0;
         if (newState == AttackableCreature::NpcIsDormant)
         {
-            gWorldManager->addDormantNpc(npc->getId(), newWaitTime);
+            gWorldManager->addDormantNpc(npc, newWaitTime);
         }
         else if (newState == AttackableCreature::NpcIsReady)
         {
-            gWorldManager->addReadyNpc(npc->getId(), newWaitTime);
+            gWorldManager->addReadyNpc(npc, newWaitTime);
         }
         else if (newState == AttackableCreature::NpcIsActive)
         {
-            gWorldManager->addActiveNpc(npc->getId(), newWaitTime);
+            gWorldManager->addActiveNpc(npc, newWaitTime);
         }
         else
         {
@@ -37,7 +37,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ObjectControllerCommandMap.h"
 #include "PlayerObject.h"
 #include "FactoryObject.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "Tutorial.h"
 #include "WorldConfig.h"
 #include "WorldManager.h"
@@ -554,10 +554,20 @@ void ObjectController::_findInRangeObjectsOutside(bool updateAll)
     {
         if(QTRegion* region = gWorldManager->getQTRegion(player->getSubZoneId()))
         {
-            Anh_Math::Rectangle qRect = Anh_Math::Rectangle(player->mPosition.x - viewingRange,player->mPosition.z - viewingRange,viewingRange * 2,viewingRange * 2);
+            uint32 typeMask = ObjType_Player | ObjType_NPC | ObjType_Creature | ObjType_Lair;
 
-            // We need to find moving creatures also...
-            region->mTree->getObjectsInRange(player,&mInRangeObjects,ObjType_Player | ObjType_NPC | ObjType_Creature | ObjType_Lair , &qRect);
+            // We listen to the cells around us, moving creatures are handed to us when they come or go.
+            // The first subscription hands us everything in range.
+            region->mTree->subscribe(player,typeMask,viewingRange);
+
+            if (updateAll)
+            {
+                Anh_Math::Rectangle qRect = Anh_Math::Rectangle(player->mPosition.x - viewingRange,player->mPosition.z - viewingRange,viewingRange * 2,viewingRange * 2);
+
+                region->mTree->getObjectsInRange(player,&mInRangeObjects,typeMask,&qRect);
+            }
+
+            region->mTree->getInterestChanges(player,&mInRangeObjects,&mLeftObjects);
         }
     }
 
@@ -854,8 +864,8 @@ bool ObjectController::_destroyOutOfRangeObjects(ObjectSet *inRangeObjects)
 
     // iterate our knowns
     PlayerObject*				player			= dynamic_cast<PlayerObject*>(mObject);
-    ObjectSet*					knownObjects	= player->getKnownObjects();
-    ObjectSet::iterator			objIt			= knownObjects->begin();
+    KnownObjectSet*				knownObjects	= player->getKnownObjects();
+    KnownObjectSet::iterator	objIt			= knownObjects->begin();
     PlayerObjectSet*			knownPlayers	= player->getKnownPlayers();
     PlayerObjectSet::iterator	playerIt		= knownPlayers->begin();
 
@@ -869,30 +879,7 @@ bool ObjectController::_destroyOutOfRangeObjects(ObjectSet *inRangeObjects)
         // if its not in the current inrange queries result, destroy it
         if(inRangeObjects->find(playerObject) == inRangeObjects->end())
         {
-            // send a destroy to us
-            gMessageLib->sendDestroyObject(playerObject->getId(),player);
-
-            //If player is mounted destroy his mount too
-            if(playerObject->checkIfMounted() && playerObject->getMount())
-            {
-                gMessageLib->sendDestroyObject(playerObject->getMount()->getId(),player);
-
-                player->removeKnownObject(playerObject->getMount());
-                playerObject->getMount()->removeKnownObject(player);
-
-            }
-
-            //send a destroy to him
-            gMessageLib->sendDestroyObject(player->getId(),playerObject);
-
-            //If we're mounted destroy our mount too
-            if(player->checkIfMounted() && playerObject->getMount())
-            {
-                gMessageLib->sendDestroyObject(player->getMount()->getId(),playerObject);
-                playerObject->removeKnownObject(player->getMount());
-                player->getMount()->removeKnownObject(playerObject);
-
-            }
+            _destroyOutOfRangePlayer(player,playerObject);
 
             // we don't know each other anymore
             knownPlayers->erase(playerIt++);
@@ -949,6 +936,90 @@ bool ObjectController::_destroyOutOfRangeObjects(ObjectSet *inRangeObjects)
     return allDestroyed;
 }
 
+//=========================================================================================
+//
+// destroy a known player that is out of range for both of us, mounts included
+// the caller removes it from our known players
+//
+
+void ObjectController::_destroyOutOfRangePlayer(PlayerObject* player,PlayerObject* playerObject)
+{
+    // send a destroy to us
+    gMessageLib->sendDestroyObject(playerObject->getId(),player);
+
+    //If player is mounted destroy his mount too
+    if(playerObject->checkIfMounted() && playerObject->getMount())
+    {
+        gMessageLib->sendDestroyObject(playerObject->getMount()->getId(),player);
+
+        player->removeKnownObject(playerObject->getMount());
+        playerObject->getMount()->removeKnownObject(player);
+
+    }
+
+    //send a destroy to him
+    gMessageLib->sendDestroyObject(player->getId(),playerObject);
+
+    //If we're mounted destroy our mount too
+    if(player->checkIfMounted() && playerObject->getMount())
+    {
+        gMessageLib->sendDestroyObject(player->getMount()->getId(),playerObject);
+        playerObject->removeKnownObject(player->getMount());
+        player->getMount()->removeKnownObject(playerObject);
+
+    }
+}
+
+//=========================================================================================
+//
+// destroy the moving objects that left our qt window, they are out of our viewing range
+// same messages as _destroyOutOfRangeObjects, without comparing everything we know
+//
+
+void ObjectController::_destroyLeftObjects()
+{
+    PlayerObject*	player			= dynamic_cast<PlayerObject*>(mObject);
+    bool			targetLeft		= false;
+
+    for(ObjectSet::iterator it = mLeftObjects.begin(); it != mLeftObjects.end(); ++it)
+    {
+        Object* object = (*it);
+
+        // a mount goes with its rider
+        if(!player->checkKnownObjects(object))
+        {
+            continue;
+        }
+
+        targetLeft |= (player->getTargetId() == object->getId());
+
+        if(object->getType() == ObjType_Player)
+        {
+            PlayerObject* playerObject = dynamic_cast<PlayerObject*>(object);
+
+            _destroyOutOfRangePlayer(player,playerObject);
+
+            player->getKnownPlayers()->erase(playerObject);
+            playerObject->removeKnownObject(player);
+        }
+        else
+        {
+            gMessageLib->sendDestroyObject(object->getId(),player);
+
+            player->getKnownObjects()->erase(object);
+            object->removeKnownObject(player);
+        }
+    }
+
+    mLeftObjects.clear();
+
+    if(targetLeft)
+    {
+        player->setTarget(0);
+        gMessageLib->sendTargetUpdateDeltasCreo6(player);
+    }
+}
+
 //=============================================================================
 //
 //	Update the world around the player.
@@ -1078,6 +1149,12 @@ uint64 ObjectController::playerWorldUpdate(bool forcedUpdate)
         // Update some of the objects we found.
         mUpdatingObjects = !_updateInRangeObjectsOutside();
 
+        // Moving objects that went out of range since the last update.
+        if (!mLeftObjects.empty())
+        {
+            _destroyLeftObjects();
+        }
+
         if (!mUpdatingObjects)
         {
             // We are not updating new objects.
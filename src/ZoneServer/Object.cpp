@@ -245,7 +245,7 @@ bool Object::removeKnownObject(Object* object)
     }
     else
     {
-        ObjectSet::iterator it = mKnownObjects.find(object);
+        KnownObjectSet::iterator it = mKnownObjects.find(object);
 
         if(it != mKnownObjects.end())
         {
@@ -274,7 +274,7 @@ bool Object::checkKnownObjects(Object* object) const
     }
     else
     {
-        ObjectSet::const_iterator it = mKnownObjects.find(object);
+        KnownObjectSet::const_iterator it = mKnownObjects.find(object);
 
         if(it != mKnownObjects.end())
         {
@@ -658,7 +658,7 @@ void Object::addKnownObject(Object* object)
 
 void Object::destroyKnownObjects()
 {
-    ObjectSet::iterator			objIt		= mKnownObjects.begin();
+    KnownObjectSet::iterator	objIt		= mKnownObjects.begin();
     PlayerObjectSet::iterator	playerIt	= mKnownPlayers.begin();
 
 
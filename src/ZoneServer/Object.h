@@ -34,6 +34,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Object_Enums.h"
 #include "Common/LogManager.h" // @todo: this needs to go.	  where does it need to go ?
 #include "Utils/EventHandler.h"
+#include "Utils/FlatSet.h"
 #include "Utils/typedefs.h"
 
 #include <boost/lexical_cast.hpp>
@@ -65,7 +66,9 @@ typedef std::tr1::shared_ptr<RadialMenu>	RadialMenuPtr;
 typedef std::list<uint64>				ObjectIDList;
 typedef std::set<Object*>				ObjectSet;
 typedef std::set<uint64>				ObjectIDSet;
-typedef std::set<PlayerObject*>			PlayerObjectSet;
+// known objects and players are walked on every broadcast, keep them flat
+typedef utils::FlatSet<Object*>			KnownObjectSet;
+typedef utils::FlatSet<PlayerObject*>	PlayerObjectSet;
 typedef std::set<uint64>			PlayerObjectIDSet;
 typedef std::list<uint32>				AttributeOrderList;
 
@@ -142,7 +145,7 @@ public:
     PlayerObjectSet*			getKnownPlayers() {
         return &mKnownPlayers;
     }
-    ObjectSet*					getKnownObjects() {
+    KnownObjectSet*				getKnownObjects() {
         return &mKnownObjects;
     }
     void						destroyKnownObjects();
@@ -355,9 +358,8 @@ protected:
     AttributeMap				mAttributeMap;
     AttributeOrderList			mAttributeOrderList;
     AttributeMap 				mInternalAttributeMap;
-    ObjectSet					mKnownObjects;
+    KnownObjectSet				mKnownObjects;
     PlayerObjectSet				mKnownPlayers;
-    ObjectIDSet					mKnownObjectsIDs;
     ObjectController			mObjectController;
     BString						mModel;
 
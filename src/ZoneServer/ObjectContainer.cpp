@@ -95,6 +95,7 @@ ObjectContainer::~ObjectContainer()
 bool ObjectContainer::addObjectSecure(Object* Data)
 {
     mData.push_back(Data->getId());
+    _contentAdded(Data);
     if(mCapacity)
     {
         return true;
@@ -114,6 +115,7 @@ bool ObjectContainer::addObject(Object* Data)
     if(mCapacity)
     {
         mData.push_back(Data->getId());
+        _contentAdded(Data);
         //PlayerObject* player = dynamic_cast<PlayerObject*>(gWorldManager->getObjectById(this->getParentId()));
         return true;
     }
@@ -269,6 +271,7 @@ bool ObjectContainer::removeObject(Object* data)
         if((*it) == data->getId())
         {
             it = mData.erase(it);
+            _contentRemoved(data->getId());
             return true;
         }
         ++it;
@@ -289,6 +292,7 @@ bool ObjectContainer::deleteObject(Object* data)
         if((*it) == data->getId())
         {
             it = mData.erase(it);
+            _contentRemoved(data->getId());
             gWorldManager->destroyObject(data);
             return true;
         }
@@ -309,6 +313,7 @@ bool ObjectContainer::removeObject(uint64 id)
         if((*it) == id)
         {
             it = mData.erase(it);
+            _contentRemoved(id);
             return true;
         }
         ++it;
@@ -381,7 +386,10 @@ ObjectIDList::iterator ObjectContainer::removeObject(ObjectIDList::iterator it,
         playerIt++;
     }
 
+    uint64 id = (*it);
+
     it = mData.erase(it);
+    _contentRemoved(id);
 
     return it;
 }
@@ -389,7 +397,11 @@ ObjectIDList::iterator ObjectContainer::removeObject(ObjectIDList::iterator it,
 ObjectIDList::iterator ObjectContainer::removeObject(ObjectIDList::iterator it, PlayerObject* player)
 {
     gMessageLib->sendDestroyObject((*it),player);
+
+    uint64 id = (*it);
+
     it = mData.erase(it);
+    _contentRemoved(id);
     return it;
 }
 
@@ -398,7 +410,10 @@ ObjectIDList::iterator ObjectContainer::removeObject(ObjectIDList::iterator it,
 
 ObjectIDList::iterator ObjectContainer::removeObject(ObjectIDList::iterator it)
 {
+    uint64 id = (*it);
+
     it = mData.erase(it);
+    _contentRemoved(id);
     return it;
 }
 
@@ -144,6 +144,11 @@ public:
         return content;
     }
 
+protected:
+
+    // every object entering or leaving the container passes here
+    virtual void		_contentAdded(Object* object) {}
+    virtual void		_contentRemoved(uint64 id) {}
 
 private:
 
@@ -782,6 +782,8 @@ private:
     void	_findInRangeObjectsInside(bool updateAll);
     bool	_updateInRangeObjectsInside();
     bool	_destroyOutOfRangeObjects(ObjectSet* inRangeObjects);
+    void	_destroyOutOfRangePlayer(PlayerObject* player,PlayerObject* playerObject);
+    void	_destroyLeftObjects();
 
 
     // ham
@@ -796,6 +798,7 @@ private:
     EventQueue					mEventQueue;
     ObjectSet						mInRangeObjects;
     ObjectSet::iterator mObjectSetIt;
+    ObjectSet						mLeftObjects;	// moving objects that left our qt window since the last update
 
     EnqueueValidators	mEnqueueValidators;
     ProcessValidators	mProcessValidators;
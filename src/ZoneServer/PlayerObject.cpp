@@ -40,7 +40,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "GroupManager.h"
 #include "GroupObject.h"
 #include "Inventory.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 
 #include "SampleEvent.h"
 #include "SchematicGroup.h"
@@ -120,6 +120,7 @@ PlayerObject::PlayerObject()
     , mHasCamp(false)
 {
     mIsForaging			= false;
+    mSaveChecksum		= 0;
     mType				= ObjType_Player;
     mCreoGroup			= CreoGroup_Player;
     mStomach			= new Stomach(this);
@@ -144,6 +144,14 @@ public:
         mPlayerSaveTimer = saveTimer;
     }
 
+    // checksum of the persisted state at the last periodic save
+    uint32				getSaveChecksum() const {
+        return mSaveChecksum;
+    }
+    void				setSaveChecksum(uint32 checksum) {
+        mSaveChecksum = checksum;
+    }
+
     BString				getTitle() const {
         return mTitle;
     }
@@ -860,6 +868,7 @@ private:
 
     int					mPreviousHarvestingSelection;
     uint32              mPlayerSaveTimer;
+    uint32              mSaveChecksum;
 };
 
 
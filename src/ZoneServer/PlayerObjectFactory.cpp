@@ -41,11 +41,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Weapon.h"
 #include "WorldConfig.h"
 #include "WorldManager.h"
+#include "Common/ConfigManager.h"
 #include "Common/LogManager.h"
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DatabaseResult.h"
 #include "DatabaseManager/DataBinding.h"
 
+#include "Utils/clock.h"
 #include "Utils/utils.h"
 
 //=============================================================================
@@ -71,7 +73,12 @@ PlayerObjectFactory*	PlayerObjectFactory::Init(Database* database)
 //=============================================================================
 
 PlayerObjectFactory::PlayerObjectFactory(Database* database) : FactoryBase(database)
+    , mLoadsCompleted(0)
+    , mLoadTimeTotal(0)
+    , mLoadTimeMax(0)
 {
+    mBatchedLoad		= gConfig->read<bool>("CharacterLoadBatched",true);
+
     mInventoryFactory	= InventoryFactory::Init(mDatabase);
     mDatapadFactory		= DatapadFactory::Init(mDatabase);
 
@@ -103,10 +110,39 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
         if(!playerObject)
         {
             gLogger->log(LogManager::CRITICAL,"Failed to Load Player (Account id=%u) at PlayerObjectFactory::handleDatabaseJobComplete.",asyncContainer->mClient->getAccountId());
+            mLoadStartTimes.erase(asyncContainer->mId);
             return;
         }
 
         playerObject->setClient(asyncContainer->mClient);
+
+        if(mBatchedLoad)
+        {
+            // everything else in one go, handleDatabaseJobComplete walks the result sets in this order
+            QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Batched,asyncContainer->mClient);
+            asContainer->mObject = playerObject;
+
+            uint64 id = playerObject->getId();
+
+            mDatabase->ExecuteSqlBatchAsync(this,asContainer,
+                                            "SELECT skill_id FROM character_skills WHERE character_id=%"PRIu64";"
+                                            "SELECT badge_id FROM character_badges WHERE character_id=%"PRIu64";"
+                                            "SELECT faction_id,value FROM character_faction WHERE character_id=%"PRIu64" ORDER BY faction_id;"
+                                            "SELECT characters.firstname FROM chat_friendlist"
+                                            " INNER JOIN characters ON (chat_friendlist.friend_id = characters.id)"
+                                            " WHERE (chat_friendlist.character_id = %"PRIu64");"
+                                            "SELECT characters.firstname FROM chat_ignorelist"
+                                            " INNER JOIN characters ON (chat_ignorelist.ignore_id = characters.id)"
+                                            " WHERE (chat_ignorelist.character_id = %"PRIu64");"
+                                            "SELECT outcast_id FROM entertainer_deny_service WHERE entertainer_id=%"PRIu64";"
+                                            "SELECT emote_id, charges FROM character_holoemotes WHERE character_id=%"PRIu64";"
+                                            "SELECT spawn_facility_id, x, y, z, planet_id FROM character_clone WHERE character_id=%"PRIu64";"
+                                            "SELECT sf_getLotCount(%"PRIu64");"
+                                            "SELECT xp_id,value FROM character_xp WHERE character_id=%"PRIu64"",
+                                            id,id,id,id,id,id,id,id,id,id);
+            break;
+        }
+
         QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Skills,asyncContainer->mClient);
         asContainer->mObject = playerObject;
 
@@ -115,30 +151,48 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
     }
     break;
 
-    case POFQuery_Skills:
+    case POFQuery_Batched:
     {
-        PlayerObject* playerObject = dynamic_cast<PlayerObject	*>(asyncContainer->mObject);
-        uint32 skillId;
+        PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
 
-        DataBinding* binding = mDatabase->CreateDataBinding(1);
-        binding->addField(DFT_uint32,0,4);
+        // a result set missing after an error leaves an empty result, the rest of the load goes on as usual
+        _loadSkills(playerObject,result);
 
-        uint64 count = result->getRowCount();
+        result->NextResultSet();
+        _loadBadges(playerObject,result);
 
-        for(uint64 i = 0; i < count; i++)
-        {
-            result->GetNextRow(binding,&skillId);
-            playerObject->mSkills.push_back(gSkillManager->getSkillById(skillId));
-        }
+        result->NextResultSet();
+        _loadFactions(playerObject,result);
 
-        mDatabase->DestroyDataBinding(binding);
+        result->NextResultSet();
+        _loadFriends(playerObject,result);
+
+        result->NextResultSet();
+        _loadIgnores(playerObject,result);
+
+        result->NextResultSet();
+        _loadDenyService(playerObject,result);
 
-        playerObject->prepareSkillMods();
-        playerObject->prepareSkillCommands();
-        playerObject->prepareSchematicIds();
+        result->NextResultSet();
+        _loadHoloEmotes(playerObject,result);
 
-        playerObject->mSkillCmdUpdateCounter = playerObject->getSkillCommands()->size();
-        playerObject->mSkillModUpdateCounter = playerObject->getSkillMods()->size();
+        result->NextResultSet();
+        _loadCloningFacility(playerObject,result);
+
+        result->NextResultSet();
+        _loadLots(playerObject,result);
+
+        // last, it starts the inventory and datapad loads
+        result->NextResultSet();
+        _loadXp(playerObject,result,asyncContainer->mOfCallback,asyncContainer->mClient);
+    }
+    break;
+
+    case POFQuery_Skills:
+    {
+        PlayerObject* playerObject = dynamic_cast<PlayerObject	*>(asyncContainer->mObject);
+
+        _loadSkills(playerObject,result);
 
         QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Badges,asyncContainer->mClient);
         asContainer->mObject = playerObject;
@@ -151,20 +205,8 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
     case POFQuery_Badges:
     {
         PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-        uint32 badgeId;
-
-        DataBinding* binding = mDatabase->CreateDataBinding(1);
-        binding->addField(DFT_uint32,0,4);
-
-        uint64 count = result->getRowCount();
-
-        for(uint64 i = 0; i < count; i++)
-        {
-            result->GetNextRow(binding,&badgeId);
-            playerObject->mBadgeList.push_back(badgeId);
-        }
 
-        mDatabase->DestroyDataBinding(binding);
+        _loadBadges(playerObject,result);
 
         QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Factions,asyncContainer->mClient);
         asContainer->mObject = playerObject;
@@ -177,21 +219,8 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
     case POFQuery_Factions:
     {
         PlayerObject*	playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-        XpContainer		factionCont;
-
-        DataBinding* binding = mDatabase->CreateDataBinding(2);
-        binding->addField(DFT_uint32,offsetof(XpContainer,mId),4,0);
-        binding->addField(DFT_int32,offsetof(XpContainer,mValue),4,1);
 
-        uint64 count = result->getRowCount();
-
-        for(uint64 i = 0; i < count; i++)
-        {
-            result->GetNextRow(binding,&factionCont);
-            playerObject->mFactionList.push_back(std::make_pair(factionCont.mId,factionCont.mValue));
-        }
-
-        mDatabase->DestroyDataBinding(binding);
+        _loadFactions(playerObject,result);
 
         // query friendslist
         QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Friends,asyncContainer->mClient);
@@ -207,23 +236,8 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
     case POFQuery_Friends:
     {
         PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-        BString name;
-
-        DataBinding* binding = mDatabase->CreateDataBinding(1);
-        binding->addField(DFT_bstring,0,64);
-
-        uint64 count = result->getRowCount();
-
-        for(uint64 i = 0; i < count; i++)
-        {
-            result->GetNextRow(binding,&name);
-            name.toLower();
-            playerObject->mFriendsList.insert(std::make_pair(name.getCrc(),name.getAnsi()));
-        }
 
-        mDatabase->DestroyDataBinding(binding);
-
-        // check online friends
+        _loadFriends(playerObject,result);
 
         // query ignorelist
         QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Ignores,asyncContainer->mClient);
@@ -239,21 +253,8 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
     case POFQuery_Ignores:
     {
         PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-        BString name;
 
-        DataBinding* binding = mDatabase->CreateDataBinding(1);
-        binding->addField(DFT_bstring,0,64);
-
-        uint64 count = result->getRowCount();
-
-        for(uint64 i = 0; i < count; i++)
-        {
-            result->GetNextRow(binding,&name);
-            name.toLower();
-            playerObject->mIgnoreList.insert(std::make_pair(name.getCrc(),name.getAnsi()));
-        }
-
-        mDatabase->DestroyDataBinding(binding);
+        _loadIgnores(playerObject,result);
 
         QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_XP,asyncContainer->mClient);
         asContainer->mObject = playerObject;
@@ -284,21 +285,8 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
     case POFQuery_DenyService:
     {
         PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-        uint64 id;
-
-        DataBinding* binding = mDatabase->CreateDataBinding(1);
-        binding->addField(DFT_uint64,0,8);
-
-        uint64 count = result->getRowCount();
-
-        for(uint64 i = 0; i < count; i++)
-        {
-            result->GetNextRow(binding,&id);
-            playerObject->mDenyAudienceList.push_back(id);
-        }
-
-        mDatabase->DestroyDataBinding(binding);
 
+        _loadDenyService(playerObject,result);
 
         // query Holoemotes
         QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_HoloEmotes,asyncContainer->mClient);
@@ -311,21 +299,7 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
 
     case POFQuery_HoloEmotes:
     {
-        PlayerObject*	playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-
-
-        DataBinding* binding = mDatabase->CreateDataBinding(2);
-        binding->addField(DFT_uint32,offsetof(PlayerObject,mHoloEmote),4,0);
-        binding->addField(DFT_int32,offsetof(PlayerObject,mHoloCharge),4,1);
-
-        uint64 count = result->getRowCount();
-
-        if(count ==1)
-        {
-            result->GetNextRow(binding,playerObject);
-        }
-
-        mDatabase->DestroyDataBinding(binding);
+        _loadHoloEmotes(dynamic_cast<PlayerObject*>(asyncContainer->mObject),result);
     }
     break;
 
@@ -333,41 +307,7 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
 
     case POFQuery_XP:
     {
-        PlayerObject*	playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-        XpContainer		xpCont;
-
-        DataBinding* binding = mDatabase->CreateDataBinding(2);
-        binding->addField(DFT_uint32,offsetof(XpContainer,mId),4,0);
-        binding->addField(DFT_int32,offsetof(XpContainer,mValue),4,1);
-
-        uint64 count = result->getRowCount();
-
-        for(uint64 i = 0; i < count; i++)
-        {
-            result->GetNextRow(binding,&xpCont);
-            playerObject->mXpList.push_back(std::make_pair(xpCont.mId,xpCont.mValue));
-        }
-        // Initiate all XP caps and optionally any missing skills.
-        // Skills that require Jedi or JTL will not be included if player do not have the prerequisites.
-        gSkillManager->initExperience(playerObject);
-
-        playerObject->mXpUpdateCounter = static_cast<uint32>(count);
-
-        mDatabase->DestroyDataBinding(binding);
-
-
-        // store us for later lookup - loadcounter is 2 for inventory and datapad
-        InLoadingContainer* ilc = new(mILCPool.ordered_malloc()) InLoadingContainer(playerObject,asyncContainer->mOfCallback,asyncContainer->mClient,2);
-
-        //flag these two as necessary to load
-        ilc->mInventory = false;
-        ilc->mDPad = false;
-
-        mObjectLoadMap.insert(std::make_pair(playerObject->getId(),ilc));
-
-        // request inventory
-        mInventoryFactory->requestObject(this,playerObject->mId + INVENTORY_OFFSET,TanGroup_Inventory,TanType_CharInventory,asyncContainer->mClient);
-
+        _loadXp(dynamic_cast<PlayerObject*>(asyncContainer->mObject),result,asyncContainer->mOfCallback,asyncContainer->mClient);
     }
     break;
 
@@ -401,72 +341,271 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
     // Get the id of the pre defined cloning facility, if any.
     case POFQuery_PreDefCloningFacility:
     {
-        PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
+        _loadCloningFacility(dynamic_cast<PlayerObject*>(asyncContainer->mObject),result);
+    }
+    break;
 
-        DataBinding* binding = mDatabase->CreateDataBinding(5);
-        binding->addField(DFT_uint64,offsetof(PlayerObject,mPreDesignatedCloningFacilityId),8,0);
-        binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.x),4,1);
-        binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.y),4,2);
-        binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.z),4,3);
-        binding->addField(DFT_uint8,offsetof(PlayerObject,mBindPlanet),1,4);
+    case POFQuery_Lots:
+    {
+        _loadLots(dynamic_cast<PlayerObject*>(asyncContainer->mObject),result);
+    }
+    break;
 
-        uint64 count = result->getRowCount();
+    default:
+    {
+        break;
+    }
+    }
 
-        if (count == 1)
-        {
-            result->GetNextRow(binding,playerObject);
-        }
-        else
-        {
-            playerObject->mPreDesignatedCloningFacilityId = 0;
-        }
+    mQueryContainerPool.free(asyncContainer);
+}
 
-        mDatabase->DestroyDataBinding(binding);
+//=============================================================================
+
+void PlayerObjectFactory::_loadSkills(PlayerObject* playerObject,DatabaseResult* result)
+{
+    uint32 skillId;
+
+    DataBinding* binding = mDatabase->CreateDataBinding(1);
+    binding->addField(DFT_uint32,0,4);
+
+    uint64 count = result->getRowCount();
+
+    for(uint64 i = 0; i < count; i++)
+    {
+        result->GetNextRow(binding,&skillId);
+        playerObject->mSkills.push_back(gSkillManager->getSkillById(skillId));
     }
-    break;
 
-    case POFQuery_Lots:
+    mDatabase->DestroyDataBinding(binding);
+
+    playerObject->prepareSkillMods();
+    playerObject->prepareSkillCommands();
+    playerObject->prepareSchematicIds();
+
+    playerObject->mSkillCmdUpdateCounter = playerObject->getSkillCommands()->size();
+    playerObject->mSkillModUpdateCounter = playerObject->getSkillMods()->size();
+}
+
+//=============================================================================
+
+void PlayerObjectFactory::_loadBadges(PlayerObject* playerObject,DatabaseResult* result)
+{
+    uint32 badgeId;
+
+    DataBinding* binding = mDatabase->CreateDataBinding(1);
+    binding->addField(DFT_uint32,0,4);
+
+    uint64 count = result->getRowCount();
+
+    for(uint64 i = 0; i < count; i++)
     {
-        PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
+        result->GetNextRow(binding,&badgeId);
+        playerObject->mBadgeList.push_back(badgeId);
+    }
 
-        uint32 lotCount;
-        DataBinding* binding = mDatabase->CreateDataBinding(1);
-        binding->addField(DFT_uint32,0,4);
+    mDatabase->DestroyDataBinding(binding);
+}
 
-        uint64 count = result->getRowCount();
-        if(!count)
-        {
-            gLogger->log(LogManager::DEBUG,"PlayerObjectFactory: sf_getLotCount did not return a value");
-            //now we have a problem ...
-            mDatabase->DestroyDataBinding(binding);
-            break;
-        }
+//=============================================================================
 
-        result->GetNextRow(binding,&lotCount);
-        uint32 maxLots = gWorldConfig->getConfiguration<uint32>("Player_Max_Lots",(uint32)10);
+void PlayerObjectFactory::_loadFactions(PlayerObject* playerObject,DatabaseResult* result)
+{
+    XpContainer		factionCont;
 
-        maxLots -= static_cast<uint8>(lotCount);
-        playerObject->setLots((uint8)maxLots);
-        gLogger->log(LogManager::DEBUG,"PlayerObjectFactory: %I64u has %u lots remaining",playerObject->getId(),maxLots);
+    DataBinding* binding = mDatabase->CreateDataBinding(2);
+    binding->addField(DFT_uint32,offsetof(XpContainer,mId),4,0);
+    binding->addField(DFT_int32,offsetof(XpContainer,mValue),4,1);
 
-        mDatabase->DestroyDataBinding(binding);
+    uint64 count = result->getRowCount();
+
+    for(uint64 i = 0; i < count; i++)
+    {
+        result->GetNextRow(binding,&factionCont);
+        playerObject->mFactionList.push_back(std::make_pair(factionCont.mId,factionCont.mValue));
     }
-    break;
 
-    default:
+    mDatabase->DestroyDataBinding(binding);
+}
+
+//=============================================================================
+
+void PlayerObjectFactory::_loadFriends(PlayerObject* playerObject,DatabaseResult* result)
+{
+    BString name;
+
+    DataBinding* binding = mDatabase->CreateDataBinding(1);
+    binding->addField(DFT_bstring,0,64);
+
+    uint64 count = result->getRowCount();
+
+    for(uint64 i = 0; i < count; i++)
     {
-        break;
+        result->GetNextRow(binding,&name);
+        name.toLower();
+        playerObject->mFriendsList.insert(std::make_pair(name.getCrc(),name.getAnsi()));
     }
+
+    mDatabase->DestroyDataBinding(binding);
+}
+
+//=============================================================================
+
+void PlayerObjectFactory::_loadIgnores(PlayerObject* playerObject,DatabaseResult* result)
+{
+    BString name;
+
+    DataBinding* binding = mDatabase->CreateDataBinding(1);
+    binding->addField(DFT_bstring,0,64);
+
+    uint64 count = result->getRowCount();
+
+    for(uint64 i = 0; i < count; i++)
+    {
+        result->GetNextRow(binding,&name);
+        name.toLower();
+        playerObject->mIgnoreList.insert(std::make_pair(name.getCrc(),name.getAnsi()));
     }
 
-    mQueryContainerPool.free(asyncContainer);
+    mDatabase->DestroyDataBinding(binding);
+}
+
+//=============================================================================
+
+void PlayerObjectFactory::_loadDenyService(PlayerObject* playerObject,DatabaseResult* result)
+{
+    uint64 id;
+
+    DataBinding* binding = mDatabase->CreateDataBinding(1);
+    binding->addField(DFT_uint64,0,8);
+
+    uint64 count = result->getRowCount();
+
+    for(uint64 i = 0; i < count; i++)
+    {
+        result->GetNextRow(binding,&id);
+        playerObject->mDenyAudienceList.push_back(id);
+    }
+
+    mDatabase->DestroyDataBinding(binding);
+}
+
+//=============================================================================
+
+void PlayerObjectFactory::_loadHoloEmotes(PlayerObject* playerObject,DatabaseResult* result)
+{
+    DataBinding* binding = mDatabase->CreateDataBinding(2);
+    binding->addField(DFT_uint32,offsetof(PlayerObject,mHoloEmote),4,0);
+    binding->addField(DFT_int32,offsetof(PlayerObject,mHoloCharge),4,1);
+
+    uint64 count = result->getRowCount();
+
+    if(count ==1)
+    {
+        result->GetNextRow(binding,playerObject);
+    }
+
+    mDatabase->DestroyDataBinding(binding);
+}
+
+//=============================================================================
+
+void PlayerObjectFactory::_loadCloningFacility(PlayerObject* playerObject,DatabaseResult* result)
+{
+    DataBinding* binding = mDatabase->CreateDataBinding(5);
+    binding->addField(DFT_uint64,offsetof(PlayerObject,mPreDesignatedCloningFacilityId),8,0);
+    binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.x),4,1);
+    binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.y),4,2);
+    binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.z),4,3);
+    binding->addField(DFT_uint8,offsetof(PlayerObject,mBindPlanet),1,4);
+
+    uint64 count = result->getRowCount();
+
+    if (count == 1)
+    {
+        result->GetNextRow(binding,playerObject);
+    }
+    else
+    {
+        playerObject->mPreDesignatedCloningFacilityId = 0;
+    }
+
+    mDatabase->DestroyDataBinding(binding);
+}
+
+//=============================================================================
+
+void PlayerObjectFactory::_loadLots(PlayerObject* playerObject,DatabaseResult* result)
+{
+    uint32 lotCount;
+    DataBinding* binding = mDatabase->CreateDataBinding(1);
+    binding->addField(DFT_uint32,0,4);
+
+    uint64 count = result->getRowCount();
+    if(!count)
+    {
+        gLogger->log(LogManager::DEBUG,"PlayerObjectFactory: sf_getLotCount did not return a value");
+        //now we have a problem ...
+        mDatabase->DestroyDataBinding(binding);
+        return;
+    }
+
+    result->GetNextRow(binding,&lotCount);
+    uint32 maxLots = gWorldConfig->getConfiguration<uint32>("Player_Max_Lots",(uint32)10);
+
+    maxLots -= static_cast<uint8>(lotCount);
+    playerObject->setLots((uint8)maxLots);
+    gLogger->log(LogManager::DEBUG,"PlayerObjectFactory: %I64u has %u lots remaining",playerObject->getId(),maxLots);
+
+    mDatabase->DestroyDataBinding(binding);
+}
+
+//=============================================================================
+
+void PlayerObjectFactory::_loadXp(PlayerObject* playerObject,DatabaseResult* result,ObjectFactoryCallback* ofCallback,DispatchClient* client)
+{
+    XpContainer		xpCont;
+
+    DataBinding* binding = mDatabase->CreateDataBinding(2);
+    binding->addField(DFT_uint32,offsetof(XpContainer,mId),4,0);
+    binding->addField(DFT_int32,offsetof(XpContainer,mValue),4,1);
+
+    uint64 count = result->getRowCount();
+
+    for(uint64 i = 0; i < count; i++)
+    {
+        result->GetNextRow(binding,&xpCont);
+        playerObject->mXpList.push_back(std::make_pair(xpCont.mId,xpCont.mValue));
+    }
+    // Initiate all XP caps and optionally any missing skills.
+    // Skills that require Jedi or JTL will not be included if player do not have the prerequisites.
+    gSkillManager->initExperience(playerObject);
+
+    playerObject->mXpUpdateCounter = static_cast<uint32>(count);
+
+    mDatabase->DestroyDataBinding(binding);
+
+
+    // store us for later lookup - loadcounter is 2 for inventory and datapad
+    InLoadingContainer* ilc = new(mILCPool.ordered_malloc()) InLoadingContainer(playerObject,ofCallback,client,2);
+
+    //flag these two as necessary to load
+    ilc->mInventory = false;
+    ilc->mDPad = false;
+
+    mObjectLoadMap.insert(std::make_pair(playerObject->getId(),ilc));
+
+    // request inventory
+    mInventoryFactory->requestObject(this,playerObject->mId + INVENTORY_OFFSET,TanGroup_Inventory,TanType_CharInventory,client);
 }
 
 //=============================================================================
 
 void PlayerObjectFactory::requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client)
 {
-    QueryContainerBase* asyncContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,POFQuery_MainPlayerData,client);
+    QueryContainerBase* asyncContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,POFQuery_MainPlayerData,client,id);
+
+    mLoadStartTimes[id] = gClock->getLocalTime();
 
     int8 sql[8152];
     sprintf(sql,"SELECT characters.id,characters.parent_Id,characters.account_id,characters.oX,characters.oY,characters.oZ,characters.oW,"//7
@@ -903,6 +1042,8 @@ void PlayerObjectFactory::handleObjectReady(Object* object,DispatchClient* clien
         // init equip counter
         playerObject->mEquipManager.setEquippedObjectsUpdateCounter(0);
 
+        _playerLoadComplete(playerObject->getId());
+
         ilc->mOfCallback->handleObjectReady(playerObject,ilc->mClient);
 
         mILCPool.free(ilc);
@@ -910,6 +1051,43 @@ void PlayerObjectFactory::handleObjectReady(Object* object,DispatchClient* clien
     //gBuffManager->InitBuffs(playerObject);
 }
 
+//=============================================================================
+//
+// time to zone in as far as the database is concerned, logged for every 100 characters
+//
+
+void PlayerObjectFactory::_playerLoadComplete(uint64 playerId)
+{
+    std::map<uint64,uint64>::iterator it = mLoadStartTimes.find(playerId);
+
+    if(it == mLoadStartTimes.end())
+    {
+        return;
+    }
+
+    uint64 loadTime = gClock->getLocalTime() - (*it).second;
+    mLoadStartTimes.erase(it);
+
+    mLoadsCompleted++;
+    mLoadTimeTotal += loadTime;
+
+    if(loadTime > mLoadTimeMax)
+    {
+        mLoadTimeMax = loadTime;
+    }
+
+    if(mLoadsCompleted == 100)
+    {
+        gLogger->log(LogManager::INFORMATION,"PlayerObjectFactory: %u characters loaded (%s), avg %"PRIu64"ms max %"PRIu64"ms, %u loading",
+                     mLoadsCompleted,mBatchedLoad ? "batched" : "sequential",mLoadTimeTotal / mLoadsCompleted,mLoadTimeMax,
+                     static_cast<uint32>(mLoadStartTimes.size()));
+
+        mLoadsCompleted	= 0;
+        mLoadTimeTotal	= 0;
+        mLoadTimeMax	= 0;
+    }
+}
+
 //=============================================================================
 
 void PlayerObjectFactory::releaseAllPoolsMemory()
@@ -31,6 +31,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "FactoryBase.h"
 #include "ObjectFactoryCallback.h"
 
+#include <map>
+
 #define 	gPlayerObjectFactory	PlayerObjectFactory::getSingletonPtr()
 
 //=============================================================================
@@ -60,7 +62,8 @@ enum POFQuery
     POFQuery_HoloEmotes				= 11,
     POFQuery_EquippedItems			= 12,
     POFQuery_PreDefCloningFacility	= 13,
-    POFQuery_Lots					= 14
+    POFQuery_Lots					= 14,
+    POFQuery_Batched				= 15
 };
 
 //=============================================================================
@@ -91,6 +94,20 @@ private:
 
     PlayerObject*	_createPlayer(DatabaseResult* result);
 
+    // one per query of the load, the sequential and the batched load share them
+    void			_loadSkills(PlayerObject* playerObject,DatabaseResult* result);
+    void			_loadBadges(PlayerObject* playerObject,DatabaseResult* result);
+    void			_loadFactions(PlayerObject* playerObject,DatabaseResult* result);
+    void			_loadFriends(PlayerObject* playerObject,DatabaseResult* result);
+    void			_loadIgnores(PlayerObject* playerObject,DatabaseResult* result);
+    void			_loadDenyService(PlayerObject* playerObject,DatabaseResult* result);
+    void			_loadHoloEmotes(PlayerObject* playerObject,DatabaseResult* result);
+    void			_loadCloningFacility(PlayerObject* playerObject,DatabaseResult* result);
+    void			_loadLots(PlayerObject* playerObject,DatabaseResult* result);
+    void			_loadXp(PlayerObject* playerObject,DatabaseResult* result,ObjectFactoryCallback* ofCallback,DispatchClient* client);
+
+    void			_playerLoadComplete(uint64 playerId);
+
     static PlayerObjectFactory*		mSingleton;
     static bool						mInsFlag;
 
@@ -101,6 +118,15 @@ private:
     DataBinding*					mHairBinding;
     DataBinding*					mBankBinding;
     //InLoadingContainer*				mIlc;
+
+    // CharacterLoadBatched, everything after the main data is queried in one multi statement request
+    bool							mBatchedLoad;
+
+    // load times, from the request until the player is handed on with inventory and datapad
+    std::map<uint64,uint64>			mLoadStartTimes;
+    uint32							mLoadsCompleted;
+    uint64							mLoadTimeTotal;
+    uint64							mLoadTimeMax;
 };
 
 //=============================================================================
@@ -26,7 +26,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "QTRegion.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
+
+#include <algorithm>
 
 
 //=============================================================================
@@ -55,12 +57,15 @@ QTRegion::~QTRegion()
 
 //=============================================================================
 //
-// setup the qtree
+// setup the grid, its cells are as big as the leafs of a quadtree of our depth were
 //
 
 void QTRegion::initTree()
 {
-    mTree = new QuadTree(mPosition.x,mPosition.z,mWidth,mHeight,mQTDepth);
+    uint8 depth = (mQTDepth > 16) ? 16 : mQTDepth;
+    float cellSize = std::min(mWidth,mHeight) / static_cast<float>(1 << depth);
+
+    mTree = new ObjectGrid(mPosition.x,mPosition.z,mWidth,mHeight,cellSize);
 }
 
 //==============================================================================
@@ -30,7 +30,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "RegionObject.h"
 
-class QuadTree;
+class Object;
+template<typename T> class SpatialGrid;
 
 //=============================================================================
 
@@ -46,7 +47,7 @@ public:
     void		initTree();
     bool		checkPlayerPosition(float x, float y);
 
-    QuadTree*	mTree;
+    SpatialGrid<Object>*	mTree;
 
 private:
 
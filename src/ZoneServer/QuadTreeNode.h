@@ -1,78 +0,0 @@
-/*
----------------------------------------------------------------------------------------
-This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
-
-For more information, visit http://www.swganh.com
-
-Copyright (c) 2006 - 2010 The SWG:ANH Team
----------------------------------------------------------------------------------------
-Use of this source code is governed by the GPL v3 license that can be found
-in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
-
-This library is free software; you can redistribute it and/or
-modify it under the terms of the GNU Lesser General Public
-License as published by the Free Software Foundation; either
-version 2.1 of the License, or (at your option) any later version.
-
-This library is distributed in the hope that it will be useful,
-but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
-Lesser General Public License for more details.
-
-You should have received a copy of the GNU Lesser General Public
-License along with this library; if not, write to the Free Software
-Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
----------------------------------------------------------------------------------------
-*/
-
-#ifndef	ANH_ZONESERVER_QUADTREE_H
-#define	ANH_ZONESERVER_QUADTREE_H
-
-#include "MathLib/Rectangle.h"
-#include "Utils/typedefs.h"
-#include <map>
-#include <set>
-#include <glm/glm.hpp>
-
-class Object;
-
-namespace Anh_Math
-{
-class Space;
-}
-
-typedef std::map<uint64,Object*> StdObjectMap;
-typedef std::set<Object*> ObjectSet;
-
-//======================================================================================================================
-
-class QuadTreeNode : public Anh_Math::Rectangle
-{
-public:
-
-    QuadTreeNode(float lowX,float lowZ,float width,float height);
-    virtual ~QuadTreeNode();
-
-    int32	addObject(Object* object);
-    int32	removeObject(Object* object);
-    int32	updateObject(Object* object, const glm::vec3& newPosition);
-
-    bool	checkBounds(Object* object);
-    bool	intersects(Anh_Math::Shape* shape);
-    bool	ObjectContained(Anh_Math::Shape* shape, Object* object);
-    void	getObjectsInRange(Object* object,ObjectSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape);
-    void	getObjectsInRangeContains(Object* object,ObjectSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape);
-
-    void	subDivide();
-
-protected:
-
-    QuadTreeNode**	mSubNodes;
-    StdObjectMap	mObjects;
-};
-
-//======================================================================================================================
-
-#endif
-
-
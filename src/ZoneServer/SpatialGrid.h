@@ -0,0 +1,740 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_ZONESERVER_SPATIALGRID_H
+#define ANH_ZONESERVER_SPATIALGRID_H
+
+#include "MathLib/Rectangle.h"
+#include "Utils/typedefs.h"
+#include <cassert>
+#include <cmath>
+#include <set>
+#include <vector>
+#include <boost/unordered_map.hpp>
+#include <glm/glm.hpp>
+
+//======================================================================================================================
+//
+// Uniform grid for the moving objects of a QTRegion, players, vehicles and roaming creatures.
+//
+// The region is cut into square cells, a cell only exists while objects are in it and is found by hashing its index. Cells hold the object pointers themselves, so a query needs no id lookup, and a move that
+// stays within its cell only writes the new position. Like the QuadTree leafs it replaces, a range query returns
+// everything in the cells the shape touches, callers do their own distance checks.
+//
+// Objects outside of the region are kept in its border cells.
+// T needs mPosition and getType(), the grid is used with Object, see ObjectGrid.
+//
+// Interest management, a subscriber (a player) listens to the square of cells around the cell it stands in. Objects
+// crossing into or out of that window, and the window moving along with its subscriber, are queued as entered / left
+// for the subscriber, so keeping its known objects current costs what changed instead of a query over the crowd.
+// The window covers at least the subscribed range in every direction, an object that left it is out of range.
+// Who listens to a cell is kept apart from the cells with objects, so windows over empty land create no cells.
+// Removing an object from the grid is no leave, it's dropped from all queues, the caller takes care of its destroys.
+//
+
+template<typename T>
+class SpatialGrid
+{
+public:
+
+    typedef std::set<T*>	ResultSet;
+
+    SpatialGrid(float lowX,float lowZ,float width,float height,float cellSize);
+
+    // return values as the QuadTree, 1 for done, 2 when the object was already in / not in the grid
+    int32	addObject(T* object);
+    int32	removeObject(T* object);
+    int32	updateObject(T* object, const glm::vec3& newPosition);
+
+    bool	ObjectContained(Anh_Math::Shape* shape, T* object);
+    void	getObjectsInRange(T* object,ResultSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape);
+    void	getObjectsInRangeContains(T* object,ResultSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape);
+
+    uint32	getObjectCount() const {
+        return static_cast<uint32>(mObjectCells.size());
+    }
+    uint32	getCellCount() const {
+        return static_cast<uint32>(mCells.size());
+    }
+    float	getCellSize() const {
+        return mCellSize;
+    }
+
+    // interest management, the subscriber needs to be in the grid
+    // subscribing again with another range moves the window, everything new in it is queued as entered
+    bool	subscribe(T* subscriber,uint32 typeMask,float range);
+    void	unsubscribe(T* subscriber);
+    bool	isSubscribed(T* subscriber) const {
+        return(mSubscriptions.find(subscriber) != mSubscriptions.end());
+    }
+
+    // hands over the queued changes since the last call
+    void	getInterestChanges(T* subscriber,ResultSet* entered,ResultSet* left);
+
+private:
+
+    typedef std::vector<T*>	ObjectList;
+
+    // cell rectangle, low > high is empty
+    struct Window
+    {
+        uint32	mLowColumn;
+        uint32	mHighColumn;
+        uint32	mLowRow;
+        uint32	mHighRow;
+
+        bool	contains(uint32 column,uint32 row) const {
+            return(column >= mLowColumn && column <= mHighColumn && row >= mLowRow && row <= mHighRow);
+        }
+    };
+
+    struct Subscription
+    {
+        uint32		mTypeMask;
+        uint32		mRadius;	// in cells around the subscribers cell
+        Window		mWindow;
+        ResultSet	mEntered;
+        ResultSet	mLeft;
+    };
+
+    typedef boost::unordered_map<uint32,ObjectList>		GridCellMap;
+    typedef boost::unordered_map<T*,uint32>				ObjectCellMap;
+    typedef boost::unordered_map<T*,Subscription>		SubscriptionMap;
+
+    uint32	_getColumn(float x) const;
+    uint32	_getRow(float z) const;
+    uint32	_getCellIndex(float x,float z) const {
+        return _getRow(z) * mColumns + _getColumn(x);
+    }
+
+    // drops the cell once its list ran empty
+    void	_removeFromCell(GridCellMap& cells,T* object,uint32 cellIndex);
+    void	_removeFromList(ObjectList& list,T* object);
+
+    // interest management
+    Window	_getWindow(uint32 cellIndex,uint32 radius) const;
+    bool	_windowContains(const Window& window,uint32 cellIndex) const {
+        return window.contains(cellIndex % mColumns,cellIndex / mColumns);
+    }
+    void	_moveWindow(T* subscriber,Subscription& subscription,const Window& window);
+    void	_objectMoved(T* object,uint32 oldCellIndex,uint32 newCellIndex);
+    void	_objectEntered(Subscription& subscription,T* subscriber,T* object);
+    void	_objectLeft(Subscription& subscription,T* subscriber,T* object);
+
+    // contains checks every object against the shape, instead of taking whole cells
+    void	_queryCells(T* object,ResultSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape,bool contains);
+    void	_collectCell(const ObjectList& objects,T* object,ResultSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape,bool contains);
+
+    float			mLowX;
+    float			mLowZ;
+    float			mCellSize;
+    float			mInverseCellSize;
+    uint32			mColumns;
+    uint32			mRows;
+
+    GridCellMap		mCells;			// the objects in a cell
+    GridCellMap		mSubscriberCells;	// the subscribers whose window covers a cell
+    ObjectCellMap	mObjectCells;	// the cell every object was filed in, positions may change behind our back
+    SubscriptionMap	mSubscriptions;
+};
+
+//======================================================================================================================
+
+template<typename T>
+SpatialGrid<T>::SpatialGrid(float lowX,float lowZ,float width,float height,float cellSize) :
+    mLowX(lowX),
+    mLowZ(lowZ),
+    mCellSize(cellSize)
+{
+    if(mCellSize < 1.0f)
+    {
+        mCellSize = 1.0f;
+    }
+
+    mInverseCellSize	= 1.0f / mCellSize;
+    mColumns			= static_cast<uint32>(std::ceil(width * mInverseCellSize));
+    mRows				= static_cast<uint32>(std::ceil(height * mInverseCellSize));
+
+    if(!mColumns)
+        mColumns = 1;
+
+    if(!mRows)
+        mRows = 1;
+}
+
+//======================================================================================================================
+
+template<typename T>
+uint32 SpatialGrid<T>::_getColumn(float x) const
+{
+    float column = std::floor((x - mLowX) * mInverseCellSize);
+
+    if(column <= 0.0f)
+        return(0);
+
+    if(column >= static_cast<float>(mColumns - 1))
+        return(mColumns - 1);
+
+    return(static_cast<uint32>(column));
+}
+
+//======================================================================================================================
+
+template<typename T>
+uint32 SpatialGrid<T>::_getRow(float z) const
+{
+    float row = std::floor((z - mLowZ) * mInverseCellSize);
+
+    if(row <= 0.0f)
+        return(0);
+
+    if(row >= static_cast<float>(mRows - 1))
+        return(mRows - 1);
+
+    return(static_cast<uint32>(row));
+}
+
+//======================================================================================================================
+
+template<typename T>
+int32 SpatialGrid<T>::addObject(T* object)
+{
+    assert(object && "SpatialGrid::addObject this method does not accept NULL objects");
+
+    uint32 cellIndex = _getCellIndex(object->mPosition.x,object->mPosition.z);
+
+    if(!mObjectCells.insert(std::make_pair(object,cellIndex)).second)
+    {
+        return(2);
+    }
+
+    mCells[cellIndex].push_back(object);
+
+    typename GridCellMap::iterator cellIt = mSubscriberCells.find(cellIndex);
+
+    if(cellIt != mSubscriberCells.end())
+    {
+        ObjectList& subscribers = (*cellIt).second;
+
+        for(typename ObjectList::iterator it = subscribers.begin(); it != subscribers.end(); ++it)
+        {
+            _objectEntered(mSubscriptions[(*it)],(*it),object);
+        }
+    }
+
+    return(1);
+}
+
+//======================================================================================================================
+
+template<typename T>
+int32 SpatialGrid<T>::removeObject(T* object)
+{
+    assert(object && "SpatialGrid::removeObject this method does not accept NULL objects");
+
+    typename ObjectCellMap::iterator it = mObjectCells.find(object);
+
+    if(it == mObjectCells.end())
+    {
+        return(2);
+    }
+
+    _removeFromCell(mCells,object,(*it).second);
+
+    mObjectCells.erase(it);
+
+    unsubscribe(object);
+
+    // no leave, but it must not be handed out anymore
+    for(typename SubscriptionMap::iterator subIt = mSubscriptions.begin(); subIt != mSubscriptions.end(); ++subIt)
+    {
+        (*subIt).second.mEntered.erase(object);
+        (*subIt).second.mLeft.erase(object);
+    }
+
+    return(1);
+}
+
+//======================================================================================================================
+//
+// sets the new position, the object only changes cells when it crossed a border
+//
+
+template<typename T>
+int32 SpatialGrid<T>::updateObject(T* object, const glm::vec3& newPosition)
+{
+    assert(object && "SpatialGrid::updateObject this method does not accept NULL objects");
+
+    object->mPosition = newPosition;
+
+    uint32 cellIndex = _getCellIndex(newPosition.x,newPosition.z);
+
+    typename ObjectCellMap::iterator it = mObjectCells.find(object);
+
+    // not in yet, the QuadTree added it as well
+    if(it == mObjectCells.end())
+    {
+        addObject(object);
+
+        return(0);
+    }
+
+    uint32 oldCellIndex = (*it).second;
+
+    if(oldCellIndex != cellIndex)
+    {
+        _removeFromCell(mCells,object,oldCellIndex);
+
+        (*it).second = cellIndex;
+        mCells[cellIndex].push_back(object);
+
+        _objectMoved(object,oldCellIndex,cellIndex);
+    }
+
+    return(0);
+}
+
+//======================================================================================================================
+//
+// cells hold few objects, so search and swap with the last one
+//
+
+template<typename T>
+void SpatialGrid<T>::_removeFromCell(GridCellMap& cells,T* object,uint32 cellIndex)
+{
+    typename GridCellMap::iterator cellIt = cells.find(cellIndex);
+
+    if(cellIt == cells.end())
+    {
+        return;
+    }
+
+    _removeFromList((*cellIt).second,object);
+
+    if((*cellIt).second.empty())
+    {
+        cells.erase(cellIt);
+    }
+}
+
+//======================================================================================================================
+
+template<typename T>
+void SpatialGrid<T>::_removeFromList(ObjectList& list,T* object)
+{
+    for(typename ObjectList::iterator it = list.begin(); it != list.end(); ++it)
+    {
+        if((*it) == object)
+        {
+            (*it) = list.back();
+            list.pop_back();
+            return;
+        }
+    }
+}
+
+//======================================================================================================================
+
+template<typename T>
+void SpatialGrid<T>::getObjectsInRange(T* object,ResultSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape)
+{
+    _queryCells(object,resultSet,typeMask,shape,false);
+}
+
+//======================================================================================================================
+//
+// used by camps, only the objects that really are inside
+//
+
+template<typename T>
+void SpatialGrid<T>::getObjectsInRangeContains(T* object,ResultSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape)
+{
+    _queryCells(object,resultSet,typeMask,shape,true);
+}
+
+//======================================================================================================================
+
+template<typename T>
+void SpatialGrid<T>::_queryCells(T* object,ResultSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape,bool contains)
+{
+    // like the QuadTree, only rectangles are supported
+    Anh_Math::Rectangle* rectangle = dynamic_cast<Anh_Math::Rectangle*>(shape);
+
+    if(!rectangle)
+    {
+        return;
+    }
+
+    const glm::vec3& rectPos = rectangle->getPosition();
+
+    uint32 lowColumn	= _getColumn(rectPos.x);
+    uint32 highColumn	= _getColumn(rectPos.x + rectangle->getWidth());
+    uint32 lowRow		= _getRow(rectPos.z);
+    uint32 highRow		= _getRow(rectPos.z + rectangle->getHeight());
+
+    uint64 cellCount = static_cast<uint64>(highColumn - lowColumn + 1) * (highRow - lowRow + 1);
+
+    // a big rectangle over a sparse grid, walk the cells we have instead of the ones it touches
+    if(cellCount > mCells.size())
+    {
+        for(typename GridCellMap::iterator cellIt = mCells.begin(); cellIt != mCells.end(); ++cellIt)
+        {
+            uint32 column	= (*cellIt).first % mColumns;
+            uint32 row		= (*cellIt).first / mColumns;
+
+            if(column >= lowColumn && column <= highColumn && row >= lowRow && row <= highRow)
+            {
+                _collectCell((*cellIt).second,object,resultSet,typeMask,shape,contains);
+            }
+        }
+
+        return;
+    }
+
+    for(uint32 row = lowRow; row <= highRow; row++)
+    {
+        for(uint32 column = lowColumn; column <= highColumn; column++)
+        {
+            typename GridCellMap::iterator cellIt = mCells.find(row * mColumns + column);
+
+            if(cellIt != mCells.end())
+            {
+                _collectCell((*cellIt).second,object,resultSet,typeMask,shape,contains);
+            }
+        }
+    }
+}
+
+//======================================================================================================================
+
+template<typename T>
+void SpatialGrid<T>::_collectCell(const ObjectList& objects,T* object,ResultSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape,bool contains)
+{
+    for(typename ObjectList::const_iterator it = objects.begin(); it != objects.end(); ++it)
+    {
+        T* currentObject = (*it);
+
+        // don't add ourself
+        if(currentObject != object && ((currentObject->getType() & typeMask) == static_cast<uint32>(currentObject->getType()))
+                && (!contains || ObjectContained(shape,currentObject)))
+        {
+            resultSet->insert(currentObject);
+        }
+    }
+}
+
+//======================================================================================================================
+
+template<typename T>
+bool SpatialGrid<T>::ObjectContained(Anh_Math::Shape* shape, T* object)
+{
+    // rectangular
+    if(Anh_Math::Rectangle* rectangle = dynamic_cast<Anh_Math::Rectangle*>(shape))
+    {
+        const glm::vec3& rectPos = rectangle->getPosition();
+
+        if(rectPos.x > object->mPosition.x   || rectPos.x + rectangle->getWidth()  < object->mPosition.x
+                || rectPos.z > object->mPosition.z  || rectPos.z + rectangle->getHeight() < object->mPosition.z)
+        {
+            return(false);
+        }
+
+        return(true);
+    }
+
+    return(false);
+}
+
+//======================================================================================================================
+
+template<typename T>
+bool SpatialGrid<T>::subscribe(T* subscriber,uint32 typeMask,float range)
+{
+    assert(subscriber && "SpatialGrid::subscribe this method does not accept NULL objects");
+
+    typename ObjectCellMap::iterator it = mObjectCells.find(subscriber);
+
+    if(it == mObjectCells.end())
+    {
+        return(false);
+    }
+
+    uint32 radius = static_cast<uint32>(std::ceil(range * mInverseCellSize));
+
+    typename SubscriptionMap::iterator subIt = mSubscriptions.find(subscriber);
+
+    if(subIt == mSubscriptions.end())
+    {
+        Subscription subscription;
+
+        subscription.mRadius				= radius;
+        subscription.mWindow.mLowColumn		= 1;
+        subscription.mWindow.mHighColumn	= 0;
+        subscription.mWindow.mLowRow		= 1;
+        subscription.mWindow.mHighRow		= 0;
+
+        subIt = mSubscriptions.insert(std::make_pair(subscriber,subscription)).first;
+    }
+    else if((*subIt).second.mRadius == radius)
+    {
+        (*subIt).second.mTypeMask = typeMask;
+
+        return(true);
+    }
+
+    Subscription& subscription = (*subIt).second;
+
+    subscription.mTypeMask	= typeMask;
+    subscription.mRadius	= radius;
+
+    _moveWindow(subscriber,subscription,_getWindow((*it).second,radius));
+
+    return(true);
+}
+
+//======================================================================================================================
+
+template<typename T>
+void SpatialGrid<T>::unsubscribe(T* subscriber)
+{
+    typename SubscriptionMap::iterator subIt = mSubscriptions.find(subscriber);
+
+    if(subIt == mSubscriptions.end())
+    {
+        return;
+    }
+
+    const Window& window = (*subIt).second.mWindow;
+
+    for(uint32 row = window.mLowRow; row <= window.mHighRow; row++)
+    {
+        for(uint32 column = window.mLowColumn; column <= window.mHighColumn; column++)
+        {
+            _removeFromCell(mSubscriberCells,subscriber,row * mColumns + column);
+        }
+    }
+
+    mSubscriptions.erase(subIt);
+}
+
+//======================================================================================================================
+
+template<typename T>
+void SpatialGrid<T>::getInterestChanges(T* subscriber,ResultSet* entered,ResultSet* left)
+{
+    typename SubscriptionMap::iterator subIt = mSubscriptions.find(subscriber);
+
+    if(subIt == mSubscriptions.end())
+    {
+        return;
+    }
+
+    Subscription& subscription = (*subIt).second;
+
+    entered->insert(subscription.mEntered.begin(),subscription.mEntered.end());
+    left->insert(subscription.mLeft.begin(),subscription.mLeft.end());
+
+    subscription.mEntered.clear();
+    subscription.mLeft.clear();
+}
+
+//======================================================================================================================
+
+template<typename T>
+typename SpatialGrid<T>::Window SpatialGrid<T>::_getWindow(uint32 cellIndex,uint32 radius) const
+{
+    uint32	column	= cellIndex % mColumns;
+    uint32	row		= cellIndex / mColumns;
+    Window	window;
+
+    window.mLowColumn	= (column > radius) ? column - radius : 0;
+    window.mHighColumn	= (mColumns - 1 - column > radius) ? column + radius : mColumns - 1;
+    window.mLowRow		= (row > radius) ? row - radius : 0;
+    window.mHighRow		= (mRows - 1 - row > radius) ? row + radius : mRows - 1;
+
+    return(window);
+}
+
+//======================================================================================================================
+//
+// only the cells that drop out of or come into the window are touched
+//
+
+template<typename T>
+void SpatialGrid<T>::_moveWindow(T* subscriber,Subscription& subscription,const Window& window)
+{
+    Window oldWindow = subscription.mWindow;
+
+    subscription.mWindow = window;
+
+    for(uint32 row = oldWindow.mLowRow; row <= oldWindow.mHighRow; row++)
+    {
+        for(uint32 column = oldWindow.mLowColumn; column <= oldWindow.mHighColumn; column++)
+        {
+            if(window.contains(column,row))
+            {
+                continue;
+            }
+
+            uint32 cellIndex = row * mColumns + column;
+
+            _removeFromCell(mSubscriberCells,subscriber,cellIndex);
+
+            typename GridCellMap::iterator cellIt = mCells.find(cellIndex);
+
+            if(cellIt == mCells.end())
+            {
+                continue;
+            }
+
+            ObjectList& objects = (*cellIt).second;
+
+            for(typename ObjectList::iterator it = objects.begin(); it != objects.end(); ++it)
+            {
+                _objectLeft(subscription,subscriber,(*it));
+            }
+        }
+    }
+
+    for(uint32 row = window.mLowRow; row <= window.mHighRow; row++)
+    {
+        for(uint32 column = window.mLowColumn; column <= window.mHighColumn; column++)
+        {
+            if(oldWindow.contains(column,row))
+            {
+                continue;
+            }
+
+            uint32 cellIndex = row * mColumns + column;
+
+            mSubscriberCells[cellIndex].push_back(subscriber);
+
+            typename GridCellMap::iterator cellIt = mCells.find(cellIndex);
+
+            if(cellIt == mCells.end())
+            {
+                continue;
+            }
+
+            ObjectList& objects = (*cellIt).second;
+
+            for(typename ObjectList::iterator it = objects.begin(); it != objects.end(); ++it)
+            {
+                _objectEntered(subscription,subscriber,(*it));
+            }
+        }
+    }
+}
+
+//======================================================================================================================
+//
+// an object changed cells, subscribers that only see one of both cells get told, a subscriber drags its window along
+//
+
+template<typename T>
+void SpatialGrid<T>::_objectMoved(T* object,uint32 oldCellIndex,uint32 newCellIndex)
+{
+    typename GridCellMap::iterator cellIt = mSubscriberCells.find(oldCellIndex);
+
+    if(cellIt != mSubscriberCells.end())
+    {
+        ObjectList& subscribers = (*cellIt).second;
+
+        for(typename ObjectList::iterator it = subscribers.begin(); it != subscribers.end(); ++it)
+        {
+            Subscription& subscription = mSubscriptions[(*it)];
+
+            if(!_windowContains(subscription.mWindow,newCellIndex))
+            {
+                _objectLeft(subscription,(*it),object);
+            }
+        }
+    }
+
+    cellIt = mSubscriberCells.find(newCellIndex);
+
+    if(cellIt != mSubscriberCells.end())
+    {
+        ObjectList& subscribers = (*cellIt).second;
+
+        for(typename ObjectList::iterator it = subscribers.begin(); it != subscribers.end(); ++it)
+        {
+            Subscription& subscription = mSubscriptions[(*it)];
+
+            if(!_windowContains(subscription.mWindow,oldCellIndex))
+            {
+                _objectEntered(subscription,(*it),object);
+            }
+        }
+    }
+
+    typename SubscriptionMap::iterator subIt = mSubscriptions.find(object);
+
+    if(subIt != mSubscriptions.end())
+    {
+        _moveWindow(object,(*subIt).second,_getWindow(newCellIndex,(*subIt).second.mRadius));
+    }
+}
+
+//======================================================================================================================
+
+template<typename T>
+void SpatialGrid<T>::_objectEntered(Subscription& subscription,T* subscriber,T* object)
+{
+    if(object == subscriber || (object->getType() & subscription.mTypeMask) != static_cast<uint32>(object->getType()))
+    {
+        return;
+    }
+
+    subscription.mLeft.erase(object);
+    subscription.mEntered.insert(object);
+}
+
+//======================================================================================================================
+
+template<typename T>
+void SpatialGrid<T>::_objectLeft(Subscription& subscription,T* subscriber,T* object)
+{
+    if(object == subscriber || (object->getType() & subscription.mTypeMask) != static_cast<uint32>(object->getType()))
+    {
+        return;
+    }
+
+    subscription.mEntered.erase(object);
+    subscription.mLeft.insert(object);
+}
+
+//======================================================================================================================
+
+class Object;
+
+typedef SpatialGrid<Object>	ObjectGrid;
+
+//======================================================================================================================
+
+#endif
+
@@ -0,0 +1,385 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_ZONESERVER_STATICRTREE_H
+#define ANH_ZONESERVER_STATICRTREE_H
+
+#include "Utils/typedefs.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//======================================================================================================================
+//
+// R-tree for what the zone loads at boot, buildings, statics, still creatures and regions.
+//
+// Entries are collected first and packed in one pass with Sort-Tile-Recursive: sort by x, cut into vertical slices,
+// sort every slice by z and fill the nodes up, then do the same with the nodes for the next level. There are no
+// splits or reinsertions and the nodes are full and hardly overlap. Nodes and entries live in flat arrays.
+//
+// Removing only marks the entry, the tree isn't repacked. Entries inserted after the build wait in a pending list
+// that is scanned by every query until the next build.
+//
+
+class StaticRTree
+{
+public:
+
+    typedef std::vector<int64>	IdList;
+
+    explicit StaticRTree(uint32 nodeCapacity = 16);
+
+    void	insert(int64 id,double lowX,double lowZ,double highX,double highZ);
+    bool	remove(int64 id,double lowX,double lowZ,double highX,double highZ);
+
+    // packs everything inserted so far, pending and already packed
+    void	build();
+    void	clear();
+
+    // everything whose box intersects the query box, a point is a box with no extent
+    void	intersects(double lowX,double lowZ,double highX,double highZ,IdList* results) const;
+
+    uint32	getEntryCount() const {
+        return static_cast<uint32>(mEntries.size() + mPending.size()) - mRemovedCount;
+    }
+    uint32	getPendingCount() const {
+        return static_cast<uint32>(mPending.size());
+    }
+    uint32	getNodeCount() const {
+        return static_cast<uint32>(mNodes.size());
+    }
+    uint32	getHeight() const {
+        return mHeight;
+    }
+
+private:
+
+    struct Box
+    {
+        double	mLowX;
+        double	mLowZ;
+        double	mHighX;
+        double	mHighZ;
+
+        bool	intersects(const Box& other) const {
+            return(mLowX <= other.mHighX && other.mLowX <= mHighX && mLowZ <= other.mHighZ && other.mLowZ <= mHighZ);
+        }
+        void	include(const Box& other) {
+            mLowX	= std::min(mLowX,other.mLowX);
+            mLowZ	= std::min(mLowZ,other.mLowZ);
+            mHighX	= std::max(mHighX,other.mHighX);
+            mHighZ	= std::max(mHighZ,other.mHighZ);
+        }
+    };
+
+    struct Entry
+    {
+        Box		mBox;
+        int64	mId;
+        bool	mRemoved;
+    };
+
+    // children are nodes of the level below, or entries for the leafs (level 0)
+    struct Node
+    {
+        Box		mBox;
+        uint32	mFirst;
+        uint32	mCount;
+        uint32	mLevel;
+    };
+
+    struct CenterXLess
+    {
+        template<typename T> bool operator()(const T& a,const T& b) const {
+            return(a.mBox.mLowX + a.mBox.mHighX < b.mBox.mLowX + b.mBox.mHighX);
+        }
+    };
+    struct CenterZLess
+    {
+        template<typename T> bool operator()(const T& a,const T& b) const {
+            return(a.mBox.mLowZ + a.mBox.mHighZ < b.mBox.mLowZ + b.mBox.mHighZ);
+        }
+    };
+
+    template<typename T> void	_tile(std::vector<T>& items) const;
+    template<typename T> void	_addParents(const std::vector<T>& children,uint32 firstChild,uint32 level,std::vector<Node>& parents) const;
+
+    void	_intersects(uint32 nodeIndex,const Box& box,IdList* results) const;
+    bool	_remove(uint32 nodeIndex,int64 id,const Box& box);
+
+    std::vector<Entry>	mEntries;	// packed, in leaf order
+    std::vector<Node>	mNodes;		// level by level from the leafs, the root is the last one
+    std::vector<Entry>	mPending;
+    uint32				mNodeCapacity;
+    uint32				mRemovedCount;
+    uint32				mHeight;
+};
+
+//======================================================================================================================
+
+inline StaticRTree::StaticRTree(uint32 nodeCapacity) :
+    mNodeCapacity(nodeCapacity < 2 ? 2 : nodeCapacity),
+    mRemovedCount(0),
+    mHeight(0)
+{
+}
+
+//======================================================================================================================
+
+inline void StaticRTree::insert(int64 id,double lowX,double lowZ,double highX,double highZ)
+{
+    Entry entry;
+
+    entry.mBox.mLowX	= lowX;
+    entry.mBox.mLowZ	= lowZ;
+    entry.mBox.mHighX	= highX;
+    entry.mBox.mHighZ	= highZ;
+    entry.mId			= id;
+    entry.mRemoved		= false;
+
+    mPending.push_back(entry);
+}
+
+//======================================================================================================================
+//
+// the entry with this id whose box intersects the given one, objects are removed with the shape they were added with
+//
+
+inline bool StaticRTree::remove(int64 id,double lowX,double lowZ,double highX,double highZ)
+{
+    Box box = {lowX,lowZ,highX,highZ};
+
+    for(std::vector<Entry>::iterator it = mPending.begin(); it != mPending.end(); ++it)
+    {
+        if((*it).mId == id && (*it).mBox.intersects(box))
+        {
+            (*it) = mPending.back();
+            mPending.pop_back();
+            return(true);
+        }
+    }
+
+    if(mNodes.empty())
+    {
+        return(false);
+    }
+
+    return(_remove(static_cast<uint32>(mNodes.size() - 1),id,box));
+}
+
+//======================================================================================================================
+
+inline bool StaticRTree::_remove(uint32 nodeIndex,int64 id,const Box& box)
+{
+    const Node& node = mNodes[nodeIndex];
+
+    if(!node.mBox.intersects(box))
+    {
+        return(false);
+    }
+
+    for(uint32 i = node.mFirst; i < node.mFirst + node.mCount; i++)
+    {
+        if(node.mLevel)
+        {
+            if(_remove(i,id,box))
+            {
+                return(true);
+            }
+        }
+        else if(!mEntries[i].mRemoved && mEntries[i].mId == id && mEntries[i].mBox.intersects(box))
+        {
+            mEntries[i].mRemoved = true;
+            mRemovedCount++;
+            return(true);
+        }
+    }
+
+    return(false);
+}
+
+//======================================================================================================================
+
+inline void StaticRTree::build()
+{
+    // whatever is still alive in the packed part goes in again
+    for(std::vector<Entry>::iterator it = mEntries.begin(); it != mEntries.end(); ++it)
+    {
+        if(!(*it).mRemoved)
+        {
+            mPending.push_back(*it);
+        }
+    }
+
+    mEntries.swap(mPending);
+    mPending.clear();
+    mNodes.clear();
+    mRemovedCount	= 0;
+    mHeight			= 0;
+
+    if(mEntries.empty())
+    {
+        return;
+    }
+
+    _tile(mEntries);
+
+    std::vector<Node> level;
+    _addParents(mEntries,0,0,level);
+    mHeight = 1;
+
+    // tile every level and let it point to its parents, until one node is left
+    while(level.size() > 1)
+    {
+        _tile(level);
+
+        uint32 first = static_cast<uint32>(mNodes.size());
+        mNodes.insert(mNodes.end(),level.begin(),level.end());
+
+        std::vector<Node> parents;
+        _addParents(level,first,mHeight,parents);
+        level.swap(parents);
+        mHeight++;
+    }
+
+    mNodes.push_back(level.front());
+}
+
+//======================================================================================================================
+
+inline void StaticRTree::clear()
+{
+    mEntries.clear();
+    mNodes.clear();
+    mPending.clear();
+    mRemovedCount	= 0;
+    mHeight			= 0;
+}
+
+//======================================================================================================================
+//
+// sort the items so every run of mNodeCapacity of them makes a node
+//
+
+template<typename T>
+void StaticRTree::_tile(std::vector<T>& items) const
+{
+    size_t nodeCount	= (items.size() + mNodeCapacity - 1) / mNodeCapacity;
+    size_t sliceCount	= static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nodeCount))));
+    size_t sliceSize	= sliceCount * mNodeCapacity;
+
+    std::sort(items.begin(),items.end(),CenterXLess());
+
+    for(size_t sliceStart = 0; sliceStart < items.size(); sliceStart += sliceSize)
+    {
+        size_t sliceEnd = std::min(sliceStart + sliceSize,items.size());
+
+        std::sort(items.begin() + sliceStart,items.begin() + sliceEnd,CenterZLess());
+    }
+}
+
+//======================================================================================================================
+
+template<typename T>
+void StaticRTree::_addParents(const std::vector<T>& children,uint32 firstChild,uint32 level,std::vector<Node>& parents) const
+{
+    for(size_t start = 0; start < children.size(); start += mNodeCapacity)
+    {
+        size_t	end = std::min(start + mNodeCapacity,children.size());
+        Node	node;
+
+        node.mBox	= children[start].mBox;
+        node.mFirst	= firstChild + static_cast<uint32>(start);
+        node.mCount	= static_cast<uint32>(end - start);
+        node.mLevel	= level;
+
+        for(size_t i = start + 1; i < end; i++)
+        {
+            node.mBox.include(children[i].mBox);
+        }
+
+        parents.push_back(node);
+    }
+}
+
+//======================================================================================================================
+
+inline void StaticRTree::intersects(double lowX,double lowZ,double highX,double highZ,IdList* results) const
+{
+    Box box = {lowX,lowZ,highX,highZ};
+
+    if(!mNodes.empty())
+    {
+        _intersects(static_cast<uint32>(mNodes.size() - 1),box,results);
+    }
+
+    for(std::vector<Entry>::const_iterator it = mPending.begin(); it != mPending.end(); ++it)
+    {
+        if((*it).mBox.intersects(box))
+        {
+            results->push_back((*it).mId);
+        }
+    }
+}
+
+//======================================================================================================================
+
+inline void StaticRTree::_intersects(uint32 nodeIndex,const Box& box,IdList* results) const
+{
+    const Node& node = mNodes[nodeIndex];
+
+    if(!node.mBox.intersects(box))
+    {
+        return;
+    }
+
+    uint32 end = node.mFirst + node.mCount;
+
+    if(node.mLevel)
+    {
+        for(uint32 i = node.mFirst; i < end; i++)
+        {
+            _intersects(i,box,results);
+        }
+
+        return;
+    }
+
+    for(uint32 i = node.mFirst; i < end; i++)
+    {
+        const Entry& entry = mEntries[i];
+
+        if(!entry.mRemoved && entry.mBox.intersects(box))
+        {
+            results->push_back(entry.mId);
+        }
+    }
+}
+
+//======================================================================================================================
+
+#endif
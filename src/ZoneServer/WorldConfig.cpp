@@ -134,6 +134,15 @@ void WorldConfig::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
     else if(mServerTimeSpeed > 5000)
         mServerTimeSpeed = 5000;
 
+    // Player Save Interval
+
+    mPlayerSaveInterval = gWorldConfig->getConfiguration<uint32>("Player_Save_Interval",(uint32)120);
+
+    if(mPlayerSaveInterval < 30)
+        mPlayerSaveInterval = 30;
+    else if(mPlayerSaveInterval > 3600)
+        mPlayerSaveInterval = 3600;
+
     // ham regen
     mHealthRegenDivider = static_cast<float>(gWorldConfig->getConfiguration<float>("Player_Health_RegenDivider",(float)100.0));
 
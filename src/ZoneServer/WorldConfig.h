@@ -117,6 +117,10 @@ public:
         return mServerTimeSpeed;
     }
 
+    uint32				getPlayerSaveInterval() {
+        return mPlayerSaveInterval;
+    }
+
     uint8				getPlayerMaxIncaps() {
         return mPlayerMaxIncaps;
     }
@@ -185,6 +189,9 @@ private:
     // Server Time Speed, add to the timecounter, adjusts how fast time goes by
     uint32				mServerTimeSpeed;
 
+    // Player Save Interval, the time in seconds it takes to periodically save every player once
+    uint32				mPlayerSaveInterval;
+
     // Server Weather Update Frequency, how often weather updates happen
     uint32				mWeatherUpdateInterval;
 
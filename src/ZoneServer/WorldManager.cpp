@@ -31,6 +31,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Buff.h"
 #include "BuffEvent.h"
 #include "BuffManager.h"
+#include "BuildingFactory.h"
 #include "BuildingObject.h"
 #include "CellObject.h"
 #include "CharacterLoginHandler.h"
@@ -60,7 +61,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Inventory.h"
 #include "MissionObject.h"
 #include "ObjectFactory.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "Shuttle.h"
 #include "ForageManager.h"
 #include "FireworkManager.h"
@@ -73,6 +74,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ScriptEngine/ScriptEngine.h"
 #include "ScriptEngine/ScriptSupport.h"
 #include "Utils/Scheduler.h"
+#include "Utils/TimingWheelScheduler.h"
 #include "Utils/VariableTimeScheduler.h"
 #include "Utils/utils.h"
 
@@ -92,6 +94,15 @@ WorldManager::WorldManager(uint32 zoneId,ZoneServer* zoneServer,Database* databa
     , mServerTime(0)
     , mTotalObjectCount(0)
     , mZoneId(zoneId)
+    , mPlayerSaveCursor(0)
+    , mPlayerSavesStarted(0)
+    , mPlayerSavesSkipped(0)
+    , mPlayerSavesInFlight(0)
+    , mPlayerSavesCompleted(0)
+    , mPlayerSaveLatencyTotal(0)
+    , mPlayerSaveLatencyMax(0)
+    , mSavePositionStatement(0)
+    , mSaveAttributesStatement(0)
 {
 #if !defined(_DEBUG)
 #endif
@@ -108,6 +119,16 @@ WorldManager::WorldManager(uint32 zoneId,ZoneServer* zoneServer,Database* databa
                         2,
                         gConfig->read<float>("Horizon"));
 
+    // buildings, statics and regions get packed once the world is loaded
+    mSpatialIndex->BeginBulkLoad();
+
+
+    // the player saves run for every player on every save round
+    mSavePositionStatement		= mDatabase->PrepareStatement("UPDATE characters SET parent_id=?,oX=?,oY=?,oZ=?,oW=?,x=?,y=?,z=?,planet_id=?,jedistate=? WHERE id=?");
+    mSaveAttributesStatement	= mDatabase->PrepareStatement("UPDATE character_attributes SET health_current=?,action_current=?,mind_current=?"
+                                  ",health_wounds=?,strength_wounds=?,constitution_wounds=?,action_wounds=?,quickness_wounds=?"
+                                  ",stamina_wounds=?,mind_wounds=?,focus_wounds=?,willpower_wounds=?,battlefatigue=?,posture=?,moodId=?,title=?"
+                                  ",character_flags=?,states=?,language=?,new_player_exemptions=? WHERE character_id=?");
 
     // load planet names and terrain files so we can start heightmap loading
     mDatabase->ExecuteSqlAsync(this,new(mWM_DB_AsyncPool.ordered_malloc()) WMAsyncContainer(WMQuery_PlanetNamesAndFiles),"SELECT * FROM planet ORDER BY planet_id;");
@@ -115,9 +136,9 @@ WorldManager::WorldManager(uint32 zoneId,ZoneServer* zoneServer,Database* databa
 
     // create schedulers
     mSubsystemScheduler		= new Anh_Utils::Scheduler();
-    mObjControllerScheduler = new Anh_Utils::Scheduler();
-    mHamRegenScheduler		= new Anh_Utils::Scheduler();
-    mStomachFillingScheduler= new Anh_Utils::Scheduler();
+    mObjControllerScheduler = new Anh_Utils::TimingWheelScheduler();
+    mHamRegenScheduler		= new Anh_Utils::TimingWheelScheduler();
+    mStomachFillingScheduler= new Anh_Utils::TimingWheelScheduler();
     mPlayerScheduler		= new Anh_Utils::Scheduler();
     mEntertainerScheduler	= new Anh_Utils::Scheduler();
     //mImagedesignerScheduler	= new Anh_Utils::Scheduler();
@@ -310,8 +331,7 @@ WorldManager::~WorldManager()
 
 void WorldManager::_loadBuildings()
 {
-    WMAsyncContainer* asynContainer = new(mWM_DB_AsyncPool.ordered_malloc()) WMAsyncContainer(WMQuery_All_Buildings);
-    mDatabase->ExecuteSqlAsync(this,asynContainer,"SELECT id FROM buildings WHERE planet_id = %u;",mZoneId);
+    gBuildingFactory->requestPlanetBuildings(this,mZoneId,NULL);
 }
 
 
@@ -394,6 +414,12 @@ void WorldManager::LoadCurrentGlobalTick()
 bool	WorldManager::_handleTick(uint64 callTime,void* ref)
 {
     mTick += 1000;
+
+    if (!(mTick % 60000))
+    {
+        _logNpcHandlerStats();
+    }
+
     return true;
 }
 
@@ -612,6 +638,7 @@ bool WorldManager::_handleServerTimeUpdate(uint64 callTime,void* ref)
 bool WorldManager::_handleCraftToolTimers(uint64 callTime,void* ref)
 {
     CraftTools::iterator it = mBusyCraftTools.begin();
+    int8 condition[64];
 
     while(it != mBusyCraftTools.end())
     {
@@ -653,10 +680,12 @@ bool WorldManager::_handleCraftToolTimers(uint64 callTime,void* ref)
 
                 it = mBusyCraftTools.erase(it);
                 tool->setAttribute("craft_tool_status","@crafting:tool_status_ready");
-                mDatabase->ExecuteSqlAsync(0,0,"UPDATE item_attributes SET value='@crafting:tool_status_ready' WHERE item_id=%"PRIu64" AND attribute_id=18",tool->getId());
+                sprintf(condition,"item_id=%"PRIu64" AND attribute_id=%u",tool->getId(),AttrType_CraftToolStatus);
+                mDatabase->ExecuteUpdateDeferred(player->getId(),"item_attributes","value",condition,"'@crafting:tool_status_ready'");
 
                 tool->setAttribute("craft_tool_time",boost::lexical_cast<std::string>(tool->getTimer()));
-                gWorldManager->getDatabase()->ExecuteSqlAsync(0,0,"UPDATE item_attributes SET value='%i' WHERE item_id=%"PRIu64" AND attribute_id=%u",tool->getId(),tool->getTimer(),AttrType_CraftToolTime);
+                sprintf(condition,"item_id=%"PRIu64" AND attribute_id=%u",tool->getId(),AttrType_CraftToolTime);
+                mDatabase->ExecuteUpdateDeferred(player->getId(),"item_attributes","value",condition,"'%i'",tool->getTimer());
            
 
                 continue;
@@ -666,7 +695,9 @@ bool WorldManager::_handleCraftToolTimers(uint64 callTime,void* ref)
 
             tool->setAttribute("craft_tool_time",boost::lexical_cast<std::string>(tool->getTimer()));
             //gLogger->log(LogManager::DEBUG,"timer : %i",tool->getTimer());
-            gWorldManager->getDatabase()->ExecuteSqlAsync(0,0,"UPDATE item_attributes SET value='%i' WHERE item_id=%"PRIu64" AND attribute_id=%u",tool->getId(),tool->getTimer(),AttrType_CraftToolTime);
+            // ticks every second, the write behind buffer only writes the last value of a window
+            sprintf(condition,"item_id=%"PRIu64" AND attribute_id=%u",tool->getId(),AttrType_CraftToolTime);
+            mDatabase->ExecuteUpdateDeferred(player->getId(),"item_attributes","value",condition,"'%i'",tool->getTimer());
             
         }
 
@@ -872,7 +903,7 @@ void WorldManager::_handleLoadComplete()
     gSchematicManager->releaseAllPoolsMemory();
     gSkillManager->releaseAllPoolsMemory();
 
-
+    mSpatialIndex->EndBulkLoad();
 
     // register script hooks
     _startWorldScripts();
@@ -904,8 +935,8 @@ void WorldManager::_handleLoadComplete()
     //whenever someone creates something near us were updated on it anyway ... ?
     mSubsystemScheduler->addTask(fastdelegate::MakeDelegate(this,&WorldManager::_handlePlayerMovementUpdateTimers),4,5000,NULL);
 
-    //save player
-    setSaveTaskId(mSubsystemScheduler->addTask(fastdelegate::MakeDelegate(this,&WorldManager::_handlePlayerSaveTimers), 4, 120000, NULL));
+    //save player, a slice of the players every second
+    setSaveTaskId(mSubsystemScheduler->addTask(fastdelegate::MakeDelegate(this,&WorldManager::_handlePlayerSaveTimers), 4, 1000, NULL));
 
     mSubsystemScheduler->addTask(fastdelegate::MakeDelegate(this,&WorldManager::_handleGeneralObjectTimers),5,2000,NULL);
     mSubsystemScheduler->addTask(fastdelegate::MakeDelegate(this,&WorldManager::_handleGroupObjectTimers),5,gWorldConfig->getGroupMissionUpdateTime(),NULL);
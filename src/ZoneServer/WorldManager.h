@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ANH_ZONESERVER_WORLDMANAGER_H
 #define ANH_ZONESERVER_WORLDMANAGER_H
 
+#include "NpcHandlerQueue.h"
 #include "ObjectFactoryCallback.h"
 #include "QTRegion.h"
 #include "Weather.h"
@@ -78,6 +79,7 @@ namespace Anh_Utils
 {
 class Clock;
 class Scheduler;
+class TimingWheelScheduler;
 class VariableTimeScheduler;
 }
 
@@ -108,13 +110,8 @@ typedef std::vector<uint64>						CraftTools;
 // Creature spawn regions.
 typedef std::map<uint64, const CreatureSpawnRegion*>	CreatureSpawnRegionMap;
 
-// Containers with handlers to Npc-objects handled by the NpcManager (or what we are going to call it its final version).
-// The active container will be the most often checked, and the Dormant the less checked container.
-
-// And yes. Handlers... handlers... no object refs that will be invalid all the time.
-typedef std::map<uint64, uint64>				NpcDormantHandlers;
-typedef std::map<uint64, uint64>				NpcReadyHandlers;
-typedef std::map<uint64, uint64>				NpcActiveHandlers;
+// Npc-objects handled by the NpcManager are kept in due time ordered NpcHandlerQueues.
+// The active queue will be the most often checked, and the Dormant the less checked queue.
 typedef std::map<uint64, uint64>				AdminRequestHandlers;
 
 // AttributeKey map
@@ -138,6 +135,9 @@ public:
         mObject = NULL;
         mClient = NULL;
         mBool = false;
+        mStartTime = 0;
+        mSaveChecksum = 0;
+        mSaveFailed = false;
     }
 
     WMLogOut					mLogout;
@@ -146,6 +146,9 @@ public:
     DispatchClient*				mClient;
     bool						mBool;
     CharacterLoadingContainer*	clContainer;
+    uint64						mStartTime;
+    uint32						mSaveChecksum;
+    bool						mSaveFailed;
 };
 
 //======================================================================================================================
@@ -264,6 +267,9 @@ public:
     // saves a player synched to the database
     void					savePlayerSync(uint32 accId,bool remove);
 
+    // first step of an async save, the characters row, callback gets ref when its done
+    void					savePlayerPosition(PlayerObject* playerObject, DatabaseCallback* callback, void* ref);
+
     // checks if the player save timer is up
     bool					checkSavePlayer(PlayerObject* playerObject);
 
@@ -312,15 +318,15 @@ public:
     bool					objectsInRange(const glm::vec3& obj1Position, uint64 obj1ParentId, uint64 obj2Id, float range);
 
     // Add-remove npc from Npc-handler queue's.
-    void					addDormantNpc(uint64 creature, uint64 when);
+    void					addDormantNpc(NPCObject* creature, uint64 when);
     void					removeDormantNpc(uint64 creature);
     void					forceHandlingOfDormantNpc(uint64 creature);
 
-    void					addReadyNpc(uint64 creature, uint64 when);
+    void					addReadyNpc(NPCObject* creature, uint64 when);
     void					removeReadyNpc(uint64 creature);
     void					forceHandlingOfReadyNpc(uint64 creature);
 
-    void					addActiveNpc(uint64 creature, uint64 when);
+    void					addActiveNpc(NPCObject* creature, uint64 when);
     void					removeActiveNpc(uint64 creature);
 
     void					addAdminRequest(uint64 requestId, uint64 when);
@@ -481,6 +487,9 @@ private:
 
     //		Save players, who haven't saved in x minutes
     bool	_handlePlayerSaveTimers(uint64 callTime, void* ref);
+    uint32	_getPlayerSaveChecksum(PlayerObject* playerObject);
+    void	_playerSaveComplete(WMAsyncContainer* asyncContainer, bool saved);
+    void	_savePlayerAttributes(PlayerObject* playerObject, WMAsyncContainer* asyncContainer);
 
     bool	_handlePlayerMovementUpdateTimers(uint64 callTime, void* ref);
 
@@ -490,6 +499,8 @@ private:
     bool	_handleDormantNpcs(uint64 callTime, void* ref);
     bool	_handleReadyNpcs(uint64 callTime, void* ref);
     bool	_handleActiveNpcs(uint64 callTime, void* ref);
+    void	_handleNpcQueue(NpcHandlerQueue& queue, uint64 callTime);
+    void	_logNpcHandlerStats();
 
     bool	_handleAdminRequests(uint64 callTime, void* ref);
 
@@ -515,9 +526,9 @@ private:
     AdminRequestHandlers		mAdminRequestHandlers;
     CreatureObjectDeletionMap	mCreatureObjectDeletionMap;
     CreatureSpawnRegionMap		mCreatureSpawnRegionMap;
-    NpcActiveHandlers			mNpcActiveHandlers;
-    NpcDormantHandlers			mNpcDormantHandlers;
-    NpcReadyHandlers			mNpcReadyHandlers;
+    NpcHandlerQueue				mNpcActiveHandlers;
+    NpcHandlerQueue				mNpcDormantHandlers;
+    NpcHandlerQueue				mNpcReadyHandlers;
     ObjectIDList			    mStructureList;
     ObjectMap					mObjectMap;
     PlayerAccMap				mPlayerAccMap;
@@ -548,11 +559,11 @@ private:
     Database*								mDatabase;
     Anh_Utils::Scheduler*		mEntertainerScheduler;
     Anh_Utils::Scheduler*		mScoutScheduler;
-    Anh_Utils::Scheduler*		mHamRegenScheduler;
-    Anh_Utils::Scheduler*		mStomachFillingScheduler;
+    Anh_Utils::TimingWheelScheduler*	mHamRegenScheduler;
+    Anh_Utils::TimingWheelScheduler*	mStomachFillingScheduler;
     Anh_Utils::Scheduler*		mMissionScheduler;
     Anh_Utils::Scheduler*		mNpcManagerScheduler;
-    Anh_Utils::Scheduler*		mObjControllerScheduler;
+    Anh_Utils::TimingWheelScheduler*	mObjControllerScheduler;
     Anh_Utils::Scheduler*		mPlayerScheduler;
     ZoneTree*								mSpatialIndex;
     Anh_Utils::Scheduler*		mSubsystemScheduler;
@@ -567,6 +578,19 @@ private:
 
     uint64						mSaveTaskId;
 
+    // periodic saves walk the players in slices, mPlayerSaveCursor is the last account saved
+    uint32						mPlayerSaveCursor;
+    uint32						mPlayerSavesStarted;
+    uint32						mPlayerSavesSkipped;
+    uint32						mPlayerSavesInFlight;
+    uint32						mPlayerSavesCompleted;
+    uint64						mPlayerSaveLatencyTotal;
+    uint64						mPlayerSaveLatencyMax;
+
+    // prepared statements of the player saves
+    uint32						mSavePositionStatement;
+    uint32						mSaveAttributesStatement;
+
 };
 
 
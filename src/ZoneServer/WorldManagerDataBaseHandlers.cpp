@@ -474,31 +474,6 @@ void WorldManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
         }
         break;
 
-        // buildings
-        case WMQuery_All_Buildings:
-        {
-
-            uint64			buildingCount;
-            uint64			buildingId;
-            DataBinding*	buildingBinding = mDatabase->CreateDataBinding(1);
-            buildingBinding->addField(DFT_int64,0,8);
-
-            buildingCount = result->getRowCount();
-
-            for(uint64 i = 0; i < buildingCount; i++)
-            {
-                result->GetNextRow(buildingBinding,&buildingId);
-
-                gObjectFactory->requestObject(ObjType_Building,0,0,this,buildingId,asyncContainer->mClient);
-            }
-
-            if(result->getRowCount())
-                gLogger->log(LogManager::NOTICE,"Loaded buildings");
-
-            mDatabase->DestroyDataBinding(buildingBinding);
-        }
-        break;
-
         // city regions
         case WMQuery_Cities:
         {
@@ -664,14 +639,12 @@ void WorldManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
             //saving ourselves async might see us deleted before finish
             if(!playerObject)
             {
-                PlayerObject* playerObject			= dynamic_cast<PlayerObject*>(asyncContainer->mObject);
+                _playerSaveComplete(asyncContainer, false);
                 break;
             }
 
             WMAsyncContainer* asyncContainer2	= new(mWM_DB_AsyncPool.ordered_malloc()) WMAsyncContainer(WMQuery_SavePlayer_Attributes);
 
-            Ham* ham							= playerObject->getHam();
-
             if(asyncContainer->mBool)
             {
                 asyncContainer2->mBool = true;
@@ -680,24 +653,18 @@ void WorldManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
             asyncContainer2->mObject		= asyncContainer->mObject;
             asyncContainer2->clContainer	= asyncContainer->clContainer;
             asyncContainer2->mLogout		= asyncContainer->mLogout;
+            asyncContainer2->mStartTime		= asyncContainer->mStartTime;
+            asyncContainer2->mSaveChecksum	= asyncContainer->mSaveChecksum;
+            asyncContainer2->mSaveFailed	= asyncContainer->mSaveFailed || !result || result->hasError();
 
-            mDatabase->ExecuteSqlAsync(this,asyncContainer2,"UPDATE character_attributes SET health_current=%u,action_current=%u,mind_current=%u"
-                                       ",health_wounds=%u,strength_wounds=%u,constitution_wounds=%u,action_wounds=%u,quickness_wounds=%u"
-                                       ",stamina_wounds=%u,mind_wounds=%u,focus_wounds=%u,willpower_wounds=%u,battlefatigue=%u,posture=%u,moodId=%u,title=\'%s\'"
-                                       ",character_flags=%u,states=%"PRIu64",language=%u,new_player_exemptions=%u WHERE character_id=%"PRIu64""
-                                       ,ham->mHealth.getCurrentHitPoints() - ham->mHealth.getModifier(),
-                                       ham->mAction.getCurrentHitPoints() - ham->mAction.getModifier(),
-                                       ham->mMind.getCurrentHitPoints() - ham->mMind.getModifier()
-                                       ,ham->mHealth.getWounds(),ham->mStrength.getWounds()
-                                       ,ham->mConstitution.getWounds(),ham->mAction.getWounds(),ham->mQuickness.getWounds(),ham->mStamina.getWounds(),ham->mMind.getWounds()
-                                       ,ham->mFocus.getWounds(),ham->mWillpower.getWounds(),ham->getBattleFatigue(),playerObject->getPosture(),playerObject->getMoodId(),playerObject->getTitle().getAnsi()
-                                       ,playerObject->getPlayerFlags(),playerObject->getState(),playerObject->getLanguage(),playerObject->getNewPlayerExemptions(),playerObject->getId());
-            
+            _savePlayerAttributes(playerObject,asyncContainer2);
         }
         break;
 
         case WMQuery_SavePlayer_Attributes:
         {
+            _playerSaveComplete(asyncContainer, !asyncContainer->mSaveFailed && result && !result->hasError());
+
             if(asyncContainer->mBool)
             {
                 PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
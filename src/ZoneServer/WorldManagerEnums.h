@@ -46,7 +46,6 @@ enum WMLogOut
 enum WMQuery
 {
     WMQuery_ObjectCount				= 0,
-    WMQuery_All_Buildings			= 1,
     WMQuery_Cells					= 2,
     WMQuery_Terminals				= 3,
     WMQuery_Furniture				= 4,
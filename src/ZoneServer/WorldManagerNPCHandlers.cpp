@@ -43,12 +43,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 //	Add a npc to the Dormant queue.
 //
 
-void WorldManager::addDormantNpc(uint64 creature, uint64 when)
+void WorldManager::addDormantNpc(NPCObject* creature, uint64 when)
 {
-    // gLogger->log(LogManager::DEBUG,"Adding dormant NPC handler... %"PRIu64"",  creature);
+    // gLogger->log(LogManager::DEBUG,"Adding dormant NPC handler... %"PRIu64"",  creature->getId());
 
     uint64 expireTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
-    mNpcDormantHandlers.insert(std::make_pair(creature, expireTime + when));
+    mNpcDormantHandlers.add(creature, expireTime + when);
 }
 
 //======================================================================================================================
@@ -58,12 +58,7 @@ void WorldManager::addDormantNpc(uint64 creature, uint64 when)
 
 void WorldManager::removeDormantNpc(uint64 creature)
 {
-    NpcDormantHandlers::iterator it = mNpcDormantHandlers.find(creature);
-    if (it != mNpcDormantHandlers.end())
-    {
-        // Remove creature.
-        mNpcDormantHandlers.erase(it);
-    }
+    mNpcDormantHandlers.remove(creature);
 }
 
 //======================================================================================================================
@@ -73,14 +68,11 @@ void WorldManager::removeDormantNpc(uint64 creature)
 
 void WorldManager::forceHandlingOfDormantNpc(uint64 creature)
 {
-    NpcDormantHandlers::iterator it = mNpcDormantHandlers.find(creature);
-    if (it != mNpcDormantHandlers.end())
-    {
-        // Change the event time to NOW.
-        uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
-        (*it).second = now;
-    }
+    // Change the event time to NOW.
+    uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
+    mNpcDormantHandlers.setDueTime(creature, now);
 }
+
 //======================================================================================================================
 //
 // Handle the queue of Dormant npc's.
@@ -88,45 +80,7 @@ void WorldManager::forceHandlingOfDormantNpc(uint64 creature)
 
 bool WorldManager::_handleDormantNpcs(uint64 callTime, void* ref)
 {
-    NpcDormantHandlers::iterator it = mNpcDormantHandlers.begin();
-    while (it != mNpcDormantHandlers.end())
-    {
-        //  The timer has expired?
-        if (callTime >= ((*it).second))
-        {
-            // Yes, handle it.
-            NPCObject* npc = dynamic_cast<NPCObject*>(this->getObjectById((*it).first));
-            if (npc)
-            {
-                // uint64 waitTime = NpcManager::Instance()->handleDormantNpc(creature, callTime - (*it).second);
-                // gLogger->log(LogManager::DEBUG,"Dormant... ID = %"PRIu64"",  (*it).first);
-                uint64 waitTime = NpcManager::Instance()->handleNpc(npc, callTime - (*it).second);
-
-                if (waitTime)
-                {
-                    // Set next execution time.
-                    (*it).second = callTime + waitTime;
-                }
-                else
-                {
-                    // gLogger->log(LogManager::DEBUG,"Removed dormant NPC handler... %"PRIu64"",  (*it).first);
-
-                    // Requested to remove the handler.
-                    mNpcDormantHandlers.erase(it++);
-                }
-            }
-            else
-            {
-                // Remove the expired object...
-                mNpcDormantHandlers.erase(it++);
-                gLogger->log(LogManager::DEBUG,"Removed expired dormant NPC handler...");
-            }
-        }
-        else
-        {
-            ++it;
-        }
-    }
+    _handleNpcQueue(mNpcDormantHandlers, callTime);
     return true;
 }
 
@@ -135,11 +89,11 @@ bool WorldManager::_handleDormantNpcs(uint64 callTime, void* ref)
 //	Add a npc to the Ready queue.
 //
 
-void WorldManager::addReadyNpc(uint64 creature, uint64 when)
+void WorldManager::addReadyNpc(NPCObject* creature, uint64 when)
 {
     uint64 expireTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
 
-    mNpcReadyHandlers.insert(std::make_pair(creature, expireTime + when));
+    mNpcReadyHandlers.add(creature, expireTime + when);
 }
 
 //======================================================================================================================
@@ -149,12 +103,7 @@ void WorldManager::addReadyNpc(uint64 creature, uint64 when)
 
 void WorldManager::removeReadyNpc(uint64 creature)
 {
-    NpcReadyHandlers::iterator it = mNpcReadyHandlers.find(creature);
-    if (it != mNpcReadyHandlers.end())
-    {
-        // Remove creature.
-        mNpcReadyHandlers.erase(it);
-    }
+    mNpcReadyHandlers.remove(creature);
 }
 
 //======================================================================================================================
@@ -164,13 +113,9 @@ void WorldManager::removeReadyNpc(uint64 creature)
 
 void WorldManager::forceHandlingOfReadyNpc(uint64 creature)
 {
-    NpcReadyHandlers::iterator it = mNpcReadyHandlers.find(creature);
-    if (it != mNpcReadyHandlers.end())
-    {
-        // Change the event time to NOW.
-        uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
-        (*it).second = now;
-    }
+    // Change the event time to NOW.
+    uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
+    mNpcReadyHandlers.setDueTime(creature, now);
 }
 
 //======================================================================================================================
@@ -180,44 +125,7 @@ void WorldManager::forceHandlingOfReadyNpc(uint64 creature)
 
 bool WorldManager::_handleReadyNpcs(uint64 callTime, void* ref)
 {
-    NpcReadyHandlers::iterator it = mNpcReadyHandlers.begin();
-    while (it != mNpcReadyHandlers.end())
-    {
-        //  The timer has expired?
-        if (callTime >= ((*it).second))
-        {
-            // Yes, handle it.
-            NPCObject* npc = dynamic_cast<NPCObject*>(this->getObjectById((*it).first));
-            if (npc)
-            {
-                // uint64 waitTime = NpcManager::Instance()->handleReadyNpc(creature, callTime - (*it).second);
-                // gLogger->log(LogManager::DEBUG,"Ready...");
-                // gLogger->log(LogManager::DEBUG,"Ready... ID = %"PRIu64"",  (*it).first);
-                uint64 waitTime = NpcManager::Instance()->handleNpc(npc, callTime - (*it).second);
-                if (waitTime)
-                {
-                    // Set next execution time.
-                    (*it).second = callTime + waitTime;
-                }
-                else
-                {
-                    // Requested to remove the handler.
-                    mNpcReadyHandlers.erase(it++);
-                    // gLogger->log(LogManager::DEBUG,"Removed ready NPC handler...");
-                }
-            }
-            else
-            {
-                // Remove the expired object...
-                mNpcReadyHandlers.erase(it++);
-                // gLogger->log(LogManager::DEBUG,"Removed ready NPC handler...");
-            }
-        }
-        else
-        {
-            ++it;
-        }
-    }
+    _handleNpcQueue(mNpcReadyHandlers, callTime);
     return true;
 }
 
@@ -226,11 +134,11 @@ bool WorldManager::_handleReadyNpcs(uint64 callTime, void* ref)
 //	Add a npc to the Active queue.
 //
 
-void WorldManager::addActiveNpc(uint64 creature, uint64 when)
+void WorldManager::addActiveNpc(NPCObject* creature, uint64 when)
 {
     uint64 expireTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
 
-    mNpcActiveHandlers.insert(std::make_pair(creature, expireTime + when));
+    mNpcActiveHandlers.add(creature, expireTime + when);
 }
 
 //======================================================================================================================
@@ -240,12 +148,7 @@ void WorldManager::addActiveNpc(uint64 creature, uint64 when)
 
 void WorldManager::removeActiveNpc(uint64 creature)
 {
-    NpcActiveHandlers::iterator it = mNpcActiveHandlers.find(creature);
-    if (it != mNpcActiveHandlers.end())
-    {
-        // Remove creature.
-        mNpcActiveHandlers.erase(it);
-    }
+    mNpcActiveHandlers.remove(creature);
 }
 
 //======================================================================================================================
@@ -254,45 +157,59 @@ void WorldManager::removeActiveNpc(uint64 creature)
 //
 bool WorldManager::_handleActiveNpcs(uint64 callTime, void* ref)
 {
-    NpcActiveHandlers::iterator it = mNpcActiveHandlers.begin();
-    while (it != mNpcActiveHandlers.end())
+    _handleNpcQueue(mNpcActiveHandlers, callTime);
+    return true;
+}
+
+//======================================================================================================================
+//
+// Handle the npcs of a queue whose timer has expired, the queue hands them out in the order they got due.
+//
+
+void WorldManager::_handleNpcQueue(NpcHandlerQueue& queue, uint64 callTime)
+{
+    uint32 queued = queue.size();
+    uint32 handled = 0;
+    uint64 dueTime;
+
+    while (NPCObject* npc = queue.getDue(callTime, dueTime))
     {
-        //  The timer has expired?
-        if (callTime >= ((*it).second))
+        uint64 npcId = npc->getId();
+        uint64 waitTime = NpcManager::Instance()->handleNpc(npc, callTime - dueTime);
+
+        handled++;
+
+        // Handling the npc may have taken it out of the queue already, it may even be gone.
+        if (!queue.contains(npcId))
         {
-            // Yes, handle it.
-            NPCObject* npc = dynamic_cast<NPCObject*>(this->getObjectById((*it).first));
-            if (npc)
-            {
-                // uint64 waitTime = NpcManager::Instance()->handleActiveNpc(creature, callTime - (*it).second);
-                // gLogger->log(LogManager::DEBUG,"Active...");
-                // gLogger->log(LogManager::DEBUG,"Active... ID = %"PRIu64"",  (*it).first);
-                uint64 waitTime = NpcManager::Instance()->handleNpc(npc, callTime - (*it).second);
-                if (waitTime)
-                {
-                    // Set next execution time.
-                    (*it).second = callTime + waitTime;
-                }
-                else
-                {
-                    // Requested to remove the handler.
-                    mNpcActiveHandlers.erase(it++);
-                    // gLogger->log(LogManager::DEBUG,"Removed active NPC handler...");
-                }
-            }
-            else
-            {
-                // Remove the expired object...
-                mNpcActiveHandlers.erase(it++);
-                // gLogger->log(LogManager::DEBUG,"Removed active NPC handler...");
-            }
+            continue;
+        }
+
+        if (waitTime)
+        {
+            // Set next execution time.
+            queue.setDueTime(npcId, callTime + waitTime);
         }
         else
         {
-            ++it;
+            // Requested to remove the handler.
+            queue.remove(npcId);
         }
     }
-    return true;
+
+    queue.setTickStats(queued, handled);
+}
+
+//======================================================================================================================
+//
+// A full scan of the queues would have looked at every queued npc per tick, the queues only at the handled ones.
+//
+
+void WorldManager::_logNpcHandlerStats()
+{
+    gLogger->log(LogManager::DEBUG,"NPC handlers dormant: %u queued, %u handled (%"PRIu64" queued, %"PRIu64" handled total)",mNpcDormantHandlers.getQueued(),mNpcDormantHandlers.getHandled(),mNpcDormantHandlers.getTotalQueued(),mNpcDormantHandlers.getTotalHandled());
+    gLogger->log(LogManager::DEBUG,"NPC handlers ready: %u queued, %u handled (%"PRIu64" queued, %"PRIu64" handled total)",mNpcReadyHandlers.getQueued(),mNpcReadyHandlers.getHandled(),mNpcReadyHandlers.getTotalQueued(),mNpcReadyHandlers.getTotalHandled());
+    gLogger->log(LogManager::DEBUG,"NPC handlers active: %u queued, %u handled (%"PRIu64" queued, %"PRIu64" handled total)",mNpcActiveHandlers.getQueued(),mNpcActiveHandlers.getHandled(),mNpcActiveHandlers.getTotalQueued(),mNpcActiveHandlers.getTotalHandled());
 }
 
 //======================================================================================================================
@@ -64,7 +64,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Inventory.h"
 #include "MissionObject.h"
 #include "ObjectFactory.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "Shuttle.h"
 #include "TicketCollector.h"
 #include "Common/ConfigManager.h"
@@ -1105,28 +1105,22 @@ Object* WorldManager::getNearestTerminal(PlayerObject* player, TangibleType term
         else if(BuildingObject* building = dynamic_cast<BuildingObject*> (*it))
         {
             //iterate through the structure and look for terminals
-            ObjectList list = building->getAllCellChilds();
-            ObjectList::iterator cellChildsIt = list.begin();
+            ObjectSet cellChilds;
+            building->getCellContent(ObjType_Tangible,&cellChilds);
 
-            while(cellChildsIt != list.end())
-            {
-                Object* cellChild = (*cellChildsIt);
-
-                uint32 tmpType = cellChild->getType();
+            ObjectSet::iterator cellChildsIt = cellChilds.begin();
 
-                if((tmpType & ObjType_Tangible) == static_cast<uint32>(ObjType_Tangible))
+            while(cellChildsIt != cellChilds.end())
+            {
+                Terminal* terminal = dynamic_cast<Terminal*> (*cellChildsIt);
+                if(terminal&&(terminal->getTangibleType() == terminalType))
                 {
-
-                    Terminal* terminal = dynamic_cast<Terminal*> (cellChild);
-                    if(terminal&&(terminal->getTangibleType() == terminalType))
+                    float nr = glm::distance(terminal->mPosition, player->mPosition);
+                    //double check the distance
+                    if((nearestTerminal && (nr < range))||(!nearestTerminal))
                     {
-                        float nr = glm::distance(terminal->mPosition, player->mPosition);
-                        //double check the distance
-                        if((nearestTerminal && (nr < range))||(!nearestTerminal))
-                        {
-                            range = nr;
-                            nearestTerminal = terminal;
-                        }
+                        range = nr;
+                        nearestTerminal = terminal;
                     }
                 }
 
@@ -63,18 +63,20 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Inventory.h"
 #include "MissionObject.h"
 #include "ObjectFactory.h"
-#include "QuadTree.h"
+#include "SpatialGrid.h"
 #include "Shuttle.h"
 #include "TicketCollector.h"
 #include "Common/ConfigManager.h"
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DataBinding.h"
 #include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/PreparedStatement.h"
 #include "MessageLib/MessageLib.h"
 #include "ScriptEngine/ScriptEngine.h"
 #include "ScriptEngine/ScriptSupport.h"
 #include "Utils/Scheduler.h"
 #include "Utils/VariableTimeScheduler.h"
+#include "Utils/clock.h"
 #include "Utils/utils.h"
 
 //======================================================================================================================
@@ -157,16 +159,23 @@ void WorldManager::savePlayer(uint32 accId,bool remove, WMLogOut mLogout, Charac
     asyncContainer->mObject			= playerObject;
     asyncContainer->mLogout			=   mLogout;
     asyncContainer->clContainer		=	clContainer;
+    asyncContainer->mStartTime		=	gClock->getLocalTime();
+    asyncContainer->mSaveChecksum	=	_getPlayerSaveChecksum(playerObject);
+
+    mPlayerSavesInFlight++;
+
+    // the character gets read again once this save is done, by the next zone or the next load
+    // its item updates still waiting in the write behind buffer need to be in by then
+    if(mLogout != WMLogOut_No_LogOut)
+    {
+        mDatabase->FlushDeferredUpdates(playerObject->getId());
+    }
 
     switch (mLogout)
     {
     case WMLogOut_LogOut:
     case WMLogOut_Char_Load:
-        mDatabase->ExecuteSqlAsync(this,asyncContainer,"UPDATE characters SET parent_id=%"PRIu64",oX=%f,oY=%f,oZ=%f,oW=%f,x=%f,y=%f,z=%f,planet_id=%u,jedistate=%u WHERE id=%"PRIu64"",playerObject->getParentId()
-                                   ,playerObject->mDirection.x,playerObject->mDirection.y,playerObject->mDirection.z,playerObject->mDirection.w
-                                   ,playerObject->mPosition.x,playerObject->mPosition.y,playerObject->mPosition.z
-                                   ,mZoneId,playerObject->getJediState(),playerObject->getId());
-       
+        savePlayerPosition(playerObject,this,asyncContainer);
         break;
 
     case WMLogOut_No_LogOut:
@@ -179,17 +188,106 @@ void WorldManager::savePlayer(uint32 accId,bool remove, WMLogOut mLogout, Charac
             if(!gBuffManager->SaveBuffsAsync(asyncContainer, this, playerObject, GetCurrentGlobalTick()))
             {
                 // position save will be called by the buff callback if there is any buff
-                mDatabase->ExecuteSqlAsync(this,asyncContainer,"UPDATE characters SET parent_id=%"PRIu64",oX=%f,oY=%f,oZ=%f,oW=%f,x=%f,y=%f,z=%f,planet_id=%u,jedistate=%u WHERE id=%"PRIu64"",playerObject->getParentId()
-                                           ,playerObject->mDirection.x,playerObject->mDirection.y,playerObject->mDirection.z,playerObject->mDirection.w
-                                           ,playerObject->mPosition.x,playerObject->mPosition.y,playerObject->mPosition.z
-                                           ,mZoneId,playerObject->getJediState(),playerObject->getId());
-              
+                savePlayerPosition(playerObject,this,asyncContainer);
 
             }
         }
+        else
+        {
+            _playerSaveComplete(asyncContainer, false);
+            mWM_DB_AsyncPool.ordered_free(asyncContainer);
+        }
         break;
     default:
         gLogger->log(LogManager::DEBUG,"We should never get in here, make sure to call savePlayer with the enum WMLogOut");
+        _playerSaveComplete(asyncContainer, false);
+        mWM_DB_AsyncPool.ordered_free(asyncContainer);
+    }
+}
+
+//======================================================================================================================
+
+void WorldManager::savePlayerPosition(PlayerObject* playerObject, DatabaseCallback* callback, void* ref)
+{
+    StatementParameters parameters;
+
+    parameters.addUint64(playerObject->getParentId());
+    parameters.addFloat(playerObject->mDirection.x);
+    parameters.addFloat(playerObject->mDirection.y);
+    parameters.addFloat(playerObject->mDirection.z);
+    parameters.addFloat(playerObject->mDirection.w);
+    parameters.addFloat(playerObject->mPosition.x);
+    parameters.addFloat(playerObject->mPosition.y);
+    parameters.addFloat(playerObject->mPosition.z);
+    parameters.addUint32(mZoneId);
+    parameters.addUint32(playerObject->getJediState());
+    parameters.addUint64(playerObject->getId());
+
+    mDatabase->ExecuteStatementAsync(callback,ref,mSavePositionStatement,parameters);
+}
+
+//======================================================================================================================
+
+void WorldManager::_savePlayerAttributes(PlayerObject* playerObject, WMAsyncContainer* asyncContainer)
+{
+    Ham*				ham = playerObject->getHam();
+    StatementParameters	parameters;
+
+    parameters.addInt32(ham->mHealth.getCurrentHitPoints() - ham->mHealth.getModifier());
+    parameters.addInt32(ham->mAction.getCurrentHitPoints() - ham->mAction.getModifier());
+    parameters.addInt32(ham->mMind.getCurrentHitPoints() - ham->mMind.getModifier());
+    parameters.addInt32(ham->mHealth.getWounds());
+    parameters.addInt32(ham->mStrength.getWounds());
+    parameters.addInt32(ham->mConstitution.getWounds());
+    parameters.addInt32(ham->mAction.getWounds());
+    parameters.addInt32(ham->mQuickness.getWounds());
+    parameters.addInt32(ham->mStamina.getWounds());
+    parameters.addInt32(ham->mMind.getWounds());
+    parameters.addInt32(ham->mFocus.getWounds());
+    parameters.addInt32(ham->mWillpower.getWounds());
+    parameters.addInt32(ham->getBattleFatigue());
+    parameters.addUint32(playerObject->getPosture());
+    parameters.addUint8(playerObject->getMoodId());
+    parameters.addString(playerObject->getTitle().getAnsi());
+    parameters.addUint32(playerObject->getPlayerFlags());
+    parameters.addUint64(playerObject->getState());
+    parameters.addUint32(playerObject->getLanguage());
+    parameters.addUint8(playerObject->getNewPlayerExemptions());
+    parameters.addUint64(playerObject->getId());
+
+    mDatabase->ExecuteStatementAsync(this,asyncContainer,mSaveAttributesStatement,parameters);
+}
+
+//======================================================================================================================
+//
+// Accounts for a save that left the database queue, for the periodic save statistics.
+// Only a save that made it to the database takes over the checksum it was started with, a failed one is retried
+// by the next round.
+//
+
+void WorldManager::_playerSaveComplete(WMAsyncContainer* asyncContainer, bool saved)
+{
+    if(saved)
+    {
+        if(PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject))
+        {
+            playerObject->setSaveChecksum(asyncContainer->mSaveChecksum);
+        }
+    }
+
+    if(mPlayerSavesInFlight)
+    {
+        mPlayerSavesInFlight--;
+    }
+
+    uint64 latency = gClock->getLocalTime() - asyncContainer->mStartTime;
+
+    mPlayerSavesCompleted++;
+    mPlayerSaveLatencyTotal += latency;
+
+    if(latency > mPlayerSaveLatencyMax)
+    {
+        mPlayerSaveLatencyMax = latency;
     }
 }
 
@@ -481,37 +579,134 @@ void WorldManager::warpPlanet(PlayerObject* playerObject, const glm::vec3& desti
 }
 //======================================================================================================================
 //
-// Handles the saving of all players on a fixed interval
-// eventually we will put some logic to only save x players at a time
-// in this once the server becomes more stable
+// Checksum over everything a periodic save writes, players that did not change since their last save are skipped.
+//
+
+uint32 WorldManager::_getPlayerSaveChecksum(PlayerObject* playerObject)
+{
+    Ham*	ham = playerObject->getHam();
+    BString	title = playerObject->getTitle();
+
+    uint32 values[] =
+    {
+        static_cast<uint32>(playerObject->getParentId()),
+        static_cast<uint32>(playerObject->getParentId() >> 32),
+        playerObject->getJediState(),
+        static_cast<uint32>(ham->mHealth.getCurrentHitPoints() - ham->mHealth.getModifier()),
+        static_cast<uint32>(ham->mAction.getCurrentHitPoints() - ham->mAction.getModifier()),
+        static_cast<uint32>(ham->mMind.getCurrentHitPoints() - ham->mMind.getModifier()),
+        static_cast<uint32>(ham->mHealth.getWounds()),
+        static_cast<uint32>(ham->mStrength.getWounds()),
+        static_cast<uint32>(ham->mConstitution.getWounds()),
+        static_cast<uint32>(ham->mAction.getWounds()),
+        static_cast<uint32>(ham->mQuickness.getWounds()),
+        static_cast<uint32>(ham->mStamina.getWounds()),
+        static_cast<uint32>(ham->mMind.getWounds()),
+        static_cast<uint32>(ham->mFocus.getWounds()),
+        static_cast<uint32>(ham->mWillpower.getWounds()),
+        static_cast<uint32>(ham->getBattleFatigue()),
+        playerObject->getPosture(),
+        playerObject->getMoodId(),
+        playerObject->getPlayerFlags(),
+        static_cast<uint32>(playerObject->getState()),
+        static_cast<uint32>(playerObject->getState() >> 32),
+        playerObject->getLanguage(),
+        playerObject->getNewPlayerExemptions()
+    };
+
+    float coords[] =
+    {
+        playerObject->mDirection.x,playerObject->mDirection.y,playerObject->mDirection.z,playerObject->mDirection.w,
+        playerObject->mPosition.x,playerObject->mPosition.y,playerObject->mPosition.z
+    };
+
+    // FNV-1a
+    uint32 checksum = 2166136261u;
+
+    const uint8* bytes = reinterpret_cast<const uint8*>(values);
+    for(uint32 i = 0; i < sizeof(values); i++)
+    {
+        checksum = (checksum ^ bytes[i]) * 16777619u;
+    }
+
+    bytes = reinterpret_cast<const uint8*>(coords);
+    for(uint32 i = 0; i < sizeof(coords); i++)
+    {
+        checksum = (checksum ^ bytes[i]) * 16777619u;
+    }
+
+    bytes = reinterpret_cast<const uint8*>(title.getAnsi());
+    for(uint32 i = 0; i < title.getLength(); i++)
+    {
+        checksum = (checksum ^ bytes[i]) * 16777619u;
+    }
+
+    return checksum;
+}
+
+//======================================================================================================================
+//
+// Handles the periodic saving of the players. Instead of saving everyone at once every interval, which floods the
+// database workers, every tick saves the next slice of players so each one is saved once per interval.
 //
+
 bool	WorldManager::_handlePlayerSaveTimers(uint64 callTime, void* ref)
 {
-    //uint32 playerCount = mPlayerAccMap.size();
-    //// don't save all players if > 100
-    uint32 playerSaveCount = 0;
-    PlayerAccMap::iterator playerIt = mPlayerAccMap.begin();
-    while (playerIt != mPlayerAccMap.end())
+    uint32 playerCount = mPlayerAccMap.size();
+    if(!playerCount)
+    {
+        return true;
+    }
+
+    // the task runs every second
+    uint32 interval		= gWorldConfig->getPlayerSaveInterval();
+    uint32 sliceSize	= (playerCount + interval - 1) / interval;
+
+    PlayerAccMap::iterator playerIt = mPlayerAccMap.upper_bound(mPlayerSaveCursor);
+
+    while(sliceSize && playerIt != mPlayerAccMap.end())
     {
-        const PlayerObject* const playerObject = (*playerIt).second;
-        if (playerObject)
+        PlayerObject* playerObject = const_cast<PlayerObject*>((*playerIt).second);
+
+        mPlayerSaveCursor = (*playerIt).first;
+        ++playerIt;
+
+        if(!playerObject || !playerObject->isConnected() || playerObject->isBeingDestroyed())
         {
-            if (playerObject->isConnected())
-            {
-                // TODO: don't save all players if > x players (100ish)
-                // set the timer to save rest of players again
-                // TODO: check if player has saved recently
-                // save player async
-                gWorldManager->savePlayer(playerObject->getAccountId(), false, WMLogOut_No_LogOut);
-                ++playerSaveCount;
-            }
+            continue;
+        }
+
+        sliceSize--;
 
+        // buffs count down while we are online, so they always need saving
+        // the checksum is stored once the save completed, see _playerSaveComplete
+        if(_getPlayerSaveChecksum(playerObject) == playerObject->getSaveChecksum() && !playerObject->GetNoOfBuffs())
+        {
+            mPlayerSavesSkipped++;
+            continue;
         }
 
-        ++playerIt;
+        savePlayer(playerObject->getAccountId(), false, WMLogOut_No_LogOut);
+        mPlayerSavesStarted++;
     }
-    gLogger->log(LogManager::NOTICE, "Periodic Save of %u Players", playerSaveCount);
-    //setSaveTaskId(mSubsystemScheduler->addTask(fastdelegate::MakeDelegate(this,&WorldManager::_handlePlayerSaveTimers), 4, 60000, NULL));
+
+    // went through everyone, start over with the next round
+    if(playerIt == mPlayerAccMap.end())
+    {
+        gLogger->log(LogManager::NOTICE, "Periodic Save of %u Players, %u unchanged", mPlayerSavesStarted, mPlayerSavesSkipped);
+
+        gLogger->log(LogManager::DEBUG, "Player saves: %u in flight, %u completed, average latency %"PRIu64"ms, max latency %"PRIu64"ms",
+                     mPlayerSavesInFlight, mPlayerSavesCompleted,
+                     mPlayerSavesCompleted ? mPlayerSaveLatencyTotal / mPlayerSavesCompleted : 0, mPlayerSaveLatencyMax);
+
+        mPlayerSaveCursor		= 0;
+        mPlayerSavesStarted		= 0;
+        mPlayerSavesSkipped		= 0;
+        mPlayerSavesCompleted	= 0;
+        mPlayerSaveLatencyTotal	= 0;
+        mPlayerSaveLatencyMax	= 0;
+    }
+
     return true;
 }
 //======================================================================================================================
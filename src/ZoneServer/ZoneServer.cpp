@@ -302,6 +302,13 @@ void ZoneServer::Process(void)
 
 //======================================================================================================================
 
+void ZoneServer::Idle(uint32 timeout)
+{
+    mDatabaseManager->waitForCompletedJobs(timeout);
+}
+
+//======================================================================================================================
+
 void ZoneServer::_updateDBServerList(uint32 status)
 {
     // Update the DB with our status.  This must be synchronous as the connection server relies on this data.
@@ -428,7 +435,7 @@ int main(int argc, char* argv[])
         gZoneServer->Process();
         gMessageFactory->Process(); //Garbage Collection
 
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        gZoneServer->Idle(1);
 
     }
 
@@ -74,6 +74,9 @@ public:
 
     void	Process(void);
 
+    // Sleeps for up to timeout ms, a completed database job wakes us up early.
+    void	Idle(uint32 timeout);
+
     void	handleWMReady();
 
     BString  getZoneName()  {
@@ -32,16 +32,28 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "CellObject.h"
 #include "WorldManager.h"
 
+#include <boost/date_time/posix_time/posix_time.hpp>
+
 
 using namespace SpatialIndex;
 
+// only every so many range queries get timed, reading the clock three times costs more than a small query
+#define ZONETREE_QUERY_SAMPLE_INTERVAL	64
+
 //=============================================================================
 
 ZoneTree::ZoneTree(void) :
     mStorageManager(NULL),
     mStorageBuffer(NULL),
     mTree(NULL),
-    mIndexIdentifier(0)
+    mIndexIdentifier(0),
+    mBulkLoading(false),
+    mBulkLoadTime(0),
+    mBulkBuildTime(0),
+    mQueryCount(0),
+    mSampledQueryCount(0),
+    mDynamicQueryTime(0),
+    mStaticQueryTime(0)
 {
     // We do have a global clock object, don't use seperate clock and times for every process.
     // mClock = new Anh_Utils::Clock();
@@ -92,6 +104,12 @@ void ZoneTree::InsertPoint(int64 objId,double x,double z)
     coords[0] = x;
     coords[1] = z;
 
+    if(mBulkLoading)
+    {
+        mStaticTree.insert(objId,x,z,x,z);
+        return;
+    }
+
     Point p = Point(coords,2);
 
     mTree->insertData(0,0,p,objId);
@@ -112,6 +130,12 @@ void ZoneTree::InsertRegion(int64 objId,double x,double z,double width,double he
     high[0] = x + width;
     high[1] = z + height;
 
+    if(mBulkLoading)
+    {
+        mStaticTree.insert(objId,low[0],low[1],high[0],high[1]);
+        return;
+    }
+
     Region r = Region(low,high,2);
 
     mTree->insertData(0,0,r,objId);
@@ -202,7 +226,7 @@ void ZoneTree::getObjectsInRangeIntersection(Object* object,ObjectSet* resultSet
         Region r = Region(plow,phigh,2);
         MyVisitor vis(&resultIdList);
 
-        mTree->intersectsWithQuery(r,vis);
+        _intersectsWithQuery(r,vis,&resultIdList);
 
         // filter needed objects
         ObjectIdList::iterator it = resultIdList.begin();
@@ -226,23 +250,7 @@ void ZoneTree::getObjectsInRangeIntersection(Object* object,ObjectSet* resultSet
                     {
                         // gLogger->log(LogManager::DEBUG,"Found a building");
 
-                        ObjectList cellChilds = (dynamic_cast<BuildingObject*>(tmpObject))->getAllCellChilds();
-                        ObjectList::iterator cellChildsIt = cellChilds.begin();
-
-                        while(cellChildsIt != cellChilds.end())
-                        {
-                            Object* cellChild = (*cellChildsIt);
-
-                            tmpType = cellChild->getType();
-
-                            if((tmpType & objTypes) == static_cast<uint32>(tmpType))
-                            {
-                                // TODO: We could add a range check to every object...
-                                resultSet->insert(cellChild);
-                            }
-
-                            ++cellChildsIt;
-                        }
+                        dynamic_cast<BuildingObject*>(tmpObject)->getCellContent(objTypes,resultSet);
                     }
                 }
             }
@@ -310,7 +318,7 @@ void ZoneTree::getObjectsInRangeIntersection(Object* object,ObjectSet* resultSet
         Region r = Region(plow,phigh,2);
         MyVisitor vis(&resultIdList);
 
-        mTree->intersectsWithQuery(r,vis);
+        _intersectsWithQuery(r,vis,&resultIdList);
 
         ObjectIdList::iterator it = resultIdList.begin();
         while(it != resultIdList.end())
@@ -328,23 +336,7 @@ void ZoneTree::getObjectsInRangeIntersection(Object* object,ObjectSet* resultSet
                 // if its a building, add objects of our types it contains
                 if(tmpType == ObjType_Building)
                 {
-                    ObjectList cellChilds = (dynamic_cast<BuildingObject*>(tmpObject))->getAllCellChilds();
-                    ObjectList::iterator cellChildsIt = cellChilds.begin();
-
-                    while(cellChildsIt != cellChilds.end())
-                    {
-                        Object* cellChild = (*cellChildsIt);
-
-                        tmpType = cellChild->getType();
-
-                        if(((tmpType & objTypes) == static_cast<uint32>(tmpType)) && cellChild->getId() != object->getId())
-                        {
-                            // TODO: We could add a range check to every object...
-                            resultSet->insert(cellChild);
-                        }
-
-                        ++cellChildsIt;
-                    }
+                    dynamic_cast<BuildingObject*>(tmpObject)->getCellContent(objTypes,resultSet,object->getId());
                 }
             }
             ++it;
@@ -378,7 +370,7 @@ void ZoneTree::getObjectsInRange(const Object* const object,ObjectSet* resultSet
         //please note that the containsWhatQuery regularly fails to find objects were standing next to -
         //mTree->containsWhatQuery(r,vis);
 
-        mTree->intersectsWithQuery(r,vis);
+        _intersectsWithQuery(r,vis,&resultIdList);
         // filter needed objects
         ObjectIdList::iterator it = resultIdList.begin();
         while(it != resultIdList.end())
@@ -402,23 +394,7 @@ void ZoneTree::getObjectsInRange(const Object* const object,ObjectSet* resultSet
                     {
                         // gLogger->log(LogManager::DEBUG,"Found a building");
 
-                        ObjectList cellChilds = (dynamic_cast<BuildingObject*>(tmpObject))->getAllCellChilds();
-                        ObjectList::iterator cellChildsIt = cellChilds.begin();
-
-                        while(cellChildsIt != cellChilds.end())
-                        {
-                            Object* cellChild = (*cellChildsIt);
-
-                            tmpType = cellChild->getType();
-
-                            if((tmpType & objTypes) == static_cast<uint32>(tmpType))
-                            {
-                                // TODO: We could add a range check to every object...
-                                resultSet->insert(cellChild);
-                            }
-
-                            ++cellChildsIt;
-                        }
+                        dynamic_cast<BuildingObject*>(tmpObject)->getCellContent(objTypes,resultSet);
                     }
                 }
             }
@@ -486,7 +462,7 @@ void ZoneTree::getObjectsInRange(const Object* const object,ObjectSet* resultSet
         Region r = Region(plow,phigh,2);
         MyVisitor vis(&resultIdList);
 
-        mTree->intersectsWithQuery(r,vis);
+        _intersectsWithQuery(r,vis,&resultIdList);
 
         //containswhat query regularly misses objects we stand next to - do *not* use it
         //this might have been because the width and height of buildings was set by default to 128 (ie our viewing range)
@@ -511,24 +487,7 @@ void ZoneTree::getObjectsInRange(const Object* const object,ObjectSet* resultSet
                 if(tmpType == ObjType_Building)
                 {
 
-                    ObjectList cellChilds = (dynamic_cast<BuildingObject*>(tmpObject))->getAllCellChilds();
-                    ObjectList::iterator cellChildsIt = cellChilds.begin();
-
-                    while(cellChildsIt != cellChilds.end())
-                    {
-                        Object* cellChild = (*cellChildsIt);
-
-                        tmpType = cellChild->getType();
-
-                        if(((tmpType & objTypes) == static_cast<uint32>(tmpType)) && cellChild->getId() != object->getId())
-                        {
-                            // TODO: We could add a range check to every object...
-                            resultSet->insert(cellChild);
-                            //gLogger->log(LogManager::DEBUG,"inserted cellchild %"PRIu64"",cellChild->getId());
-                        }
-
-                        ++cellChildsIt;
-                    }
+                    dynamic_cast<BuildingObject*>(tmpObject)->getCellContent(objTypes,resultSet,object->getId());
                 }
             }
             ++it;
@@ -547,7 +506,7 @@ void ZoneTree::RemovePoint(int64 objId,double x,double z)
 
     Point p = Point(coords,2);
 
-    if(mTree->deleteData(p,objId) == false)
+    if(mTree->deleteData(p,objId) == false && !mStaticTree.remove(objId,x,z,x,z))
     {
         std::ostringstream ss;
         ss << "ZoneTree::RemovePoint *** ERROR: Cannot delete id: " << objId << std::endl;
@@ -574,7 +533,7 @@ void ZoneTree::RemoveRegion(int64 objId,double xLow,double zLow,double xHigh,dou
 
     Region r = Region(low,high,2);
 
-    if(mTree->deleteData(r,objId) == false)
+    if(mTree->deleteData(r,objId) == false && !mStaticTree.remove(objId,xLow,zLow,xHigh,zHigh))
     {
         std::ostringstream ss;
         ss << " ZoneTree::RemoveRegion *** ERROR: Cannot delete id: " << objId << std::endl;
@@ -597,15 +556,84 @@ void ZoneTree::DumpStats()
     ss << *mTree;
     ss << "Buffer Hits: " << mStorageBuffer->getHits() << std::endl;
     ss << "IndexIdentifier: " << mIndexIdentifier << std::endl;
+    ss << "Static: " << mStaticTree.getEntryCount() << " entries in " << mStaticTree.getNodeCount() << " nodes, height " << mStaticTree.getHeight();
+    ss << ", collected in " << mBulkLoadTime << " ms, packed in " << mBulkBuildTime << " ms" << std::endl;
+
+    if(mSampledQueryCount)
+    {
+        ss << "Queries: " << mQueryCount << ", avg dynamic " << mDynamicQueryTime / mSampledQueryCount << " us";
+        ss << ", avg static " << mStaticQueryTime / mSampledQueryCount << " us";
+        ss << " (" << mSampledQueryCount << " sampled)" << std::endl;
+    }
+
     gLogger->log(LogManager::DEBUG,ss.str());
 }
 
 //=============================================================================
 
+void ZoneTree::BeginBulkLoad()
+{
+    mBulkLoading	= true;
+    mBulkLoadStart	= boost::posix_time::microsec_clock::universal_time();
+}
+
+//=============================================================================
+
+void ZoneTree::EndBulkLoad()
+{
+    if(!mBulkLoading)
+    {
+        return;
+    }
+
+    boost::posix_time::ptime loaded = boost::posix_time::microsec_clock::universal_time();
+
+    mStaticTree.build();
+    mBulkLoading = false;
+
+    mBulkLoadTime	= (loaded - mBulkLoadStart).total_milliseconds();
+    mBulkBuildTime	= (boost::posix_time::microsec_clock::universal_time() - loaded).total_milliseconds();
+
+    gLogger->log(LogManager::NOTICE,"SpatialIndex packed %u static objects in %"PRIu64" ms",mStaticTree.getEntryCount(),mBulkBuildTime);
+
+    DumpStats();
+}
+
+//=============================================================================
+//
+// range queries go to both trees
+//
+
+void ZoneTree::_intersectsWithQuery(const Region& r,MyVisitor& vis,ObjectIdList* resultIdList)
+{
+    if(++mQueryCount % ZONETREE_QUERY_SAMPLE_INTERVAL)
+    {
+        mTree->intersectsWithQuery(r,vis);
+        mStaticTree.intersects(r.m_pLow[0],r.m_pLow[1],r.m_pHigh[0],r.m_pHigh[1],resultIdList);
+        return;
+    }
+
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+    mTree->intersectsWithQuery(r,vis);
+
+    boost::posix_time::ptime dynamicDone = boost::posix_time::microsec_clock::universal_time();
+
+    mStaticTree.intersects(r.m_pLow[0],r.m_pLow[1],r.m_pHigh[0],r.m_pHigh[1],resultIdList);
+
+    mStaticQueryTime	+= (boost::posix_time::microsec_clock::universal_time() - dynamicDone).total_microseconds();
+    mDynamicQueryTime	+= (dynamicDone - start).total_microseconds();
+    mSampledQueryCount++;
+}
+
+//=============================================================================
+
 void ZoneTree::ShutDown()
 {
     gLogger->log(LogManager::DEBUG,"SpatialIndex Shutdown\n");
 
+    DumpStats();
+
     try
     {
         mResourceUsage.stop();
@@ -623,6 +651,7 @@ void ZoneTree::ShutDown()
     delete(mStorageBuffer);
     delete(mStorageManager);
 
+    mStaticTree.clear();
     mIndexIdentifier = 0;
 
     gLogger->log(LogManager::WARNING,"SpatialIndex Shutdown complete\n");
@@ -653,7 +682,7 @@ void ZoneTree::getObjectsInRangeEx(Object* object,ObjectSet* resultSet,uint32 ob
         Region r = Region(plow,phigh,2);
         MyVisitor vis(&resultIdList);
 
-        mTree->intersectsWithQuery(r,vis);
+        _intersectsWithQuery(r,vis,&resultIdList);
         // mTree->containsWhatQuery(r,vis);
 
         // filter needed objects
@@ -677,24 +706,7 @@ void ZoneTree::getObjectsInRangeEx(Object* object,ObjectSet* resultSet,uint32 ob
                     {
                         // gLogger->log(LogManager::DEBUG,"Found a building");
 
-                        ObjectList cellChilds = (dynamic_cast<BuildingObject*>(tmpObject))->getAllCellChilds();
-                        ObjectList::iterator cellChildsIt = cellChilds.begin();
-
-                        while(cellChildsIt != cellChilds.end())
-                        {
-                            Object* cellChild = (*cellChildsIt);
-
-                            tmpType = cellChild->getType();
-
-                            if((tmpType & objTypes) == static_cast<uint32>(tmpType))
-                            {
-                                // TODO: We could add a range check to every object...
-                                // gLogger->log(LogManager::DEBUG,"Found object PRId32",cellChild->getId());
-                                resultSet->insert(cellChild);
-                            }
-
-                            ++cellChildsIt;
-                        }
+                        dynamic_cast<BuildingObject*>(tmpObject)->getCellContent(objTypes,resultSet);
                     }
                 }
             }
@@ -774,7 +786,7 @@ void ZoneTree::getObjectsInRangeEx(Object* object,ObjectSet* resultSet,uint32 ob
         Region r = Region(plow,phigh,2);
         MyVisitor vis(&resultIdList);
 
-        mTree->intersectsWithQuery(r,vis);
+        _intersectsWithQuery(r,vis,&resultIdList);
 
         ObjectIdList::iterator it = resultIdList.begin();
         while(it != resultIdList.end())
@@ -792,23 +804,7 @@ void ZoneTree::getObjectsInRangeEx(Object* object,ObjectSet* resultSet,uint32 ob
                 // if its a building, add objects of our types it contains
                 if(tmpType == ObjType_Building)
                 {
-                    ObjectList cellChilds = (dynamic_cast<BuildingObject*>(tmpObject))->getAllCellChilds();
-                    ObjectList::iterator cellChildsIt = cellChilds.begin();
-
-                    while(cellChildsIt != cellChilds.end())
-                    {
-                        Object* cellChild = (*cellChildsIt);
-
-                        tmpType = cellChild->getType();
-
-                        if(((tmpType & objTypes) == static_cast<uint32>(tmpType)) && cellChild->getId() != object->getId())
-                        {
-                            // TODO: We could add a range check to every object...
-                            resultSet->insert(cellChild);
-                        }
-
-                        ++cellChildsIt;
-                    }
+                    dynamic_cast<BuildingObject*>(tmpObject)->getCellContent(objTypes,resultSet,object->getId());
                 }
             }
             ++it;
@@ -31,7 +31,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/typedefs.h"
 #include <vector>
 #include <SpatialIndex.h>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include "ObjectController.h"
+#include "StaticRTree.h"
 
 //======================================================================================================================
 
@@ -78,6 +80,11 @@ public:
 
     void			DumpStats();
 
+    // points and regions inserted in between are collected and packed in one go when the load is done,
+    // the qt regions still go straight into the dynamic tree, the load needs them for the getQTRegion lookups
+    void			BeginBulkLoad();
+    void			EndBulkLoad();
+
     void			insertQTRegion(int64 objId, double x, double z, double width, double height);
     void			InsertPoint(int64 objId, double x, double z);
     void			InsertRegion(int64 objId, double x, double z, double width, double height);
@@ -91,11 +98,26 @@ public:
 
 private:
 
+    void			_intersectsWithQuery(const SpatialIndex::Region& r, MyVisitor& vis, ObjectIdList* resultIdList);
+
     SpatialIndex::IStorageManager*			mStorageManager;
     SpatialIndex::StorageManager::IBuffer*	mStorageBuffer;
     SpatialIndex::ISpatialIndex*			mTree;
     int64						            mIndexIdentifier;
     Tools::ResourceUsage 		            mResourceUsage;
+
+    // what the zone loads at boot, packed once
+    StaticRTree								mStaticTree;
+    bool									mBulkLoading;
+    boost::posix_time::ptime				mBulkLoadStart;
+    uint64									mBulkLoadTime;
+    uint64									mBulkBuildTime;
+
+    // query times in microseconds, per tree, summed over the sampled queries
+    uint64									mQueryCount;
+    uint64									mSampledQueryCount;
+    uint64									mDynamicQueryTime;
+    uint64									mStaticQueryTime;
 };
 
 //======================================================================================================================
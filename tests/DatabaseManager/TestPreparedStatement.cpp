@@ -0,0 +1,190 @@
+﻿/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/PreparedStatement.h"
+#include "Utils/bstring.h"
+
+namespace {
+
+class StatementRow {
+public:
+    uint64  mId;
+    float   mX;
+    uint16  mCount;
+    BString mName;
+    int8    mShort[8];
+};
+
+// fills a result the way a worker does after fetching: id as uint64, x as float, count and name from
+// columns fetched as their own type
+StatementResult* buildResult() {
+    StatementResult* result = new StatementResult(4);
+    result->setColumnType(0, DFT_uint64);
+    result->setColumnType(1, DFT_float);
+    result->setColumnType(2, DFT_int64);
+    result->setColumnType(3, DFT_string);
+
+    for (uint32 i = 0; i < 2; i++) {
+        uint64 cells[4] = {0};
+
+        uint64 id = 1000 + i;
+        float x = 1.5f + i;
+        int64 count = 7 + i;
+
+        memcpy(&cells[0], &id, sizeof(id));
+        memcpy(&cells[1], &x, sizeof(x));
+        memcpy(&cells[2], &count, sizeof(count));
+        cells[3] = result->addString(i ? "second row" : "first", i ? 10 : 5);
+
+        result->addRow(cells);
+    }
+
+    return result;
+}
+
+}
+
+TEST(PreparedStatementTest, ParametersKeepTypeAndValueInOrder) {
+    StatementParameters parameters;
+
+    parameters.addUint64(8589934593ULL);
+    parameters.addFloat(2.5f);
+    parameters.addString("it's quoted");
+
+    ASSERT_EQ(3, parameters.getCount());
+
+    EXPECT_EQ(DFT_uint64, parameters.getParameter(0).mType);
+    EXPECT_EQ(8589934593ULL, parameters.getParameter(0).mValue);
+
+    float x;
+    memcpy(&x, &parameters.getParameter(1).mValue, sizeof(x));
+    EXPECT_EQ(DFT_float, parameters.getParameter(1).mType);
+    EXPECT_FLOAT_EQ(2.5f, x);
+
+    EXPECT_EQ(DFT_string, parameters.getParameter(2).mType);
+    EXPECT_EQ("it's quoted", parameters.getParameter(2).mString);
+}
+
+TEST(PreparedStatementTest, RowsAreCopiedToTheBindingOffsets) {
+    StatementResult* result = buildResult();
+
+    DataBinding binding(4);
+    binding.addField(DFT_uint64, offsetof(StatementRow, mId), 8, 0);
+    binding.addField(DFT_float, offsetof(StatementRow, mX), 4, 1);
+    binding.addField(DFT_uint16, offsetof(StatementRow, mCount), 2, 2);
+    binding.addField(DFT_bstring, offsetof(StatementRow, mName), 64, 3);
+
+    ASSERT_EQ(2, result->getRowCount());
+
+    StatementRow row;
+    result->GetNextRow(&binding, &row);
+
+    EXPECT_EQ(1000, row.mId);
+    EXPECT_FLOAT_EQ(1.5f, row.mX);
+    EXPECT_EQ(7, row.mCount);
+    EXPECT_STREQ("first", row.mName.getAnsi());
+
+    result->GetNextRow(&binding, &row);
+
+    EXPECT_EQ(1001, row.mId);
+    EXPECT_EQ(8, row.mCount);
+    EXPECT_STREQ("second row", row.mName.getAnsi());
+
+    delete result;
+}
+
+TEST(PreparedStatementTest, ResultCanBeReadAgainWithAnotherBinding) {
+    StatementResult* result = buildResult();
+
+    DataBinding first(1);
+    first.addField(DFT_uint64, offsetof(StatementRow, mId), 8, 0);
+
+    DataBinding second(2);
+    second.addField(DFT_string, offsetof(StatementRow, mShort), 8, 0);
+    second.addField(DFT_string, offsetof(StatementRow, mShort), 8, 3);
+
+    StatementRow row;
+    result->GetNextRow(&first, &row);
+    EXPECT_EQ(1000, row.mId);
+
+    // numbers are formatted for string fields, strings are cut to the field size
+    result->setRowIndex(1);
+    result->GetNextRow(&second, &row);
+    EXPECT_STREQ("second ", row.mShort);
+
+    result->setRowIndex(0);
+    DataBinding third(1);
+    third.addField(DFT_string, offsetof(StatementRow, mShort), 8, 0);
+    result->GetNextRow(&third, &row);
+    EXPECT_STREQ("1000", row.mShort);
+
+    delete result;
+}
+
+TEST(PreparedStatementTest, StringColumnsConvertToNumbers) {
+    StatementResult result(1);
+    result.setColumnType(0, DFT_string);
+
+    uint64 cells[1];
+    cells[0] = result.addString("42", 2);
+    result.addRow(cells);
+
+    DataBinding binding(1);
+    binding.addField(DFT_uint16, offsetof(StatementRow, mCount), 2, 0);
+
+    StatementRow row;
+    row.mCount = 0;
+    result.GetNextRow(&binding, &row);
+
+    EXPECT_EQ(42, row.mCount);
+}
+
+TEST(PreparedStatementTest, ColumnsThatWereNotFetchedAreSkipped) {
+    StatementResult result(2);
+    result.setColumnType(0, DFT_uint64);
+
+    uint64 cells[2] = {5, 0};
+    result.addRow(cells);
+
+    DataBinding binding(2);
+    binding.addField(DFT_uint64, offsetof(StatementRow, mId), 8, 0);
+    binding.addField(DFT_uint16, offsetof(StatementRow, mCount), 2, 1);
+
+    StatementRow row;
+    row.mCount = 3;
+    result.GetNextRow(&binding, &row);
+
+    EXPECT_EQ(5, row.mId);
+    EXPECT_EQ(3, row.mCount);
+}
@@ -0,0 +1,138 @@
+﻿/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DatabaseManager/WriteBehindBuffer.h"
+
+TEST(WriteBehindBufferTest, NewerValueReplacesPendingUpdateOfSameRow) {
+    WriteBehindBuffer buffer(1000);
+
+    buffer.add("resource_containers", "amount", "id=5", "10", 0, 0);
+    buffer.add("resource_containers", "amount", "id=5", "20", 0, 10);
+    buffer.add("resource_containers", "amount", "id=5", "30", 0, 20);
+
+    EXPECT_EQ(1, buffer.getPendingCount());
+    EXPECT_EQ(3, buffer.getQueuedCount());
+    EXPECT_EQ(2, buffer.getCoalescedCount());
+
+    std::vector<std::string> statements;
+    buffer.flush(statements, 8191);
+
+    ASSERT_EQ(1, statements.size());
+    EXPECT_EQ("UPDATE resource_containers SET amount=30 WHERE id=5", statements[0]);
+    EXPECT_EQ(0, buffer.getPendingCount());
+}
+
+TEST(WriteBehindBufferTest, RowsOfOneColumnAreWrittenAsOneStatement) {
+    WriteBehindBuffer buffer(1000);
+
+    buffer.add("item_attributes", "value", "item_id=1 AND attribute_id=18", "'a'", 0, 0);
+    buffer.add("item_attributes", "value", "item_id=2 AND attribute_id=18", "'b'", 0, 0);
+    buffer.add("resource_containers", "amount", "id=5", "10", 0, 0);
+
+    std::vector<std::string> statements;
+    buffer.flush(statements, 8191);
+
+    ASSERT_EQ(2, statements.size());
+    EXPECT_EQ("UPDATE item_attributes SET value=CASE WHEN item_id=1 AND attribute_id=18 THEN 'a' WHEN item_id=2 AND attribute_id=18 THEN 'b'"
+              " END WHERE (item_id=1 AND attribute_id=18) OR (item_id=2 AND attribute_id=18)", statements[0]);
+    EXPECT_EQ("UPDATE resource_containers SET amount=10 WHERE id=5", statements[1]);
+    EXPECT_EQ(2, buffer.getStatementCount());
+}
+
+TEST(WriteBehindBufferTest, IsDueOnceOldestUpdateWaitedForWindow) {
+    WriteBehindBuffer buffer(1000);
+
+    EXPECT_FALSE(buffer.isDue(5000));
+
+    buffer.add("resource_containers", "amount", "id=5", "10", 0, 100);
+    buffer.add("resource_containers", "amount", "id=6", "10", 0, 900);
+
+    EXPECT_FALSE(buffer.isDue(1099));
+    EXPECT_TRUE(buffer.isDue(1100));
+
+    std::vector<std::string> statements;
+    buffer.flush(statements, 8191);
+
+    EXPECT_FALSE(buffer.isDue(5000));
+}
+
+TEST(WriteBehindBufferTest, LongBatchesAreSplitToFitMaxLength) {
+    WriteBehindBuffer buffer(1000);
+
+    for(int i = 0; i < 100; i++) {
+        buffer.add("resource_containers", "amount", "id=" + std::to_string(static_cast<long long>(1000 + i)), "10", 0, 0);
+    }
+
+    std::vector<std::string> statements;
+    buffer.flush(statements, 512);
+
+    EXPECT_LT(1, statements.size());
+
+    size_t rows = 0;
+    for(size_t i = 0; i < statements.size(); i++) {
+        EXPECT_GE(512, statements[i].length());
+
+        // every row shows up once in the WHERE clause
+        for(size_t pos = statements[i].find("(id="); pos != std::string::npos; pos = statements[i].find("(id=", pos + 1)) {
+            rows++;
+        }
+    }
+
+    EXPECT_EQ(100, rows);
+}
+
+TEST(WriteBehindBufferTest, FlushOwnerOnlyWritesThatOwnersRows) {
+    WriteBehindBuffer buffer(1000);
+
+    buffer.add("item_attributes", "value", "item_id=1 AND attribute_id=18", "'a'", 7, 0);
+    buffer.add("item_attributes", "value", "item_id=2 AND attribute_id=18", "'b'", 8, 0);
+    buffer.add("item_attributes", "value", "item_id=3 AND attribute_id=18", "'c'", 7, 0);
+
+    std::vector<std::string> statements;
+    buffer.flushOwner(9, statements, 8191);
+
+    EXPECT_TRUE(statements.empty());
+    EXPECT_EQ(3, buffer.getPendingCount());
+
+    buffer.flushOwner(7, statements, 8191);
+
+    ASSERT_EQ(1, statements.size());
+    EXPECT_EQ("UPDATE item_attributes SET value=CASE WHEN item_id=1 AND attribute_id=18 THEN 'a' WHEN item_id=3 AND attribute_id=18 THEN 'c'"
+              " END WHERE (item_id=1 AND attribute_id=18) OR (item_id=3 AND attribute_id=18)", statements[0]);
+    EXPECT_EQ(1, buffer.getPendingCount());
+
+    statements.clear();
+    buffer.flush(statements, 8191);
+
+    ASSERT_EQ(1, statements.size());
+    EXPECT_EQ("UPDATE item_attributes SET value='b' WHERE item_id=2 AND attribute_id=18", statements[0]);
+}
@@ -0,0 +1,340 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include "NetworkManager/CompCryptor.h"
+
+namespace {
+
+// Builds a packet body that looks like a typical SWG payload: a few opcodes and
+// object ids followed by mostly repeating baseline data.
+std::vector<int8> buildPayload(uint32 size, uint32 seed) {
+    std::vector<int8> payload(size);
+
+    for (uint32 i = 0; i < size; ++i) {
+        payload[i] = static_cast<int8>((i < 16) ? (seed * 31 + i * 7) : (i % 24));
+    }
+
+    return payload;
+}
+
+// The way CompCryptor used to compress, a full deflate setup and teardown per packet.
+int compressWithFreshStream(int8* inData, uint32 inLen, int8* outData, uint32 outLen) {
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+
+    deflateInit(&stream, Z_DEFAULT_COMPRESSION);
+
+    stream.next_in = (Bytef*)inData;
+    stream.avail_in = inLen;
+    stream.next_out = (Bytef*)outData;
+    stream.avail_out = outLen;
+
+    deflate(&stream, Z_FINISH);
+
+    uint32 outBytes = stream.total_out;
+    deflateEnd(&stream);
+
+    return (outBytes > inLen) ? 0 : outBytes;
+}
+
+// The byte-at-a-time seeded crc CompCryptor::GenerateCRC used before slicing-by-8,
+// kept here with its own table as the reference for the differential tests.
+uint32 generateCRCBytewise(int8* data, uint32 len, uint32 seed) {
+    static uint32 crcTable[256];
+    static bool tableReady = false;
+
+    if (!tableReady) {
+        for (uint32 i = 0; i < 256; ++i) {
+            uint32 crc = i;
+            for (uint32 bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+            }
+            crcTable[i] = crc;
+        }
+        tableReady = true;
+    }
+
+    uint32 newCRC = 0, index = 0;
+
+    newCRC = crcTable[(~seed) & 0xFF];
+    newCRC ^= 0x00FFFFFF;
+    index = (seed >> 8) ^ newCRC;
+    newCRC = (newCRC >> 8) & 0x00FFFFFF;
+    newCRC ^= crcTable[index & 0xFF];
+    index = (seed >> 16) ^ newCRC;
+    newCRC = (newCRC >> 8) & 0x00FFFFFF;
+    newCRC ^= crcTable[index & 0xFF];
+    index = (seed >> 24) ^ newCRC;
+    newCRC = (newCRC >> 8) &0x00FFFFFF;
+    newCRC ^= crcTable[index & 0xFF];
+
+    for (uint32 i = 0; i < len; i++) {
+        index = (data[i]) ^ newCRC;
+        newCRC = (newCRC >> 8) & 0x00FFFFFF;
+        newCRC ^= crcTable[index & 0xFF];
+    }
+
+    return ~newCRC;
+}
+
+// The scalar decrypt loop CompCryptor::Decrypt used before the vector kernels.
+void decryptWordwise(int8* data, uint32 len, uint32 seed) {
+    uint32 tempSeed = 0;
+    uint32 blockCount = (len / 4);
+    uint32 byteCount = (len % 4);
+
+    for (uint32 count = 0; count < blockCount; count++) {
+        tempSeed = ((uint32*)data)[count];
+        ((uint32*)data)[count] ^= seed;
+        seed = tempSeed;
+    }
+
+    for (uint32 count = blockCount * 4; count < blockCount * 4 + byteCount; count++) {
+        data[count] ^= seed;
+    }
+}
+
+}
+
+/// Compressing and decompressing with the same cryptor gives back the original data.
+TEST(CompCryptorTests, CompressedPacketsRoundTrip) {
+    CompCryptor cryptor;
+
+    std::vector<int8> payload = buildPayload(480, 1);
+    int8 compressed[8192];
+    int8 decompressed[8192];
+
+    int compressedLen = cryptor.Compress(&payload[0], payload.size(), compressed, sizeof(compressed));
+    ASSERT_GT(compressedLen, 0);
+
+    int decompressedLen = cryptor.Decompress(compressed, compressedLen, decompressed, sizeof(decompressed));
+    ASSERT_EQ(static_cast<int>(payload.size()), decompressedLen);
+
+    EXPECT_EQ(0, memcmp(&payload[0], decompressed, payload.size()));
+}
+
+/// The reused streams must produce the same bytes as a freshly initialized stream for every packet.
+TEST(CompCryptorTests, ReusedStreamMatchesFreshStream) {
+    CompCryptor cryptor;
+
+    int8 reused[8192];
+    int8 fresh[8192];
+
+    for (uint32 size = 64; size <= 496; size += 16) {
+        std::vector<int8> payload = buildPayload(size, size);
+
+        int reusedLen = cryptor.Compress(&payload[0], size, reused, sizeof(reused));
+        int freshLen = compressWithFreshStream(&payload[0], size, fresh, sizeof(fresh));
+
+        ASSERT_EQ(freshLen, reusedLen);
+        EXPECT_EQ(0, memcmp(fresh, reused, reusedLen));
+    }
+}
+
+/// Data that does not start with a zlib header is left alone.
+TEST(CompCryptorTests, UncompressedDataIsNotDecompressed) {
+    CompCryptor cryptor;
+
+    int8 data[32] = {0};
+    int8 out[64];
+
+    EXPECT_EQ(0, cryptor.Decompress(data, sizeof(data), out, sizeof(out)));
+}
+
+/// GenerateCRC must match the old byte-at-a-time loop for every length, alignment and seed.
+TEST(CompCryptorTests, CrcMatchesBytewiseImplementation) {
+    CompCryptor cryptor;
+
+    int8 buffer[512 + 8];
+    for (uint32 i = 0; i < sizeof(buffer); ++i) {
+        buffer[i] = static_cast<int8>(i * 131 + 17);
+    }
+
+    const uint32 seeds[] = {0, 0xFFFFFFFF, 0xDEADBEEF, 0x62491908, 0x00000080};
+
+    for (uint32 s = 0; s < sizeof(seeds) / sizeof(seeds[0]); ++s) {
+        for (uint32 offset = 0; offset < 8; ++offset) {
+            for (uint32 len = 0; len <= 512; ++len) {
+                ASSERT_EQ(generateCRCBytewise(buffer + offset, len, seeds[s]), cryptor.GenerateCRC(buffer + offset, len, seeds[s]))
+                    << "len " << len << " offset " << offset << " seed " << seeds[s];
+            }
+        }
+    }
+}
+
+/// The seeded crc is a plain crc32 over the little endian seed followed by the data.
+TEST(CompCryptorTests, CrcMatchesZlibCrc32) {
+    CompCryptor cryptor;
+
+    uint32 seed = 0x12345678;
+    int8 packet[496];
+    for (uint32 i = 0; i < sizeof(packet); ++i) {
+        packet[i] = static_cast<int8>(i ^ 0x5A);
+    }
+
+    const Bytef seedBytes[4] = {0x78, 0x56, 0x34, 0x12};
+    uLong expected = crc32(crc32(0L, seedBytes, 4), reinterpret_cast<const Bytef*>(packet), sizeof(packet));
+
+    EXPECT_EQ(static_cast<uint32>(expected), cryptor.GenerateCRC(packet, sizeof(packet), seed));
+}
+
+/// Decrypt must undo Encrypt and match the old scalar loop for every length.
+TEST(CompCryptorTests, DecryptMatchesWordwiseImplementation) {
+    CompCryptor cryptor;
+
+    for (uint32 len = 0; len <= 496; ++len) {
+        int8 plain[500];
+        for (uint32 i = 0; i < len; ++i) {
+            plain[i] = static_cast<int8>(i * 13 + len);
+        }
+
+        int8 cipher[500];
+        memcpy(cipher, plain, len);
+        cryptor.Encrypt(cipher, len, 0xCAFEBABE);
+
+        int8 expected[500];
+        memcpy(expected, cipher, len);
+        decryptWordwise(expected, len, 0xCAFEBABE);
+
+        int8 decrypted[500];
+        memcpy(decrypted, cipher, len);
+        cryptor.Decrypt(decrypted, len, 0xCAFEBABE);
+
+        ASSERT_EQ(0, memcmp(expected, decrypted, len)) << "len " << len;
+        ASSERT_EQ(0, memcmp(plain, decrypted, len)) << "len " << len;
+    }
+}
+
+/// The read path gives the same crc and plaintext as the old bytewise crc and scalar decrypt. Bodies run to many
+/// AVX2 widths, and with the 1 and 2 byte headers the vector kernels see unaligned words.
+TEST(CompCryptorTests, DecryptAndGenerateCRCMatchesSeparatePasses) {
+    CompCryptor cryptor;
+
+    for (uint32 headerLen = 1; headerLen <= 2; ++headerLen) {
+        for (uint32 len = headerLen; len <= 1024; ++len) {
+            int8 packet[1024];
+            for (uint32 i = 0; i < len; ++i) {
+                packet[i] = static_cast<int8>(i * 29 + 3);
+            }
+
+            int8 separate[1024];
+            memcpy(separate, packet, len);
+            uint32 expectedCrc = generateCRCBytewise(separate, len, 0x1F2E3D4C);
+            decryptWordwise(separate + headerLen, len - headerLen, 0x1F2E3D4C);
+
+            int8 fused[1024];
+            memcpy(fused, packet, len);
+            uint32 fusedCrc = cryptor.DecryptAndGenerateCRC(fused, len, headerLen, 0x1F2E3D4C);
+
+            ASSERT_EQ(expectedCrc, fusedCrc) << "len " << len << " header " << headerLen;
+            ASSERT_EQ(0, memcmp(separate, fused, len)) << "len " << len << " header " << headerLen;
+        }
+    }
+}
+
+/// Throughput of the old byte-at-a-time crc vs slicing-by-8 over client sized packets.
+/// Run with --gtest_also_run_disabled_tests.
+TEST(CompCryptorTests, DISABLED_BenchmarkCrcThroughput) {
+    const uint32 iterations = 500000;
+    const uint32 sizes[] = {64, 128, 256, 496};
+
+    CompCryptor cryptor;
+    int8 packet[496];
+    for (uint32 i = 0; i < sizeof(packet); ++i) {
+        packet[i] = static_cast<int8>(i * 7);
+    }
+
+    uint32 sink = 0;
+
+    for (uint32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+        for (uint32 i = 0; i < iterations; ++i) {
+            sink ^= generateCRCBytewise(packet, sizes[s], i);
+        }
+
+        boost::posix_time::ptime middle = boost::posix_time::microsec_clock::universal_time();
+
+        for (uint32 i = 0; i < iterations; ++i) {
+            sink ^= cryptor.GenerateCRC(packet, sizes[s], i);
+        }
+
+        boost::posix_time::ptime end = boost::posix_time::microsec_clock::universal_time();
+
+        double bytewiseSeconds = (middle - start).total_microseconds() / 1000000.0;
+        double slicedSeconds = (end - middle).total_microseconds() / 1000000.0;
+
+        printf("%3u bytes: bytewise %6.0f MB/s, slicing-by-8 %6.0f MB/s\n", sizes[s],
+               (iterations * sizes[s]) / bytewiseSeconds / 1048576.0, (iterations * sizes[s]) / slicedSeconds / 1048576.0);
+    }
+
+    EXPECT_NE(0u, sink | 1);
+}
+
+/// Packets/sec of a fresh deflate stream per packet vs the reused CompCryptor stream.
+/// Run with --gtest_also_run_disabled_tests.
+TEST(CompCryptorTests, DISABLED_BenchmarkCompressPacketsPerSecond) {
+    const uint32 iterations = 20000;
+    const uint32 sizes[] = {64, 128, 256, 496};
+
+    CompCryptor cryptor;
+    int8 out[8192];
+
+    for (uint32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        std::vector<int8> payload = buildPayload(sizes[s], s);
+
+        boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+        for (uint32 i = 0; i < iterations; ++i) {
+            compressWithFreshStream(&payload[0], sizes[s], out, sizeof(out));
+        }
+
+        boost::posix_time::ptime middle = boost::posix_time::microsec_clock::universal_time();
+
+        for (uint32 i = 0; i < iterations; ++i) {
+            cryptor.Compress(&payload[0], sizes[s], out, sizeof(out));
+        }
+
+        boost::posix_time::ptime end = boost::posix_time::microsec_clock::universal_time();
+
+        double freshSeconds = (middle - start).total_microseconds() / 1000000.0;
+        double reusedSeconds = (end - middle).total_microseconds() / 1000000.0;
+
+        printf("%3u bytes: fresh stream %10.0f packets/sec, reused stream %10.0f packets/sec\n",
+               sizes[s], iterations / freshSeconds, iterations / reusedSeconds);
+    }
+}
@@ -0,0 +1,147 @@
+﻿/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <cstring>
+
+#include <boost/thread/thread.hpp>
+#include <gtest/gtest.h>
+
+#include "Utils/clock.h"
+#include "Utils/ConcurrentQueue.h"
+#include "NetworkManager/Message.h"
+#include "NetworkManager/MessageBuilder.h"
+#include "NetworkManager/MessageFactory.h"
+
+namespace {
+
+// the queue Session::PostChannelA hands the messages of the workers to the write thread with
+typedef utils::ConcurrentQueue<Message*> PostQueue;
+
+void buildBaselines(MessageBuilder* builder, PostQueue* queue, uint32 id) {
+    for (uint32 i = 0; i < 1000; ++i) {
+        builder->StartMessage();
+        builder->addUint32(id);
+        builder->addUint32(i);
+        builder->addString("baseline");
+        queue->push(builder->EndMessage());
+    }
+}
+
+class MessageBuilderTests : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        // messages are timestamped with the stored time
+        Anh_Utils::Clock::Init();
+    }
+};
+
+}  // namespace
+
+TEST_F(MessageBuilderTests, BuildsFactoryLayout) {
+    MessageBuilder builder;
+
+    builder.StartMessage();
+    builder.addUint32(0x12345678);
+    builder.addUint16(7);
+    builder.addString("abc");
+    Message* message = builder.EndMessage();
+
+    ASSERT_EQ(4u + 2u + 2u + 3u, message->getSize());
+    EXPECT_EQ(0x12345678u, message->getUint32());
+    EXPECT_EQ(7u, message->getUint16());
+    EXPECT_EQ(3u, message->getUint16());
+    EXPECT_EQ(0, memcmp(message->getData() + 8, "abc", 3));
+}
+
+TEST_F(MessageBuilderTests, ReclaimsSentMessages) {
+    MessageBuilder builder;
+
+    builder.StartMessage();
+    builder.addUint64(1);
+    Message* held = builder.EndMessage();
+
+    builder.StartMessage();
+    builder.addUint64(2);
+    Message* sent = builder.EndMessage();
+
+    EXPECT_EQ(2u, builder.getMessageCount());
+
+    // the session is done with the younger message, the older one must not hold it up
+    sent->setPendingDelete(true);
+
+    builder.StartMessage();
+    builder.EndMessage();
+
+    EXPECT_EQ(2u, builder.getMessageCount());
+    EXPECT_EQ(1ull, *reinterpret_cast<uint64*>(held->getData()));
+}
+
+TEST_F(MessageBuilderTests, ReclaimsSessionlessStuckMessages) {
+    MessageBuilder builder;
+
+    builder.StartMessage();
+    builder.addUint64(1);
+    Message* lost = builder.EndMessage();
+
+    // built but never handed to a session
+    lost->setCreateTime(Anh_Utils::Clock::getSingleton()->getStoredTime() - MESSAGE_MAX_LIFE_TIME - 1);
+
+    // the first pass flags it, the next one gives its block back
+    builder.StartMessage();
+    builder.EndMessage();
+    builder.StartMessage();
+    builder.EndMessage();
+
+    EXPECT_EQ(2u, builder.getMessageCount());
+}
+
+TEST_F(MessageBuilderTests, BuildersPostConcurrently) {
+    MessageBuilder builders[4];
+    PostQueue queue;
+
+    boost::thread_group workers;
+    for (uint32 i = 0; i < 4; ++i) {
+        workers.create_thread(boost::bind(buildBaselines, &builders[i], &queue, i));
+    }
+    workers.join_all();
+
+    // everything arrives, the messages of each worker in the order it built them
+    uint32 next[4] = {0, 0, 0, 0};
+    Message* message;
+
+    while (queue.pop(message)) {
+        message->ResetIndex();
+        uint32 id = message->getUint32();
+
+        ASSERT_LT(id, 4u);
+        EXPECT_EQ(next[id]++, message->getUint32());
+    }
+
+    for (uint32 i = 0; i < 4; ++i) {
+        EXPECT_EQ(1000u, next[i]);
+    }
+}
@@ -0,0 +1,89 @@
+﻿/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "NetworkManager/MessageSlabHeap.h"
+
+TEST(MessageSlabHeapTests, SizeClassesArePowersOfTwo) {
+    EXPECT_EQ(0u, MessageSlabHeap::getSizeClass(1));
+    EXPECT_EQ(0u, MessageSlabHeap::getSizeClass(64));
+    EXPECT_EQ(1u, MessageSlabHeap::getSizeClass(65));
+    EXPECT_EQ(128u, MessageSlabHeap::getBlockSize(MessageSlabHeap::getSizeClass(100)));
+
+    // a header plus the largest payload still has a class
+    EXPECT_EQ(MessageSlabHeap::SizeClassCount - 1, MessageSlabHeap::getSizeClass(0xffff + 256));
+}
+
+TEST(MessageSlabHeapTests, CountsLiveBytesPerSizeClass) {
+    MessageSlabHeap heap;
+
+    int8* small = heap.allocate(40);
+    int8* large = heap.allocate(1000);
+
+    EXPECT_EQ(64u, heap.getLiveBytes(0));
+    EXPECT_EQ(1024u, heap.getLiveBytes(MessageSlabHeap::getSizeClass(1000)));
+    EXPECT_EQ(64u + 1024u, heap.getLiveBytes());
+
+    heap.release(small, 40);
+    heap.release(large, 1000);
+
+    EXPECT_EQ(0u, heap.getLiveBytes());
+    EXPECT_EQ(0u, heap.getLiveBlocks(0));
+}
+
+TEST(MessageSlabHeapTests, ReleasedBlockIsReusedRightAway) {
+    MessageSlabHeap heap;
+
+    int8* oldest = heap.allocate(100);
+    int8* newer = heap.allocate(100);
+
+    // releasing the younger block while the oldest is still held frees it for the next allocation
+    heap.release(newer, 100);
+    EXPECT_EQ(newer, heap.allocate(100));
+
+    heap.release(oldest, 100);
+}
+
+TEST(MessageSlabHeapTests, GrowsBySlabsUnderPressure) {
+    MessageSlabHeap heap;
+    std::vector<int8*> blocks;
+
+    for(uint32 i = 0; i < (MessageSlabHeap::SlabSize / 1024) * 3; i++)
+        blocks.push_back(heap.allocate(1024));
+
+    EXPECT_EQ(3u * MessageSlabHeap::SlabSize, heap.getReservedBytes());
+
+    for(uint32 i = 0; i < blocks.size(); i++)
+        heap.release(blocks[i], 1024);
+
+    // slabs stay around for the next peak
+    EXPECT_EQ(0u, heap.getLiveBytes());
+    EXPECT_EQ(3u * MessageSlabHeap::SlabSize, heap.getReservedBytes());
+}
@@ -0,0 +1,240 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "NetworkManager/ReliableWindow.h"
+
+namespace {
+
+// The window never looks at its packets, distinct addresses are all it needs.
+class ReliableWindowTest : public ::testing::Test {
+protected:
+    ReliableWindowTest() : storage_(1024) {}
+
+    Packet* packet(uint32 index) {
+        return reinterpret_cast<Packet*>(&storage_[index]);
+    }
+
+    // Pushes count packets and sends the first sent of them.
+    void fill(ReliableWindow& window, uint32 count, uint32 sent) {
+        for (uint32 i = 0; i < count; ++i) {
+            window.push(packet(i));
+        }
+
+        for (uint32 i = 0; i < sent; ++i) {
+            window.popUnsent();
+        }
+    }
+
+    std::vector<char> storage_;
+};
+
+}
+
+TEST_F(ReliableWindowTest, HandsOutUnsentPacketsInOrder) {
+    ReliableWindow window;
+    fill(window, 3, 0);
+
+    EXPECT_EQ(packet(0), window.popUnsent());
+    EXPECT_EQ(packet(1), window.popUnsent());
+    EXPECT_EQ(packet(2), window.popUnsent());
+    EXPECT_EQ(NULL, window.popUnsent());
+
+    EXPECT_EQ(3u, window.getSentCount());
+    EXPECT_EQ(0u, window.getUnsentCount());
+}
+
+TEST_F(ReliableWindowTest, AckOnEmptyWindowIsIgnored) {
+    ReliableWindow window;
+
+    EXPECT_EQ(0u, window.getAckCount(0));
+    EXPECT_EQ(0u, window.getAckCount(0xffff));
+}
+
+TEST_F(ReliableWindowTest, CumulativeAckReleasesEverythingUpToIt) {
+    ReliableWindow window;
+    fill(window, 5, 5);
+
+    ASSERT_EQ(3u, window.getAckCount(2));
+
+    EXPECT_EQ(packet(0), window.popFront());
+    EXPECT_EQ(packet(1), window.popFront());
+    EXPECT_EQ(packet(2), window.popFront());
+
+    EXPECT_EQ(3, window.getFrontSequence());
+    EXPECT_EQ(2u, window.getSentCount());
+}
+
+TEST_F(ReliableWindowTest, DuplicateAckIsIgnored) {
+    ReliableWindow window(10);
+    fill(window, 4, 4);
+
+    window.popFront();
+    window.popFront();
+
+    // Sequence 11 was released already, sequence 9 came before the window.
+    EXPECT_EQ(0u, window.getAckCount(11));
+    EXPECT_EQ(0u, window.getAckCount(9));
+}
+
+TEST_F(ReliableWindowTest, AckForUnsentPacketIsOutOfBounds) {
+    ReliableWindow window;
+    fill(window, 6, 3);
+
+    EXPECT_EQ(3u, window.getAckCount(2));
+    EXPECT_EQ(0u, window.getAckCount(3));
+    EXPECT_EQ(0u, window.getAckCount(5));
+    EXPECT_EQ(0u, window.getAckCount(300));
+}
+
+TEST_F(ReliableWindowTest, AckAcrossSequenceRollover) {
+    ReliableWindow window(0xfffd);
+    fill(window, 6, 6);
+
+    EXPECT_EQ(0xfffd, window.getFrontSequence());
+    EXPECT_EQ(3, window.getBackSequence());
+
+    // 0xfffd, 0xfffe, 0xffff, 0 and 1 are acknowledged by an ack for 1.
+    ASSERT_EQ(5u, window.getAckCount(1));
+
+    for (uint32 i = 0; i < 5; ++i) {
+        EXPECT_EQ(packet(i), window.popFront());
+    }
+
+    EXPECT_EQ(2, window.getFrontSequence());
+    EXPECT_EQ(packet(5), window.getSent(0));
+}
+
+TEST_F(ReliableWindowTest, OldAckAfterRolloverIsIgnored) {
+    ReliableWindow window(0xfffe);
+    fill(window, 4, 4);
+
+    window.popFront();
+    window.popFront();
+
+    // Front is 0 now, a late ack for 0xffff must not release anything.
+    EXPECT_EQ(0u, window.getAckCount(0xffff));
+    EXPECT_EQ(2u, window.getAckCount(1));
+}
+
+TEST_F(ReliableWindowTest, OutOfOrderResendsWhatWasSentBeforeIt) {
+    ReliableWindow window;
+    fill(window, 8, 6);
+
+    EXPECT_EQ(4u, window.getSentCountBefore(4));
+    EXPECT_EQ(packet(3), window.getSent(3));
+
+    // Out of order packets past what we sent only resend what is on the wire.
+    EXPECT_EQ(6u, window.getSentCountBefore(7));
+    EXPECT_EQ(NULL, window.getSent(6));
+}
+
+TEST_F(ReliableWindowTest, StaleOutOfOrderResendsNothing) {
+    ReliableWindow window(100);
+    fill(window, 4, 4);
+
+    EXPECT_EQ(0u, window.getSentCountBefore(99));
+    EXPECT_EQ(0u, window.getSentCountBefore(100));
+}
+
+TEST_F(ReliableWindowTest, OutOfOrderAcrossSequenceRollover) {
+    ReliableWindow window(0xfffa);
+    fill(window, 10, 10);
+
+    // The remote got 2 but nothing from 0xfffa on, so the 8 packets before it need resending.
+    EXPECT_EQ(8u, window.getSentCountBefore(2));
+    EXPECT_EQ(packet(7), window.getSent(7));
+
+    // A bottom sequence (order channel B) from before the rollover.
+    EXPECT_EQ(4u, window.getSentCountBefore(0xfffe));
+}
+
+TEST_F(ReliableWindowTest, GrowingKeepsSequencesAcrossRollover) {
+    ReliableWindow window(0xffc0);
+    fill(window, 1000, 500);
+
+    EXPECT_EQ(1000u, window.getCount());
+    EXPECT_EQ(500u, window.getSentCount());
+
+    for (uint32 i = 0; i < 500; ++i) {
+        ASSERT_EQ(packet(i), window.getSent(i));
+    }
+
+    EXPECT_EQ(packet(500), window.popUnsent());
+
+    ASSERT_EQ(501u, window.getAckCount(static_cast<uint16>(0xffc0 + 500)));
+
+    for (uint32 i = 0; i < 501; ++i) {
+        ASSERT_EQ(packet(i), window.popFront());
+    }
+
+    EXPECT_EQ(499u, window.getUnsentCount());
+}
+
+TEST_F(ReliableWindowTest, PopFrontDrainsUnsentPackets) {
+    ReliableWindow window;
+    fill(window, 3, 1);
+
+    EXPECT_EQ(packet(0), window.popFront());
+    EXPECT_EQ(packet(1), window.popFront());
+    EXPECT_EQ(packet(2), window.popFront());
+    EXPECT_EQ(NULL, window.popFront());
+
+    EXPECT_EQ(0u, window.getCount());
+    EXPECT_EQ(3, window.getSendSequence());
+}
+
+TEST_F(ReliableWindowTest, RefusesPacketsPastTheCapAcrossRollover) {
+    ReliableWindow window(0xff00);
+    std::vector<char> storage(RELIABLE_WINDOW_MAX_COUNT + 1);
+
+    for (uint32 i = 0; i < RELIABLE_WINDOW_MAX_COUNT; ++i) {
+        EXPECT_EQ(i >= RELIABLE_WINDOW_BUILD_LIMIT, window.isFull());
+        ASSERT_TRUE(window.push(reinterpret_cast<Packet*>(&storage[i])));
+    }
+
+    EXPECT_TRUE(window.isFull());
+    EXPECT_FALSE(window.push(reinterpret_cast<Packet*>(&storage[RELIABLE_WINDOW_MAX_COUNT])));
+    EXPECT_EQ(static_cast<uint32>(RELIABLE_WINDOW_MAX_COUNT), window.getCount());
+
+    // every packet still sits in its own slot, nothing got overwritten
+    for (uint32 i = 0; i < RELIABLE_WINDOW_MAX_COUNT; ++i) {
+        ASSERT_EQ(reinterpret_cast<Packet*>(&storage[i]), window.popUnsent());
+    }
+
+    EXPECT_EQ(0u, window.getUnsentCount());
+    EXPECT_EQ(static_cast<uint32>(RELIABLE_WINDOW_MAX_COUNT), window.getAckCount(static_cast<uint16>(0xff00 + RELIABLE_WINDOW_MAX_COUNT - 1)));
+
+    // an ack frees room and the window takes packets again
+    window.popFront();
+
+    EXPECT_TRUE(window.push(reinterpret_cast<Packet*>(&storage[RELIABLE_WINDOW_MAX_COUNT])));
+    EXPECT_EQ(reinterpret_cast<Packet*>(&storage[RELIABLE_WINDOW_MAX_COUNT]), window.popUnsent());
+}
@@ -0,0 +1,98 @@
+﻿/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <gtest/gtest.h>
+
+#include "NetworkManager/Message.h"
+
+TEST(SharedMessageTests, ReferencesBodyData) {
+    int8 data[] = "shared payload";
+
+    Message body;
+    body.Init(data, sizeof(data));
+
+    Message reference;
+    reference.setSharedBody(&body);
+
+    EXPECT_EQ(body.getData(), reference.getData());
+    EXPECT_EQ(body.getSize(), reference.getSize());
+    EXPECT_EQ(&body, reference.getSharedBody());
+}
+
+TEST(SharedMessageTests, OffsetSkipsMulticastEnvelope) {
+    int8 data[] = "envelopepayload";
+
+    Message body;
+    body.Init(data, sizeof(data));
+
+    Message reference;
+    reference.setSharedBody(&body, 8);
+
+    EXPECT_EQ(body.getData() + 8, reference.getData());
+    EXPECT_EQ(body.getSize() - 8, reference.getSize());
+    EXPECT_STREQ("payload", reference.getData());
+}
+
+TEST(SharedMessageTests, OnlyHeaderCountsAgainstTheHeap) {
+    int8 data[64] = {0};
+
+    Message body;
+    body.Init(data, sizeof(data));
+
+    Message reference;
+    reference.setSharedBody(&body);
+
+    EXPECT_EQ(sizeof(Message) + sizeof(data), body.getHeapSize());
+    EXPECT_EQ(sizeof(Message), reference.getHeapSize());
+}
+
+TEST(SharedMessageTests, BodyWaitsForAllReferences) {
+    int8 data[] = "shared payload";
+
+    Message body;
+    body.Init(data, sizeof(data));
+
+    Message first;
+    Message second;
+    first.setSharedBody(&body);
+    second.setSharedBody(&body);
+
+    // The broadcaster is done with the body before the sessions packetized their references.
+    body.setPendingDelete(true);
+    EXPECT_FALSE(body.getPendingDelete());
+
+    first.setPendingDelete(true);
+    EXPECT_TRUE(first.getPendingDelete());
+    EXPECT_FALSE(body.getPendingDelete());
+
+    // Flagging a reference twice must not release the body early.
+    first.setPendingDelete(true);
+    EXPECT_FALSE(body.getPendingDelete());
+
+    second.setPendingDelete(true);
+    EXPECT_TRUE(body.getPendingDelete());
+}
@@ -0,0 +1,388 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "Utils/clock.h"
+#include "Utils/FlatSet.h"
+
+using ::Anh_Utils::Clock;
+using ::utils::FlatSet;
+
+TEST(FlatSetTests, StartsEmpty) {
+    FlatSet<uint32> set;
+
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(0u, set.size());
+    EXPECT_TRUE(set.begin() == set.end());
+}
+
+TEST(FlatSetTests, IteratesInOrderWithoutDuplicates) {
+    FlatSet<uint32> set;
+
+    EXPECT_TRUE(set.insert(5).second);
+    EXPECT_TRUE(set.insert(1).second);
+    EXPECT_TRUE(set.insert(3).second);
+    EXPECT_FALSE(set.insert(3).second);
+
+    EXPECT_EQ(3u, set.size());
+
+    std::vector<uint32> values(set.begin(), set.end());
+
+    ASSERT_EQ(3u, values.size());
+    EXPECT_EQ(1u, values[0]);
+    EXPECT_EQ(3u, values[1]);
+    EXPECT_EQ(5u, values[2]);
+}
+
+TEST(FlatSetTests, FindsAndErasesValues) {
+    FlatSet<uint32> set;
+
+    set.insert(1);
+    set.insert(2);
+    set.insert(3);
+
+    EXPECT_EQ(2u, *set.find(2));
+    EXPECT_TRUE(set.find(4) == set.end());
+
+    EXPECT_EQ(1u, set.erase(2));
+    EXPECT_EQ(0u, set.erase(2));
+
+    EXPECT_TRUE(set.find(2) == set.end());
+    EXPECT_EQ(0u, set.count(2));
+    EXPECT_EQ(2u, set.size());
+
+    // back in the slot it had
+    EXPECT_TRUE(set.insert(2).second);
+    EXPECT_EQ(1u, set.count(2));
+    EXPECT_EQ(3u, set.size());
+}
+
+TEST(FlatSetTests, EraseWhileIteratingVisitsEveryElementOnce) {
+    FlatSet<uint32> set;
+
+    for (uint32 i = 0; i < 100; ++i) {
+        set.insert(i);
+    }
+
+    uint32 visited = 0;
+    FlatSet<uint32>::iterator it = set.begin();
+
+    while (it != set.end()) {
+        ++visited;
+
+        if (*it % 2) {
+            set.erase(it++);
+            continue;
+        }
+
+        ++it;
+    }
+
+    EXPECT_EQ(100u, visited);
+    EXPECT_EQ(50u, set.size());
+
+    for (FlatSet<uint32>::const_iterator check = set.begin(); check != set.end(); ++check) {
+        EXPECT_EQ(0u, *check % 2);
+    }
+}
+
+TEST(FlatSetTests, BroadcastSurvivesReceiversLeaving) {
+    FlatSet<uint32> set;
+
+    for (uint32 i = 0; i < 10; ++i) {
+        set.insert(i);
+    }
+
+    // a receiver drops out and takes its neighbour with it while we are sending
+    std::vector<uint32> sentTo;
+    FlatSet<uint32>::const_iterator end = set.end();
+
+    for (FlatSet<uint32>::iterator it = set.begin(); it != end; ++it) {
+        sentTo.push_back(*it);
+
+        if (*it == 4) {
+            set.erase(it);
+            set.erase(5);
+        }
+    }
+
+    ASSERT_EQ(9u, sentTo.size());
+    EXPECT_EQ(4u, sentTo[4]);
+    EXPECT_EQ(6u, sentTo[5]);
+}
+
+TEST(FlatSetTests, ErasingEverythingWhileIteratingEnds) {
+    FlatSet<uint32> set;
+
+    set.insert(1);
+    set.insert(2);
+
+    FlatSet<uint32>::const_iterator end = set.end();
+    FlatSet<uint32>::iterator it = set.begin();
+
+    while (it != end) {
+        set.erase(it++);
+    }
+
+    EXPECT_TRUE(set.empty());
+    EXPECT_TRUE(set.begin() == set.end());
+}
+
+TEST(FlatSetTests, CompactsErasedSlotsOnInsert) {
+    FlatSet<uint32> set;
+
+    for (uint32 i = 0; i < 64; ++i) {
+        set.insert(i * 2);
+    }
+
+    for (uint32 i = 0; i < 48; ++i) {
+        set.erase(i * 2);
+    }
+
+    set.insert(1001);
+
+    EXPECT_EQ(17u, set.size());
+    EXPECT_EQ(1u, set.count(1001));
+    EXPECT_EQ(1u, set.count(96));
+    EXPECT_EQ(0u, set.count(94));
+
+    std::vector<uint32> values(set.begin(), set.end());
+
+    ASSERT_EQ(17u, values.size());
+    EXPECT_EQ(96u, values.front());
+    EXPECT_EQ(1001u, values.back());
+}
+
+TEST(FlatSetTests, InsertThatCompactsDoesNotSkipElementsOfAWalk) {
+    FlatSet<uint32> set;
+
+    for (uint32 i = 0; i < 64; ++i) {
+        set.insert(i * 2);
+    }
+
+    // half the slots are erased, the next insert squeezes them out and moves everything left
+    for (uint32 i = 0; i < 32; ++i) {
+        set.erase(i * 2);
+    }
+
+    std::vector<uint32> visited;
+
+    for (FlatSet<uint32>::iterator it = set.begin(); it != set.end(); ++it) {
+        visited.push_back(*it);
+
+        if (*it == 80) {
+            set.insert(1);
+        }
+    }
+
+    ASSERT_EQ(32u, visited.size());
+
+    for (uint32 i = 0; i < 32; ++i) {
+        EXPECT_EQ(64 + i * 2, visited[i]);
+    }
+}
+
+TEST(FlatSetTests, InsertBeforeTheIteratorDoesNotRepeatElements) {
+    FlatSet<uint32> set;
+
+    for (uint32 i = 1; i <= 8; ++i) {
+        set.insert(i * 10);
+    }
+
+    std::vector<uint32> visited;
+
+    for (FlatSet<uint32>::iterator it = set.begin(); it != set.end(); ++it) {
+        visited.push_back(*it);
+
+        // lands in front of the iterator and shifts the rest right
+        if (*it == 40) {
+            set.insert(5);
+        }
+    }
+
+    ASSERT_EQ(8u, visited.size());
+
+    for (uint32 i = 0; i < 8; ++i) {
+        EXPECT_EQ((i + 1) * 10, visited[i]);
+    }
+}
+
+TEST(FlatSetTests, EraseAndCompactUnderTheIteratorMovesOnToTheNextElement) {
+    FlatSet<uint32> set;
+
+    for (uint32 i = 0; i < 8; ++i) {
+        set.insert(i);
+    }
+
+    std::vector<uint32> visited;
+
+    for (FlatSet<uint32>::iterator it = set.begin(); it != set.end(); ++it) {
+        visited.push_back(*it);
+
+        // the element under the iterator goes away and the insert squeezes its slot out
+        if (*it == 3) {
+            set.erase(0);
+            set.erase(1);
+            set.erase(2);
+            set.erase(3);
+            set.insert(100);
+        }
+    }
+
+    uint32 expected[] = {0, 1, 2, 3, 4, 5, 6, 7, 100};
+
+    ASSERT_EQ(9u, visited.size());
+    EXPECT_TRUE(std::equal(visited.begin(), visited.end(), expected));
+}
+
+TEST(FlatSetTests, MatchesStdSetUnderRandomOperations) {
+    FlatSet<uint32> set;
+    std::set<uint32> reference;
+
+    srand(7);
+
+    for (uint32 i = 0; i < 20000; ++i) {
+        uint32 value = rand() % 300;
+
+        if (rand() % 3) {
+            EXPECT_EQ(reference.insert(value).second, set.insert(value).second);
+        } else {
+            EXPECT_EQ(reference.erase(value), set.erase(value));
+        }
+
+        EXPECT_EQ(reference.count(value), set.count(value));
+    }
+
+    ASSERT_EQ(reference.size(), set.size());
+    EXPECT_TRUE(std::equal(reference.begin(), reference.end(), set.begin()));
+}
+
+TEST(FlatSetTests, CopiesAreIndependent) {
+    FlatSet<uint32> set;
+
+    set.insert(1);
+    set.insert(2);
+
+    FlatSet<uint32> copy = set;
+    set.erase(1);
+
+    EXPECT_EQ(2u, copy.size());
+    EXPECT_EQ(1u, copy.count(1));
+    EXPECT_EQ(1u, set.size());
+}
+
+//======================================================================================================================
+//
+// What an object does with its known players, at crowd sizes from a quiet street to a city hub. Fill the set,
+// broadcast over it a few times, look everyone up, and let a quarter of them leave and come back.
+//
+
+namespace {
+
+struct Known {
+    uint64 id;
+};
+
+template <typename Set>
+uint64 knownObjectRounds(const std::vector<Known*>& objects, uint32 rounds) {
+    uint64 checksum = 0;
+
+    for (uint32 round = 0; round < rounds; ++round) {
+        Set set;
+
+        for (size_t i = 0; i < objects.size(); ++i) {
+            set.insert(objects[i]);
+        }
+
+        for (uint32 broadcast = 0; broadcast < 4; ++broadcast) {
+            for (typename Set::const_iterator it = set.begin(); it != set.end(); ++it) {
+                checksum += (*it)->id;
+            }
+        }
+
+        for (size_t i = 0; i < objects.size(); ++i) {
+            checksum += set.count(objects[i]);
+        }
+
+        for (size_t i = 0; i < objects.size(); i += 4) {
+            set.erase(objects[i]);
+        }
+
+        for (size_t i = 0; i < objects.size(); i += 4) {
+            set.insert(objects[i]);
+        }
+    }
+
+    return checksum;
+}
+
+}  // namespace
+
+TEST(FlatSetTests, DISABLED_BenchmarkKnownObjects) {
+    const uint32 sizes[] = {50, 100, 250, 500};
+    const uint32 totalInserts = 5000000;
+
+    Clock::Init();
+    srand(42);
+
+    printf("%10s %14s %14s\n", "entries", "std::set ms", "FlatSet ms");
+
+    for (uint32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        std::vector<Known> storage(sizes[s]);
+        std::vector<Known*> objects;
+
+        // heap objects come in no particular order
+        for (uint32 i = 0; i < sizes[s]; ++i) {
+            storage[i].id = i;
+            objects.push_back(&storage[i]);
+        }
+
+        for (uint32 i = sizes[s] - 1; i > 0; --i) {
+            std::swap(objects[i], objects[rand() % (i + 1)]);
+        }
+
+        uint32 rounds = totalInserts / sizes[s];
+
+        uint64 start = Clock::getSingleton()->getLocalTime();
+        uint64 treeChecksum = knownObjectRounds<std::set<Known*> >(objects, rounds);
+        uint64 treeTime = Clock::getSingleton()->getLocalTime() - start;
+
+        start = Clock::getSingleton()->getLocalTime();
+        uint64 flatChecksum = knownObjectRounds<FlatSet<Known*> >(objects, rounds);
+        uint64 flatTime = Clock::getSingleton()->getLocalTime() - start;
+
+        EXPECT_EQ(treeChecksum, flatChecksum);
+
+        printf("%10u %14" PRIu64 " %14" PRIu64 "\n", sizes[s], treeTime, flatTime);
+    }
+}
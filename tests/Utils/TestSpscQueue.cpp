@@ -0,0 +1,116 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <boost/thread/thread.hpp>
+#include <gtest/gtest.h>
+#include "Utils/SpscQueue.h"
+
+using ::utils::SpscQueue;
+
+namespace {
+
+void produceSequence(SpscQueue<uint32, 16>* queue, uint32 count) {
+    for (uint32 i = 0; i < count; ++i) {
+        queue->push(i);
+    }
+}
+
+}
+
+TEST(SpscQueueTests, StartsEmpty) {
+    SpscQueue<uint32> queue;
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(0u, queue.size());
+}
+
+TEST(SpscQueueTests, PopsInPushOrder) {
+    SpscQueue<uint32> queue;
+
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    EXPECT_EQ(3u, queue.size());
+
+    EXPECT_EQ(1u, queue.front());
+    queue.pop();
+    EXPECT_EQ(2u, queue.front());
+    queue.pop();
+    EXPECT_EQ(3u, queue.front());
+    queue.pop();
+
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTests, GrowsPastOneBlock) {
+    SpscQueue<uint32, 4> queue;
+
+    for (uint32 i = 0; i < 19; ++i) {
+        queue.push(i);
+    }
+
+    EXPECT_EQ(19u, queue.size());
+
+    for (uint32 i = 0; i < 19; ++i) {
+        ASSERT_FALSE(queue.empty());
+        EXPECT_EQ(i, queue.front());
+        queue.pop();
+    }
+
+    EXPECT_TRUE(queue.empty());
+
+    // The drained queue keeps working across the block boundary it stopped on.
+    queue.push(42);
+    EXPECT_EQ(42u, queue.front());
+}
+
+TEST(SpscQueueTests, HandsItemsAcrossThreadsInOrder) {
+    const uint32 count = 200000;
+    SpscQueue<uint32, 16> queue;
+
+    boost::thread producer(produceSequence, &queue, count);
+
+    uint32 expected = 0;
+    bool in_order = true;
+
+    while (expected < count) {
+        if (queue.empty()) {
+            boost::this_thread::yield();
+            continue;
+        }
+
+        in_order = in_order && (queue.front() == expected);
+        queue.pop();
+        ++expected;
+    }
+
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(queue.empty());
+}
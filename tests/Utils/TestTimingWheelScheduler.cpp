@@ -0,0 +1,216 @@
+﻿/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include "Utils/clock.h"
+#include "Utils/Scheduler.h"
+#include "Utils/TimingWheelScheduler.h"
+
+using Anh_Utils::Clock;
+using Anh_Utils::TimingWheelScheduler;
+
+namespace {
+
+class TaskCounter {
+public:
+    TaskCounter(bool repeat = true) : calls(0), repeat(repeat), scheduler(0), removeId(0) {}
+
+    bool run(uint64 callTime, void* async) {
+        ++calls;
+
+        if (scheduler && removeId) {
+            scheduler->removeTask(removeId);
+        }
+
+        return repeat;
+    }
+
+    uint32 calls;
+    bool repeat;
+    TimingWheelScheduler* scheduler;
+    uint64 removeId;
+};
+
+class TimingWheelSchedulerTests : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        Clock::Init();
+    }
+
+    FDCallback callback(TaskCounter& counter) {
+        return fastdelegate::MakeDelegate(&counter, &TaskCounter::run);
+    }
+
+    uint64 now() {
+        return Clock::getSingleton()->getLocalTime();
+    }
+};
+
+}  // namespace
+
+TEST_F(TimingWheelSchedulerTests, RunsTaskOnceIntervalPassed) {
+    TimingWheelScheduler scheduler;
+    TaskCounter counter;
+
+    uint64 start = now();
+    scheduler.addTask(callback(counter), 1, 100, NULL);
+
+    scheduler.processUntil(start + 50);
+    EXPECT_EQ(0u, counter.calls);
+
+    scheduler.processUntil(start + 110);
+    EXPECT_EQ(1u, counter.calls);
+
+    // the next run is an interval after the last one
+    scheduler.processUntil(start + 180);
+    EXPECT_EQ(1u, counter.calls);
+
+    scheduler.processUntil(start + 220);
+    EXPECT_EQ(2u, counter.calls);
+}
+
+TEST_F(TimingWheelSchedulerTests, CallbackReturningFalseRemovesTask) {
+    TimingWheelScheduler scheduler;
+    TaskCounter counter(false);
+
+    uint64 start = now();
+    uint64 id = scheduler.addTask(callback(counter), 1, 10, NULL);
+    EXPECT_TRUE(scheduler.checkTask(id));
+
+    scheduler.processUntil(start + 1000);
+
+    EXPECT_EQ(1u, counter.calls);
+    EXPECT_FALSE(scheduler.checkTask(id));
+    EXPECT_EQ(0u, scheduler.getTaskCount());
+}
+
+TEST_F(TimingWheelSchedulerTests, RemovedTaskNeverRuns) {
+    TimingWheelScheduler scheduler;
+    TaskCounter removed;
+    TaskCounter kept;
+
+    uint64 start = now();
+    uint64 removedId = scheduler.addTask(callback(removed), 1, 100, NULL);
+    scheduler.removeTask(removedId);
+
+    // the new task reuses the node, the stale id must not touch it
+    uint64 keptId = scheduler.addTask(callback(kept), 1, 100, NULL);
+    scheduler.removeTask(removedId);
+
+    EXPECT_NE(removedId, keptId);
+    EXPECT_FALSE(scheduler.checkTask(removedId));
+    EXPECT_TRUE(scheduler.checkTask(keptId));
+
+    scheduler.processUntil(start + 150);
+
+    EXPECT_EQ(0u, removed.calls);
+    EXPECT_EQ(1u, kept.calls);
+}
+
+TEST_F(TimingWheelSchedulerTests, TaskCanRemoveItselfWhileRunning) {
+    TimingWheelScheduler scheduler;
+    TaskCounter counter;
+
+    uint64 start = now();
+    counter.scheduler = &scheduler;
+    counter.removeId = scheduler.addTask(callback(counter), 1, 10, NULL);
+
+    scheduler.processUntil(start + 1000);
+
+    EXPECT_EQ(1u, counter.calls);
+    EXPECT_FALSE(scheduler.checkTask(counter.removeId));
+}
+
+TEST_F(TimingWheelSchedulerTests, LongIntervalsCascadeDown) {
+    TimingWheelScheduler scheduler;
+    TaskCounter minute;
+    TaskCounter hours;
+
+    uint64 start = now();
+    scheduler.addTask(callback(minute), 1, 70000, NULL);
+    scheduler.addTask(callback(hours), 1, 5 * 3600 * 1000, NULL);
+
+    scheduler.processUntil(start + 69000);
+    EXPECT_EQ(0u, minute.calls);
+
+    scheduler.processUntil(start + 70010);
+    EXPECT_EQ(1u, minute.calls);
+
+    scheduler.processUntil(start + 5 * 3600 * 1000 - 1000);
+    EXPECT_EQ(0u, hours.calls);
+
+    scheduler.processUntil(start + 5 * 3600 * 1000 + 10);
+    EXPECT_EQ(1u, hours.calls);
+}
+
+// Compares a process() call with 100k registered tasks of which only a few are due, like the ham, stomach and
+// object controller schedulers of a busy zone.
+// Run with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F(TimingWheelSchedulerTests, DISABLED_Benchmark100kTasks) {
+    const uint32 taskCount = 100000;
+    const uint32 frames = 20;
+
+    TaskCounter scheduledCounter;
+    TaskCounter wheelCounter;
+
+    // no time limit, we want to see what a whole pass costs
+    Anh_Utils::Scheduler scheduler(100000);
+    TimingWheelScheduler wheel(100000);
+
+    srand(42);
+
+    for (uint32 i = 0; i < taskCount; ++i) {
+        uint64 interval = 1000 + rand() % 59000;
+
+        scheduler.addTask(callback(scheduledCounter), 1, interval, NULL);
+        wheel.addTask(callback(wheelCounter), 1, interval, NULL);
+    }
+
+    uint64 schedulerTime = 0;
+    uint64 wheelTime = 0;
+
+    for (uint32 frame = 0; frame < frames; ++frame) {
+        uint64 frameStart = now();
+        scheduler.process();
+        schedulerTime += now() - frameStart;
+
+        frameStart = now();
+        wheel.process();
+        wheelTime += now() - frameStart;
+
+        // a zone frame is 100ms
+        while (now() - frameStart < 100) {}
+    }
+
+    printf("%u tasks, %u frames\n", taskCount, frames);
+    printf("Scheduler:            %6.2f ms per process, %u callbacks\n", static_cast<double>(schedulerTime) / frames, scheduledCounter.calls);
+    printf("TimingWheelScheduler: %6.2f ms per process, %u callbacks\n", static_cast<double>(wheelTime) / frames, wheelCounter.calls);
+}
@@ -0,0 +1,136 @@
+﻿/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ZoneServer/CellContentIndex.h"
+
+namespace {
+
+// the ObjectType bits the range queries ask for
+const uint32 kCreature = 1;
+const uint32 kPlayer = 2;
+const uint32 kTangible = 16;
+
+// the ids a range query with objTypes walks, as CellObject::getContent does
+std::vector<uint64> idsOf(const CellContentIndex& index, uint32 objTypes) {
+    std::vector<uint64> ids;
+
+    for (uint32 bucket = 0; bucket < index.getBucketCount(); ++bucket) {
+        if (index.bucketMatches(bucket, objTypes)) {
+            ids.insert(ids.end(), index.getBucketIds(bucket).begin(), index.getBucketIds(bucket).end());
+        }
+    }
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+}  // namespace
+
+TEST(CellContentIndexTest, QueriesOnlyWalkTheRequestedTypes) {
+    CellContentIndex index;
+
+    index.add(1, kPlayer);
+    index.add(2, kTangible);
+    index.add(3, kCreature);
+    index.add(4, kPlayer);
+
+    EXPECT_EQ(4u, index.size());
+    EXPECT_EQ(3u, index.getBucketCount());
+
+    std::vector<uint64> players = idsOf(index, kPlayer);
+    ASSERT_EQ(2u, players.size());
+    EXPECT_EQ(1u, players[0]);
+    EXPECT_EQ(4u, players[1]);
+
+    EXPECT_EQ(3u, idsOf(index, kPlayer | kCreature).size());
+    EXPECT_EQ(4u, idsOf(index, kPlayer | kCreature | kTangible).size());
+    EXPECT_TRUE(idsOf(index, 0).empty());
+}
+
+TEST(CellContentIndexTest, RemoveFindsTheIdInAnyBucket) {
+    CellContentIndex index;
+
+    index.add(1, kPlayer);
+    index.add(2, kTangible);
+    index.add(3, kTangible);
+
+    EXPECT_TRUE(index.remove(2));
+    EXPECT_FALSE(index.remove(2));
+    EXPECT_FALSE(index.remove(42));
+
+    EXPECT_EQ(2u, index.size());
+    ASSERT_EQ(1u, idsOf(index, kTangible).size());
+    EXPECT_EQ(3u, idsOf(index, kTangible)[0]);
+}
+
+TEST(CellContentIndexTest, IdsAddedTwiceAreRemovedTwice) {
+    CellContentIndex index;
+
+    index.add(7, kCreature);
+    index.add(7, kCreature);
+
+    EXPECT_EQ(2u, idsOf(index, kCreature).size());
+    EXPECT_TRUE(index.remove(7));
+    EXPECT_EQ(1u, index.size());
+    EXPECT_TRUE(index.remove(7));
+    EXPECT_EQ(0u, index.size());
+    EXPECT_TRUE(idsOf(index, kCreature).empty());
+}
+
+TEST(CellContentIndexTest, StaysInStepWithAContainerThroughMixedAddsAndRemoves) {
+    CellContentIndex index;
+    std::vector<uint64> container;
+
+    srand(3);
+
+    for (uint32 i = 0; i < 2000; ++i) {
+        if (container.empty() || rand() % 3) {
+            uint64 id = static_cast<uint64>(rand() % 200);
+
+            container.push_back(id);
+            index.add(id, 1u << (id % 5));
+        } else {
+            size_t at = rand() % container.size();
+
+            EXPECT_TRUE(index.remove(container[at]));
+            container.erase(container.begin() + at);
+        }
+
+        ASSERT_EQ(container.size(), index.size());
+    }
+
+    std::vector<uint64> expected = container;
+    std::sort(expected.begin(), expected.end());
+
+    EXPECT_EQ(expected, idsOf(index, 0xffffffff));
+}
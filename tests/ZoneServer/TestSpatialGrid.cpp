@@ -0,0 +1,706 @@
+﻿/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+#include <gtest/gtest.h>
+#include <SpatialIndex.h>
+
+#include "Utils/clock.h"
+#include "ZoneServer/SpatialGrid.h"
+
+using Anh_Utils::Clock;
+
+namespace {
+
+// what the grid needs of an Object
+class GridObject {
+public:
+    GridObject(uint64 id, uint32 type, float x, float z) : mPosition(x, 0.0f, z), mId(id), mType(type) {}
+
+    uint32 getType() const {
+        return mType;
+    }
+    uint64 getId() const {
+        return mId;
+    }
+
+    glm::vec3 mPosition;
+    uint64 mId;
+    uint32 mType;
+};
+
+typedef SpatialGrid<GridObject> TestGrid;
+
+const uint32 kPlayer = 1;
+const uint32 kCreature = 2;
+
+// a planet sized region with 64m cells, as a depth 8 QTRegion
+TestGrid* createGrid() {
+    return new TestGrid(-8192.0f, -8192.0f, 16384.0f, 16384.0f, 64.0f);
+}
+
+// query rectangle as the ObjectControllers build them, range around the object
+Anh_Math::Rectangle rangeAround(const GridObject& object, float range) {
+    return Anh_Math::Rectangle(object.mPosition.x - range, object.mPosition.z - range, range * 2.0f, range * 2.0f);
+}
+
+}  // namespace
+
+TEST(SpatialGridTest, FindsObjectsInRangeButNotItself) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 100.0f, 100.0f);
+    GridObject near(2, kCreature, 150.0f, 120.0f);
+    GridObject far(3, kCreature, 2000.0f, 2000.0f);
+
+    EXPECT_EQ(1, grid->addObject(&player));
+    EXPECT_EQ(1, grid->addObject(&near));
+    EXPECT_EQ(1, grid->addObject(&far));
+    EXPECT_EQ(3, grid->getObjectCount());
+
+    Anh_Math::Rectangle range = rangeAround(player, 128.0f);
+    TestGrid::ResultSet result;
+    grid->getObjectsInRange(&player, &result, kPlayer | kCreature, &range);
+
+    EXPECT_EQ(1, result.size());
+    EXPECT_EQ(1, result.count(&near));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, TypeMaskFiltersResults) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 0.0f, 0.0f);
+    GridObject otherPlayer(2, kPlayer, 10.0f, 10.0f);
+    GridObject creature(3, kCreature, 20.0f, 20.0f);
+
+    grid->addObject(&player);
+    grid->addObject(&otherPlayer);
+    grid->addObject(&creature);
+
+    Anh_Math::Rectangle range = rangeAround(player, 64.0f);
+    TestGrid::ResultSet result;
+    grid->getObjectsInRange(&player, &result, kPlayer, &range);
+
+    EXPECT_EQ(1, result.size());
+    EXPECT_EQ(1, result.count(&otherPlayer));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, UpdateMovesObjectBetweenCells) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 0.0f, 0.0f);
+    GridObject mover(2, kCreature, 10.0f, 10.0f);
+
+    grid->addObject(&player);
+    grid->addObject(&mover);
+
+    // within its cell
+    grid->updateObject(&mover, glm::vec3(20.0f, 0.0f, 20.0f));
+    EXPECT_EQ(20.0f, mover.mPosition.x);
+
+    // far away, into another cell
+    grid->updateObject(&mover, glm::vec3(3000.0f, 0.0f, 3000.0f));
+    EXPECT_EQ(2, grid->getObjectCount());
+
+    Anh_Math::Rectangle range = rangeAround(player, 128.0f);
+    TestGrid::ResultSet result;
+    grid->getObjectsInRange(&player, &result, kCreature, &range);
+    EXPECT_TRUE(result.empty());
+
+    range = rangeAround(mover, 16.0f);
+    grid->getObjectsInRange(&player, &result, kCreature, &range);
+    EXPECT_EQ(1, result.count(&mover));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, RemoveFindsObjectAfterItsPositionChanged) {
+    TestGrid* grid = createGrid();
+
+    GridObject mover(1, kCreature, 0.0f, 0.0f);
+    grid->addObject(&mover);
+
+    // moved without telling the grid
+    mover.mPosition = glm::vec3(5000.0f, 0.0f, 5000.0f);
+
+    EXPECT_EQ(1, grid->removeObject(&mover));
+    EXPECT_EQ(2, grid->removeObject(&mover));
+    EXPECT_EQ(0, grid->getObjectCount());
+
+    Anh_Math::Rectangle range(-100.0f, -100.0f, 200.0f, 200.0f);
+    TestGrid::ResultSet result;
+    grid->getObjectsInRange(NULL, &result, kCreature, &range);
+    EXPECT_TRUE(result.empty());
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, AddingTwiceIsRefused) {
+    TestGrid* grid = createGrid();
+
+    GridObject object(1, kCreature, 0.0f, 0.0f);
+
+    EXPECT_EQ(1, grid->addObject(&object));
+    EXPECT_EQ(2, grid->addObject(&object));
+    EXPECT_EQ(1, grid->getObjectCount());
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, ContainsQueryChecksEveryObject) {
+    TestGrid* grid = createGrid();
+
+    // both in the same 64m cell
+    GridObject inside(1, kPlayer, 5.0f, 5.0f);
+    GridObject outside(2, kPlayer, 50.0f, 50.0f);
+
+    grid->addObject(&inside);
+    grid->addObject(&outside);
+
+    Anh_Math::Rectangle camp(0.0f, 0.0f, 10.0f, 10.0f);
+    TestGrid::ResultSet result;
+
+    grid->getObjectsInRange(NULL, &result, kPlayer, &camp);
+    EXPECT_EQ(2, result.size());
+
+    result.clear();
+    grid->getObjectsInRangeContains(NULL, &result, kPlayer, &camp);
+    EXPECT_EQ(1, result.size());
+    EXPECT_EQ(1, result.count(&inside));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, ObjectsOutsideTheRegionStayInBorderCells) {
+    TestGrid* grid = createGrid();
+
+    GridObject object(1, kCreature, 9000.0f, -9000.0f);
+    grid->addObject(&object);
+
+    Anh_Math::Rectangle corner(8100.0f, -8192.0f, 92.0f, 92.0f);
+    TestGrid::ResultSet result;
+    grid->getObjectsInRange(NULL, &result, kCreature, &corner);
+
+    EXPECT_EQ(1, result.count(&object));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, LargeQueryOverSparseGridFindsEverything) {
+    TestGrid* grid = createGrid();
+
+    GridObject a(1, kCreature, -8000.0f, -8000.0f);
+    GridObject b(2, kCreature, 8000.0f, 8000.0f);
+
+    grid->addObject(&a);
+    grid->addObject(&b);
+
+    Anh_Math::Rectangle everything(-8192.0f, -8192.0f, 16384.0f, 16384.0f);
+    TestGrid::ResultSet result;
+    grid->getObjectsInRange(NULL, &result, kCreature, &everything);
+
+    EXPECT_EQ(2, result.size());
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, SubscribingQueuesEverythingInTheWindow) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 0.0f, 0.0f);
+    GridObject near(2, kCreature, 100.0f, 100.0f);
+    GridObject far(3, kCreature, 1000.0f, 1000.0f);
+    GridObject inBuilding(4, kPlayer, 0.0f, 0.0f);
+
+    grid->addObject(&player);
+    grid->addObject(&near);
+    grid->addObject(&far);
+
+    // only what is in the grid can subscribe
+    EXPECT_FALSE(grid->subscribe(&inBuilding, kCreature, 128.0f));
+    EXPECT_TRUE(grid->subscribe(&player, kCreature, 128.0f));
+    EXPECT_TRUE(grid->isSubscribed(&player));
+
+    TestGrid::ResultSet entered, left;
+    grid->getInterestChanges(&player, &entered, &left);
+
+    EXPECT_EQ(1, entered.size());
+    EXPECT_EQ(1, entered.count(&near));
+    EXPECT_TRUE(left.empty());
+
+    // handed over, nothing changed since
+    entered.clear();
+    grid->getInterestChanges(&player, &entered, &left);
+    EXPECT_TRUE(entered.empty());
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, ObjectsCrossingTheWindowAreQueued) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 0.0f, 0.0f);
+    GridObject mover(2, kCreature, 1000.0f, 0.0f);
+
+    grid->addObject(&player);
+    grid->addObject(&mover);
+    grid->subscribe(&player, kCreature, 128.0f);
+
+    TestGrid::ResultSet entered, left;
+
+    // moving around far away is nobodies business
+    grid->updateObject(&mover, glm::vec3(900.0f, 0.0f, 0.0f));
+    grid->getInterestChanges(&player, &entered, &left);
+    EXPECT_TRUE(entered.empty());
+    EXPECT_TRUE(left.empty());
+
+    grid->updateObject(&mover, glm::vec3(50.0f, 0.0f, 0.0f));
+    grid->getInterestChanges(&player, &entered, &left);
+    EXPECT_EQ(1, entered.count(&mover));
+    EXPECT_TRUE(left.empty());
+
+    entered.clear();
+    grid->updateObject(&mover, glm::vec3(900.0f, 0.0f, 0.0f));
+    grid->getInterestChanges(&player, &entered, &left);
+    EXPECT_TRUE(entered.empty());
+    EXPECT_EQ(1, left.count(&mover));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, LastChangeWinsBetweenHandovers) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 0.0f, 0.0f);
+    GridObject mover(2, kCreature, 1000.0f, 0.0f);
+
+    grid->addObject(&player);
+    grid->addObject(&mover);
+    grid->subscribe(&player, kCreature, 128.0f);
+
+    grid->updateObject(&mover, glm::vec3(50.0f, 0.0f, 0.0f));
+    grid->updateObject(&mover, glm::vec3(1000.0f, 0.0f, 0.0f));
+    grid->updateObject(&mover, glm::vec3(60.0f, 0.0f, 0.0f));
+
+    TestGrid::ResultSet entered, left;
+    grid->getInterestChanges(&player, &entered, &left);
+
+    EXPECT_EQ(1, entered.count(&mover));
+    EXPECT_TRUE(left.empty());
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, WindowMovesWithTheSubscriber) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 0.0f, 0.0f);
+    GridObject here(2, kCreature, 10.0f, 10.0f);
+    GridObject there(3, kCreature, 2000.0f, 10.0f);
+
+    grid->addObject(&player);
+    grid->addObject(&here);
+    grid->addObject(&there);
+    grid->subscribe(&player, kCreature, 128.0f);
+
+    TestGrid::ResultSet entered, left;
+    grid->getInterestChanges(&player, &entered, &left);
+    entered.clear();
+
+    grid->updateObject(&player, glm::vec3(1990.0f, 0.0f, 0.0f));
+    grid->getInterestChanges(&player, &entered, &left);
+
+    EXPECT_EQ(1, entered.size());
+    EXPECT_EQ(1, entered.count(&there));
+    EXPECT_EQ(1, left.size());
+    EXPECT_EQ(1, left.count(&here));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, WindowCoversTheSubscribedRange) {
+    TestGrid* grid = createGrid();
+
+    // right at the border of the players cell, 127m away
+    GridObject player(1, kPlayer, 63.0f, 0.0f);
+    GridObject mover(2, kCreature, 190.0f, 0.0f);
+
+    grid->addObject(&player);
+    grid->addObject(&mover);
+    grid->subscribe(&player, kCreature, 128.0f);
+
+    TestGrid::ResultSet entered, left;
+    grid->getInterestChanges(&player, &entered, &left);
+    EXPECT_EQ(1, entered.count(&mover));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, RemovedObjectsAreNoLongerHandedOut) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 0.0f, 0.0f);
+    GridObject stays(2, kCreature, 10.0f, 0.0f);
+    GridObject leaves(3, kCreature, 20.0f, 0.0f);
+
+    grid->addObject(&player);
+    grid->subscribe(&player, kCreature, 128.0f);
+
+    grid->addObject(&stays);
+    grid->addObject(&leaves);
+
+    // despawned or went into a building, whoever removes it sends its destroys
+    grid->removeObject(&leaves);
+
+    TestGrid::ResultSet entered, left;
+    grid->getInterestChanges(&player, &entered, &left);
+
+    EXPECT_EQ(1, entered.size());
+    EXPECT_EQ(1, entered.count(&stays));
+    EXPECT_TRUE(left.empty());
+
+    // removing the subscriber drops its subscription
+    grid->removeObject(&player);
+    EXPECT_FALSE(grid->isSubscribed(&player));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, ResubscribingWithSmallerRangeShrinksTheWindow) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 10.0f, 10.0f);
+    GridObject mover(2, kCreature, 200.0f, 10.0f);
+
+    grid->addObject(&player);
+    grid->addObject(&mover);
+    grid->subscribe(&player, kPlayer | kCreature, 256.0f);
+
+    TestGrid::ResultSet entered, left;
+    grid->getInterestChanges(&player, &entered, &left);
+    EXPECT_EQ(1, entered.count(&mover));
+
+    // the server scales the viewing range down under load
+    entered.clear();
+    grid->subscribe(&player, kPlayer | kCreature, 64.0f);
+    grid->getInterestChanges(&player, &entered, &left);
+
+    EXPECT_TRUE(entered.empty());
+    EXPECT_EQ(1, left.count(&mover));
+
+    delete grid;
+}
+
+TEST(SpatialGridTest, WindowsOverEmptyCellsCreateNoCells) {
+    TestGrid* grid = createGrid();
+
+    GridObject player(1, kPlayer, 0.0f, 0.0f);
+    GridObject creature(2, kCreature, 100.0f, 100.0f);
+
+    grid->addObject(&player);
+    grid->addObject(&creature);
+    EXPECT_EQ(2u, grid->getCellCount());
+
+    // a 17x17 window, and dragged across the map it touches a lot more
+    grid->subscribe(&player, kCreature, 512.0f);
+    EXPECT_EQ(2u, grid->getCellCount());
+
+    for (float x = 0.0f; x < 4000.0f; x += 50.0f) {
+        grid->updateObject(&player, glm::vec3(x, 0.0f, 0.0f));
+    }
+
+    EXPECT_EQ(2u, grid->getCellCount());
+
+    // cells go away with their last object
+    grid->removeObject(&creature);
+    EXPECT_EQ(1u, grid->getCellCount());
+
+    grid->removeObject(&player);
+    EXPECT_EQ(0u, grid->getCellCount());
+
+    delete grid;
+}
+
+//======================================================================================================================
+//
+// Mos Eisley at a busy hour, 1500 players and 2500 creatures and npcs on 2x2km. Every frame everyone moves a few
+// meters and every player looks around within the viewing range. The R*-tree is set up as the ZoneTree does, moves
+// are a delete and insert, and every hit is looked up by id as ZoneTree asks the WorldManager.
+//
+
+namespace {
+
+class IdVisitor : public SpatialIndex::IVisitor {
+public:
+    explicit IdVisitor(std::vector<int64>* ids) : mIds(ids) {}
+
+    void visitNode(const SpatialIndex::INode& n) {}
+    void visitData(const SpatialIndex::IData& d) {
+        mIds->push_back(d.getIdentifier());
+    }
+    void visitData(std::vector<const SpatialIndex::IData*>& v) {}
+
+private:
+    std::vector<int64>* mIds;
+};
+
+SpatialIndex::Point pointOf(const GridObject& object) {
+    double coords[2] = {object.mPosition.x, object.mPosition.z};
+    return SpatialIndex::Point(coords, 2);
+}
+
+}  // namespace
+
+TEST(SpatialGridTest, DISABLED_BenchmarkMosEisleyPopulation) {
+    const uint32 playerCount = 1500;
+    const uint32 creatureCount = 2500;
+    const uint32 frames = 50;
+    const float viewingRange = 128.0f;
+
+    Clock::Init();
+
+    std::vector<GridObject> objects;
+    objects.reserve(playerCount + creatureCount);
+
+    srand(42);
+
+    for (uint32 i = 0; i < playerCount + creatureCount; ++i) {
+        float x = 2500.0f + static_cast<float>(rand() % 2000);
+        float z = -5800.0f + static_cast<float>(rand() % 2000);
+
+        objects.push_back(GridObject(i + 1, (i < playerCount) ? kPlayer : kCreature, x, z));
+    }
+
+    // every frame moves everyone by the same steps in both indexes
+    std::vector<glm::vec3> steps(objects.size());
+
+    for (size_t i = 0; i < steps.size(); ++i) {
+        steps[i] = glm::vec3(static_cast<float>(rand() % 13 - 6), 0.0f, static_cast<float>(rand() % 13 - 6));
+    }
+
+    std::vector<GridObject> treeObjects = objects;
+    boost::unordered_map<int64, GridObject*> objectsById;
+
+    SpatialIndex::IStorageManager* storage = SpatialIndex::StorageManager::createNewMemoryStorageManager();
+    SpatialIndex::StorageManager::IBuffer* buffer = SpatialIndex::StorageManager::createNewRandomEvictionsBuffer(*storage, 200, false);
+    int64 indexIdentifier = 0;
+    SpatialIndex::ISpatialIndex* tree = SpatialIndex::RTree::createNewRTree(*buffer, 0.7, 100, 100, 2, SpatialIndex::RTree::RV_RSTAR, indexIdentifier);
+
+    TestGrid* grid = createGrid();
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        grid->addObject(&objects[i]);
+
+        tree->insertData(0, 0, pointOf(treeObjects[i]), treeObjects[i].mId);
+        objectsById[treeObjects[i].mId] = &treeObjects[i];
+    }
+
+    uint64 gridUpdateTime = 0, gridQueryTime = 0, treeUpdateTime = 0, treeQueryTime = 0;
+    uint64 gridResults = 0, treeResults = 0;
+
+    for (uint32 frame = 0; frame < frames; ++frame) {
+        uint64 start = Clock::getSingleton()->getLocalTime();
+
+        for (size_t i = 0; i < objects.size(); ++i) {
+            grid->updateObject(&objects[i], objects[i].mPosition + steps[(i + frame) % steps.size()]);
+        }
+
+        gridUpdateTime += Clock::getSingleton()->getLocalTime() - start;
+        start = Clock::getSingleton()->getLocalTime();
+
+        for (uint32 i = 0; i < playerCount; ++i) {
+            Anh_Math::Rectangle range = rangeAround(objects[i], viewingRange);
+            TestGrid::ResultSet result;
+
+            grid->getObjectsInRange(&objects[i], &result, kPlayer | kCreature, &range);
+            gridResults += result.size();
+        }
+
+        gridQueryTime += Clock::getSingleton()->getLocalTime() - start;
+        start = Clock::getSingleton()->getLocalTime();
+
+        for (size_t i = 0; i < treeObjects.size(); ++i) {
+            tree->deleteData(pointOf(treeObjects[i]), treeObjects[i].mId);
+            treeObjects[i].mPosition += steps[(i + frame) % steps.size()];
+            tree->insertData(0, 0, pointOf(treeObjects[i]), treeObjects[i].mId);
+        }
+
+        treeUpdateTime += Clock::getSingleton()->getLocalTime() - start;
+        start = Clock::getSingleton()->getLocalTime();
+
+        for (uint32 i = 0; i < playerCount; ++i) {
+            const GridObject& player = treeObjects[i];
+
+            double low[2] = {player.mPosition.x - viewingRange, player.mPosition.z - viewingRange};
+            double high[2] = {player.mPosition.x + viewingRange, player.mPosition.z + viewingRange};
+
+            std::vector<int64> ids;
+            ids.reserve(100);
+            IdVisitor visitor(&ids);
+
+            tree->intersectsWithQuery(SpatialIndex::Region(low, high, 2), visitor);
+
+            TestGrid::ResultSet result;
+
+            for (std::vector<int64>::iterator it = ids.begin(); it != ids.end(); ++it) {
+                GridObject* object = objectsById[*it];
+
+                if (object != &player) {
+                    result.insert(object);
+                }
+            }
+
+            treeResults += result.size();
+        }
+
+        treeQueryTime += Clock::getSingleton()->getLocalTime() - start;
+    }
+
+    printf("%u players, %u creatures, %u frames\n", playerCount, creatureCount, frames);
+    printf("R*-tree:     %7.2f ms updates, %7.2f ms queries per frame, %6.1f objects per query\n",
+           static_cast<double>(treeUpdateTime) / frames, static_cast<double>(treeQueryTime) / frames,
+           static_cast<double>(treeResults) / (frames * playerCount));
+    printf("SpatialGrid: %7.2f ms updates, %7.2f ms queries per frame, %6.1f objects per query\n",
+           static_cast<double>(gridUpdateTime) / frames, static_cast<double>(gridQueryTime) / frames,
+           static_cast<double>(gridResults) / (frames * playerCount));
+
+    delete grid;
+    delete tree;
+    delete buffer;
+    delete storage;
+}
+
+//======================================================================================================================
+//
+// The same crowd, a world update for every player each frame. Rescanning the viewing range against taking the
+// changes from a subscription.
+//
+
+TEST(SpatialGridTest, DISABLED_BenchmarkInterestManagement) {
+    const uint32 playerCount = 1500;
+    const uint32 creatureCount = 2500;
+    const uint32 frames = 50;
+    const float viewingRange = 128.0f;
+
+    Clock::Init();
+
+    std::vector<GridObject> objects;
+    objects.reserve(playerCount + creatureCount);
+
+    srand(42);
+
+    for (uint32 i = 0; i < playerCount + creatureCount; ++i) {
+        float x = 2500.0f + static_cast<float>(rand() % 2000);
+        float z = -5800.0f + static_cast<float>(rand() % 2000);
+
+        objects.push_back(GridObject(i + 1, (i < playerCount) ? kPlayer : kCreature, x, z));
+    }
+
+    std::vector<glm::vec3> steps(objects.size());
+
+    for (size_t i = 0; i < steps.size(); ++i) {
+        steps[i] = glm::vec3(static_cast<float>(rand() % 13 - 6), 0.0f, static_cast<float>(rand() % 13 - 6));
+    }
+
+    std::vector<GridObject> subscribedObjects = objects;
+
+    TestGrid* grid = createGrid();
+    TestGrid* subscribedGrid = createGrid();
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        grid->addObject(&objects[i]);
+        subscribedGrid->addObject(&subscribedObjects[i]);
+    }
+
+    for (uint32 i = 0; i < playerCount; ++i) {
+        subscribedGrid->subscribe(&subscribedObjects[i], kPlayer | kCreature, viewingRange);
+
+        TestGrid::ResultSet entered, left;
+        subscribedGrid->getInterestChanges(&subscribedObjects[i], &entered, &left);
+    }
+
+    uint64 rescanUpdateTime = 0, rescanTime = 0, subscribedUpdateTime = 0, subscribedTime = 0;
+    uint64 rescanResults = 0, changes = 0;
+
+    for (uint32 frame = 0; frame < frames; ++frame) {
+        uint64 start = Clock::getSingleton()->getLocalTime();
+
+        for (size_t i = 0; i < objects.size(); ++i) {
+            grid->updateObject(&objects[i], objects[i].mPosition + steps[(i + frame) % steps.size()]);
+        }
+
+        rescanUpdateTime += Clock::getSingleton()->getLocalTime() - start;
+        start = Clock::getSingleton()->getLocalTime();
+
+        for (uint32 i = 0; i < playerCount; ++i) {
+            Anh_Math::Rectangle range = rangeAround(objects[i], viewingRange);
+            TestGrid::ResultSet result;
+
+            grid->getObjectsInRange(&objects[i], &result, kPlayer | kCreature, &range);
+            rescanResults += result.size();
+        }
+
+        rescanTime += Clock::getSingleton()->getLocalTime() - start;
+        start = Clock::getSingleton()->getLocalTime();
+
+        for (size_t i = 0; i < subscribedObjects.size(); ++i) {
+            subscribedGrid->updateObject(&subscribedObjects[i], subscribedObjects[i].mPosition + steps[(i + frame) % steps.size()]);
+        }
+
+        subscribedUpdateTime += Clock::getSingleton()->getLocalTime() - start;
+        start = Clock::getSingleton()->getLocalTime();
+
+        for (uint32 i = 0; i < playerCount; ++i) {
+            TestGrid::ResultSet entered, left;
+
+            subscribedGrid->getInterestChanges(&subscribedObjects[i], &entered, &left);
+            changes += entered.size() + left.size();
+        }
+
+        subscribedTime += Clock::getSingleton()->getLocalTime() - start;
+    }
+
+    printf("%u players, %u creatures, %u frames\n", playerCount, creatureCount, frames);
+    printf("rescan:       %7.2f ms updates, %7.2f ms world updates per frame, %6.1f objects per player\n",
+           static_cast<double>(rescanUpdateTime) / frames, static_cast<double>(rescanTime) / frames,
+           static_cast<double>(rescanResults) / (frames * playerCount));
+    printf("subscription: %7.2f ms updates, %7.2f ms world updates per frame, %6.1f changes per player\n",
+           static_cast<double>(subscribedUpdateTime) / frames, static_cast<double>(subscribedTime) / frames,
+           static_cast<double>(changes) / (frames * playerCount));
+
+    delete grid;
+    delete subscribedGrid;
+}
@@ -0,0 +1,328 @@
+﻿/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <SpatialIndex.h>
+
+#include "Utils/clock.h"
+#include "ZoneServer/StaticRTree.h"
+
+using Anh_Utils::Clock;
+
+namespace {
+
+struct TestBox {
+    int64 id;
+    double lowX, lowZ, highX, highZ;
+};
+
+// buildings as ZoneTree::InsertRegion stores them and statics as points, spread over 4x4km
+std::vector<TestBox> createStatics(uint32 count) {
+    std::vector<TestBox> boxes;
+
+    for (uint32 i = 0; i < count; ++i) {
+        TestBox box;
+        box.id = i + 1;
+        box.lowX = static_cast<double>(rand() % 4000 - 2000);
+        box.lowZ = static_cast<double>(rand() % 4000 - 2000);
+        box.highX = box.lowX;
+        box.highZ = box.lowZ;
+
+        if (i % 10 == 0) {
+            box.highX += rand() % 64;
+            box.highZ += rand() % 64;
+        }
+
+        boxes.push_back(box);
+    }
+
+    return boxes;
+}
+
+std::vector<int64> linearScan(const std::vector<TestBox>& boxes, double lowX, double lowZ, double highX, double highZ) {
+    std::vector<int64> ids;
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (boxes[i].lowX <= highX && lowX <= boxes[i].highX && boxes[i].lowZ <= highZ && lowZ <= boxes[i].highZ) {
+            ids.push_back(boxes[i].id);
+        }
+    }
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+std::vector<int64> query(const StaticRTree& tree, double lowX, double lowZ, double highX, double highZ) {
+    StaticRTree::IdList ids;
+
+    tree.intersects(lowX, lowZ, highX, highZ, &ids);
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+}  // namespace
+
+TEST(StaticRTreeTest, EmptyTreeFindsNothing) {
+    StaticRTree tree;
+
+    tree.build();
+
+    EXPECT_TRUE(query(tree, -100.0, -100.0, 100.0, 100.0).empty());
+    EXPECT_EQ(0, tree.getHeight());
+    EXPECT_EQ(0, tree.getNodeCount());
+}
+
+TEST(StaticRTreeTest, EntriesAreFoundBeforeTheBuild) {
+    StaticRTree tree;
+
+    tree.insert(1, 10.0, 10.0, 10.0, 10.0);
+    tree.insert(2, 500.0, 500.0, 520.0, 520.0);
+
+    EXPECT_EQ(2, tree.getPendingCount());
+    EXPECT_EQ(1, query(tree, 0.0, 0.0, 20.0, 20.0).size());
+    EXPECT_EQ(2, query(tree, 505.0, 505.0, 505.0, 505.0).at(0));
+}
+
+TEST(StaticRTreeTest, BuildPacksFullNodes) {
+    StaticRTree tree(16);
+
+    srand(7);
+    std::vector<TestBox> boxes = createStatics(1000);
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        tree.insert(boxes[i].id, boxes[i].lowX, boxes[i].lowZ, boxes[i].highX, boxes[i].highZ);
+    }
+
+    tree.build();
+
+    // 63 leafs, 4 nodes above them and the root
+    EXPECT_EQ(0, tree.getPendingCount());
+    EXPECT_EQ(1000, tree.getEntryCount());
+    EXPECT_EQ(68, tree.getNodeCount());
+    EXPECT_EQ(3, tree.getHeight());
+}
+
+TEST(StaticRTreeTest, QueriesMatchALinearScan) {
+    StaticRTree tree(8);
+
+    srand(11);
+    std::vector<TestBox> boxes = createStatics(5000);
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        tree.insert(boxes[i].id, boxes[i].lowX, boxes[i].lowZ, boxes[i].highX, boxes[i].highZ);
+    }
+
+    tree.build();
+
+    for (uint32 i = 0; i < 200; ++i) {
+        double x = static_cast<double>(rand() % 4400 - 2200);
+        double z = static_cast<double>(rand() % 4400 - 2200);
+        double range = static_cast<double>(rand() % 300);
+
+        EXPECT_EQ(linearScan(boxes, x - range, z - range, x + range, z + range),
+                  query(tree, x - range, z - range, x + range, z + range));
+    }
+}
+
+TEST(StaticRTreeTest, PointQueryFindsTheRegionsAroundIt) {
+    StaticRTree tree;
+
+    tree.insert(1, -50.0, -50.0, 50.0, 50.0);
+    tree.insert(2, 0.0, 0.0, 10.0, 10.0);
+    tree.insert(3, 60.0, 60.0, 70.0, 70.0);
+    tree.build();
+
+    std::vector<int64> ids = query(tree, 5.0, 5.0, 5.0, 5.0);
+
+    ASSERT_EQ(2, ids.size());
+    EXPECT_EQ(1, ids[0]);
+    EXPECT_EQ(2, ids[1]);
+
+    // the border belongs to the region
+    EXPECT_EQ(3, query(tree, 70.0, 65.0, 70.0, 65.0).at(0));
+}
+
+TEST(StaticRTreeTest, RemovedEntriesAreSkipped) {
+    StaticRTree tree(4);
+
+    for (int64 id = 1; id <= 20; ++id) {
+        tree.insert(id, static_cast<double>(id), 0.0, static_cast<double>(id), 0.0);
+    }
+
+    tree.build();
+
+    EXPECT_FALSE(tree.remove(5, 100.0, 0.0, 100.0, 0.0));
+    EXPECT_FALSE(tree.remove(21, 5.0, 0.0, 5.0, 0.0));
+    EXPECT_TRUE(tree.remove(5, 5.0, 0.0, 5.0, 0.0));
+    EXPECT_FALSE(tree.remove(5, 5.0, 0.0, 5.0, 0.0));
+
+    EXPECT_EQ(19, tree.getEntryCount());
+    EXPECT_TRUE(query(tree, 4.5, -1.0, 5.5, 1.0).empty());
+    EXPECT_EQ(19, query(tree, 0.0, -1.0, 21.0, 1.0).size());
+}
+
+TEST(StaticRTreeTest, InsertsAfterTheBuildArePendingUntilTheNext) {
+    StaticRTree tree(4);
+
+    for (int64 id = 1; id <= 20; ++id) {
+        tree.insert(id, static_cast<double>(id), 0.0, static_cast<double>(id), 0.0);
+    }
+
+    tree.build();
+    tree.remove(3, 3.0, 0.0, 3.0, 0.0);
+
+    tree.insert(30, 3.0, 0.0, 3.0, 0.0);
+    tree.insert(31, 40.0, 0.0, 40.0, 0.0);
+
+    EXPECT_EQ(2, tree.getPendingCount());
+    EXPECT_EQ(30, query(tree, 3.0, 0.0, 3.0, 0.0).at(0));
+
+    EXPECT_TRUE(tree.remove(31, 40.0, 0.0, 40.0, 0.0));
+    EXPECT_EQ(1, tree.getPendingCount());
+
+    tree.build();
+
+    EXPECT_EQ(0, tree.getPendingCount());
+    EXPECT_EQ(20, tree.getEntryCount());
+    EXPECT_EQ(20, query(tree, 0.0, 0.0, 50.0, 0.0).size());
+    EXPECT_EQ(30, query(tree, 3.0, 0.0, 3.0, 0.0).at(0));
+}
+
+//======================================================================================================================
+//
+// A zone boot, 40000 statics and buildings go in one at a time into the R*-tree as the ZoneTree is set up, against
+// collecting them and packing them once. Then every player in a busy city looks around in both.
+//
+
+namespace {
+
+class IdVisitor : public SpatialIndex::IVisitor {
+public:
+    explicit IdVisitor(std::vector<int64>* ids) : mIds(ids) {}
+
+    void visitNode(const SpatialIndex::INode& n) {}
+    void visitData(const SpatialIndex::IData& d) {
+        mIds->push_back(d.getIdentifier());
+    }
+    void visitData(std::vector<const SpatialIndex::IData*>& v) {}
+
+private:
+    std::vector<int64>* mIds;
+};
+
+}  // namespace
+
+TEST(StaticRTreeTest, DISABLED_BenchmarkZoneBoot) {
+    const uint32 staticCount = 40000;
+    const uint32 queryCount = 20000;
+    const double viewingRange = 128.0;
+
+    Clock::Init();
+
+    srand(42);
+    std::vector<TestBox> boxes = createStatics(staticCount);
+
+    std::vector<double> queryCenters;
+
+    for (uint32 i = 0; i < queryCount * 2; ++i) {
+        queryCenters.push_back(static_cast<double>(rand() % 4000 - 2000));
+    }
+
+    // the R*-tree as ZoneTree::Init sets it up
+    uint64 start = Clock::getSingleton()->getLocalTime();
+
+    SpatialIndex::IStorageManager* storage = SpatialIndex::StorageManager::createNewMemoryStorageManager();
+    SpatialIndex::StorageManager::IBuffer* buffer = SpatialIndex::StorageManager::createNewRandomEvictionsBuffer(*storage, 200, false);
+    int64 indexIdentifier = 0;
+    SpatialIndex::ISpatialIndex* rstarTree = SpatialIndex::RTree::createNewRTree(*buffer, 0.7, 100, 100, 2, SpatialIndex::RTree::RV_RSTAR, indexIdentifier);
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        double low[2] = {boxes[i].lowX, boxes[i].lowZ};
+        double high[2] = {boxes[i].highX, boxes[i].highZ};
+
+        rstarTree->insertData(0, 0, SpatialIndex::Region(low, high, 2), boxes[i].id);
+    }
+
+    uint64 rstarBuildTime = Clock::getSingleton()->getLocalTime() - start;
+    start = Clock::getSingleton()->getLocalTime();
+
+    uint64 rstarResults = 0;
+
+    for (uint32 i = 0; i < queryCount; ++i) {
+        double low[2] = {queryCenters[i * 2] - viewingRange, queryCenters[i * 2 + 1] - viewingRange};
+        double high[2] = {queryCenters[i * 2] + viewingRange, queryCenters[i * 2 + 1] + viewingRange};
+
+        std::vector<int64> ids;
+        IdVisitor visitor(&ids);
+
+        rstarTree->intersectsWithQuery(SpatialIndex::Region(low, high, 2), visitor);
+        rstarResults += ids.size();
+    }
+
+    uint64 rstarQueryTime = Clock::getSingleton()->getLocalTime() - start;
+    start = Clock::getSingleton()->getLocalTime();
+
+    StaticRTree staticTree;
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        staticTree.insert(boxes[i].id, boxes[i].lowX, boxes[i].lowZ, boxes[i].highX, boxes[i].highZ);
+    }
+
+    staticTree.build();
+
+    uint64 staticBuildTime = Clock::getSingleton()->getLocalTime() - start;
+    start = Clock::getSingleton()->getLocalTime();
+
+    uint64 staticResults = 0;
+
+    for (uint32 i = 0; i < queryCount; ++i) {
+        StaticRTree::IdList ids;
+
+        staticTree.intersects(queryCenters[i * 2] - viewingRange, queryCenters[i * 2 + 1] - viewingRange,
+                              queryCenters[i * 2] + viewingRange, queryCenters[i * 2 + 1] + viewingRange, &ids);
+        staticResults += ids.size();
+    }
+
+    uint64 staticQueryTime = Clock::getSingleton()->getLocalTime() - start;
+
+    EXPECT_EQ(rstarResults, staticResults);
+
+    printf("%u statics, %u queries\n", staticCount, queryCount);
+    printf("R*-tree:     %6"PRIu64" ms inserts, %6"PRIu64" ms queries\n", rstarBuildTime, rstarQueryTime);
+    printf("StaticRTree: %6"PRIu64" ms build,   %6"PRIu64" ms queries, %u nodes, height %u\n", staticBuildTime,
+           staticQueryTime, staticTree.getNodeCount(), staticTree.getHeight());
+
+    delete rstarTree;
+    delete buffer;
+    delete storage;
+}